@@ -0,0 +1,109 @@
+/**
+  ******************************************************************************
+  * @file    bench.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   目标板基准测试公共实现
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench.h"
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t* stack_probe_top;           /* 填充时的主栈指针 */
+
+/* 主栈范围，链接脚本中定义 */
+extern uint32_t _sstack[];
+extern uint32_t _estack[];
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  使能DWT周期计数器
+  * @param  None
+  * @retval None
+  */
+void bench_cycles_init(void)
+{
+    /* 不清零：测量只用差值，启动阶段记录(prof/bootprof)以复位为起点 */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+  * @brief  填充当前主栈指针以下BENCH_STACK_PROBE_SIZE字节
+  * @param  None
+  * @retval None
+  * @note   须在调度器启动前(使用MSP)调用，随后立即调用被测函数
+  */
+void bench_stack_paint(void)
+{
+    uint32_t* p = (uint32_t*)__get_MSP();
+    uint32_t i;
+
+    stack_probe_top = p;
+    for (i = 1; i <= BENCH_STACK_PROBE_SIZE / 4U; i++) {
+        p[-(int32_t)i] = BENCH_STACK_PATTERN;
+    }
+}
+
+/**
+  * @brief  查找填充区域中被改写的最大深度
+  * @param  None
+  * @retval 栈深度(字节)，等于BENCH_STACK_PROBE_SIZE表示已超出测量范围
+  */
+uint32_t bench_stack_used(void)
+{
+    uint32_t* p = stack_probe_top - BENCH_STACK_PROBE_SIZE / 4U;
+
+    while (p < stack_probe_top && *p == BENCH_STACK_PATTERN) {
+        p++;
+    }
+    return (uint32_t)(stack_probe_top - p) * 4U;
+}
+
+/**
+  * @brief  填充主栈底部(_sstack)到当前主栈指针之间的区域
+  * @param  None
+  * @retval None
+  * @note   须在调度器启动前(使用MSP)调用；填充期间的中断仍可使用主栈，
+  *         改写的部分计入随后的最大用量
+  */
+void bench_msp_paint(void)
+{
+    uint32_t* p = _sstack;
+    uint32_t* top = (uint32_t*)__get_MSP();
+
+    while (p < top) {
+        *p++ = BENCH_STACK_PATTERN;
+    }
+}
+
+/**
+  * @brief  查找主栈中被改写的最低地址
+  * @param  None
+  * @retval 从_estack起的最大用量(字节)，等于主栈大小表示已用尽或溢出
+  */
+uint32_t bench_msp_peak(void)
+{
+    uint32_t* p = _sstack;
+
+    while (p < _estack && *p == BENCH_STACK_PATTERN) {
+        p++;
+    }
+    return (uint32_t)(_estack - p) * 4U;
+}
+
+/**
+  * @brief  链接脚本分配的主栈大小
+  * @param  None
+  * @retval 字节数
+  */
+uint32_t bench_msp_size(void)
+{
+    return (uint32_t)(_estack - _sstack) * 4U;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    bench.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   目标板基准测试公共接口
+  *          DWT周期计数和主栈用量测量，以及各项基准测试入口
+  ******************************************************************************
+  * @attention
+  *
+  * 基准测试在main.h中RUN_BENCHMARKS为1时于调度器启动前运行，
+  * 结果经rtos_printf输出到标准输出(UART1或RTT)。
+  *
+  * 栈用量测量原理：先把当前主栈指针以下的一段区域填充为固定图案，
+  * 调用被测函数后从低地址向上查找第一个被改写的字，二者之差即为
+  * 被测函数的最大栈深度。期间发生的中断会使结果偏大。
+  *
+  * 测量范围只有BENCH_STACK_PROBE_SIZE。main在基准测试前后另以
+  * bench_msp_paint/bench_msp_peak测量整个主栈(_sstack~_estack)的最大用量，
+  * 包括main、被测函数和期间嵌套的中断，与链接脚本中的主栈大小比较。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define BENCH_STACK_PATTERN     0xDEADBEEFUL    /* 栈填充图案 */
+#define BENCH_STACK_PROBE_SIZE  2048U           /* 栈用量测量范围(字节) */
+
+/* Exported macro ------------------------------------------------------------*/
+#define BENCH_CYCLES()          (DWT->CYCCNT)   /* 当前CPU周期计数 */
+
+/* 中断延迟测量(RUN_IRQ_LATENCY)：TIM2中断入口的第一条语句记录DWT周期数，
+   并拉高测量引脚，被唤醒任务恢复运行时拉低，示波器上脉宽即中断到任务的延迟 */
+#define BENCH_IRQLAT_PIN_PORT   GPIOF
+#define BENCH_IRQLAT_PIN        GPIO_Pin_11     /* 绿色LED引脚 */
+#define BENCH_IRQLAT_ISR_ENTRY()                                \
+    do {                                                        \
+        bench_irqlat_isr_cycles = DWT->CYCCNT;                  \
+        BENCH_IRQLAT_PIN_PORT->BSRRL = BENCH_IRQLAT_PIN;        \
+    } while (0)
+
+/* Exported variables --------------------------------------------------------*/
+extern volatile uint32_t bench_irqlat_isr_cycles;  /* 最近一次TIM2中断入口的DWT周期数 */
+
+/* Exported functions ------------------------------------------------------- */
+void bench_cycles_init(void);                   /* 使能DWT周期计数器 */
+void bench_stack_paint(void);                   /* 填充主栈指针以下的测量范围 */
+uint32_t bench_stack_used(void);                /* 返回填充后被改写的最大深度(字节) */
+void bench_msp_paint(void);                     /* 填充主栈底部到当前主栈指针之间的区域 */
+uint32_t bench_msp_peak(void);                  /* 返回主栈的最大用量(字节) */
+uint32_t bench_msp_size(void);                  /* 返回链接脚本分配的主栈大小(字节) */
+
+/* 各项基准测试 */
+void bench_printf_run(void);
+void bench_pool_run(void);                      /* 内存块池与malloc对比，见bench_pool.c */
+
+/* 中断延迟测量(RUN_IRQ_LATENCY为1)，见bench_irqlat.c */
+void bench_irqlat_start(void);                  /* 创建测量任务 */
+
+/* CCM与SRAM1对比(RUN_CCM_BENCH为1)，见bench_ccm.c */
+void bench_ccm_start(void);                     /* 创建测量任务 */
+void bench_ccm_dma_irq_handler(void);           /* DMA2 Stream0传输完成中断 */
+
+/* QEMU测试镜像(QEMU_HARNESS为1)，见bench_qemu.c */
+void bench_qemu_start(void);                    /* 创建运行全部场景的控制任务 */
+void bench_qemu_write(const char* data, uint32_t len);  /* 半主机输出 */
+void bench_qemu_exit(int ok);                   /* 半主机退出，ok非0时退出码为0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BENCH_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
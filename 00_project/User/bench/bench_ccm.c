@@ -0,0 +1,314 @@
+/**
+  ******************************************************************************
+  * @file    bench_ccm.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   CCM与SRAM1的对比基准测试 - 任务切换和栈密集的DSP代码，
+  *          分别在DMA空闲和DMA持续搬运SRAM1数据时测量
+  ******************************************************************************
+  * @attention
+  *
+  * main.h中RUN_CCM_BENCH为1时，main在rtos_init之后调用bench_ccm_start
+  * 代替演示任务，结果经rtos_printf输出到标准输出。
+  *
+  * 背景DMA负载：DMA2 Stream0以存储器到存储器模式在两块SRAM1缓冲区
+  * (PORT_DMA_BSS)之间按字搬运，每次传输完成在中断中重新启动，
+  * 最高优先级并使用4拍突发，使SRAM1和总线矩阵持续繁忙。
+  *
+  * 测量项(CPU周期，DWT)：
+  * 1. fir/ccm   32阶FIR滤波256点，输入、系数和输出都是局部数组(约2.2KB栈)，
+  *              栈位于CCM
+  * 2. fir/sram  同上，栈位于SRAM1
+  * 3. switch    两个同优先级任务以task_yield轮流运行，每次切换的平均周期数；
+  *              任务控制块和栈的位置由RTOS_KERNEL_BSS/RTOS_KERNEL_NOINIT决定，默认在CCM，
+  *              以make CCM=0构建可得到放在SRAM1时的结果；以make MPU_GUARD=0
+  *              构建可得到不移动MPU栈保护区时的结果
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench.h"
+#include "../../02_rtos/core.h"
+#include "../../02_rtos/time.h"
+#include "../../02_rtos/rtos_printf.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_CCM_PRIO          2U      /* 测量任务和切换伙伴任务的优先级 */
+#define BENCH_CCM_STACK_WORDS   1024U   /* DSP代码使用的栈(4KB) */
+#define BENCH_CCM_DMA_WORDS     1024U   /* DMA每次搬运的字数 */
+#define BENCH_CCM_DMA_IRQ_PRIORITY  6U
+#define BENCH_CCM_FIR_TAPS      32U
+#define BENCH_CCM_FIR_SAMPLES   256U
+#define BENCH_CCM_FIR_LOOPS     20U
+#define BENCH_CCM_SWITCHES      2000U
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 一行测量结果：DMA空闲和DMA运行时的周期数 */
+typedef struct {
+    const char* name;
+    uint32_t cycles[2];
+} ccm_result_t;
+
+/* Private variables ---------------------------------------------------------*/
+/* 栈顶须8字节对齐 */
+static uint32_t ccm_stack[BENCH_CCM_STACK_WORDS] __attribute__((aligned(8))) PORT_FAST_BSS;
+static uint32_t sram_stack[BENCH_CCM_STACK_WORDS] __attribute__((aligned(8)));
+
+static uint32_t dma_src[BENCH_CCM_DMA_WORDS] PORT_DMA_BSS;
+static uint32_t dma_dst[BENCH_CCM_DMA_WORDS] PORT_DMA_BSS;
+static volatile uint8_t dma_running;
+static volatile uint32_t dma_transfers;
+
+static volatile float fir_sink;         /* 防止FIR结果被优化掉 */
+static volatile uint8_t partner_stop;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  在指定的栈上调用函数，返回后恢复原栈指针
+  * @param  fn: 被调用的函数
+  * @param  arg: 参数
+  * @param  sp: 新栈顶(8字节对齐)
+  * @retval None
+  */
+static void __attribute__((naked, noinline)) ccm_call_on_stack(void (*fn)(void*), void* arg, uint32_t* sp)
+{
+    __asm volatile(
+        "push {r4, lr}\n"
+        "mov r4, sp\n"
+        "mov sp, r2\n"
+        "mov r3, r0\n"
+        "mov r0, r1\n"
+        "blx r3\n"
+        "mov sp, r4\n"
+        "pop {r4, pc}\n"
+    );
+}
+
+/**
+  * @brief  启动一次DMA2 Stream0存储器到存储器传输
+  * @param  None
+  * @retval None
+  */
+static void ccm_dma_kick(void)
+{
+    DMA_ClearFlag(DMA2_Stream0, DMA_FLAG_TCIF0 | DMA_FLAG_HTIF0 | DMA_FLAG_TEIF0 |
+                                DMA_FLAG_DMEIF0 | DMA_FLAG_FEIF0);
+    DMA_SetCurrDataCounter(DMA2_Stream0, BENCH_CCM_DMA_WORDS);
+    DMA_Cmd(DMA2_Stream0, ENABLE);
+}
+
+/**
+  * @brief  配置并启动背景DMA负载
+  * @param  None
+  * @retval None
+  */
+static void ccm_dma_start(void)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+    DMA_Cmd(DMA2_Stream0, DISABLE);
+    while (DMA_GetCmdStatus(DMA2_Stream0) != DISABLE);
+    DMA_DeInit(DMA2_Stream0);
+
+    /* 存储器到存储器只能使用DMA2，源地址在外设端口，必须使用FIFO */
+    DMA_InitStructure.DMA_Channel = DMA_Channel_0;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)dma_src;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)dma_dst;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToMemory;
+    DMA_InitStructure.DMA_BufferSize = BENCH_CCM_DMA_WORDS;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Enable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Word;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Word;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Enable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_INC4;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_INC4;
+    DMA_Init(DMA2_Stream0, &DMA_InitStructure);
+
+    DMA_ITConfig(DMA2_Stream0, DMA_IT_TC, ENABLE);
+    NVIC_SetPriority(DMA2_Stream0_IRQn, BENCH_CCM_DMA_IRQ_PRIORITY);
+    NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+
+    dma_running = 1;
+    ccm_dma_kick();
+}
+
+/**
+  * @brief  停止背景DMA负载
+  * @param  None
+  * @retval None
+  */
+static void ccm_dma_stop(void)
+{
+    dma_running = 0;
+    DMA_Cmd(DMA2_Stream0, DISABLE);
+    while (DMA_GetCmdStatus(DMA2_Stream0) != DISABLE);
+    NVIC_DisableIRQ(DMA2_Stream0_IRQn);
+}
+
+/**
+  * @brief  栈密集的DSP代码 - 32阶FIR，数据全部在栈上
+  * @param  arg: 未使用
+  * @retval None
+  */
+static void ccm_fir(void* arg)
+{
+    float x[BENCH_CCM_FIR_SAMPLES + BENCH_CCM_FIR_TAPS];
+    float h[BENCH_CCM_FIR_TAPS];
+    float y[BENCH_CCM_FIR_SAMPLES];
+    float acc = 0.0f;
+    uint32_t i, k, loop;
+
+    (void)arg;
+    for (k = 0; k < BENCH_CCM_FIR_TAPS; k++) {
+        h[k] = 1.0f / (float)(k + 1U);
+    }
+    for (i = 0; i < BENCH_CCM_FIR_SAMPLES + BENCH_CCM_FIR_TAPS; i++) {
+        x[i] = (float)(i & 15U) - 7.5f;
+    }
+
+    for (loop = 0; loop < BENCH_CCM_FIR_LOOPS; loop++) {
+        for (i = 0; i < BENCH_CCM_FIR_SAMPLES; i++) {
+            float s = 0.0f;
+            for (k = 0; k < BENCH_CCM_FIR_TAPS; k++) {
+                s += h[k] * x[i + k];
+            }
+            y[i] = s;
+        }
+        for (i = 0; i < BENCH_CCM_FIR_SAMPLES; i++) {
+            acc += y[i];
+        }
+    }
+    fir_sink = acc;
+}
+
+/**
+  * @brief  在指定的栈上运行FIR并计时
+  * @param  stack: 栈数组(BENCH_CCM_STACK_WORDS字)
+  * @retval 每轮FIR的平均周期数
+  */
+static uint32_t ccm_time_fir(uint32_t* stack)
+{
+    uint32_t start = BENCH_CYCLES();
+
+    ccm_call_on_stack(ccm_fir, NULL, &stack[BENCH_CCM_STACK_WORDS]);
+    return (BENCH_CYCLES() - start) / BENCH_CCM_FIR_LOOPS;
+}
+
+/**
+  * @brief  切换伙伴任务 - 每次运行都立即让出处理器
+  * @param  arg: 未使用
+  * @retval None
+  */
+static void ccm_partner_task(void* arg)
+{
+    (void)arg;
+    while (!partner_stop) {
+        task_yield();
+    }
+}
+
+/**
+  * @brief  测量同优先级任务之间的切换周期
+  * @param  None
+  * @retval 每次切换的平均周期数
+  */
+static uint32_t ccm_time_switch(void)
+{
+    uint32_t start, i;
+
+    partner_stop = 0;
+    task_create(ccm_partner_task, NULL, BENCH_CCM_PRIO);
+    task_yield();                       /* 伙伴任务先运行一次，进入循环 */
+
+    start = BENCH_CYCLES();
+    for (i = 0; i < BENCH_CCM_SWITCHES; i++) {
+        task_yield();                   /* 切到伙伴任务，伙伴让出后切回 */
+    }
+    start = BENCH_CYCLES() - start;
+
+    partner_stop = 1;
+    task_yield();                       /* 伙伴任务退出并删除自身 */
+    return start / (BENCH_CCM_SWITCHES * 2U);
+}
+
+/**
+  * @brief  测量任务 - 依次在DMA空闲和DMA运行时测量，完成后删除自身
+  * @param  arg: 未使用
+  * @retval None
+  */
+static void ccm_task(void* arg)
+{
+    ccm_result_t results[3] = {
+        { "fir/ccm",  { 0, 0 } },
+        { "fir/sram", { 0, 0 } },
+        { "switch",   { 0, 0 } },
+    };
+    uint32_t dma, i, transfers;
+
+    (void)arg;
+    bench_cycles_init();
+
+    for (dma = 0; dma < 2U; dma++) {
+        if (dma) {
+            dma_transfers = 0;
+            ccm_dma_start();
+        }
+        results[0].cycles[dma] = ccm_time_fir(ccm_stack);
+        results[1].cycles[dma] = ccm_time_fir(sram_stack);
+        results[2].cycles[dma] = ccm_time_switch();
+        if (dma) {
+            ccm_dma_stop();
+        }
+    }
+    transfers = dma_transfers;
+
+    rtos_printf("\r\n[bench] CCM vs SRAM1 (cycles), task stacks in %s\r\n",
+                PORT_DMA_REACHABLE(scheduler.current_task->stack,
+                                   scheduler.current_task->stack_size * sizeof(uint32_t)) ? "SRAM" : "CCM");
+    rtos_printf("%-10s %10s %10s\r\n", "case", "dma-idle", "dma-busy");
+    for (i = 0; i < 3U; i++) {
+        rtos_printf("%-10s %10lu %10lu\r\n", results[i].name,
+                    (unsigned long)results[i].cycles[0], (unsigned long)results[i].cycles[1]);
+    }
+    rtos_printf("dma: %lu transfers of %lu bytes\r\n",
+                (unsigned long)transfers, (unsigned long)(BENCH_CCM_DMA_WORDS * 4U));
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  背景DMA传输完成中断 - 立即开始下一次传输
+  * @param  None
+  * @retval None
+  */
+void bench_ccm_dma_irq_handler(void)
+{
+    if (DMA_GetITStatus(DMA2_Stream0, DMA_IT_TCIF0) != RESET) {
+        DMA_ClearITPendingBit(DMA2_Stream0, DMA_IT_TCIF0);
+        dma_transfers++;
+        if (dma_running) {
+            ccm_dma_kick();
+        }
+    }
+}
+
+/**
+  * @brief  创建测量任务，须在rtos_init和Time_Init之后、rtos_start之前调用
+  * @param  None
+  * @retval None
+  */
+void bench_ccm_start(void)
+{
+    task_create(ccm_task, NULL, BENCH_CCM_PRIO);
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
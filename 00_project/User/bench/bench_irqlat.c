@@ -0,0 +1,339 @@
+/**
+  ******************************************************************************
+  * @file    bench_irqlat.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   中断延迟和抖动测量 - 延时到期的比较事件、中断入口、任务恢复
+  ******************************************************************************
+  * @attention
+  *
+  * main.h中RUN_IRQ_LATENCY为1时，main在rtos_init之后调用bench_irqlat_start
+  * 代替演示任务，结果经rtos_printf输出到标准输出。
+  *
+  * 三个时间戳，单位均为CPU周期(168MHz)：
+  * 1. 比较事件：TIM2的TRGO配置为比较脉冲(CC1IF置位时输出)，经内部触发
+  *    ITR1送到TIM1，TIM1通道1以TRC输入捕获。TIM1在APB2上按168MHz计数，
+  *    捕获值即事件发生的周期数(16位)，含约2~3个周期的触发同步延迟
+  * 2. 中断入口：stm32f4xx_it.c中TIM2_IRQHandler的第一条语句读DWT->CYCCNT
+  * 3. 任务恢复：测量任务从Delay_ticks返回后的第一条语句读DWT->CYCCNT
+  *
+  * TIM1和DWT的偏移在开始时以软件捕获(EGR.CC1G)前后两次读DWT标定，
+  * 误差为两次读数之差的一半，随结果输出。
+  *
+  * 每种背景负载采集BENCH_IRQLAT_SAMPLES个样本，输出三项延迟：
+  *   isr_entry    比较事件 -> 中断入口
+  *   isr_to_task  中断入口 -> 任务恢复
+  *   delay_total  比较事件 -> 任务恢复
+  * 的最小/平均/最大值和直方图。捕获溢出(CC1OF)或未捕获的样本计为丢弃。
+  *
+  * 测量引脚(BENCH_IRQLAT_PIN)在中断入口拉高、任务恢复时拉低，可用示波器
+  * 独立核对isr_to_task。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench.h"
+#include "../../02_rtos/core.h"
+#include "../../02_rtos/time.h"
+#include "../../02_rtos/rtos_printf.h"
+
+/* Private define ------------------------------------------------------------*/
+#ifndef BENCH_IRQLAT_SAMPLES
+#define BENCH_IRQLAT_SAMPLES        2000U   /* 每种负载的样本数 */
+#endif
+#ifndef BENCH_IRQLAT_CRITICAL_CYCLES
+#define BENCH_IRQLAT_CRITICAL_CYCLES 400U   /* critical负载的临界区长度 */
+#endif
+#define BENCH_IRQLAT_BUCKET         16U     /* 直方图每格周期数 */
+#define BENCH_IRQLAT_BUCKETS        64U     /* 直方图格数，另有一格记录更大的值 */
+#define BENCH_IRQLAT_BAR            40U     /* 直方图最长条的字符数 */
+
+#define BENCH_IRQLAT_PRIO           1U      /* 测量任务优先级，高于负载任务 */
+#define BENCH_IRQLAT_LOAD_PRIO      5U
+#define BENCH_IRQLAT_MAX_LOAD       3U
+
+#define BENCH_IRQLAT_DELAY_BASE     US_TO_TICKS(50)   /* 每次延时的基本长度 */
+#define BENCH_IRQLAT_DELAY_SPREAD   US_TO_TICKS(50)   /* 随机附加长度，避免与负载同相 */
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 背景负载 */
+typedef struct {
+    const char* name;
+    uint8_t tasks;              /* 负载任务数 */
+    uint32_t critical;          /* 每轮临界区长度(周期)，0表示不进入临界区 */
+    uint8_t print;              /* 每16轮经rtos_printf输出一个点(UART DMA中断) */
+} irqlat_load_t;
+
+/* 一项延迟的统计 */
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t count;
+    uint32_t bucket[BENCH_IRQLAT_BUCKETS + 1U];
+} irqlat_stat_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const irqlat_load_t irqlat_loads[] = {
+    { "idle",     0, 0,                            0 },  /* 只有空闲任务，含WFI唤醒 */
+    { "busy",     2, 0,                            0 },  /* 计算型任务 */
+    { "critical", 2, BENCH_IRQLAT_CRITICAL_CYCLES, 0 },  /* 任务反复进入临界区 */
+    { "printf",   1, 0,                            1 },  /* 格式化输出和UART DMA中断 */
+};
+
+static const char* const irqlat_names[3] = { "isr_entry", "isr_to_task", "delay_total" };
+
+static irqlat_stat_t irqlat_stat[3];
+static const irqlat_load_t* irqlat_load;
+static task_t* irqlat_load_tasks[BENCH_IRQLAT_MAX_LOAD];
+static uint32_t irqlat_sync_offset;     /* DWT周期数 - TIM1计数值 */
+static uint32_t irqlat_sync_error;
+
+/* Public variables ----------------------------------------------------------*/
+volatile uint32_t bench_irqlat_isr_cycles;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  配置TIM1以168MHz计数，通道1捕获TIM2的比较脉冲
+  * @param  None
+  * @retval None
+  */
+static void irqlat_capture_init(void)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    TIM_ICInitTypeDef TIM_ICInitStructure;
+    uint32_t c0, c1;
+
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM1, ENABLE);
+
+    TIM_TimeBaseStructure.TIM_Period = 0xFFFF;
+    TIM_TimeBaseStructure.TIM_Prescaler = 0;               /* APB2定时器时钟168MHz */
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(TIM1, &TIM_TimeBaseStructure);
+
+    /* ITR1为TIM2_TRGO，通道1映射到TRC */
+    TIM_SelectInputTrigger(TIM1, TIM_TS_ITR1);
+    TIM_ICInitStructure.TIM_Channel = TIM_Channel_1;
+    TIM_ICInitStructure.TIM_ICPolarity = TIM_ICPolarity_Rising;
+    TIM_ICInitStructure.TIM_ICSelection = TIM_ICSelection_TRC;
+    TIM_ICInitStructure.TIM_ICPrescaler = TIM_ICPSC_DIV1;
+    TIM_ICInitStructure.TIM_ICFilter = 0;
+    TIM_ICInit(TIM1, &TIM_ICInitStructure);
+    TIM_Cmd(TIM1, ENABLE);
+
+    /* TIM2的CC1IF置位时TRGO输出脉冲 */
+    TIM_SelectOutputTrigger(TIM2, TIM_TRGOSource_OC1);
+
+    /* 标定：软件捕获前后各读一次DWT */
+    __disable_irq();
+    c0 = DWT->CYCCNT;
+    TIM1->EGR = TIM_EGR_CC1G;
+    c1 = DWT->CYCCNT;
+    __enable_irq();
+    irqlat_sync_offset = c0 + (c1 - c0) / 2U - TIM1->CCR1;
+    irqlat_sync_error = (c1 - c0 + 1U) / 2U;
+    TIM_ClearFlag(TIM1, TIM_FLAG_CC1 | TIM_FLAG_CC1OF);
+}
+
+/**
+  * @brief  恢复TIM2的TRGO并停止TIM1
+  * @param  None
+  * @retval None
+  */
+static void irqlat_capture_deinit(void)
+{
+    TIM_SelectOutputTrigger(TIM2, TIM_TRGOSource_Reset);
+    TIM_Cmd(TIM1, DISABLE);
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM1, DISABLE);
+}
+
+/**
+  * @brief  记录一个样本
+  * @param  stat: 统计
+  * @param  cycles: 延迟周期数
+  * @retval None
+  */
+static void irqlat_add(irqlat_stat_t* stat, uint32_t cycles)
+{
+    uint32_t b = cycles / BENCH_IRQLAT_BUCKET;
+
+    if (stat->count == 0U || cycles < stat->min) {
+        stat->min = cycles;
+    }
+    if (cycles > stat->max) {
+        stat->max = cycles;
+    }
+    stat->sum += cycles;
+    stat->count++;
+    stat->bucket[(b < BENCH_IRQLAT_BUCKETS) ? b : BENCH_IRQLAT_BUCKETS]++;
+}
+
+/**
+  * @brief  输出一项统计的直方图，只输出非空的格
+  * @param  name: 名称
+  * @param  stat: 统计
+  * @retval None
+  */
+static void irqlat_print_histogram(const char* name, const irqlat_stat_t* stat)
+{
+    char bar[BENCH_IRQLAT_BAR + 1U];
+    uint32_t peak = 1;
+    uint32_t i, n;
+
+    for (i = 0; i <= BENCH_IRQLAT_BUCKETS; i++) {
+        if (stat->bucket[i] > peak) {
+            peak = stat->bucket[i];
+        }
+    }
+
+    rtos_printf("  %s:\r\n", name);
+    for (i = 0; i <= BENCH_IRQLAT_BUCKETS; i++) {
+        if (stat->bucket[i] == 0U) {
+            continue;
+        }
+        n = (stat->bucket[i] * BENCH_IRQLAT_BAR + peak - 1U) / peak;
+        bar[n] = '\0';
+        while (n > 0U) {
+            bar[--n] = '#';
+        }
+        if (i < BENCH_IRQLAT_BUCKETS) {
+            rtos_printf("    %5lu-%-5lu %6lu %s\r\n",
+                        (unsigned long)(i * BENCH_IRQLAT_BUCKET),
+                        (unsigned long)((i + 1U) * BENCH_IRQLAT_BUCKET - 1U),
+                        (unsigned long)stat->bucket[i], bar);
+        } else {
+            rtos_printf("    %5lu+      %6lu %s\r\n",
+                        (unsigned long)(i * BENCH_IRQLAT_BUCKET),
+                        (unsigned long)stat->bucket[i], bar);
+        }
+    }
+}
+
+/**
+  * @brief  背景负载任务
+  * @param  arg: 未使用，负载参数取自irqlat_load
+  * @retval None
+  */
+static void irqlat_load_task(void* arg)
+{
+    uint32_t primask, start, n = 0;
+
+    (void)arg;
+    while (1) {
+        if (irqlat_load->critical > 0U) {
+            primask = rtos_enter_critical();
+            start = DWT->CYCCNT;
+            while (DWT->CYCCNT - start < irqlat_load->critical) {
+            }
+            rtos_exit_critical(primask);
+        }
+        if (irqlat_load->print && (n % 16U) == 0U) {
+            rtos_printf(".");
+        }
+        for (start = DWT->CYCCNT; DWT->CYCCNT - start < 1000U + (n % 7U) * 100U; ) {
+        }
+        n++;
+    }
+}
+
+/**
+  * @brief  在一种负载下采集样本并输出结果
+  * @param  load: 负载
+  * @retval None
+  */
+static void irqlat_run(const irqlat_load_t* load)
+{
+    uint32_t i, j, sr, cap, isr, task_cycles, dropped = 0;
+    uint32_t lcg = 12345U;
+
+    for (j = 0; j < 3U; j++) {
+        irqlat_stat[j] = (irqlat_stat_t){ 0 };
+    }
+    irqlat_load = load;
+    for (j = 0; j < load->tasks && j < BENCH_IRQLAT_MAX_LOAD; j++) {
+        irqlat_load_tasks[j] = task_create(irqlat_load_task, NULL, BENCH_IRQLAT_LOAD_PRIO);
+    }
+
+    for (i = 0; i < BENCH_IRQLAT_SAMPLES; i++) {
+        lcg = lcg * 1103515245U + 12345U;
+        TIM_ClearFlag(TIM1, TIM_FLAG_CC1 | TIM_FLAG_CC1OF);
+
+        Delay_ticks(BENCH_IRQLAT_DELAY_BASE + (lcg >> 8) % BENCH_IRQLAT_DELAY_SPREAD);
+        task_cycles = DWT->CYCCNT;
+        BENCH_IRQLAT_PIN_PORT->BSRRH = BENCH_IRQLAT_PIN;
+
+        sr = TIM1->SR;
+        cap = TIM1->CCR1;
+        isr = bench_irqlat_isr_cycles;
+        if ((sr & TIM_FLAG_CC1) == 0U || (sr & TIM_FLAG_CC1OF) != 0U) {
+            dropped++;
+            continue;
+        }
+
+        /* 捕获值是16位的，延迟须小于65536个周期(390us) */
+        irqlat_add(&irqlat_stat[0], (uint16_t)(isr - irqlat_sync_offset - cap));
+        irqlat_add(&irqlat_stat[1], task_cycles - isr);
+        irqlat_add(&irqlat_stat[2], (uint16_t)(task_cycles - irqlat_sync_offset - cap));
+    }
+
+    for (j = 0; j < load->tasks && j < BENCH_IRQLAT_MAX_LOAD; j++) {
+        task_delete(irqlat_load_tasks[j]);
+    }
+
+    rtos_printf("\r\nload %s: %lu samples, %lu dropped\r\n", load->name,
+                (unsigned long)irqlat_stat[0].count, (unsigned long)dropped);
+    rtos_printf("  %-12s %8s %8s %8s\r\n", "cycles", "min", "avg", "max");
+    for (j = 0; j < 3U; j++) {
+        rtos_printf("  %-12s %8lu %8lu %8lu\r\n", irqlat_names[j],
+                    (unsigned long)irqlat_stat[j].min,
+                    (unsigned long)(irqlat_stat[j].count ? irqlat_stat[j].sum / irqlat_stat[j].count : 0U),
+                    (unsigned long)irqlat_stat[j].max);
+    }
+    for (j = 0; j < 3U; j++) {
+        irqlat_print_histogram(irqlat_names[j], &irqlat_stat[j]);
+    }
+}
+
+/**
+  * @brief  测量任务 - 依次在各种负载下测量，完成后删除自身
+  * @param  arg: 未使用
+  * @retval None
+  */
+static void irqlat_task(void* arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    bench_cycles_init();
+    irqlat_capture_init();
+
+    rtos_printf("IRQ latency: %lu samples per load, %lu cycles/bucket, sync +-%lu cycles\r\n",
+                (unsigned long)BENCH_IRQLAT_SAMPLES, (unsigned long)BENCH_IRQLAT_BUCKET,
+                (unsigned long)irqlat_sync_error);
+    for (i = 0; i < sizeof(irqlat_loads) / sizeof(irqlat_loads[0]); i++) {
+        irqlat_run(&irqlat_loads[i]);
+    }
+
+    irqlat_capture_deinit();
+    rtos_printf("IRQ latency: done\r\n");
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  创建测量任务，须在rtos_init和Time_Init之后、rtos_start之前调用
+  * @param  None
+  * @retval None
+  */
+void bench_irqlat_start(void)
+{
+    task_create(irqlat_task, NULL, BENCH_IRQLAT_PRIO);
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,217 @@
+/**
+  ******************************************************************************
+  * @file    bench_pool.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   内存块池、malloc和rtos_alloc的对比及TLSF堆最坏耗时测量
+  ******************************************************************************
+  * @attention
+  *
+  * 三种分配器各自重复以下过程BENCH_POOL_ROUNDS轮：
+  * 1. 连续分配BENCH_POOL_BLOCKS个BENCH_POOL_SIZE字节的块
+  * 2. 先释放奇数序号的块再释放偶数序号的块，使空闲链表交错
+  * 每次调用单独以DWT计时，输出分配和释放各自的最小、平均和最大周期数。
+  * malloc经port/cm4/malloc.c接到TLSF堆，比rtos_alloc多一次互斥锁加解锁。
+  *
+  * 第二部分测量TLSF堆的最坏耗时：BENCH_MIX_SLOTS个槽位上随机分配和释放
+  * 8~1024字节(1/8的请求为256~2303字节)，共BENCH_MIX_OPS次，使空闲块
+  * 大小分散、链表交错，输出每次分配和释放的最大周期数以及结束时各区域
+  * 的空闲块数和碎片率。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench.h"
+#include "../../02_rtos/pool.h"
+#include "../../02_rtos/mem.h"
+#include "../../02_rtos/rtos_printf.h"
+#include <stdlib.h>
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_POOL_SIZE         48U
+#define BENCH_POOL_BLOCKS       32U
+#define BENCH_POOL_ROUNDS       20U
+#define BENCH_MIX_SLOTS         64U
+#define BENCH_MIX_OPS           20000U
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 周期统计 */
+typedef struct {
+    uint32_t min;
+    uint32_t max;
+    uint32_t sum;
+    uint32_t count;
+} bench_pool_stat_t;
+
+/* 被测分配器 */
+typedef struct {
+    const char* name;
+    void* (*alloc)(void);
+    void (*free)(void* ptr);
+} bench_pool_impl_t;
+
+/* Private variables ---------------------------------------------------------*/
+POOL_DEFINE(bench_pool, BENCH_POOL_SIZE, BENCH_POOL_BLOCKS);
+
+/* Private functions ---------------------------------------------------------*/
+
+static void* impl_pool_alloc(void) { return pool_alloc(&bench_pool); }
+static void impl_pool_free(void* ptr) { pool_free(&bench_pool, ptr); }
+static void* impl_malloc(void) { return malloc(BENCH_POOL_SIZE); }
+static void impl_free(void* ptr) { free(ptr); }
+static void* impl_rtos_alloc(void) { return rtos_alloc(BENCH_POOL_SIZE, RTOS_MEM_ANY); }
+static void impl_rtos_free(void* ptr) { rtos_free(ptr); }
+
+static const bench_pool_impl_t bench_pool_impls[] = {
+    { "pool",       impl_pool_alloc,  impl_pool_free },
+    { "malloc",     impl_malloc,      impl_free },
+    { "rtos_alloc", impl_rtos_alloc,  impl_rtos_free },
+};
+
+/**
+  * @brief  记录一个周期样本
+  * @param  stat: 统计
+  * @param  cycles: 周期数
+  * @retval None
+  */
+static void bench_pool_add(bench_pool_stat_t* stat, uint32_t cycles)
+{
+    if (stat->count == 0U || cycles < stat->min) {
+        stat->min = cycles;
+    }
+    if (cycles > stat->max) {
+        stat->max = cycles;
+    }
+    stat->sum += cycles;
+    stat->count++;
+}
+
+/**
+  * @brief  测量一种分配器并输出一行结果
+  * @param  impl: 分配器
+  * @retval None
+  */
+static void bench_pool_measure(const bench_pool_impl_t* impl)
+{
+    void* blocks[BENCH_POOL_BLOCKS];
+    bench_pool_stat_t alloc_stat = { 0 };
+    bench_pool_stat_t free_stat = { 0 };
+    uint32_t failed = 0;
+    uint32_t start;
+    uint32_t round;
+    uint32_t i;
+
+    for (round = 0; round < BENCH_POOL_ROUNDS; round++) {
+        for (i = 0; i < BENCH_POOL_BLOCKS; i++) {
+            start = BENCH_CYCLES();
+            blocks[i] = impl->alloc();
+            bench_pool_add(&alloc_stat, BENCH_CYCLES() - start);
+            if (blocks[i] == NULL) {
+                failed++;
+            }
+        }
+        for (i = 0; i < BENCH_POOL_BLOCKS; i++) {
+            uint32_t k = (i < BENCH_POOL_BLOCKS / 2U) ? (2U * i + 1U) : (2U * (i - BENCH_POOL_BLOCKS / 2U));
+
+            start = BENCH_CYCLES();
+            impl->free(blocks[k]);
+            bench_pool_add(&free_stat, BENCH_CYCLES() - start);
+        }
+    }
+
+    rtos_printf("%-10s %6lu %6lu %6lu %6lu %6lu %6lu %6lu\r\n", impl->name,
+                (unsigned long)alloc_stat.min, (unsigned long)(alloc_stat.sum / alloc_stat.count),
+                (unsigned long)alloc_stat.max,
+                (unsigned long)free_stat.min, (unsigned long)(free_stat.sum / free_stat.count),
+                (unsigned long)free_stat.max, (unsigned long)failed);
+}
+
+/**
+  * @brief  随机大小的分配和释放，测量TLSF堆的最坏耗时
+  * @param  None
+  * @retval None
+  */
+static void bench_pool_mix(void)
+{
+    static void* slots[BENCH_MIX_SLOTS];
+    bench_pool_stat_t alloc_stat = { 0 };
+    bench_pool_stat_t free_stat = { 0 };
+    rtos_mem_stats_t mem;
+    uint32_t seed = 1U;
+    uint32_t failed = 0;
+    uint32_t start;
+    uint32_t size;
+    uint32_t i;
+    uint32_t k;
+
+    for (i = 0; i < BENCH_MIX_OPS; i++) {
+        seed = seed * 1103515245U + 12345U;
+        k = (seed >> 8) % BENCH_MIX_SLOTS;
+        if (slots[k] != NULL) {
+            start = BENCH_CYCLES();
+            rtos_free(slots[k]);
+            bench_pool_add(&free_stat, BENCH_CYCLES() - start);
+            slots[k] = NULL;
+        } else {
+            size = ((seed >> 20) & 7U) == 0U ? 256U + (seed >> 4) % 2048U : 8U + (seed >> 12) % 1017U;
+            start = BENCH_CYCLES();
+            slots[k] = rtos_alloc(size, RTOS_MEM_ANY);
+            bench_pool_add(&alloc_stat, BENCH_CYCLES() - start);
+            if (slots[k] == NULL) {
+                failed++;
+            }
+        }
+    }
+
+    rtos_printf("%-10s %6lu %6lu %6lu %6lu %6lu %6lu %6lu\r\n", "tlsf-mix",
+                (unsigned long)alloc_stat.min, (unsigned long)(alloc_stat.sum / alloc_stat.count),
+                (unsigned long)alloc_stat.max,
+                (unsigned long)free_stat.min, (unsigned long)(free_stat.sum / free_stat.count),
+                (unsigned long)free_stat.max, (unsigned long)failed);
+
+    for (i = 0; i < rtos_mem_region_count(); i++) {
+        (void)rtos_mem_get_stats(i, &mem);
+        rtos_printf("heap %-6s used %6lu peak %6lu largest %6lu free_blocks %4lu frag %2lu%%\r\n",
+                    mem.name, (unsigned long)mem.used, (unsigned long)mem.peak,
+                    (unsigned long)mem.largest_free, (unsigned long)mem.free_blocks,
+                    (unsigned long)mem.fragmentation);
+    }
+    for (k = 0; k < BENCH_MIX_SLOTS; k++) {
+        rtos_free(slots[k]);
+        slots[k] = NULL;
+    }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  运行内存分配对比基准测试
+  * @param  None
+  * @retval None
+  */
+void bench_pool_run(void)
+{
+    pool_stats_t stats;
+    uint32_t i;
+
+    bench_cycles_init();
+
+    rtos_printf("\r\n[bench] alloc/free %u bytes x %u: pool vs malloc vs rtos_alloc (cycles)\r\n",
+                (unsigned)BENCH_POOL_SIZE, (unsigned)BENCH_POOL_BLOCKS);
+    rtos_printf("%-10s %6s %6s %6s %6s %6s %6s %6s\r\n", "impl",
+                "a_min", "a_avg", "a_max", "f_min", "f_avg", "f_max", "fail");
+    for (i = 0; i < sizeof(bench_pool_impls) / sizeof(bench_pool_impls[0]); i++) {
+        bench_pool_measure(&bench_pool_impls[i]);
+    }
+    bench_pool_mix();
+
+    pool_get_stats(&bench_pool, &stats);
+    rtos_printf("pool %s: block %lu x %lu, peak %lu, failures %lu\r\n", stats.name,
+                (unsigned long)stats.block_size, (unsigned long)stats.block_count,
+                (unsigned long)stats.peak, (unsigned long)stats.failures);
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,163 @@
+/**
+  ******************************************************************************
+  * @file    bench_printf.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   rtos_snprintf、newlib snprintf和TLOG的对比基准测试
+  ******************************************************************************
+  * @attention
+  *
+  * 对同一组格式字符串分别调用newlib snprintf和rtos_snprintf，输出：
+  * - 每次调用的平均CPU周期数(DWT)
+  * - 单次调用的最大栈深度
+  * - 两者输出是否一致
+  *
+  * 第二张表以同样的格式字符串和参数比较每条日志的CPU周期数：newlib snprintf、
+  * rtos_snprintf(都只格式化到缓冲区，不含输出)和TLOG(编码并写入RTT通道1)，
+  * 给出snprintf与TLOG的周期比，以及文本长度与TLOG帧长度(字节/条)。测量前
+  * 代替调试器清空通道1，BENCH_TLOG_LOOPS条帧不会因通道满被丢弃。
+  *
+  * 工程使用nano.specs：newlib-nano默认不支持%f(需链接选项-u _printf_float)
+  * 也不支持%lld，对应两项会显示DIFF，此时仅周期数和栈深度有参考意义。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench.h"
+#include "../../02_rtos/rtos_printf.h"
+#include "../../02_rtos/rtt.h"
+#include "../../02_rtos/tlog.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define BENCH_PRINTF_LOOPS      100U
+#define BENCH_TLOG_LOOPS        32U         /* 帧不超过31字节时不会填满1KB的通道 */
+
+/* 用同样的参数分别测量两种实现 */
+#define BENCH_PRINTF_CASE(name, ...)                                                \
+    do {                                                                            \
+        uint32_t i_, start_, cyc_newlib_, cyc_rtos_, stk_newlib_, stk_rtos_;        \
+        start_ = BENCH_CYCLES();                                                    \
+        for (i_ = 0; i_ < BENCH_PRINTF_LOOPS; i_++) {                               \
+            (void)snprintf(ref, sizeof(ref), __VA_ARGS__);                          \
+        }                                                                           \
+        cyc_newlib_ = (BENCH_CYCLES() - start_) / BENCH_PRINTF_LOOPS;               \
+        start_ = BENCH_CYCLES();                                                    \
+        for (i_ = 0; i_ < BENCH_PRINTF_LOOPS; i_++) {                               \
+            (void)rtos_snprintf(out, sizeof(out), __VA_ARGS__);                     \
+        }                                                                           \
+        cyc_rtos_ = (BENCH_CYCLES() - start_) / BENCH_PRINTF_LOOPS;                 \
+        bench_stack_paint();                                                        \
+        (void)snprintf(ref, sizeof(ref), __VA_ARGS__);                              \
+        stk_newlib_ = bench_stack_used();                                           \
+        bench_stack_paint();                                                        \
+        (void)rtos_snprintf(out, sizeof(out), __VA_ARGS__);                         \
+        stk_rtos_ = bench_stack_used();                                             \
+        rtos_printf("%-12s %8lu %8lu %6lu %6lu  %s\r\n", name,                      \
+                    (unsigned long)cyc_newlib_, (unsigned long)cyc_rtos_,           \
+                    (unsigned long)stk_newlib_, (unsigned long)stk_rtos_,           \
+                    (strcmp(ref, out) == 0) ? "ok" : "DIFF");                       \
+    } while (0)
+
+/* 每条日志的周期数：snprintf和rtos_snprintf只格式化，TLOG编码并写入RTT；
+   比值以0.1为单位，文本和帧长度为字节 */
+#define BENCH_TLOG_CASE(name, ...)                                                  \
+    do {                                                                            \
+        uint32_t i_, start_, cyc_newlib_, cyc_rtos_, cyc_tlog_, wr_, frame_;        \
+        int text_;                                                                  \
+        start_ = BENCH_CYCLES();                                                    \
+        for (i_ = 0; i_ < BENCH_TLOG_LOOPS; i_++) {                                 \
+            text_ = snprintf(ref, sizeof(ref), __VA_ARGS__);                        \
+        }                                                                           \
+        cyc_newlib_ = (BENCH_CYCLES() - start_) / BENCH_TLOG_LOOPS;                 \
+        start_ = BENCH_CYCLES();                                                    \
+        for (i_ = 0; i_ < BENCH_TLOG_LOOPS; i_++) {                                 \
+            text_ = rtos_snprintf(out, sizeof(out), __VA_ARGS__);                   \
+        }                                                                           \
+        cyc_rtos_ = (BENCH_CYCLES() - start_) / BENCH_TLOG_LOOPS;                   \
+        ring->rd_off = ring->wr_off;                                                \
+        wr_ = ring->wr_off;                                                         \
+        start_ = BENCH_CYCLES();                                                    \
+        for (i_ = 0; i_ < BENCH_TLOG_LOOPS; i_++) {                                 \
+            TLOG(__VA_ARGS__);                                                      \
+        }                                                                           \
+        cyc_tlog_ = (BENCH_CYCLES() - start_) / BENCH_TLOG_LOOPS;                   \
+        frame_ = (ring->wr_off + ring->size - wr_) % ring->size / BENCH_TLOG_LOOPS; \
+        ring->rd_off = ring->wr_off;                                                \
+        if (cyc_tlog_ == 0U) {                                                      \
+            cyc_tlog_ = 1U;                 /* TLOG_ENABLE为0 */                    \
+        }                                                                           \
+        rtos_printf("%-12s %8lu %8lu %6lu %4lu.%lu %4lu.%lu %5d %5lu\r\n", name,    \
+                    (unsigned long)cyc_newlib_, (unsigned long)cyc_rtos_,           \
+                    (unsigned long)cyc_tlog_,                                       \
+                    (unsigned long)(cyc_newlib_ * 10U / cyc_tlog_ / 10U),           \
+                    (unsigned long)(cyc_newlib_ * 10U / cyc_tlog_ % 10U),           \
+                    (unsigned long)(cyc_rtos_ * 10U / cyc_tlog_ / 10U),             \
+                    (unsigned long)(cyc_rtos_ * 10U / cyc_tlog_ % 10U),             \
+                    text_, (unsigned long)frame_);                                  \
+    } while (0)
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  运行printf对比基准测试
+  * @param  None
+  * @retval None
+  */
+static void bench_tlog_run(void);
+
+void bench_printf_run(void)
+{
+    char ref[96];
+    char out[96];
+    uint32_t counter = 123456U;
+
+    bench_cycles_init();
+
+    rtos_printf("\r\n[bench] snprintf: newlib vs rtos (cycles/call, stack bytes)\r\n");
+    rtos_printf("%-12s %8s %8s %6s %6s\r\n", "case", "newlib", "rtos", "stk_n", "stk_r");
+
+    BENCH_PRINTF_CASE("literal", "Hellow rtos!\r\n");
+    BENCH_PRINTF_CASE("counter", "Hellow rtos! Counter: %lu\r\n", (unsigned long)counter);
+    BENCH_PRINTF_CASE("int-mix", "%d %5d %-5d|%+d", -42, 7, 12, 99);
+    BENCH_PRINTF_CASE("hex", "0x%08lx %#x %X", 0xDEADBEEFUL, 255U, 48879U);
+    BENCH_PRINTF_CASE("string", "[%s] [%10s] [%-6.3s]", "rtos", "task", "serial");
+    BENCH_PRINTF_CASE("int64", "%lld %llu", -1234567890123LL, 9876543210ULL);
+    BENCH_PRINTF_CASE("float", "%.3f %8.2f %f", 3.14159, -273.15, 0.5);
+
+    bench_tlog_run();
+}
+
+/**
+  * @brief  TLOG与snprintf的每条日志周期数和字节数对比
+  * @param  None
+  * @retval None
+  * @note   须在TLOG_Init之后调用；格式中的浮点参数TLOG须以TLOG_FLOAT传递，
+  *         这里只比较整数和字符串格式
+  */
+static void bench_tlog_run(void)
+{
+    char ref[96];
+    char out[96];
+    rtt_buffer_t* ring = &_SEGGER_RTT.up[TLOG_RTT_CHANNEL];
+    uint32_t dropped = TLOG_GetDropCount();
+    uint32_t counter = 123456U;
+
+    rtos_printf("\r\n[bench] log line: snprintf vs TLOG (cycles/line, ratio, bytes/line)\r\n");
+    rtos_printf("%-12s %8s %8s %6s %6s %6s %5s %5s\r\n", "case", "newlib", "rtos", "tlog",
+                "n/tlog", "r/tlog", "text", "frame");
+
+    BENCH_TLOG_CASE("literal", "Hellow rtos!\r\n");
+    BENCH_TLOG_CASE("counter", "Hellow rtos! Counter: %lu\r\n", (unsigned long)counter);
+    BENCH_TLOG_CASE("int-mix", "%d %5d %-5d|%+d", -42, 7, 12, 99);
+    BENCH_TLOG_CASE("hex", "0x%08lx %#x %X", 0xDEADBEEFUL, 255U, 48879U);
+
+    if (TLOG_GetDropCount() != dropped) {
+        rtos_printf("[bench] TLOG frames dropped, cycles are not valid\r\n");
+    }
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,406 @@
+/**
+  ******************************************************************************
+  * @file    bench_qemu.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   QEMU测试镜像的场景脚本和调度路径指令数测量
+  ******************************************************************************
+  * @attention
+  *
+  * 仅在QEMU_HARNESS为1时编译，由00_project/Makefile的qemu目标构建，
+  * 在QEMU的netduinoplus2(STM32F405)机器上运行。输出经ARM半主机
+  * (bkpt 0xAB)写到QEMU的标准输出，全部场景结束后以SYS_EXIT退出，
+  * 退出码0表示全部通过。半主机调用在没有调试器的真实硬件上会进入
+  * HardFault，测试镜像只用于QEMU。
+  *
+  * 输出格式(每行一项，供qemu/qemu_run.sh解析)：
+  *   PASS <场景> / FAIL <场景> / SKIP <场景> <原因>
+  *   insns <路径> <计数>
+  *   RESULT PASS|FAIL <通过数>/<场景数>
+  *
+  * 指令数：QEMU的TIM2按1GHz虚拟时钟计数，以-icount shift=0运行时每条
+  * 指令推进1ns，TIM2计数差即为执行的指令数。QEMU不模拟流水线和总线
+  * 等待，数值不是周期数，只用于发现算法层面的退化(如查找变为O(n^2))。
+  *
+  * QEMU未模拟DMA、RCC、GPIO输出和DWT，也不产生TIM2比较事件：
+  * 测试镜像不初始化LED和UART，延时场景在比较事件缺失时报告SKIP。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "bench.h"
+
+#if QEMU_HARNESS
+
+#include "../../02_rtos/core.h"
+#include "../../02_rtos/time.h"
+#include "../../02_rtos/rtos_printf.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define QEMU_CTRL_PRIO          8U      /* 控制任务优先级 */
+#define QEMU_ROUNDS             100U    /* 乒乓场景往返次数 */
+#define QEMU_FILL_TASKS         24U     /* 查找和延时链表测量用的填充任务数 */
+#define QEMU_DELAY_US           100U    /* 延时场景的延时时间 */
+#define QEMU_PROBE_TICKS        1000U   /* 比较事件探测的等待时间 */
+
+/* ARM半主机操作号和SYS_EXIT原因码 */
+#define SEMIHOST_SYS_WRITE0     0x04U
+#define SEMIHOST_SYS_EXIT       0x18U
+#define ADP_STOPPED_APP_EXIT    0x20026U /* 正常退出，QEMU退出码0 */
+#define ADP_STOPPED_RUN_ERROR   0x20023U /* 运行错误，QEMU退出码1 */
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t pass_count;
+static uint32_t fail_count;
+static uint32_t read_overhead;          /* 连续两次读TIM2计数值的差 */
+
+static wait_queue_t ctrl_queue;         /* 控制任务等待被其他任务唤醒 */
+static wait_queue_t ping_queue;         /* 乒乓场景：应答任务等待 */
+static wait_queue_t pong_queue;         /* 乒乓场景：控制任务等待 */
+
+static volatile uint32_t seq;           /* 抢占场景的执行顺序 */
+static volatile uint32_t hi_seq;
+static volatile uint32_t lo_seq;
+static volatile uint32_t pong_count;
+static volatile float pong_result;      /* 应答任务的浮点运算结果 */
+
+static task_t* fill_tasks[QEMU_FILL_TASKS];
+
+/* Private function prototypes -----------------------------------------------*/
+static int semihost_call(uint32_t op, const void* arg);
+static void check(const char* name, int ok);
+static void report(const char* name, uint32_t ticks);
+static float float_series(float x, float a, float b, uint32_t n);
+static void qemu_ctrl_task(void* arg);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  执行一次半主机调用
+  * @param  op: 操作号(R0)
+  * @param  arg: 参数块地址(R1)
+  * @retval 调用返回值
+  */
+static int semihost_call(uint32_t op, const void* arg)
+{
+    register uint32_t r0 __asm("r0") = op;
+    register const void* r1 __asm("r1") = arg;
+
+    __asm volatile ("bkpt 0xAB" : "+r" (r0) : "r" (r1) : "memory");
+    return (int)r0;
+}
+
+/**
+  * @brief  记录并输出一个场景的结果
+  * @param  name: 场景名
+  * @param  ok: 非0表示通过
+  * @retval None
+  */
+static void check(const char* name, int ok)
+{
+    if (ok) {
+        pass_count++;
+    } else {
+        fail_count++;
+    }
+    rtos_printf("%s %s\r\n", ok ? "PASS" : "FAIL", name);
+}
+
+/**
+  * @brief  输出一条路径的指令数，扣除读计数器本身的开销
+  * @param  name: 路径名
+  * @param  ticks: 测得的TIM2计数差
+  * @retval None
+  */
+static void report(const char* name, uint32_t ticks)
+{
+    ticks = (ticks > read_overhead) ? (ticks - read_overhead) : 0U;
+    rtos_printf("insns %s %lu\r\n", name, (unsigned long)ticks);
+}
+
+/**
+  * @brief  浮点迭代，乒乓场景中与任务切换交替执行以检查FPU上下文
+  * @param  x: 初值
+  * @param  a: 乘数
+  * @param  b: 加数
+  * @param  n: 迭代次数
+  * @retval n次x = x * a + b后的结果
+  */
+static float float_series(float x, float a, float b, uint32_t n)
+{
+    while (n--) {
+        x = x * a + b;
+    }
+    return x;
+}
+
+/**
+  * @brief  抢占场景：高优先级任务，创建后立即运行并返回(自动删除)
+  */
+static void preempt_hi_task(void* arg)
+{
+    (void)arg;
+    hi_seq = ++seq;
+}
+
+/**
+  * @brief  抢占场景：低优先级任务，控制任务挂起后才运行
+  */
+static void preempt_lo_task(void* arg)
+{
+    (void)arg;
+    lo_seq = ++seq;
+    task_wake_one(&ctrl_queue);
+    while (1) {
+        /* 被控制任务删除 */
+    }
+}
+
+/**
+  * @brief  退出场景：任务函数返回即删除任务
+  */
+static void exit_task(void* arg)
+{
+    (void)arg;
+}
+
+/**
+  * @brief  乒乓场景的应答任务，每轮做一次浮点运算
+  */
+static void pong_task(void* arg)
+{
+    float x = 2.0f;
+    uint32_t primask;
+
+    (void)arg;
+    while (1) {
+        primask = rtos_enter_critical();
+        task_wait(&ping_queue);
+        rtos_exit_critical(primask);
+
+        x = x * 0.9999f + 0.25f;
+        pong_result = x;
+        pong_count++;
+        task_wake_one(&pong_queue);
+    }
+}
+
+/**
+  * @brief  填充任务，优先级低于控制任务，测量期间不会运行
+  */
+static void fill_task(void* arg)
+{
+    (void)arg;
+    while (1) {
+        port_idle();
+    }
+}
+
+/**
+  * @brief  控制任务 - 依次运行全部场景，输出结果后退出QEMU
+  * @param  arg: 未使用
+  * @retval None
+  */
+static void qemu_ctrl_task(void* arg)
+{
+    uint32_t primask, t0, t1, i, count;
+    task_t* task;
+    task_t* reused;
+    char name[32];
+    float x;
+
+    (void)arg;
+    t0 = port_timer_now();
+    t1 = port_timer_now();
+    read_overhead = t1 - t0;
+
+    rtos_printf("QEMU harness: %u tasks max, stack %u words\r\n",
+                (unsigned)MAX_TASKS, (unsigned)STACK_SIZE);
+
+    /* 启动：控制任务在线程模式下使用PSP运行 */
+    check("boot", (__get_CONTROL() & CONTROL_SPSEL_Msk) != 0U && !port_in_isr());
+
+    /* 抢占：创建更高优先级的任务时立即切换，低优先级任务等到控制任务挂起 */
+    seq = 0;
+    hi_seq = 0;
+    lo_seq = 0;
+    task = task_create(preempt_lo_task, NULL, QEMU_CTRL_PRIO + 1U);
+    (void)task_create(preempt_hi_task, NULL, QEMU_CTRL_PRIO - 1U);
+    count = ++seq;
+    primask = rtos_enter_critical();
+    task_wait(&ctrl_queue);
+    rtos_exit_critical(primask);
+    check("preempt", task != NULL && hi_seq == 1U && count == 2U && lo_seq == 3U);
+    task_delete(task);
+
+    /* 退出：任务函数返回后删除，空闲的控制块被复用 */
+    count = scheduler.task_count;
+    task = task_create(exit_task, NULL, QEMU_CTRL_PRIO - 1U);
+    reused = task_create(exit_task, NULL, QEMU_CTRL_PRIO - 1U);
+    check("task_exit", task != NULL && task->task_func == NULL &&
+                       reused == task && scheduler.task_count == count);
+
+    /* 乒乓：每轮唤醒应答任务并等待其唤醒，两次切换；期间双方都使用FPU */
+    pong_count = 0;
+    (void)task_create(pong_task, NULL, QEMU_CTRL_PRIO - 1U);
+    x = 1.0f;
+    t0 = port_timer_now();
+    for (i = 0; i < QEMU_ROUNDS; i++) {
+        primask = rtos_enter_critical();
+        task_wake_one(&ping_queue);
+        task_wait(&pong_queue);
+        rtos_exit_critical(primask);
+        x = x * 1.0001f + 0.5f;
+    }
+    t1 = port_timer_now();
+    check("pingpong", pong_count == QEMU_ROUNDS);
+    check("fpu_context", x == float_series(1.0f, 1.0001f, 0.5f, QEMU_ROUNDS) &&
+                         pong_result == float_series(2.0f, 0.9999f, 0.25f, QEMU_ROUNDS));
+    report("wake_wait_roundtrip", (t1 - t0) / QEMU_ROUNDS + read_overhead);  /* 平均值，读计数器开销已摊薄 */
+
+    /* 调度路径：少量任务和填满任务池两种情况 */
+    t0 = port_timer_now();
+    primask = rtos_enter_critical();
+    rtos_exit_critical(primask);
+    t1 = port_timer_now();
+    report("critical_pair", t1 - t0);
+
+    t0 = port_timer_now();
+    rtos_schedule();
+    t1 = port_timer_now();
+    report("schedule_noswitch", t1 - t0);
+
+    t0 = port_timer_now();
+    (void)find_highest_priority_task();
+    t1 = port_timer_now();
+    rtos_snprintf(name, sizeof(name), "find_highest_n%u", (unsigned)scheduler.task_count);
+    report(name, t1 - t0);
+
+    count = scheduler.task_count;
+    for (i = 0; i < QEMU_FILL_TASKS; i++) {
+        t0 = port_timer_now();
+        fill_tasks[i] = task_create(fill_task, NULL, QEMU_CTRL_PRIO + 2U);
+        t1 = port_timer_now();
+    }
+    report("task_create", t1 - t0);
+
+    t0 = port_timer_now();
+    (void)find_highest_priority_task();
+    t1 = port_timer_now();
+    rtos_snprintf(name, sizeof(name), "find_highest_n%u", (unsigned)scheduler.task_count);
+    report(name, t1 - t0);
+
+    t0 = port_timer_now();
+    rtos_schedule();
+    t1 = port_timer_now();
+    rtos_snprintf(name, sizeof(name), "schedule_noswitch_n%u", (unsigned)scheduler.task_count);
+    report(name, t1 - t0);
+
+    /* 延时链表：到期时间递增，每次插入都走到链表尾部 */
+    for (i = 0; i < QEMU_FILL_TASKS; i++) {
+        t0 = port_timer_now();
+        Time_AddDelay(fill_tasks[i], DELAY_MAX_CHUNK_TICKS / 2U + i * 1000U);
+        t1 = port_timer_now();
+    }
+    rtos_snprintf(name, sizeof(name), "add_delay_tail_n%u", (unsigned)(QEMU_FILL_TASKS - 1U));
+    report(name, t1 - t0);
+
+    t0 = port_timer_now();
+    Time_CancelDelay(fill_tasks[QEMU_FILL_TASKS - 1U]);
+    t1 = port_timer_now();
+    rtos_snprintf(name, sizeof(name), "cancel_delay_tail_n%u", (unsigned)(QEMU_FILL_TASKS - 1U));
+    report(name, t1 - t0);
+
+    for (i = 0; i < QEMU_FILL_TASKS; i++) {
+        Time_CancelDelay(fill_tasks[i]);
+    }
+    for (i = 0; i < QEMU_FILL_TASKS; i++) {
+        t0 = port_timer_now();
+        task_delete(fill_tasks[i]);
+        t1 = port_timer_now();
+    }
+    report("task_delete", t1 - t0);
+    check("fill_cleanup", scheduler.task_count == count &&
+                          (TIM2->DIER & TIM_DIER_CC1IE) == 0U);
+
+    /* 延时：先探测TIM2比较事件是否存在，QEMU中缺失时跳过 */
+    primask = rtos_enter_critical();
+    TIM_ClearFlag(TIM2, TIM_FLAG_CC1);
+    t0 = port_timer_now();
+    TIM_SetCompare1(TIM2, t0 + QEMU_PROBE_TICKS);
+    while (port_timer_now() - t0 < 2U * QEMU_PROBE_TICKS) {
+    }
+    count = (TIM_GetFlagStatus(TIM2, TIM_FLAG_CC1) != RESET);
+    TIM_ClearFlag(TIM2, TIM_FLAG_CC1);
+    rtos_exit_critical(primask);
+    if (count) {
+        t0 = port_timer_now();
+        Delay_us(QEMU_DELAY_US);
+        t1 = port_timer_now();
+        check("delay", t1 - t0 >= US_TO_TICKS(QEMU_DELAY_US));
+    } else {
+        rtos_printf("SKIP delay TIM2 compare not modeled\r\n");
+    }
+
+    rtos_printf("RESULT %s %lu/%lu\r\n", fail_count == 0U ? "PASS" : "FAIL",
+                (unsigned long)pass_count, (unsigned long)(pass_count + fail_count));
+    bench_qemu_exit(fail_count == 0U);
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  创建控制任务，须在rtos_init之后、rtos_start之前调用
+  * @param  None
+  * @retval None
+  */
+void bench_qemu_start(void)
+{
+    pass_count = 0;
+    fail_count = 0;
+    memset(&ctrl_queue, 0, sizeof(ctrl_queue));
+    memset(&ping_queue, 0, sizeof(ping_queue));
+    memset(&pong_queue, 0, sizeof(pong_queue));
+    (void)task_create(qemu_ctrl_task, NULL, QEMU_CTRL_PRIO);
+}
+
+/**
+  * @brief  经半主机SYS_WRITE0输出一段数据，_write在测试镜像中调用
+  * @param  data: 待输出数据
+  * @param  len: 数据长度
+  * @retval None
+  */
+void bench_qemu_write(const char* data, uint32_t len)
+{
+    char chunk[65];
+    uint32_t n;
+
+    while (len > 0U) {
+        n = (len < sizeof(chunk) - 1U) ? len : (uint32_t)(sizeof(chunk) - 1U);
+        memcpy(chunk, data, n);
+        chunk[n] = '\0';
+        (void)semihost_call(SEMIHOST_SYS_WRITE0, chunk);
+        data += n;
+        len -= n;
+    }
+}
+
+/**
+  * @brief  经半主机SYS_EXIT结束QEMU
+  * @param  ok: 非0时退出码为0，否则为1
+  * @retval None
+  */
+void bench_qemu_exit(int ok)
+{
+    (void)semihost_call(SEMIHOST_SYS_EXIT,
+                        (const void*)(ok ? ADP_STOPPED_APP_EXIT : ADP_STOPPED_RUN_ERROR));
+    while (1) {
+    }
+}
+
+#endif /* QEMU_HARNESS */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -71,6 +71,12 @@ defined in linker script */
   .type  Reset_Handler, %function
 Reset_Handler:  
 
+/* Start the boot profile (DWT cycle counter from 0, User/prof/bootprof.c) */
+  bl  bootprof_reset
+/* Call the clock system intitialization function first: it uses no .data or
+   .bss, and the copy and zero loops below then run at 168MHz instead of HSI */
+  bl  SystemInit
+
 /* Copy the data segment initializers from flash to SRAM */  
   movs  r1, #0
   b  LoopCopyDataInit
@@ -110,8 +116,9 @@ LoopFillZerobss2:
   cmp  r2, r3
   bcc  FillZerobss2
 
-/* Call the clock system intitialization function.*/
-  bl  SystemInit   
+/* .noinit sections (task pool, large buffers) are not cleared */
+  movs  r0, #4                /* BOOTPROF_DATA */
+  bl  bootprof_mark
 /* Call the application's entry point.*/
   bl  main
   bx  lr    
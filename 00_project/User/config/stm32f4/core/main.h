@@ -12,7 +12,7 @@
   * 本文件定义了STM32F407 RTOS项目的硬件抽象层：
   * 1. 绿色LED控制宏定义（PF11引脚）
   * 2. 红色LED控制宏定义（PF12引脚）
-  * 3. UART1串口配置和printf重定向
+  * 3. UART1串口配置和printf重定向 (可选重定向到RTT通道0)
   * 4. 硬件初始化函数声明
   * 
   * 硬件平台：星火一号开发板 (STM32F407VGTx)
@@ -63,6 +63,94 @@
 #define LED_OFF()                    LED_G_OFF()
 #define LED_TOGGLE()                 LED_G_TOGGLE()
 
+/* UART1波特率 - APB2为84MHz，2Mbaud可整除分频 */
+#ifndef UART1_BAUDRATE
+#define UART1_BAUDRATE               115200
+#endif
+
+/* printf输出通道选择：0 - UART1串口，1 - RTT通道0 (调试器后台读取，不占用外设) */
+#ifndef STDIO_USE_RTT
+#define STDIO_USE_RTT                0
+#endif
+
+/* 串口打印任务使用令牌化日志：0 - printf文本输出，1 - TLOG二进制输出到RTT通道1 */
+#ifndef SERIAL_PRINT_USE_TLOG
+#define SERIAL_PRINT_USE_TLOG        0
+#endif
+
+/* 调度器启动前运行目标板基准测试(User/bench)，结果输出到标准输出 */
+#ifndef RUN_BENCHMARKS
+#define RUN_BENCHMARKS               0
+#endif
+
+/* 统计采样性能分析(User/prof)：TIM5按PROF_SAMPLE_HZ采样PC和当前任务，
+   样本输出到RTT通道2，主机端用03_tools/prof_report分析 */
+#ifndef PROF_ENABLE
+#define PROF_ENABLE                  0
+#endif
+
+#ifndef PROF_SAMPLE_HZ
+#define PROF_SAMPLE_HZ               1000
+#endif
+
+/* 中断统计(User/prof/irqstat)：stm32f4xx_it.c中的处理函数记录次数和周期数，
+   每IRQSTAT_REPORT_MS毫秒经rtos_printf输出各中断的频率、耗时和负载 */
+#ifndef IRQSTAT_ENABLE
+#define IRQSTAT_ENABLE               0
+#endif
+
+#ifndef IRQSTAT_REPORT_MS
+#define IRQSTAT_REPORT_MS            1000
+#endif
+
+/* 启动阶段记录(User/prof/bootprof)：复位起以DWT记录时钟、.data/.bss、main、
+   rtos_start和首个任务的时刻，串口打印任务启动时输出 */
+#ifndef BOOTPROF_ENABLE
+#define BOOTPROF_ENABLE              1
+#endif
+
+/* 复位到首个控制任务的目标时间(微秒)，bootprof_report据此给出结论 */
+#ifndef BOOTPROF_TARGET_US
+#define BOOTPROF_TARGET_US           5000
+#endif
+
+/* 上电/欠压复位的复位延时(微秒)：Reset_Handler之前，DWT无法计数。取数据手册
+   STM32F405/407 tRSTTEMPO的典型值(0.5~3ms)，未实测；NRST、软件和看门狗复位不计 */
+#ifndef BOOTPROF_RESET_TEMPO_US
+#define BOOTPROF_RESET_TEMPO_US      1500
+#endif
+
+/* 函数跟踪(02_rtos/ftrace)：make FTRACE=1时以FTRACE_ENABLE=1编译，
+   低优先级任务把数据块转发到RTT通道3，主机端用03_tools/ftrace_report分析 */
+#ifndef FTRACE_RTT_CHANNEL
+#define FTRACE_RTT_CHANNEL           3
+#endif
+
+#ifndef FTRACE_RTT_SIZE
+#define FTRACE_RTT_SIZE              4096
+#endif
+
+/* 以中断延迟测量(User/bench/bench_irqlat.c)代替演示任务，占用TIM1 */
+#ifndef RUN_IRQ_LATENCY
+#define RUN_IRQ_LATENCY              0
+#endif
+
+/* 以CCM与SRAM1对比测试(User/bench/bench_ccm.c)代替演示任务，占用DMA2 Stream0 */
+#ifndef RUN_CCM_BENCH
+#define RUN_CCM_BENCH                0
+#endif
+
+/* 以Thread-Metric测试(User/tm)代替演示任务，每项测试30秒，汇总表输出到标准输出 */
+#ifndef RUN_THREAD_METRIC
+#define RUN_THREAD_METRIC            0
+#endif
+
+/* QEMU测试镜像：由00_project/Makefile的qemu目标以-DQEMU_HARNESS=1构建，
+   跳过LED和UART初始化，运行User/bench/bench_qemu.c中的场景，标准输出经半主机 */
+#ifndef QEMU_HARNESS
+#define QEMU_HARNESS                 0
+#endif
+
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
 /* Exported macro ------------------------------------------------------------*/
@@ -71,7 +159,9 @@ void LED_Init(void);
 void LED_G_Init(void);
 void LED_R_Init(void);
 void UART1_Init(void);
+int UART1_Open(void);
 int fputc(int ch, FILE *f);
+int _write(int fd, char *ptr, int len);
 
 /* 高精度延时函数声明 - 在time.h中定义 */
 /* void Delay_ns(uint32_t ns);   - 在time.h中声明 */
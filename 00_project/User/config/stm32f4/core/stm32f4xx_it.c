@@ -10,23 +10,38 @@
   * @attention
   *
   * 本文件实现了Tickless RTOS系统所需的关键中断处理函数：
-  * 1. SVC_Handler - 系统调用中断，用于RTOS任务调度
+  * 1. SVC_Handler - 系统调用中断，SVC 0启动首个任务
   * 2. PendSV_Handler - 可挂起系统调用中断，用于上下文切换
   * 3. SysTick_Handler - 保留为空，Tickless系统不使用
   * 4. TIM2_IRQHandler - TIM2中断，用于高精度延时系统
+  * 5. DMA2_Stream7_IRQHandler - UART1 DMA发送完成中断
+  * 6. DMA2_Stream2_IRQHandler/USART1_IRQHandler - UART1 循环DMA接收
+  * 7. EXTI1_IRQHandler - Thread-Metric软件中断 (RUN_THREAD_METRIC)
+  * 8. TIM5_IRQHandler - 统计采样性能分析 (PROF_ENABLE)
+  * 9. DMA2_Stream0_IRQHandler - CCM对比测试的背景DMA负载 (RUN_CCM_BENCH)
+  * 10. HardFault_Handler/MemManage_Handler - 跳转到移植层，识别任务栈越界
   *
   * 中断优先级配置：
   * - SVC: 0 (最高优先级)
+  * - TIM5: 1 (采样性能分析，可采样其他中断)
   * - PendSV: 15 (最低优先级)
   * - TIM2: 3 (高优先级)
+  * - USART1/DMA2_Stream2: 4 (UART1接收)
+  * - DMA2_Stream7: 5 (UART1发送)
+  * - EXTI1: 6 (Thread-Metric软件中断)
   * - SysTick: 不使用 (Tickless架构)
   *
+  * IRQSTAT_ENABLE为1时外设中断处理函数以IRQSTAT_ENTER/IRQSTAT_EXIT包裹，
+  * 统计次数和周期数，见User/prof/irqstat.h
+  *
   ******************************************************************************
   */
 
 /* Includes ------------------------------------------------------------------*/
 #include "stm32f4xx_it.h"
 #include "main.h"
+#include "bench/bench.h"
+#include "prof/irqstat.h"
 
 /** @addtogroup Template_Project
   * @{
@@ -56,26 +71,22 @@ void NMI_Handler(void)
   * @brief  This function handles Hard Fault exception.
   * @param  None
   * @retval None
+  * @note   临界区内的MemManage故障升级为HardFault，同样交给移植层判断
   */
-//void HardFault_Handler(void)
-//{
-//  /* Go to infinite loop when Hard Fault exception occurs */
-//  while (1)
-//  {
-//  }
-//}
+void __attribute__((naked)) HardFault_Handler(void)
+{
+    __asm volatile("b port_fault_handler\n");
+}
 
 /**
   * @brief  This function handles Memory Manage exception.
   * @param  None
   * @retval None
+  * @note   由移植层判断是否为任务栈越界进入MPU保护区，并调用rtos_stack_overflow
   */
-void MemManage_Handler(void)
+void __attribute__((naked)) MemManage_Handler(void)
 {
-  /* Go to infinite loop when Memory Manage exception occurs */
-  while (1)
-  {
-  }
+    __asm volatile("b port_fault_handler\n");
 }
 
 /**
@@ -108,11 +119,11 @@ void UsageFault_Handler(void)
   * @brief  This function handles SVCall exception.
   * @param  None
   * @retval None
+  * @note   naked函数直接跳转，保留异常入口的LR(EXC_RETURN)
   */
-void SVC_Handler(void)
+void __attribute__((naked)) SVC_Handler(void)
 {
-    extern void svc_handler(void);
-    svc_handler();
+    __asm volatile("b svc_handler\n");
 }
 
 /**
@@ -128,11 +139,11 @@ void DebugMon_Handler(void)
   * @brief  This function handles PendSVC exception.
   * @param  None
   * @retval None
+  * @note   naked函数直接跳转，上下文切换见02_rtos/port/cm4/port.c
   */
-void PendSV_Handler(void)
+void __attribute__((naked)) PendSV_Handler(void)
 {
-    extern void pend_sv_handler(void);
-    pend_sv_handler();
+    __asm volatile("b pend_sv_handler\n");
 }
 
 /**
@@ -156,8 +167,99 @@ void SysTick_Handler(void)
 void TIM2_IRQHandler(void)
 {
     extern void TIM2_IRQHandler_Internal(void);
+#if RUN_IRQ_LATENCY
+    BENCH_IRQLAT_ISR_ENTRY();   /* 须为第一条语句 */
+#endif
+    IRQSTAT_ENTER();
     TIM2_IRQHandler_Internal();
+    IRQSTAT_EXIT(IRQSTAT_TIM2);
+}
+
+/**
+  * @brief  This function handles DMA2 Stream7 (USART1_TX) interrupt.
+  * @param  None
+  * @retval None
+  */
+void DMA2_Stream7_IRQHandler(void)
+{
+    extern void uart_tx_dma_irq_handler(void);
+    IRQSTAT_ENTER();
+    uart_tx_dma_irq_handler();
+    IRQSTAT_EXIT(IRQSTAT_DMA2_STREAM7);
+}
+
+/**
+  * @brief  This function handles DMA2 Stream2 (USART1_RX) interrupt.
+  * @param  None
+  * @retval None
+  */
+void DMA2_Stream2_IRQHandler(void)
+{
+    extern void uart_rx_dma_irq_handler(void);
+    IRQSTAT_ENTER();
+    uart_rx_dma_irq_handler();
+    IRQSTAT_EXIT(IRQSTAT_DMA2_STREAM2);
+}
+
+/**
+  * @brief  This function handles USART1 global interrupt (idle line).
+  * @param  None
+  * @retval None
+  */
+void USART1_IRQHandler(void)
+{
+    extern void uart_rx_idle_irq_handler(void);
+    IRQSTAT_ENTER();
+    uart_rx_idle_irq_handler();
+    IRQSTAT_EXIT(IRQSTAT_USART1);
+}
+
+#if RUN_THREAD_METRIC
+/**
+  * @brief  This function handles EXTI Line1 interrupt (Thread-Metric软件中断).
+  * @param  None
+  * @retval None
+  */
+void EXTI1_IRQHandler(void)
+{
+    extern void tm_irq_handler(void);
+    IRQSTAT_ENTER();
+    tm_irq_handler();
+    IRQSTAT_EXIT(IRQSTAT_EXTI1);
+}
+#endif
+
+#if RUN_CCM_BENCH
+/**
+  * @brief  This function handles DMA2 Stream0 interrupt (CCM对比测试的背景DMA).
+  * @param  None
+  * @retval None
+  */
+void DMA2_Stream0_IRQHandler(void)
+{
+    bench_ccm_dma_irq_handler();
+}
+#endif
+
+#if PROF_ENABLE
+/**
+  * @brief  This function handles TIM5 global interrupt (采样性能分析).
+  * @param  None
+  * @retval None
+  * @note   naked函数按EXC_RETURN选择MSP或PSP，把异常栈帧地址和EXC_RETURN
+  *         传给prof_sample_isr，见User/prof/prof.c
+  */
+void __attribute__((naked)) TIM5_IRQHandler(void)
+{
+    __asm volatile(
+        "tst lr, #4\n"
+        "ite eq\n"
+        "mrseq r0, msp\n"
+        "mrsne r0, psp\n"
+        "mov r1, lr\n"
+        "b prof_sample_isr\n");
 }
+#endif
 
 /******************************************************************************/
 /*                 STM32F4xx Peripherals Interrupt Handlers                   */
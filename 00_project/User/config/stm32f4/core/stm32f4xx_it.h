@@ -12,7 +12,7 @@
   * 本文件声明了Tickless RTOS系统所需的关键中断处理函数：
   * 1. 系统异常处理函数 (NMI, HardFault, MemManage, BusFault, UsageFault)
   * 2. RTOS核心中断处理函数 (SVC, PendSV)
-  * 3. 外设中断处理函数 (TIM2)
+  * 3. 外设中断处理函数 (TIM2, DMA2_Stream2/7, USART1)
   * 4. 兼容性中断处理函数 (SysTick - 保留但为空)
   *
   * 注意：这是一个Tickless RTOS系统，不使用SysTick周期性中断
@@ -46,6 +46,9 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 void SysTick_Handler(void);
 void TIM2_IRQHandler(void);
+void DMA2_Stream7_IRQHandler(void);
+void DMA2_Stream2_IRQHandler(void);
+void USART1_IRQHandler(void);
 
 #ifdef __cplusplus
 }
@@ -315,6 +315,7 @@
   */
 
 #include "stm32f4xx.h"
+#include "prof/bootprof.h"
 
 /**
   * @}
@@ -680,6 +681,8 @@ static void SetSysClock(void)
 
   if (HSEStatus == (uint32_t)0x01)
   {
+    bootprof_mark(BOOTPROF_HSE);
+
     /* Select regulator voltage output Scale 1 mode */
     RCC->APB1ENR |= RCC_APB1ENR_PWREN;
     PWR->CR |= PWR_CR_VOS;
@@ -722,6 +725,7 @@ static void SetSysClock(void)
     while((RCC->CR & RCC_CR_PLLRDY) == 0)
     {
     }
+    bootprof_mark(BOOTPROF_PLL);
    
 #if defined(STM32F427_437xx) || defined(STM32F429_439xx) || defined(STM32F446xx) || defined(STM32F469_479xx)
     /* Enable the Over-drive to extend the clock frequency to 180 Mhz */
@@ -760,6 +764,7 @@ static void SetSysClock(void)
     while ((RCC->CFGR & (uint32_t)RCC_CFGR_SWS ) != RCC_CFGR_SWS_PLL)
     {
     }
+    bootprof_mark(BOOTPROF_SYSCLK);
   }
   else
   { /* If HSE fails to start-up, the application will have wrong clock
@@ -0,0 +1,578 @@
+/**
+  ******************************************************************************
+  * @file    drv_uart.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   UART1 DMA收发驱动实现
+  ******************************************************************************
+  * @attention
+  *
+  * 实现原理：
+  * 1. 读写指针为自由递增的32位计数值，缓冲区大小为2的幂，取模即得下标
+  * 2. 写入者在临界区内完成拷贝和写指针更新，DMA中断只修改读指针
+  * 3. 每次DMA传输只搬运一段地址连续的数据，回绕部分由完成中断续传
+  * 4. 阻塞的写入者挂在等待队列上，由DMA完成中断唤醒
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "drv_uart.h"
+#include "core.h"
+#include "time.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#if (UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1)) != 0
+#error "UART_TX_BUFFER_SIZE must be a power of two"
+#endif
+
+#define UART_TX_MASK            (UART_TX_BUFFER_SIZE - 1U)
+#define UART_TX_DMA_STREAM      DMA2_Stream7
+#define UART_TX_DMA_CHANNEL     DMA_Channel_4
+#define UART_TX_DMA_FLAGS       (DMA_FLAG_TCIF7 | DMA_FLAG_HTIF7 | DMA_FLAG_TEIF7 | \
+                                 DMA_FLAG_DMEIF7 | DMA_FLAG_FEIF7)
+
+#if (UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) != 0 || UART_RX_BUFFER_SIZE > 0xFFFF
+#error "UART_RX_BUFFER_SIZE must be a power of two not above 32768"
+#endif
+
+#define UART_RX_MASK            (UART_RX_BUFFER_SIZE - 1U)
+#define UART_RX_DMA_STREAM      DMA2_Stream2
+#define UART_RX_DMA_CHANNEL     DMA_Channel_4
+
+/* Private variables ---------------------------------------------------------*/
+
+/* 发送环形缓冲区 - DMA可访问的SRAM中，内容由读写指针界定，启动时不清零 */
+static uint8_t uart_tx_buf[UART_TX_BUFFER_SIZE] PORT_DMA_NOINIT;
+
+static volatile uint32_t tx_head = 0;       /* 写指针 - 写入者推进 */
+static volatile uint32_t tx_tail = 0;       /* 读指针 - DMA完成中断推进 */
+static volatile uint32_t tx_dma_len = 0;    /* 正在传输的字节数，0表示DMA空闲 */
+
+static uart_tx_policy_t tx_policy = UART_TX_DEFAULT_POLICY;
+static uart_tx_stats_t tx_stats;
+static wait_queue_t tx_waiters;              /* 等待缓冲区空间的任务 */
+
+/* 接收环形缓冲区 - 即循环DMA的目标缓冲区，启动时不清零 */
+static uint8_t uart_rx_buf[UART_RX_BUFFER_SIZE] PORT_DMA_NOINIT;
+
+static volatile uint32_t rx_head = 0;       /* 已发布的字节计数 - 接收中断推进 */
+static volatile uint32_t rx_tail = 0;       /* 已消费的字节计数 - 读取者推进 */
+static uint32_t rx_dma_pos = 0;             /* 上次发布时DMA的写入位置 */
+static uart_rx_stats_t rx_stats;
+static wait_queue_t rx_waiters;              /* 等待数据的任务 */
+
+/* Private function prototypes -----------------------------------------------*/
+static void uart_tx_kick(void);
+static uint32_t uart_rx_dma_count(void);
+static void uart_rx_publish(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  DMA空闲时启动下一段连续数据的传输
+  * @param  None
+  * @retval None
+  * @note   须在临界区或DMA中断中调用
+  */
+static void uart_tx_kick(void)
+{
+    uint32_t pending;
+    uint32_t offset;
+    uint32_t chunk;
+
+    if (tx_dma_len != 0) {
+        return;
+    }
+
+    pending = tx_head - tx_tail;
+    if (pending == 0) {
+        return;
+    }
+
+    /* 只发送到缓冲区末尾，回绕部分在完成中断中续传 */
+    offset = tx_tail & UART_TX_MASK;
+    chunk = UART_TX_BUFFER_SIZE - offset;
+    if (chunk > pending) {
+        chunk = pending;
+    }
+    if (chunk > 0xFFFFU) {
+        chunk = 0xFFFFU;  /* NDTR为16位 */
+    }
+
+    tx_dma_len = chunk;
+    tx_stats.dma_transfers++;
+
+    DMA_ClearFlag(UART_TX_DMA_STREAM, UART_TX_DMA_FLAGS);
+    DMA_MemoryTargetConfig(UART_TX_DMA_STREAM, (uint32_t)&uart_tx_buf[offset], DMA_Memory_0);
+    DMA_SetCurrDataCounter(UART_TX_DMA_STREAM, (uint16_t)chunk);
+    DMA_Cmd(UART_TX_DMA_STREAM, ENABLE);
+}
+
+/**
+  * @brief  DMA累计写入的字节计数，含尚未发布的部分
+  * @param  None
+  * @retval 与rx_head同一计数基准的DMA写入位置
+  * @note   须在临界区或接收中断中调用；两次发布之间DMA不超过一个缓冲区
+  */
+static uint32_t uart_rx_dma_count(void)
+{
+    uint32_t pos = (UART_RX_BUFFER_SIZE - DMA_GetCurrDataCounter(UART_RX_DMA_STREAM)) & UART_RX_MASK;
+
+    return rx_head + ((pos - rx_dma_pos) & UART_RX_MASK);
+}
+
+/**
+  * @brief  根据DMA当前写入位置发布新接收的数据
+  * @param  None
+  * @retval None
+  * @note   由DMA半满/全满和空闲线中断调用，两者优先级相同不会互相嵌套；
+  *         半满/全满中断保证两次发布之间不超过半个缓冲区
+  */
+static void uart_rx_publish(void)
+{
+    uint32_t count;
+    uint32_t used;
+
+    count = uart_rx_dma_count() - rx_head;
+    if (count == 0) {
+        return;
+    }
+    rx_dma_pos = (rx_dma_pos + count) & UART_RX_MASK;
+
+    rx_head += count;
+    rx_stats.bytes_received += count;
+
+    /* 读取者落后超过一个缓冲区：最旧的数据已被DMA覆盖 */
+    used = rx_head - rx_tail;
+    if (used > UART_RX_BUFFER_SIZE) {
+        rx_stats.bytes_lost += used - UART_RX_BUFFER_SIZE;
+        rx_tail = rx_head - UART_RX_BUFFER_SIZE;
+        used = UART_RX_BUFFER_SIZE;
+    }
+    if (used > rx_stats.max_used) {
+        rx_stats.max_used = used;
+    }
+
+    if (rx_waiters.head != NULL) {
+        task_wake_all(&rx_waiters);
+    }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  初始化UART1 DMA发送
+  * @param  None
+  * @retval None
+  */
+void uart_tx_init(void)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    /* DMA不能访问CCM，缓冲区被放错位置时传输会产生总线错误 */
+    assert_param(PORT_DMA_REACHABLE(uart_tx_buf, sizeof(uart_tx_buf)));
+
+    /* 使能DMA2时钟 */
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+
+    /* 复位DMA2 Stream7 */
+    DMA_Cmd(UART_TX_DMA_STREAM, DISABLE);
+    while (DMA_GetCmdStatus(UART_TX_DMA_STREAM) != DISABLE);
+    DMA_DeInit(UART_TX_DMA_STREAM);
+
+    /* 配置为存储器到外设、字节宽度、普通模式 */
+    DMA_InitStructure.DMA_Channel = UART_TX_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)uart_tx_buf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_MemoryToPeripheral;
+    DMA_InitStructure.DMA_BufferSize = 1;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(UART_TX_DMA_STREAM, &DMA_InitStructure);
+
+    /* 使能传输完成中断 */
+    DMA_ITConfig(UART_TX_DMA_STREAM, DMA_IT_TC, ENABLE);
+    NVIC_SetPriority(DMA2_Stream7_IRQn, UART_TX_DMA_IRQ_PRIORITY);
+    NVIC_EnableIRQ(DMA2_Stream7_IRQn);
+
+    /* 使能USART1的DMA发送请求 */
+    USART_DMACmd(USART1, USART_DMAReq_Tx, ENABLE);
+
+    tx_head = 0;
+    tx_tail = 0;
+    tx_dma_len = 0;
+    memset(&tx_stats, 0, sizeof(tx_stats));
+    tx_waiters.head = NULL;
+    tx_waiters.tail = NULL;
+}
+
+/**
+  * @brief  写入发送缓冲区
+  * @param  data: 数据指针
+  * @param  len: 数据长度
+  * @retval 进入缓冲区的字节数
+  * @note   阻塞策略下仅在缓冲区满时挂起当前任务；中断上下文或调度器
+  *         未启动时无法挂起，中断中丢弃剩余数据，启动前则轮询等待DMA
+  */
+uint32_t uart_write(const void* data, uint32_t len)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t written = 0;
+    uint32_t primask;
+    uint32_t space;
+    uint32_t offset;
+    uint32_t chunk;
+
+    while (len > 0) {
+        primask = rtos_enter_critical();
+
+        space = UART_TX_BUFFER_SIZE - (tx_head - tx_tail);
+        chunk = (space < len) ? space : len;
+        if (chunk > 0) {
+            /* 拷贝到缓冲区，最多两段 */
+            offset = tx_head & UART_TX_MASK;
+            if (chunk > UART_TX_BUFFER_SIZE - offset) {
+                memcpy(&uart_tx_buf[offset], p, UART_TX_BUFFER_SIZE - offset);
+                memcpy(uart_tx_buf, p + (UART_TX_BUFFER_SIZE - offset),
+                       chunk - (UART_TX_BUFFER_SIZE - offset));
+            } else {
+                memcpy(&uart_tx_buf[offset], p, chunk);
+            }
+            tx_head += chunk;
+            p += chunk;
+            len -= chunk;
+            written += chunk;
+            tx_stats.bytes_queued += chunk;
+            if (tx_head - tx_tail > tx_stats.max_used) {
+                tx_stats.max_used = tx_head - tx_tail;
+            }
+            uart_tx_kick();
+        }
+
+        if (len > 0) {
+            if (tx_policy == UART_TX_POLICY_DROP || port_in_isr()) {
+                tx_stats.bytes_dropped += len;
+                rtos_exit_critical(primask);
+                break;
+            }
+            /* 挂起等待DMA释放空间；调度器未运行时退化为轮询 */
+            (void)task_wait(&tx_waiters);
+        }
+
+        rtos_exit_critical(primask);
+    }
+
+    return written;
+}
+
+/**
+  * @brief  等待发送缓冲区中的数据全部发出
+  * @param  None
+  * @retval None
+  */
+void uart_flush(void)
+{
+    uint32_t primask;
+
+    if (port_in_isr()) {
+        return;
+    }
+
+    primask = rtos_enter_critical();
+    while (tx_head != tx_tail) {
+        (void)task_wait(&tx_waiters);
+        rtos_exit_critical(primask);
+        primask = rtos_enter_critical();
+    }
+    rtos_exit_critical(primask);
+
+    /* 等待最后一个字节移出移位寄存器 */
+    while (USART_GetFlagStatus(USART1, USART_FLAG_TC) == RESET);
+}
+
+/**
+  * @brief  设置缓冲区满时的处理策略
+  * @param  policy: UART_TX_POLICY_BLOCK 或 UART_TX_POLICY_DROP
+  * @retval None
+  */
+void uart_tx_set_policy(uart_tx_policy_t policy)
+{
+    tx_policy = policy;
+}
+
+/**
+  * @brief  读取发送统计
+  * @param  stats: 输出统计信息
+  * @retval None
+  */
+void uart_tx_get_stats(uart_tx_stats_t* stats)
+{
+    uint32_t primask = rtos_enter_critical();
+    *stats = tx_stats;
+    rtos_exit_critical(primask);
+}
+
+/**
+  * @brief  初始化UART1循环DMA接收
+  * @param  None
+  * @retval None
+  */
+void uart_rx_init(void)
+{
+    DMA_InitTypeDef DMA_InitStructure;
+
+    assert_param(PORT_DMA_REACHABLE(uart_rx_buf, sizeof(uart_rx_buf)));
+
+    RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2, ENABLE);
+
+    /* 复位DMA2 Stream2 */
+    DMA_Cmd(UART_RX_DMA_STREAM, DISABLE);
+    while (DMA_GetCmdStatus(UART_RX_DMA_STREAM) != DISABLE);
+    DMA_DeInit(UART_RX_DMA_STREAM);
+
+    /* 配置为外设到存储器、字节宽度、循环模式 */
+    DMA_InitStructure.DMA_Channel = UART_RX_DMA_CHANNEL;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&USART1->DR;
+    DMA_InitStructure.DMA_Memory0BaseAddr = (uint32_t)uart_rx_buf;
+    DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralToMemory;
+    DMA_InitStructure.DMA_BufferSize = UART_RX_BUFFER_SIZE;
+    DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+    DMA_InitStructure.DMA_FIFOMode = DMA_FIFOMode_Disable;
+    DMA_InitStructure.DMA_FIFOThreshold = DMA_FIFOThreshold_Full;
+    DMA_InitStructure.DMA_MemoryBurst = DMA_MemoryBurst_Single;
+    DMA_InitStructure.DMA_PeripheralBurst = DMA_PeripheralBurst_Single;
+    DMA_Init(UART_RX_DMA_STREAM, &DMA_InitStructure);
+
+    rx_head = 0;
+    rx_tail = 0;
+    rx_dma_pos = 0;
+    memset(&rx_stats, 0, sizeof(rx_stats));
+    rx_waiters.head = NULL;
+    rx_waiters.tail = NULL;
+
+    /* 半满/全满中断 + 空闲线中断，批量发布数据 */
+    DMA_ITConfig(UART_RX_DMA_STREAM, DMA_IT_HT | DMA_IT_TC, ENABLE);
+    NVIC_SetPriority(DMA2_Stream2_IRQn, UART_RX_IRQ_PRIORITY);
+    NVIC_EnableIRQ(DMA2_Stream2_IRQn);
+
+    USART_ITConfig(USART1, USART_IT_IDLE, ENABLE);
+    NVIC_SetPriority(USART1_IRQn, UART_RX_IRQ_PRIORITY);
+    NVIC_EnableIRQ(USART1_IRQn);
+
+    USART_DMACmd(USART1, USART_DMAReq_Rx, ENABLE);
+    DMA_Cmd(UART_RX_DMA_STREAM, ENABLE);
+}
+
+/**
+  * @brief  未读字节数
+  * @param  None
+  * @retval 字节数
+  */
+uint32_t uart_rx_available(void)
+{
+    return rx_head - rx_tail;
+}
+
+/**
+  * @brief  获取一段地址连续的未读数据（零拷贝）
+  * @param  data: 输出数据起始地址
+  * @retval 连续数据长度，数据回绕时需再次调用获取剩余部分
+  * @note   处理完成后调用uart_rx_consume()释放；数据在DMA回绕前有效
+  */
+uint32_t uart_rx_peek(const uint8_t** data)
+{
+    uint32_t primask = rtos_enter_critical();
+    uint32_t avail = rx_head - rx_tail;
+    uint32_t offset = rx_tail & UART_RX_MASK;
+    uint32_t span = UART_RX_BUFFER_SIZE - offset;
+    rtos_exit_critical(primask);
+
+    *data = &uart_rx_buf[offset];
+    return (avail < span) ? avail : span;
+}
+
+/**
+  * @brief  释放已处理的数据
+  * @param  len: 字节数，超过未读字节数时按未读字节数处理
+  * @retval None
+  * @note   释放时DMA已写过这些字节所在位置(可能尚未发布)的部分计入bytes_lost，
+  *         读取者拿到的可能已是新数据；发布时读取者仍未读到的覆盖由uart_rx_publish计入
+  */
+void uart_rx_consume(uint32_t len)
+{
+    uint32_t primask = rtos_enter_critical();
+    uint32_t avail = rx_head - rx_tail;
+    uint32_t overwritten;
+
+    if (len > avail) {
+        len = avail;
+    }
+    overwritten = uart_rx_dma_count() - UART_RX_BUFFER_SIZE - rx_tail;
+    if ((int32_t)overwritten > 0) {
+        rx_stats.bytes_lost += (overwritten < len) ? overwritten : len;
+    }
+    rx_tail += len;
+    rtos_exit_critical(primask);
+}
+
+/**
+  * @brief  阻塞读取
+  * @param  buf: 接收缓冲区
+  * @param  len: 期望读取的字节数
+  * @param  timeout_ms: 超时时间(ms)，0表示不等待，UART_WAIT_FOREVER表示一直等待
+  * @retval 实际读取的字节数，超时时可能小于len
+  */
+uint32_t uart_read(void* buf, uint32_t len, uint32_t timeout_ms)
+{
+    uint8_t* out = (uint8_t*)buf;
+    const uint8_t* span;
+    uint32_t got = 0;
+    uint32_t n;
+    uint32_t primask;
+    uint32_t wait_ticks;
+    uint32_t start;
+    uint32_t elapsed;
+    uint64_t remaining = (uint64_t)timeout_ms * TIM2_TICKS_PER_MS;
+
+    /* 中断中不能阻塞 */
+    if (port_in_isr()) {
+        timeout_ms = 0;
+    }
+
+    for (;;) {
+        /* 拷贝当前可读的数据 */
+        while (got < len && (n = uart_rx_peek(&span)) > 0) {
+            if (n > len - got) {
+                n = len - got;
+            }
+            memcpy(out + got, span, n);
+            uart_rx_consume(n);
+            got += n;
+        }
+        if (got >= len || timeout_ms == 0) {
+            break;
+        }
+
+        primask = rtos_enter_critical();
+        if (rx_head != rx_tail) {
+            rtos_exit_critical(primask);
+            continue;
+        }
+        if (timeout_ms != UART_WAIT_FOREVER && remaining == 0) {
+            rtos_exit_critical(primask);
+            break;
+        }
+
+        /* 挂起等待新数据或超时；调度器未运行时退化为轮询 */
+        if (timeout_ms == UART_WAIT_FOREVER) {
+            wait_ticks = RTOS_WAIT_FOREVER;
+        } else {
+            wait_ticks = (remaining > DELAY_MAX_CHUNK_TICKS) ? DELAY_MAX_CHUNK_TICKS : (uint32_t)remaining;
+        }
+        start = port_timer_now();
+        (void)task_wait_timeout(&rx_waiters, wait_ticks);
+        rtos_exit_critical(primask);
+
+        if (timeout_ms != UART_WAIT_FOREVER) {
+            elapsed = port_timer_now() - start;
+            remaining = (elapsed >= remaining) ? 0 : remaining - elapsed;
+        }
+    }
+
+    return got;
+}
+
+/**
+  * @brief  读取接收统计
+  * @param  stats: 输出统计信息
+  * @retval None
+  */
+void uart_rx_get_stats(uart_rx_stats_t* stats)
+{
+    uint32_t primask = rtos_enter_critical();
+    *stats = rx_stats;
+    rtos_exit_critical(primask);
+}
+
+/**
+  * @brief  DMA2 Stream2半满/全满中断处理
+  * @param  None
+  * @retval None
+  */
+void uart_rx_dma_irq_handler(void)
+{
+    if (DMA_GetITStatus(UART_RX_DMA_STREAM, DMA_IT_HTIF2) != RESET) {
+        DMA_ClearITPendingBit(UART_RX_DMA_STREAM, DMA_IT_HTIF2);
+        rx_stats.dma_events++;
+    }
+    if (DMA_GetITStatus(UART_RX_DMA_STREAM, DMA_IT_TCIF2) != RESET) {
+        DMA_ClearITPendingBit(UART_RX_DMA_STREAM, DMA_IT_TCIF2);
+        rx_stats.dma_events++;
+    }
+    uart_rx_publish();
+}
+
+/**
+  * @brief  USART1空闲线中断处理 - 一帧数据结束后立即发布
+  * @param  None
+  * @retval None
+  */
+void uart_rx_idle_irq_handler(void)
+{
+    uint32_t primask;
+
+    if (USART_GetITStatus(USART1, USART_IT_IDLE) != RESET) {
+        rx_stats.idle_events++;
+        uart_rx_publish();
+
+        /* IDLE以读SR、读DR清除。DMA读DR时才取走字节，RXNE置位说明DR中是
+         * DMA尚未取走的新字节，此时读DR会把它从DMA手中拿走，因此不读；
+         * IDLE仍置位时中断再次进入，届时DMA已取走该字节。检查和读取在
+         * 临界区内连续进行，其间不会被更高优先级的中断拉开 */
+        primask = rtos_enter_critical();
+        if (USART_GetFlagStatus(USART1, USART_FLAG_RXNE) == RESET) {
+            (void)USART_ReceiveData(USART1);
+        }
+        rtos_exit_critical(primask);
+    }
+}
+
+/**
+  * @brief  DMA2 Stream7传输完成中断处理
+  * @param  None
+  * @retval None
+  */
+void uart_tx_dma_irq_handler(void)
+{
+    if (DMA_GetITStatus(UART_TX_DMA_STREAM, DMA_IT_TCIF7) != RESET) {
+        DMA_ClearITPendingBit(UART_TX_DMA_STREAM, DMA_IT_TCIF7);
+
+        /* 释放已发送的数据段并续传下一段 */
+        tx_tail += tx_dma_len;
+        tx_dma_len = 0;
+        uart_tx_kick();
+
+        /* 唤醒等待空间的写入者 */
+        if (tx_waiters.head != NULL) {
+            task_wake_all(&tx_waiters);
+        }
+    }
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
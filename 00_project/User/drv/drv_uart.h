@@ -0,0 +1,114 @@
+/**
+  ******************************************************************************
+  * @file    drv_uart.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   UART1 DMA收发驱动头文件
+  *          发送：环形缓冲区 + DMA2 Stream7/Channel4 (USART1_TX)
+  *          接收：循环DMA + DMA2 Stream2/Channel4 (USART1_RX) + 空闲线检测
+  ******************************************************************************
+  * @attention
+  *
+  * 发送路径：
+  * 1. uart_write()只把数据拷贝进发送环形缓冲区，随后立即返回
+  * 2. DMA空闲时启动一次传输，发送缓冲区中一段连续的数据
+  * 3. DMA传输完成中断推进读指针，并接着启动下一段连续数据
+  * 4. 缓冲区满时按策略处理：阻塞等待空间(仅任务上下文)或丢弃并计数
+  *
+  * 接收路径：
+  * 1. DMA以循环模式把数据持续写入接收环形缓冲区，CPU不参与逐字节搬运
+  * 2. DMA半满/全满中断和USART空闲线中断读取DMA当前位置，批量发布新数据
+  * 3. uart_read()阻塞读取(带超时)，uart_rx_peek()/uart_rx_consume()零拷贝访问
+  * 4. 读取者来不及消费时最旧的数据被覆盖，丢失字节数计入统计
+  *
+  * 中断优先级：USART1/DMA2_Stream2 - 4，DMA2_Stream7 - 5 (均低于TIM2，高于PendSV)
+  *
+  ******************************************************************************
+  */
+
+#ifndef __DRV_UART_H__
+#define __DRV_UART_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32f4xx.h"
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* 发送缓冲区大小，必须为2的幂 */
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE     1024
+#endif
+
+/* 缓冲区满时的默认处理策略 */
+#ifndef UART_TX_DEFAULT_POLICY
+#define UART_TX_DEFAULT_POLICY  UART_TX_POLICY_BLOCK
+#endif
+
+#define UART_TX_DMA_IRQ_PRIORITY    5     /* DMA发送完成中断优先级 */
+
+/* 接收缓冲区大小，必须为2的幂；2Mbaud下半个缓冲区(1KB)约5ms到达一次 */
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE     2048
+#endif
+
+#define UART_RX_IRQ_PRIORITY        4     /* USART1空闲线及DMA接收中断优先级 */
+#define UART_WAIT_FOREVER           0xFFFFFFFFUL  /* uart_read无限等待 */
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 发送缓冲区满时的处理策略 */
+typedef enum {
+    UART_TX_POLICY_BLOCK = 0,   /* 阻塞等待空间，中断上下文中退化为丢弃 */
+    UART_TX_POLICY_DROP         /* 丢弃放不下的部分并计数 */
+} uart_tx_policy_t;
+
+/* 发送统计信息 */
+typedef struct {
+    uint32_t bytes_queued;      /* 累计进入缓冲区的字节数 */
+    uint32_t bytes_dropped;     /* 累计因缓冲区满丢弃的字节数 */
+    uint32_t dma_transfers;     /* 累计启动的DMA传输次数 */
+    uint32_t max_used;          /* 缓冲区占用高水位 */
+} uart_tx_stats_t;
+
+/* 接收统计信息 */
+typedef struct {
+    uint32_t bytes_received;    /* 累计发布的字节数 */
+    uint32_t bytes_lost;        /* 累计因未及时读取被覆盖的字节数(DMA在两次发布之间写满一圈以上时为下限) */
+    uint32_t idle_events;       /* 空闲线中断次数 */
+    uint32_t dma_events;        /* DMA半满/全满中断次数 */
+    uint32_t max_used;          /* 未读数据高水位 */
+} uart_rx_stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+void uart_tx_init(void);                            /* 初始化DMA发送，须在UART1_Init之后调用 */
+uint32_t uart_write(const void* data, uint32_t len); /* 写入发送缓冲区，返回接收的字节数 */
+void uart_flush(void);                              /* 等待缓冲区全部发送完毕 */
+void uart_tx_set_policy(uart_tx_policy_t policy);   /* 设置缓冲区满时的处理策略 */
+void uart_tx_get_stats(uart_tx_stats_t* stats);     /* 读取发送统计 */
+
+void uart_rx_init(void);                            /* 初始化循环DMA接收，须在UART1_Init之后调用 */
+uint32_t uart_read(void* buf, uint32_t len, uint32_t timeout_ms); /* 读取len字节或超时，返回实际字节数 */
+uint32_t uart_rx_available(void);                   /* 未读字节数 */
+uint32_t uart_rx_peek(const uint8_t** data);        /* 获取一段连续未读数据，返回长度 */
+void uart_rx_consume(uint32_t len);                 /* 标记已处理len字节 */
+void uart_rx_get_stats(uart_rx_stats_t* stats);     /* 读取接收统计 */
+
+/* 中断处理函数（供stm32f4xx_it.c调用） */
+void uart_tx_dma_irq_handler(void);
+void uart_rx_dma_irq_handler(void);
+void uart_rx_idle_irq_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DRV_UART_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
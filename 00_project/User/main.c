@@ -17,21 +17,71 @@
   * 
   * 硬件平台：星火一号开发板 (STM32F407VGTx)
   * LED引脚：绿色LED - PF11，红色LED - PF12
-  * 串口：UART1 - PA9(TX), PA10(RX)，波特率115200
+  * 串口：UART1 - PA9(TX), PA10(RX)，波特率115200，发送经由DMA2 Stream7
+  *
+  * 快速启动：时钟在Reset_Handler中先于.data/.bss初始化配置，任务栈不清零；
+  * 演示任务由RTOS_TASK_DEFINE静态定义，rtos_start一次启动；main只做调度器
+  * 需要的初始化，LED由各自的任务初始化，UART1在第一次输出时初始化
+  * (UART1_Open)。各阶段时刻由User/prof/bootprof记录。
   *
   ******************************************************************************
   */
 #include "main.h"
 #include "../../02_rtos/core.h"
 #include "../../02_rtos/time.h"
+#include "../../02_rtos/rtt.h"
+#include "../../02_rtos/tlog.h"
+#include "../../02_rtos/rtos_printf.h"
+#include "../../02_rtos/ftrace.h"
+#include "bench/bench.h"
+#include "tm/tm_api.h"
+#include "prof/prof.h"
+#include "prof/irqstat.h"
+#include "prof/bootprof.h"
+#include "drv/drv_uart.h"
 #include <stdio.h>
 
 /* 私有变量定义 - 已移除废弃的TimingDelay变量 */
+static rtos_once_t uart1_once;  /* UART1首次使用时初始化 */
 
 /* 示例任务函数声明 */
 void task_led_g_blink(void* arg);
 void task_led_r_blink(void* arg);
 void task_serial_print(void* arg);
+#if FTRACE_ENABLE
+void task_ftrace_drain(void* arg);
+#endif
+#if IRQSTAT_ENABLE
+void task_irqstat_report(void* arg);
+#endif
+
+/* 静态定义的任务 - 控制块和栈在链接时分配，rtos_start一次性启动 */
+#define DEMO_TASKS (!QEMU_HARNESS && !RUN_IRQ_LATENCY && !RUN_CCM_BENCH && !RUN_THREAD_METRIC)
+
+/* 栈大小(字)：make stack生成的STACK_WORDS_<func>经STACK_HEADER加入时按各任务的
+   最坏用量分配，否则为STACK_SIZE；不低于RTOS_TASK_MIN_STACK */
+#define TASK_STACK(words)   ((words) > RTOS_TASK_MIN_STACK ? (words) : RTOS_TASK_MIN_STACK)
+#ifndef STACK_WORDS_task_led_g_blink
+#define STACK_WORDS_task_led_g_blink    STACK_SIZE
+#endif
+#ifndef STACK_WORDS_task_led_r_blink
+#define STACK_WORDS_task_led_r_blink    STACK_SIZE
+#endif
+#ifndef STACK_WORDS_task_serial_print
+#define STACK_WORDS_task_serial_print   STACK_SIZE
+#endif
+
+#if DEMO_TASKS
+RTOS_TASK_DEFINE(led_g_task, task_led_g_blink, NULL, 1, TASK_STACK(STACK_WORDS_task_led_g_blink));      /* 高优先级绿色LED闪烁任务 */
+RTOS_TASK_DEFINE(led_r_task, task_led_r_blink, NULL, 2, TASK_STACK(STACK_WORDS_task_led_r_blink));      /* 中等优先级红色LED闪烁任务 */
+RTOS_TASK_DEFINE(serial_task, task_serial_print, NULL, 3, TASK_STACK(STACK_WORDS_task_serial_print));   /* 低优先级串口打印任务 */
+#endif
+#if FTRACE_ENABLE
+RTOS_TASK_DEFINE(ftrace_task, task_ftrace_drain, NULL, 30, STACK_SIZE);  /* 函数跟踪数据块经RTT通道3输出 */
+#endif
+#if IRQSTAT_ENABLE
+RTOS_TASK_DEFINE(irqstat_task, task_irqstat_report, NULL, 29, STACK_SIZE);  /* 周期输出各中断的频率、耗时和负载 */
+#endif
 
 /**
   * @brief  主函数
@@ -40,37 +90,74 @@ void task_serial_print(void* arg);
   */
 int main(void)
 {
-    /* 系统时钟初始化 */
-    SystemInit();
+    /* 系统时钟已在Reset_Handler中初始化，这里不再重复(重新等待HSE和PLL锁定) */
+    bootprof_mark(BOOTPROF_MAIN);
     
-    /* LED初始化 */
-    LED_G_Init();
-    LED_R_Init();
+    /* RTT控制块初始化 - 尽早建立，调试器可立即定位 */
+    RTT_Init();
+    TLOG_Init();
     
-    /* UART1初始化 */
-    UART1_Init();
+    /* LED由各自的任务初始化，UART1在第一次输出时初始化，不占用启动时间 */
     
     /* 高精度延时系统初始化 */
     Time_Init();
     
+#if PROF_ENABLE
+    /* 采样性能分析 - 从此开始采样，样本经RTT通道2输出 */
+    prof_init(PROF_SAMPLE_HZ);
+#endif
+    
+#if RUN_BENCHMARKS
+    /* 目标板基准测试 - 使用主栈，在任务创建之前运行；newlib snprintf等的
+       栈深度连同期间的中断一起与主栈大小比较，超过3/4时提示 */
+    bench_msp_paint();
+    bench_printf_run();
+    bench_pool_run();
+    rtos_printf("\r\n[bench] MSP peak %lu of %lu bytes%s\r\n", (unsigned long)bench_msp_peak(),
+                (unsigned long)bench_msp_size(),
+                (bench_msp_peak() * 4U > bench_msp_size() * 3U) ? " - LOW HEADROOM" : "");
+#endif
+    
     /* 配置中断优先级 - Tickless RTOS系统 */
     NVIC_SetPriority(SVCall_IRQn, 0);      /* SVC中断优先级设为最高 */
     NVIC_SetPriority(PendSV_IRQn, 15);     /* PendSV中断优先级设为最低 */
     /* 注意：不使用SysTick中断，系统采用事件驱动架构 */
     
+#if FTRACE_ENABLE
+    /* 函数跟踪 - 须在rtos_init之前，此后的记录归入main */
+    ftrace_init();
+#endif
+    
     /* RTOS初始化 */
     rtos_init();
     
-    /* 创建多个任务 */
-    task_create(task_led_g_blink, NULL, 1);    /* 高优先级绿色LED闪烁任务 */
-    task_create(task_led_r_blink, NULL, 2);    /* 中等优先级红色LED闪烁任务 */
-    task_create(task_serial_print, NULL, 3);   /* 低优先级串口打印任务 */
+#if QEMU_HARNESS
+    /* QEMU测试镜像：控制任务运行全部场景后经半主机退出 */
+    bench_qemu_start();
+#elif RUN_IRQ_LATENCY
+    /* 中断延迟测量：各种背景负载下的延时唤醒延迟直方图 */
+    bench_irqlat_start();
+#elif RUN_CCM_BENCH
+    /* CCM与SRAM1对比：DMA空闲和繁忙时的任务切换和栈密集计算 */
+    bench_ccm_start();
+#elif RUN_THREAD_METRIC
+    /* Thread-Metric：报告任务依次运行七项测试并输出汇总表 */
+    tm_start();
+#endif
+    /* 演示任务、函数跟踪和中断统计任务由文件开头的RTOS_TASK_DEFINE定义 */
     
-    /* 启动RTOS调度器 */
+#if IRQSTAT_ENABLE
+    /* 中断统计 - 从此开始第一个统计窗口 */
+    irqstat_reset();
+#endif
+    
+    /* 启动RTOS调度器 - 先启动全部静态任务 */
+    bootprof_mark(BOOTPROF_START);
     rtos_start();
     
     /* 程序不会执行到这里，因为RTOS会接管控制权 */
     /* 如果执行到这里，说明RTOS启动失败 */
+    LED_G_Init();
     while(1)
     {
         /* 如果RTOS启动失败，LED会快速闪烁表示错误 */
@@ -87,6 +174,10 @@ int main(void)
   */
 void task_led_g_blink(void* arg)
 {
+    /* 最高优先级的任务最先运行，记为首个控制任务开始执行的时刻 */
+    bootprof_mark(BOOTPROF_TASK);
+    LED_G_Init();
+    
     while(1)
     {
         LED_G_ON();
@@ -105,16 +196,73 @@ void task_led_g_blink(void* arg)
 void task_serial_print(void* arg)
 {
     uint32_t counter = 0;
+    
+#if BOOTPROF_ENABLE
+    /* 启动阶段耗时，首次输出时初始化UART1 */
+    bootprof_report();
+#endif
+    
     while(1)
     {
-        /* 使用printf输出字符串 */
-        printf("Hellow rtos! Counter: %lu\r\n", counter++);
+#if SERIAL_PRINT_USE_TLOG
+        /* 只输出编号和计数值，文本由主机端tlog_decode还原 */
+        TLOG("Hellow rtos! Counter: %lu\r\n", counter++);
+#else
+        /* 可重入的轻量格式化输出，栈用量远小于newlib printf */
+        rtos_printf("Hellow rtos! Counter: %lu\r\n", (unsigned long)counter++);
+#endif
         
         /* 延时1000ms */
         Delay_ms(1000);
     }
 }
 
+#if FTRACE_ENABLE
+/**
+  * @brief  函数跟踪读出任务 - 每10ms把数据块转发到RTT通道
+  * @param  arg: 任务参数（未使用）
+  * @retval None
+  * @note   只写入通道能完整容纳的数据块，放不下的记录留在跟踪缓冲区，
+  *         跟踪缓冲区满时由ftrace计数丢弃
+  */
+void task_ftrace_drain(void* arg)
+{
+    static char rtt_buffer[FTRACE_RTT_SIZE];
+    static uint8_t block[512];
+    uint32_t space, len;
+    
+    (void)RTT_ConfigUpBuffer(FTRACE_RTT_CHANNEL, "FTrace", rtt_buffer, sizeof(rtt_buffer),
+                             RTT_MODE_NO_BLOCK_SKIP);
+    while(1)
+    {
+        space = RTT_GetFreeSpace(FTRACE_RTT_CHANNEL);
+        len = ftrace_read(block, (space < sizeof(block)) ? space : sizeof(block));
+        if (len > 0)
+        {
+            (void)RTT_Write(FTRACE_RTT_CHANNEL, block, len);
+            continue;
+        }
+        Delay_ms(10);
+    }
+}
+#endif
+
+#if IRQSTAT_ENABLE
+/**
+  * @brief  中断统计输出任务 - 每IRQSTAT_REPORT_MS输出一次并开始新窗口
+  * @param  arg: 任务参数（未使用）
+  * @retval None
+  */
+void task_irqstat_report(void* arg)
+{
+    while(1)
+    {
+        Delay_ms(IRQSTAT_REPORT_MS);
+        irqstat_report();
+    }
+}
+#endif
+
 /**
   * @brief  红色LED闪烁任务 - 周期500ms
   * @param  arg: 任务参数（未使用）
@@ -122,6 +270,8 @@ void task_serial_print(void* arg)
   */
 void task_led_r_blink(void* arg)
 {
+    LED_R_Init();
+    
     while(1)
     {
         LED_R_ON();
@@ -217,7 +367,7 @@ void UART1_Init(void)
     GPIO_PinAFConfig(GPIOA, GPIO_PinSource10, GPIO_AF_USART1);
     
     /* 配置UART1参数 */
-    USART_InitStructure.USART_BaudRate = 115200;
+    USART_InitStructure.USART_BaudRate = UART1_BAUDRATE;
     USART_InitStructure.USART_WordLength = USART_WordLength_8b;
     USART_InitStructure.USART_StopBits = USART_StopBits_1;
     USART_InitStructure.USART_Parity = USART_Parity_No;
@@ -227,6 +377,22 @@ void UART1_Init(void)
     
     /* 使能UART1 */
     USART_Cmd(USART1, ENABLE);
+    
+    /* 发送经由DMA2 Stream7完成，CPU只负责拷贝到发送缓冲区 */
+    uart_tx_init();
+    
+    /* 接收经由DMA2 Stream2循环写入接收缓冲区 */
+    uart_rx_init();
+}
+
+/**
+  * @brief  首次调用时初始化UART1，之后直接返回
+  * @param  None
+  * @retval 0 - 已初始化；-1 - 中断打断了正在进行的初始化，本次不能使用
+  */
+int UART1_Open(void)
+{
+    return rtos_once(&uart1_once, UART1_Init);
 }
 
 /**
@@ -237,15 +403,48 @@ void UART1_Init(void)
   */
 int fputc(int ch, FILE *f)
 {
-    /* 等待发送寄存器空 */
-    while (USART_GetFlagStatus(USART1, USART_FLAG_TXE) == RESET);
-    
-    /* 发送字符 */
-    USART_SendData(USART1, (uint8_t)ch);
+#if QEMU_HARNESS
+    char c = (char)ch;
+    bench_qemu_write(&c, 1);
+#elif STDIO_USE_RTT
+    /* 写入RTT通道0，空间不足时按通道模式丢弃并计数 */
+    RTT_PutChar(0, (char)ch);
+#else
+    /* 放入DMA发送缓冲区，不等待发送完成 */
+    uint8_t c = (uint8_t)ch;
+    if (UART1_Open() == 0) {
+        uart_write(&c, 1);
+    }
+#endif
     
     return ch;
 }
 
+/**
+  * @brief  newlib输出系统调用 - GCC工具链下printf经由此函数输出
+  * @param  fd: 文件描述符（未使用）
+  * @param  ptr: 待输出数据
+  * @param  len: 数据长度
+  * @retval 输出的字节数
+  */
+int _write(int fd, char *ptr, int len)
+{
+#if QEMU_HARNESS
+    /* QEMU测试镜像：经半主机写到QEMU的标准输出 */
+    bench_qemu_write(ptr, (uint32_t)len);
+#elif STDIO_USE_RTT
+    /* 整段写入，一次拷贝完成 */
+    RTT_Write(0, ptr, (uint32_t)len);
+#else
+    /* 整段拷贝进DMA发送缓冲区 */
+    if (UART1_Open() == 0) {
+        uart_write(ptr, (uint32_t)len);
+    }
+#endif
+    
+    return len;
+}
+
 /* Delay_Init函数已移除 - 请使用Time_Init()替代 */
 
 /* 
@@ -0,0 +1,165 @@
+/**
+  ******************************************************************************
+  * @file    bootprof.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   启动阶段耗时记录实现 - DWT周期计数
+  ******************************************************************************
+  * @attention
+  *
+  * 实现原理：
+  * 1. bootprof_reset在Reset_Handler中最先调用，此时.data和.bss尚未初始化，
+  *    本文件只使用寄存器、栈和PORT_FAST_NOINIT中的变量
+  * 2. DWT->CYCCNT在复位时清零并开始计数，之后不再清零；其他模块只读取
+  *    差值(bench_cycles_init、port_timer_init只使能计数器)
+  * 3. 每个阶段只记录第一次，有效位保存在bootprof_valid中
+  * 4. RCC->CSR的复位标志在清除之前一直累积，bootprof_reset读取后以RMVF
+  *    清除，下次复位时读到的只有该次的原因
+  *
+  * 168MHz下32位计数约25秒回绕，启动阶段远小于此。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "bootprof.h"
+#include "../../../02_rtos/port.h"
+#include "../../../02_rtos/rtos_printf.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BOOTPROF_HSI_HZ         16000000UL      /* SYSCLK之前的CPU频率 */
+
+/* Private variables ---------------------------------------------------------*/
+#if BOOTPROF_ENABLE
+/* 名称表 - 与bootprof_phase_t一致 */
+static const char* const bootprof_names[BOOTPROF_COUNT] = {
+    "reset", "hse", "pll", "sysclk", "data", "main", "start", "task"
+};
+
+static uint32_t bootprof_cycles[BOOTPROF_COUNT] PORT_FAST_NOINIT;
+static uint32_t bootprof_valid PORT_FAST_NOINIT;  /* 已记录阶段的位图 */
+static uint32_t bootprof_csr PORT_FAST_NOINIT;    /* 复位时的RCC->CSR */
+#endif
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  使能DWT周期计数器并从0开始计数，清空时刻表
+  * @param  None
+  * @retval None
+  * @note   在Reset_Handler中于SystemInit之前调用
+  */
+void bootprof_reset(void)
+{
+#if BOOTPROF_ENABLE
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    bootprof_cycles[BOOTPROF_RESET] = 0;
+    bootprof_valid = 1UL << BOOTPROF_RESET;
+    bootprof_csr = RCC->CSR;
+    RCC->CSR |= RCC_CSR_RMVF;
+#endif
+}
+
+/**
+  * @brief  记录阶段的时刻
+  * @param  phase: 阶段
+  * @retval None
+  * @note   同一阶段只记录第一次，可在.data和.bss初始化之前调用
+  */
+void bootprof_mark(bootprof_phase_t phase)
+{
+#if BOOTPROF_ENABLE
+    uint32_t now = DWT->CYCCNT;
+
+    if ((uint32_t)phase < BOOTPROF_COUNT && (bootprof_valid & (1UL << phase)) == 0U) {
+        bootprof_cycles[phase] = now;
+        bootprof_valid |= 1UL << phase;
+    }
+#else
+    (void)phase;
+#endif
+}
+
+/**
+  * @brief  复位到该阶段的微秒数
+  * @param  phase: 阶段
+  * @retval 微秒数，阶段未记录或未启用时返回0
+  * @note   SYSCLK之前按HSI频率换算，之后按SystemCoreClock换算
+  */
+uint32_t bootprof_us(bootprof_phase_t phase)
+{
+#if BOOTPROF_ENABLE
+    uint32_t cycles;
+    uint32_t hsi;
+
+    if ((uint32_t)phase >= BOOTPROF_COUNT || (bootprof_valid & (1UL << phase)) == 0U) {
+        return 0;
+    }
+    cycles = bootprof_cycles[phase];
+    if (phase < BOOTPROF_SYSCLK || (bootprof_valid & (1UL << BOOTPROF_SYSCLK)) == 0U) {
+        return (uint32_t)((uint64_t)cycles * 1000000U / BOOTPROF_HSI_HZ);
+    }
+    hsi = bootprof_cycles[BOOTPROF_SYSCLK];
+    return (uint32_t)((uint64_t)hsi * 1000000U / BOOTPROF_HSI_HZ +
+                      (uint64_t)(cycles - hsi) * 1000000U / SystemCoreClock);
+#else
+    (void)phase;
+    return 0;
+#endif
+}
+
+/**
+  * @brief  输出各阶段的时刻、与上一阶段的间隔，以及到首个任务的时间与目标的比较
+  * @param  None
+  * @retval None
+  * @note   上电或欠压复位时总时间加上BOOTPROF_RESET_TEMPO_US(估计值)
+  */
+void bootprof_report(void)
+{
+#if BOOTPROF_ENABLE
+    uint32_t prev = 0;
+    uint32_t tempo = 0;
+    const char* cause = "pin";
+    uint32_t us;
+    uint32_t i;
+
+    rtos_printf("\r\n[boot] phase   cycles      us   delta\r\n");
+    for (i = 0; i < BOOTPROF_COUNT; i++) {
+        if ((bootprof_valid & (1UL << i)) == 0U) {
+            rtos_printf("[boot] %-6s %8s %7s %7s\r\n", bootprof_names[i], "-", "-", "-");
+            continue;
+        }
+        us = bootprof_us((bootprof_phase_t)i);
+        rtos_printf("[boot] %-6s %8lu %7lu %7lu\r\n", bootprof_names[i],
+                    (unsigned long)bootprof_cycles[i], (unsigned long)us,
+                    (unsigned long)(us - prev));
+        prev = us;
+    }
+
+    if (bootprof_csr & (RCC_CSR_PORRSTF | RCC_CSR_BORRSTF)) {
+        cause = (bootprof_csr & RCC_CSR_PORRSTF) ? "por" : "bor";
+        tempo = BOOTPROF_RESET_TEMPO_US;
+    } else if (bootprof_csr & (RCC_CSR_WDGRSTF | RCC_CSR_WWDGRSTF)) {
+        cause = "watchdog";
+    } else if (bootprof_csr & RCC_CSR_SFTRSTF) {
+        cause = "software";
+    } else if (bootprof_csr & RCC_CSR_LPWRRSTF) {
+        cause = "low-power";
+    }
+    if ((bootprof_valid & (1UL << BOOTPROF_TASK)) == 0U) {
+        rtos_printf("[boot] reset: %s, first task not reached\r\n", cause);
+        return;
+    }
+    us = bootprof_us(BOOTPROF_TASK) + tempo;
+    rtos_printf("[boot] reset: %s, +%lu us before reset (datasheet, not measured)\r\n",
+                cause, (unsigned long)tempo);
+    rtos_printf("[boot] reset to task %lu us, target %lu us: %s\r\n", (unsigned long)us,
+                (unsigned long)BOOTPROF_TARGET_US, (us <= BOOTPROF_TARGET_US) ? "ok" : "OVER");
+#endif
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file    bootprof.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   启动阶段耗时记录接口
+  *          复位后以DWT->CYCCNT记录各启动阶段的时刻，启动完成后输出
+  ******************************************************************************
+  * @attention
+  *
+  * main.h中BOOTPROF_ENABLE为1时启用；为0时各函数为空，启动文件中的调用
+  * 只剩几条指令。
+  *
+  * 记录点：
+  *   BOOTPROF_RESET    Reset_Handler第一条语句(bootprof_reset)，计数从0开始；
+  *                     不是芯片复位的时刻，见下文
+  *   BOOTPROF_HSE      SetSysClock中HSE就绪
+  *   BOOTPROF_PLL      SetSysClock中主PLL锁定
+  *   BOOTPROF_SYSCLK   系统时钟切换到PLL，此后CPU运行在SystemCoreClock
+  *   BOOTPROF_DATA     启动文件完成.data拷贝和.bss清零
+  *   BOOTPROF_MAIN     main第一条语句
+  *   BOOTPROF_START    main调用rtos_start之前，调度器需要的驱动已初始化
+  *   BOOTPROF_TASK     首个控制任务开始执行(由任务自己调用bootprof_mark)
+  *
+  * SYSCLK之前CPU运行在HSI(16MHz)，之后运行在SystemCoreClock，换算微秒时
+  * 两段分别按各自的频率计算。记录在.data拷贝和.bss清零之前就开始，时刻
+  * 表放在PORT_FAST_NOINIT中，启动文件不会清除。
+  *
+  * 复位引脚释放或电源稳定之后、Reset_Handler之前的时间(复位延时、取向量)
+  * 不在表中。bootprof_reset读取RCC->CSR的复位标志并清除：上电或欠压复位
+  * 时，bootprof_report把main.h中BOOTPROF_RESET_TEMPO_US(数据手册典型值，
+  * 未实测)加到task时刻上，再与BOOTPROF_TARGET_US比较；其他复位不加。
+  * 精确值须在板上以示波器测量电源(或NRST)到首个任务翻转的LED引脚。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __BOOTPROF_H__
+#define __BOOTPROF_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 启动阶段 - 启动文件以数值调用bootprof_mark，修改顺序时须同步修改 */
+typedef enum {
+    BOOTPROF_RESET = 0,
+    BOOTPROF_HSE,
+    BOOTPROF_PLL,
+    BOOTPROF_SYSCLK,
+    BOOTPROF_DATA,              /* 4 - startup_stm32f40xx.s */
+    BOOTPROF_MAIN,
+    BOOTPROF_START,
+    BOOTPROF_TASK,
+    BOOTPROF_COUNT
+} bootprof_phase_t;
+
+/* Exported functions ------------------------------------------------------- */
+void bootprof_reset(void);                      /* 使能DWT并从0开始计数，清空时刻表，读取复位标志 */
+void bootprof_mark(bootprof_phase_t phase);     /* 记录阶段的时刻，只记录第一次 */
+uint32_t bootprof_us(bootprof_phase_t phase);   /* 复位到该阶段的微秒数，未记录时返回0 */
+void bootprof_report(void);                     /* 经rtos_printf输出各阶段的时刻、间隔和与目标的比较 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOTPROF_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,192 @@
+/**
+  ******************************************************************************
+  * @file    irqstat.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   中断执行时间和频率统计实现 - DWT周期计数
+  ******************************************************************************
+  * @attention
+  *
+  * 实现原理：
+  * 1. 进入时在处理函数栈上记录DWT->CYCCNT和外层的嵌套周期，并把嵌套周期
+  *    清零；退出时总耗时减去期间累计的嵌套周期即为本中断自身的周期数
+  * 2. 退出时把本中断的总耗时加上异常进出周期累加给外层，外层中断
+  *    因此不重复计入被嵌套的中断
+  * 3. 进入和退出各有一段几条指令的PRIMASK临界区，避免更高优先级的
+  *    中断在读写嵌套周期之间插入
+  *
+  * 进入和退出合计约40个周期，计入被统计中断自身的周期数。
+  * 未使用时本文件由--gc-sections整体去除。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "irqstat.h"
+#include "../../../02_rtos/rtos_printf.h"
+#include <string.h>
+
+/* Private variables ---------------------------------------------------------*/
+
+/* 名称表 - 与irqstat_id_t一致 */
+static const char* const irqstat_names[IRQSTAT_COUNT] = {
+    "TIM2", "DMA2_Stream7", "DMA2_Stream2", "USART1", "EXTI1"
+};
+
+static irqstat_entry_t irqstat_table[IRQSTAT_COUNT];
+static uint32_t irqstat_nested_cycles;  /* 当前层内已结束的嵌套中断周期 */
+static uint32_t irqstat_depth;          /* 当前嵌套深度 */
+static uint32_t irqstat_window_start;   /* 统计窗口开始时的DWT周期数 */
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  中断进入
+  * @param  frame: 处理函数栈上的进入记录
+  * @retval None
+  */
+void irqstat_enter(irqstat_frame_t* frame)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    frame->start = DWT->CYCCNT;
+    frame->outer = irqstat_nested_cycles;
+    irqstat_nested_cycles = 0;
+    irqstat_depth++;
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  中断退出 - 累计本中断自身的周期数
+  * @param  frame: irqstat_enter填写的进入记录
+  * @param  id: 中断编号
+  * @retval None
+  */
+void irqstat_exit(irqstat_frame_t* frame, irqstat_id_t id)
+{
+    irqstat_entry_t* e = &irqstat_table[id];
+    uint32_t primask = __get_PRIMASK();
+    uint32_t elapsed, self;
+
+    __disable_irq();
+    elapsed = DWT->CYCCNT - frame->start;
+    self = (elapsed > irqstat_nested_cycles) ? elapsed - irqstat_nested_cycles : 0U;
+
+    e->count++;
+    e->total_cycles += self;
+    if (self > e->max_cycles) {
+        e->max_cycles = self;
+    }
+    if (irqstat_depth > 1U) {
+        e->nested++;
+    }
+    if (irqstat_depth > e->max_depth) {
+        e->max_depth = irqstat_depth;
+    }
+
+    irqstat_depth--;
+    irqstat_nested_cycles = frame->outer + elapsed + IRQSTAT_EXC_CYCLES;
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  清零统计，开始新的窗口
+  * @param  None
+  * @retval None
+  * @note   DWT周期计数器由Time_Init(port_timer_init)使能
+  */
+void irqstat_reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    memset(irqstat_table, 0, sizeof(irqstat_table));
+    irqstat_window_start = DWT->CYCCNT;
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  读取一个中断的统计
+  * @param  id: 中断编号
+  * @param  entry: 输出
+  * @retval None
+  */
+void irqstat_get(irqstat_id_t id, irqstat_entry_t* entry)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *entry = irqstat_table[id];
+    __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  全部被统计中断的负载
+  * @param  None
+  * @retval 本窗口内中断周期数(含异常进出)占总周期数的千分比
+  */
+uint32_t irqstat_load_permille(void)
+{
+    uint64_t busy = 0;
+    uint32_t window, i;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    window = DWT->CYCCNT - irqstat_window_start;
+    for (i = 0; i < IRQSTAT_COUNT; i++) {
+        busy += irqstat_table[i].total_cycles +
+                (uint64_t)irqstat_table[i].count * IRQSTAT_EXC_CYCLES;
+    }
+    __set_PRIMASK(primask);
+
+    return (window == 0U) ? 0U : (uint32_t)(busy * 1000U / window);
+}
+
+/**
+  * @brief  输出本窗口的统计表(rtos_printf)并开始新窗口
+  * @param  None
+  * @retval None
+  * @note   负载单位为0.01%，只输出执行过的中断
+  */
+void irqstat_report(void)
+{
+    irqstat_entry_t snap[IRQSTAT_COUNT];
+    uint64_t busy, total_busy = 0;
+    uint32_t window, load, i;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    memcpy(snap, irqstat_table, sizeof(snap));
+    window = DWT->CYCCNT - irqstat_window_start;
+    memset(irqstat_table, 0, sizeof(irqstat_table));
+    irqstat_window_start += window;
+    __set_PRIMASK(primask);
+
+    if (window == 0U) {
+        return;
+    }
+    rtos_printf("irq           count   rate/s  avg cyc  max cyc   load%%  nest depth\r\n");
+    for (i = 0; i < IRQSTAT_COUNT; i++) {
+        if (snap[i].count == 0U) {
+            continue;
+        }
+        busy = snap[i].total_cycles + (uint64_t)snap[i].count * IRQSTAT_EXC_CYCLES;
+        total_busy += busy;
+        load = (uint32_t)(busy * 10000U / window);
+        rtos_printf("%-12s %6lu %8lu %8lu %8lu %3lu.%02lu %5lu %5lu\r\n", irqstat_names[i],
+                    (unsigned long)snap[i].count,
+                    (unsigned long)((uint64_t)snap[i].count * SystemCoreClock / window),
+                    (unsigned long)(snap[i].total_cycles / snap[i].count),
+                    (unsigned long)snap[i].max_cycles,
+                    (unsigned long)(load / 100U), (unsigned long)(load % 100U),
+                    (unsigned long)snap[i].nested, (unsigned long)snap[i].max_depth);
+    }
+    load = (uint32_t)(total_busy * 10000U / window);
+    rtos_printf("window %lu ms, interrupt load %lu.%02lu%%\r\n",
+                (unsigned long)((uint64_t)window * 1000U / SystemCoreClock),
+                (unsigned long)(load / 100U), (unsigned long)(load % 100U));
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
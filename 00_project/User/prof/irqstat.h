@@ -0,0 +1,103 @@
+/**
+  ******************************************************************************
+  * @file    irqstat.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   中断执行时间和频率统计接口
+  *          stm32f4xx_it.c中的中断处理函数以IRQSTAT_ENTER/IRQSTAT_EXIT包裹
+  ******************************************************************************
+  * @attention
+  *
+  * main.h中IRQSTAT_ENABLE为1时启用；为0时两个宏展开为空，处理函数与
+  * 未包裹时完全相同。
+  *
+  * 包裹方法(处理函数中第一条和最后一条语句)：
+  *   void USART1_IRQHandler(void)
+  *   {
+  *       IRQSTAT_ENTER();
+  *       uart_rx_idle_irq_handler();
+  *       IRQSTAT_EXIT(IRQSTAT_USART1);
+  *   }
+  * 新增中断时在irqstat_id_t中加一项，并在irqstat.c的名称表中加上名称。
+  *
+  * 每个中断记录：
+  *   count       执行次数
+  *   total/max   处理函数的周期数，不含嵌套在其中的其他被统计中断
+  *   nested      打断其他被统计中断的次数
+  *   max_depth   执行时的最大嵌套深度(1为未嵌套)
+  * 负载 = (total + count * IRQSTAT_EXC_CYCLES) / 统计窗口周期数，
+  * 窗口从irqstat_reset开始，须短于DWT->CYCCNT的回绕时间(168MHz下约25秒)。
+  *
+  * naked的SVC/PendSV/TIM5处理函数不能包裹；TIM5(采样性能分析)打断被统计
+  * 的中断时，其时间计入被打断的中断。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __IRQSTAT_H__
+#define __IRQSTAT_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define IRQSTAT_EXC_CYCLES      24U         /* 异常进入和返回的压栈/出栈周期 */
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 被统计的中断 */
+typedef enum {
+    IRQSTAT_TIM2 = 0,
+    IRQSTAT_DMA2_STREAM7,
+    IRQSTAT_DMA2_STREAM2,
+    IRQSTAT_USART1,
+    IRQSTAT_EXTI1,
+    IRQSTAT_COUNT
+} irqstat_id_t;
+
+/* 一个中断的统计 */
+typedef struct {
+    uint32_t count;             /* 执行次数 */
+    uint32_t nested;            /* 打断其他被统计中断的次数 */
+    uint32_t max_cycles;        /* 单次最大周期数 */
+    uint32_t max_depth;         /* 最大嵌套深度 */
+    uint64_t total_cycles;      /* 累计周期数 */
+} irqstat_entry_t;
+
+/* 处理函数栈上的进入记录 */
+typedef struct {
+    uint32_t start;             /* 进入时的DWT周期数 */
+    uint32_t outer;             /* 外层已累计的嵌套周期 */
+} irqstat_frame_t;
+
+/* Exported macro ------------------------------------------------------------*/
+#if IRQSTAT_ENABLE
+#define IRQSTAT_ENTER()         irqstat_frame_t irqstat_frame; irqstat_enter(&irqstat_frame)
+#define IRQSTAT_EXIT(id)        irqstat_exit(&irqstat_frame, (id))
+#else
+#define IRQSTAT_ENTER()
+#define IRQSTAT_EXIT(id)
+#endif
+
+/* Exported functions ------------------------------------------------------- */
+void irqstat_reset(void);                               /* 清零统计，开始新的窗口 */
+void irqstat_get(irqstat_id_t id, irqstat_entry_t* entry);  /* 读取一个中断的统计 */
+uint32_t irqstat_load_permille(void);                   /* 全部被统计中断的负载(千分比) */
+void irqstat_report(void);                              /* 输出本窗口的统计表并开始新窗口 */
+
+/* 由IRQSTAT_ENTER/IRQSTAT_EXIT调用 */
+void irqstat_enter(irqstat_frame_t* frame);
+void irqstat_exit(irqstat_frame_t* frame, irqstat_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IRQSTAT_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
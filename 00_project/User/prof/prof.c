@@ -0,0 +1,222 @@
+/**
+  ******************************************************************************
+  * @file    prof.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   统计采样性能分析实现 - TIM5周期中断，样本写入RTT通道
+  ******************************************************************************
+  * @attention
+  *
+  * 实现原理：
+  * 1. TIM5为APB1上的32位定时器(84MHz)，更新中断周期为1/采样率
+  * 2. 异常栈帧的第6、5、7个字为被打断处的PC、LR和xPSR，xPSR的低9位
+  *    非0表示被打断的是另一个中断，此时样本记为该异常号
+  * 3. 每个样本通过一次RTT_Write写入，通道配置为空间不足时整条丢弃，
+  *    主机端看到的数据流总是完整的16字节记录
+  * 4. 中断内用DWT周期计数测量自身耗时，加上异常进出的固定周期，
+  *    即为采样开销
+  *
+  * 未使用时本文件由--gc-sections整体去除。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "prof.h"
+#include "../../../02_rtos/core.h"
+#include "../../../02_rtos/rtt.h"
+
+/* Private variables ---------------------------------------------------------*/
+
+/* RTT通道缓冲区 */
+static char prof_buffer[PROF_BUFFER_SIZE];
+
+static prof_stats_t prof_stats;
+static uint32_t prof_last_cycles;       /* 上一个样本的DWT周期数 */
+
+/* 当前统计区间，输出统计记录后清零 */
+static uint32_t prof_window_samples;
+static uint32_t prof_window_dropped;
+static uint32_t prof_window_isr;
+static uint32_t prof_window_total;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  按采样率设置TIM5的自动重装值
+  * @param  hz: 采样率
+  * @retval None
+  */
+static void prof_load_period(uint32_t hz)
+{
+    if (hz < PROF_MIN_HZ) {
+        hz = PROF_MIN_HZ;
+    } else if (hz > PROF_MAX_HZ) {
+        hz = PROF_MAX_HZ;
+    }
+    TIM_SetAutoreload(TIM5, (SystemCoreClock / 2U) / hz - 1U);
+}
+
+/**
+  * @brief  区间满PROF_STATS_INTERVAL个样本时输出统计记录
+  * @param  None
+  * @retval None
+  * @note   通道满时保留区间计数，下一个样本再试
+  */
+static void prof_emit_stats(void)
+{
+    prof_record_t rec;
+
+    if (prof_window_samples + prof_window_dropped < PROF_STATS_INTERVAL) {
+        return;
+    }
+    rec.pc = PROF_STATS_MARK;
+    rec.lr = prof_window_isr;
+    rec.task = prof_window_total;
+    rec.ctx = prof_window_dropped;
+    if (RTT_Write(PROF_RTT_CHANNEL, &rec, sizeof(rec)) == sizeof(rec)) {
+        prof_window_samples = 0;
+        prof_window_dropped = 0;
+        prof_window_isr = 0;
+        prof_window_total = 0;
+    }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  配置RTT通道和TIM5，开始采样
+  * @param  hz: 采样率，限制在PROF_MIN_HZ~PROF_MAX_HZ
+  * @retval None
+  * @note   须在RTT_Init之后调用
+  */
+void prof_init(uint32_t hz)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+
+    (void)RTT_ConfigUpBuffer(PROF_RTT_CHANNEL, "Prof", prof_buffer, sizeof(prof_buffer),
+                             RTT_MODE_NO_BLOCK_SKIP);
+
+    /* 开销测量使用DWT周期计数，不清零，不影响其他使用者 */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    prof_last_cycles = DWT->CYCCNT;
+
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM5, ENABLE);
+    TIM_TimeBaseStructure.TIM_Period = 0xFFFFFFFFUL;
+    TIM_TimeBaseStructure.TIM_Prescaler = 0;
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseStructure.TIM_RepetitionCounter = 0;
+    TIM_TimeBaseInit(TIM5, &TIM_TimeBaseStructure);
+    prof_load_period(hz);
+    TIM_ClearITPendingBit(TIM5, TIM_IT_Update);
+    TIM_ITConfig(TIM5, TIM_IT_Update, ENABLE);
+
+    NVIC_SetPriority(TIM5_IRQn, PROF_IRQ_PRIORITY);
+    NVIC_EnableIRQ(TIM5_IRQn);
+    TIM_Cmd(TIM5, ENABLE);
+}
+
+/**
+  * @brief  修改采样率
+  * @param  hz: 采样率，限制在PROF_MIN_HZ~PROF_MAX_HZ
+  * @retval None
+  */
+void prof_set_rate(uint32_t hz)
+{
+    prof_load_period(hz);
+}
+
+/**
+  * @brief  停止采样
+  * @param  None
+  * @retval None
+  */
+void prof_stop(void)
+{
+    TIM_Cmd(TIM5, DISABLE);
+    NVIC_DisableIRQ(TIM5_IRQn);
+}
+
+/**
+  * @brief  读取累计统计
+  * @param  stats: 输出
+  * @retval None
+  */
+void prof_get_stats(prof_stats_t* stats)
+{
+    uint32_t primask = rtos_enter_critical();
+    *stats = prof_stats;
+    rtos_exit_critical(primask);
+}
+
+/**
+  * @brief  采样开销
+  * @param  None
+  * @retval 采样中断占总周期的千分比
+  */
+uint32_t prof_overhead_permille(void)
+{
+    prof_stats_t stats;
+
+    prof_get_stats(&stats);
+    if (stats.total_cycles == 0U) {
+        return 0;
+    }
+    return (uint32_t)(stats.isr_cycles * 1000U / stats.total_cycles);
+}
+
+/**
+  * @brief  采样一次
+  * @param  frame: 被打断处的异常栈帧
+  * @param  exc_return: 异常入口的LR
+  * @retval None
+  * @note   由TIM5_IRQHandler跳转调用，返回即退出异常
+  */
+void prof_sample_isr(const uint32_t* frame, uint32_t exc_return)
+{
+    uint32_t start = DWT->CYCCNT;
+    uint32_t ipsr = frame[7] & 0x1FFU;
+    uint32_t cycles;
+    prof_record_t rec;
+
+    (void)exc_return;
+    TIM5->SR = (uint16_t)~TIM_IT_Update;
+
+    rec.pc = frame[6];
+    rec.lr = frame[5];
+    if (ipsr != 0U) {
+        rec.task = 0;
+        rec.ctx = ipsr;
+    } else if (scheduler.running && scheduler.current_task != NULL) {
+        rec.task = (uint32_t)scheduler.current_task;
+        rec.ctx = (uint32_t)scheduler.current_task->task_func;
+    } else {
+        rec.task = 0;
+        rec.ctx = 0;
+    }
+
+    if (RTT_Write(PROF_RTT_CHANNEL, &rec, sizeof(rec)) == sizeof(rec)) {
+        prof_stats.samples++;
+        prof_window_samples++;
+    } else {
+        prof_stats.dropped++;
+        prof_window_dropped++;
+    }
+
+    /* 上一个样本到本样本的总周期数 */
+    prof_stats.total_cycles += start - prof_last_cycles;
+    prof_window_total += start - prof_last_cycles;
+    prof_last_cycles = start;
+
+    prof_emit_stats();
+
+    cycles = DWT->CYCCNT - start + PROF_EXC_CYCLES;
+    prof_stats.isr_cycles += cycles;
+    prof_window_isr += cycles;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
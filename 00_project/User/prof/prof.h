@@ -0,0 +1,96 @@
+/**
+  ******************************************************************************
+  * @file    prof.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   统计采样性能分析接口
+  *          TIM5周期中断采样被打断处的PC和当前任务，经RTT通道输出
+  ******************************************************************************
+  * @attention
+  *
+  * main.h中PROF_ENABLE为1时，main在Time_Init之后调用prof_init启动采样，
+  * 采样率为PROF_SAMPLE_HZ(1~20kHz)，运行时可用prof_set_rate修改。
+  *
+  * TIM5_IRQHandler(stm32f4xx_it.c)为naked函数，按EXC_RETURN取得异常栈帧
+  * 后跳转到prof_sample_isr。每个样本为一条16字节的记录，写入RTT通道
+  * PROF_RTT_CHANNEL，主机端用03_tools/prof_report按固件ELF符号化：
+  *   pc      被打断处的PC
+  *   lr      被打断处的LR，叶子函数中即调用者的返回地址
+  *   task    当前任务的TCB地址，中断上下文或调度器启动前为0
+  *   ctx     当前任务的入口函数地址；中断上下文为异常号(<256)，启动前为0
+  *
+  * 每PROF_STATS_INTERVAL个样本追加一条统计记录(pc为PROF_STATS_MARK)：
+  *   lr      本区间内采样中断消耗的周期数(含异常进出)
+  *   task    本区间的总周期数
+  *   ctx     本区间内因通道满丢弃的样本数
+  * 主机端据此报告采样开销，开销约与采样率成正比。
+  *
+  * TIM5优先级为1，可以采样到其他中断；临界区(PRIMASK)内的样本会推迟到
+  * 临界区结束，被计入退出临界区的位置。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __PROF_H__
+#define __PROF_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#ifndef PROF_RTT_CHANNEL
+#define PROF_RTT_CHANNEL        2           /* 使用的RTT上行通道 */
+#endif
+
+#ifndef PROF_BUFFER_SIZE
+#define PROF_BUFFER_SIZE        4096        /* 通道缓冲区大小(字节)，256个样本 */
+#endif
+
+#define PROF_MIN_HZ             1000U
+#define PROF_MAX_HZ             20000U
+#define PROF_IRQ_PRIORITY       1           /* 高于TIM2(3)，低于SVC(0) */
+
+#define PROF_STATS_INTERVAL     256U        /* 每多少个样本输出一条统计记录 */
+#define PROF_STATS_MARK         0xFFFFFFFFUL
+#define PROF_EXC_CYCLES         24U         /* 异常进入和返回的压栈/出栈周期 */
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 样本记录 - 小端写入RTT通道，格式由主机端prof_report解析 */
+typedef struct {
+    uint32_t pc;
+    uint32_t lr;
+    uint32_t task;
+    uint32_t ctx;
+} prof_record_t;
+
+/* 累计统计 */
+typedef struct {
+    uint32_t samples;           /* 写入通道的样本数 */
+    uint32_t dropped;           /* 通道满丢弃的样本数 */
+    uint64_t isr_cycles;        /* 采样中断消耗的周期数 */
+    uint64_t total_cycles;      /* 从prof_init开始的总周期数 */
+} prof_stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+void prof_init(uint32_t hz);                    /* 配置RTT通道和TIM5，开始采样 */
+void prof_set_rate(uint32_t hz);                /* 修改采样率，限制在PROF_MIN_HZ~PROF_MAX_HZ */
+void prof_stop(void);                           /* 停止采样 */
+void prof_get_stats(prof_stats_t* stats);       /* 读取累计统计 */
+uint32_t prof_overhead_permille(void);          /* 采样开销(千分比) */
+
+/* 由TIM5_IRQHandler跳转调用 */
+void prof_sample_isr(const uint32_t* frame, uint32_t exc_return);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PROF_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,106 @@
+/**
+  ******************************************************************************
+  * @file    tm_api.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   Thread-Metric基准测试接口
+  *          沿用Thread-Metric的移植层函数(tm_*)，由tm_porting.c在02_rtos上实现
+  ******************************************************************************
+  * @attention
+  *
+  * 七项测试(tm_tests.c)只通过本文件的接口使用内核，每项测试在
+  * TM_TEST_DURATION秒的时间窗口内统计完成的操作次数：
+  *   cooperative              5个同优先级任务轮流计数并让出处理器
+  *   preemptive               5个优先级递增的任务逐级恢复、抢占、挂起
+  *   interrupt                任务触发软件中断，中断释放信号量，任务取回
+  *   interrupt_preemption     中断恢复更高优先级的任务，任务计数后挂起
+  *   message                  单任务向队列发送并取回4个字的消息
+  *   synchronization          单任务获取并释放信号量
+  *   memory                   单任务从内存池分配并释放128字节
+  *
+  * 信号量、消息队列和内存池均为不等待的版本(与Thread-Metric的ThreadX
+  * 移植一致)，只测量内核临界区和数据结构本身的开销。
+  *
+  * 平台相关部分(软件中断、测试结束处理)由tm_platform_*函数提供：
+  * 目标板见tm_target.c，主机POSIX移植层见04_host/tm/tm_host.c。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __TM_API_H__
+#define __TM_API_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define TM_SUCCESS              0
+#define TM_ERROR                1
+
+/* 每项测试的统计时间窗口(秒) */
+#ifndef TM_TEST_DURATION
+#define TM_TEST_DURATION        30
+#endif
+
+/* 资源数量 */
+#define TM_MAX_THREADS          8       /* 不含报告任务 */
+#define TM_MAX_QUEUES           1
+#define TM_MAX_SEMAPHORES       1
+#define TM_MAX_POOLS            1
+
+#define TM_QUEUE_MESSAGES       10      /* 队列容量(条) */
+#define TM_MESSAGE_WORDS        4       /* 每条消息的字数 */
+#define TM_POOL_BLOCK_SIZE      128     /* 内存池块大小(字节) */
+#define TM_POOL_BLOCKS          16      /* 内存池块数，共2048字节 */
+
+/* 报告任务优先级，高于全部测试任务(数值越小优先级越高) */
+#define TM_REPORT_PRIORITY      1
+
+/* Exported functions ------------------------------------------------------- */
+
+/* 任务：thread_id为0..TM_MAX_THREADS-1，创建后处于挂起状态 */
+int tm_thread_create(int thread_id, int priority, void (*entry_function)(void));
+int tm_thread_resume(int thread_id);
+int tm_thread_suspend(int thread_id);
+void tm_thread_relinquish(void);
+void tm_thread_sleep(int seconds);
+
+/* 消息队列，消息为TM_MESSAGE_WORDS个unsigned long */
+int tm_queue_create(int queue_id);
+int tm_queue_send(int queue_id, unsigned long* message_ptr);
+int tm_queue_receive(int queue_id, unsigned long* message_ptr);
+
+/* 计数信号量，初值为1 */
+int tm_semaphore_create(int semaphore_id);
+int tm_semaphore_get(int semaphore_id);
+int tm_semaphore_put(int semaphore_id);
+
+/* 固定块内存池 */
+int tm_memory_pool_create(int pool_id);
+int tm_memory_pool_allocate(int pool_id, unsigned char** memory_ptr);
+int tm_memory_pool_deallocate(int pool_id, unsigned char* memory_ptr);
+
+/* 删除全部测试任务并清空队列、信号量和内存池，测试之间由报告任务调用 */
+void tm_reset(void);
+
+/* 测试入口：创建报告任务，依次运行七项测试并输出汇总表。
+   须在rtos_init和Time_Init之后、rtos_start之前调用 */
+void tm_start(void);
+
+/* 平台接口 */
+void tm_platform_interrupt_init(void (*handler)(void)); /* 登记软件中断处理函数 */
+void tm_cause_interrupt(void);                          /* 触发软件中断 */
+void tm_platform_done(void);                            /* 全部测试结束后调用 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TM_API_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,394 @@
+/**
+  ******************************************************************************
+  * @file    tm_porting.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   Thread-Metric移植层 - 在02_rtos的任务、临界区和延时接口上实现tm_*
+  ******************************************************************************
+  * @attention
+  *
+  * 只使用core.h和time.h中的接口，目标板和主机POSIX移植层共用本文件。
+  * 内核没有信号量、消息队列和内存池，这里以临界区保护的简单结构实现，
+  * 不等待；中断中可调用tm_semaphore_put和tm_thread_resume。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "tm_api.h"
+#include "../../../02_rtos/core.h"
+#include "../../../02_rtos/time.h"
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 测试任务 - task_create的参数指向本结构，由包装函数调用无参入口 */
+typedef struct {
+    task_t* task;
+    void (*entry)(void);
+} tm_thread_t;
+
+/* 消息队列 - 环形缓冲区 */
+typedef struct {
+    unsigned long messages[TM_QUEUE_MESSAGES][TM_MESSAGE_WORDS];
+    uint32_t head;                      /* 下一条读出位置 */
+    uint32_t count;                     /* 当前消息数 */
+    uint8_t created;
+} tm_queue_t;
+
+/* 计数信号量 */
+typedef struct {
+    uint32_t count;
+    uint8_t created;
+} tm_semaphore_t;
+
+/* 固定块内存池 - 空闲块以块首字作为链表指针 */
+typedef struct {
+    void* free_list;
+    uint32_t storage[TM_POOL_BLOCKS * TM_POOL_BLOCK_SIZE / 4];
+    uint8_t created;
+} tm_pool_t;
+
+/* Private variables ---------------------------------------------------------*/
+static tm_thread_t tm_threads[TM_MAX_THREADS];
+static tm_queue_t tm_queues[TM_MAX_QUEUES];
+static tm_semaphore_t tm_semaphores[TM_MAX_SEMAPHORES];
+static tm_pool_t tm_pools[TM_MAX_POOLS];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  测试任务包装函数
+  * @param  arg: tm_thread_t指针
+  * @retval None
+  */
+static void tm_thread_entry(void* arg)
+{
+    ((tm_thread_t*)arg)->entry();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  创建测试任务，创建后处于挂起状态
+  * @param  thread_id: 0..TM_MAX_THREADS-1
+  * @param  priority: 优先级，数值越小优先级越高，须低于TM_REPORT_PRIORITY
+  * @param  entry_function: 任务入口
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_thread_create(int thread_id, int priority, void (*entry_function)(void))
+{
+    tm_thread_t* thread;
+    uint32_t primask;
+
+    if (thread_id < 0 || thread_id >= TM_MAX_THREADS ||
+        priority <= TM_REPORT_PRIORITY || priority >= MAX_PRIORITY) {
+        return TM_ERROR;
+    }
+    thread = &tm_threads[thread_id];
+    if (thread->task != NULL) {
+        return TM_ERROR;
+    }
+
+    primask = rtos_enter_critical();
+    thread->entry = entry_function;
+    thread->task = task_create(tm_thread_entry, thread, (uint32_t)priority);
+    task_suspend(thread->task);
+    rtos_exit_critical(primask);
+
+    return (thread->task != NULL) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  恢复测试任务，优先级高于当前任务时立即切换
+  * @param  thread_id: 任务编号
+  * @retval TM_SUCCESS或TM_ERROR
+  * @note   可在中断中调用，切换在中断返回时发生
+  */
+int tm_thread_resume(int thread_id)
+{
+    uint32_t primask;
+
+    if (thread_id < 0 || thread_id >= TM_MAX_THREADS || tm_threads[thread_id].task == NULL) {
+        return TM_ERROR;
+    }
+
+    primask = rtos_enter_critical();
+    task_resume(tm_threads[thread_id].task);
+    rtos_schedule();
+    rtos_exit_critical(primask);
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  挂起测试任务，挂起自身时切换到下一个就绪任务
+  * @param  thread_id: 任务编号
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_thread_suspend(int thread_id)
+{
+    uint32_t primask;
+
+    if (thread_id < 0 || thread_id >= TM_MAX_THREADS || tm_threads[thread_id].task == NULL) {
+        return TM_ERROR;
+    }
+
+    primask = rtos_enter_critical();
+    task_suspend(tm_threads[thread_id].task);
+    rtos_schedule();
+    rtos_exit_critical(primask);
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  让出处理器给同优先级的就绪任务
+  * @param  None
+  * @retval None
+  */
+void tm_thread_relinquish(void)
+{
+    task_yield();
+}
+
+/**
+  * @brief  当前任务休眠
+  * @param  seconds: 秒数
+  * @retval None
+  */
+void tm_thread_sleep(int seconds)
+{
+    Delay_ms((uint32_t)seconds * 1000U);
+}
+
+/**
+  * @brief  创建消息队列
+  * @param  queue_id: 队列编号
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_queue_create(int queue_id)
+{
+    if (queue_id < 0 || queue_id >= TM_MAX_QUEUES) {
+        return TM_ERROR;
+    }
+    memset(&tm_queues[queue_id], 0, sizeof(tm_queue_t));
+    tm_queues[queue_id].created = 1;
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  发送一条消息，队列满时返回错误
+  * @param  queue_id: 队列编号
+  * @param  message_ptr: TM_MESSAGE_WORDS个字的消息
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_queue_send(int queue_id, unsigned long* message_ptr)
+{
+    tm_queue_t* queue;
+    uint32_t primask;
+    int status = TM_ERROR;
+
+    if (queue_id < 0 || queue_id >= TM_MAX_QUEUES || !tm_queues[queue_id].created) {
+        return TM_ERROR;
+    }
+    queue = &tm_queues[queue_id];
+
+    primask = rtos_enter_critical();
+    if (queue->count < TM_QUEUE_MESSAGES) {
+        memcpy(queue->messages[(queue->head + queue->count) % TM_QUEUE_MESSAGES],
+               message_ptr, sizeof(queue->messages[0]));
+        queue->count++;
+        status = TM_SUCCESS;
+    }
+    rtos_exit_critical(primask);
+    return status;
+}
+
+/**
+  * @brief  取出一条消息，队列空时返回错误
+  * @param  queue_id: 队列编号
+  * @param  message_ptr: 接收缓冲区
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_queue_receive(int queue_id, unsigned long* message_ptr)
+{
+    tm_queue_t* queue;
+    uint32_t primask;
+    int status = TM_ERROR;
+
+    if (queue_id < 0 || queue_id >= TM_MAX_QUEUES || !tm_queues[queue_id].created) {
+        return TM_ERROR;
+    }
+    queue = &tm_queues[queue_id];
+
+    primask = rtos_enter_critical();
+    if (queue->count > 0U) {
+        memcpy(message_ptr, queue->messages[queue->head], sizeof(queue->messages[0]));
+        queue->head = (queue->head + 1U) % TM_QUEUE_MESSAGES;
+        queue->count--;
+        status = TM_SUCCESS;
+    }
+    rtos_exit_critical(primask);
+    return status;
+}
+
+/**
+  * @brief  创建信号量，初值为1
+  * @param  semaphore_id: 信号量编号
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_semaphore_create(int semaphore_id)
+{
+    if (semaphore_id < 0 || semaphore_id >= TM_MAX_SEMAPHORES) {
+        return TM_ERROR;
+    }
+    tm_semaphores[semaphore_id].count = 1;
+    tm_semaphores[semaphore_id].created = 1;
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  获取信号量，计数为0时返回错误
+  * @param  semaphore_id: 信号量编号
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_semaphore_get(int semaphore_id)
+{
+    tm_semaphore_t* sem;
+    uint32_t primask;
+    int status = TM_ERROR;
+
+    if (semaphore_id < 0 || semaphore_id >= TM_MAX_SEMAPHORES || !tm_semaphores[semaphore_id].created) {
+        return TM_ERROR;
+    }
+    sem = &tm_semaphores[semaphore_id];
+
+    primask = rtos_enter_critical();
+    if (sem->count > 0U) {
+        sem->count--;
+        status = TM_SUCCESS;
+    }
+    rtos_exit_critical(primask);
+    return status;
+}
+
+/**
+  * @brief  释放信号量，可在中断中调用
+  * @param  semaphore_id: 信号量编号
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_semaphore_put(int semaphore_id)
+{
+    uint32_t primask;
+
+    if (semaphore_id < 0 || semaphore_id >= TM_MAX_SEMAPHORES || !tm_semaphores[semaphore_id].created) {
+        return TM_ERROR;
+    }
+
+    primask = rtos_enter_critical();
+    tm_semaphores[semaphore_id].count++;
+    rtos_exit_critical(primask);
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  创建内存池，TM_POOL_BLOCKS个TM_POOL_BLOCK_SIZE字节的块
+  * @param  pool_id: 内存池编号
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_memory_pool_create(int pool_id)
+{
+    tm_pool_t* pool;
+    uint8_t* block;
+    uint32_t i;
+
+    if (pool_id < 0 || pool_id >= TM_MAX_POOLS) {
+        return TM_ERROR;
+    }
+    pool = &tm_pools[pool_id];
+
+    pool->free_list = NULL;
+    for (i = TM_POOL_BLOCKS; i > 0U; i--) {
+        block = (uint8_t*)pool->storage + (i - 1U) * TM_POOL_BLOCK_SIZE;
+        *(void**)block = pool->free_list;
+        pool->free_list = block;
+    }
+    pool->created = 1;
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  分配一块内存，没有空闲块时返回错误
+  * @param  pool_id: 内存池编号
+  * @param  memory_ptr: 返回块地址
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_memory_pool_allocate(int pool_id, unsigned char** memory_ptr)
+{
+    tm_pool_t* pool;
+    uint32_t primask;
+    void* block;
+
+    if (pool_id < 0 || pool_id >= TM_MAX_POOLS || !tm_pools[pool_id].created) {
+        return TM_ERROR;
+    }
+    pool = &tm_pools[pool_id];
+
+    primask = rtos_enter_critical();
+    block = pool->free_list;
+    if (block != NULL) {
+        pool->free_list = *(void**)block;
+    }
+    rtos_exit_critical(primask);
+
+    *memory_ptr = (unsigned char*)block;
+    return (block != NULL) ? TM_SUCCESS : TM_ERROR;
+}
+
+/**
+  * @brief  释放一块内存
+  * @param  pool_id: 内存池编号
+  * @param  memory_ptr: tm_memory_pool_allocate返回的地址
+  * @retval TM_SUCCESS或TM_ERROR
+  */
+int tm_memory_pool_deallocate(int pool_id, unsigned char* memory_ptr)
+{
+    tm_pool_t* pool;
+    uint32_t primask;
+
+    if (pool_id < 0 || pool_id >= TM_MAX_POOLS || !tm_pools[pool_id].created ||
+        memory_ptr < (unsigned char*)tm_pools[pool_id].storage ||
+        memory_ptr >= (unsigned char*)tm_pools[pool_id].storage + sizeof(tm_pools[pool_id].storage)) {
+        return TM_ERROR;
+    }
+    pool = &tm_pools[pool_id];
+
+    primask = rtos_enter_critical();
+    *(void**)memory_ptr = pool->free_list;
+    pool->free_list = memory_ptr;
+    rtos_exit_critical(primask);
+    return TM_SUCCESS;
+}
+
+/**
+  * @brief  删除全部测试任务并清空队列、信号量和内存池
+  * @param  None
+  * @retval None
+  * @note   由优先级最高的报告任务调用，测试任务此时都不在运行
+  */
+void tm_reset(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < TM_MAX_THREADS; i++) {
+        if (tm_threads[i].task != NULL) {
+            task_delete(tm_threads[i].task);
+            tm_threads[i].task = NULL;
+        }
+    }
+    memset(tm_queues, 0, sizeof(tm_queues));
+    memset(tm_semaphores, 0, sizeof(tm_semaphores));
+    memset(tm_pools, 0, sizeof(tm_pools));
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,81 @@
+/**
+  ******************************************************************************
+  * @file    tm_target.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   Thread-Metric目标板平台接口
+  *          以NVIC软件挂起EXTI1中断作为测试用的软件中断
+  ******************************************************************************
+  * @attention
+  *
+  * main.h中RUN_THREAD_METRIC为1时，main在rtos_init之后调用tm_start代替
+  * 演示任务，结果经rtos_printf输出到标准输出。EXTI1线未在EXTI中使能，只由软件挂起，
+  * stm32f4xx_it.c中的EXTI1_IRQHandler转发到tm_irq_handler。未使用时
+  * 本文件和tm_porting.c、tm_tests.c由--gc-sections整体去除。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "tm_api.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TM_IRQ                  EXTI1_IRQn
+#define TM_IRQ_PRIORITY         6       /* 低于TIM2和UART */
+
+/* Private variables ---------------------------------------------------------*/
+static void (*tm_handler)(void);
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  登记软件中断处理函数并使能中断
+  * @param  handler: 处理函数
+  * @retval None
+  */
+void tm_platform_interrupt_init(void (*handler)(void))
+{
+    tm_handler = handler;
+    NVIC_SetPriority(TM_IRQ, TM_IRQ_PRIORITY);
+    NVIC_ClearPendingIRQ(TM_IRQ);
+    NVIC_EnableIRQ(TM_IRQ);
+}
+
+/**
+  * @brief  触发软件中断，返回前中断处理已完成
+  * @param  None
+  * @retval None
+  */
+void tm_cause_interrupt(void)
+{
+    NVIC_SetPendingIRQ(TM_IRQ);
+    __DSB();
+    __ISB();
+}
+
+/**
+  * @brief  软件中断处理函数（由stm32f4xx_it.c调用）
+  * @param  None
+  * @retval None
+  */
+void tm_irq_handler(void)
+{
+    if (tm_handler) {
+        tm_handler();
+    }
+}
+
+/**
+  * @brief  全部测试结束 - 关闭软件中断，报告任务返回后由空闲任务接管
+  * @param  None
+  * @retval None
+  */
+void tm_platform_done(void)
+{
+    NVIC_DisableIRQ(TM_IRQ);
+    tm_handler = NULL;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
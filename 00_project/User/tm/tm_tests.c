@@ -0,0 +1,357 @@
+/**
+  ******************************************************************************
+  * @file    tm_tests.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   Thread-Metric七项测试和汇总报告
+  ******************************************************************************
+  * @attention
+  *
+  * 报告任务以TM_REPORT_PRIORITY运行，依次对每项测试：创建测试任务和资源，
+  * 休眠TM_TEST_DURATION秒，读取计数并检查一致性，然后删除测试任务。
+  * 全部完成后输出汇总表并调用tm_platform_done。
+  *
+  * 计数口径与Thread-Metric一致：协作和抢占调度为全部任务计数之和，
+  * 其余为测试任务(中断抢占为中断处理函数)完成的循环次数。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "tm_api.h"
+#include "../../../02_rtos/core.h"
+#include "../../../02_rtos/rtos_printf.h"
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 一项测试 */
+typedef struct {
+    const char* name;
+    void (*init)(void);                 /* 创建任务和资源，并恢复起始任务 */
+    unsigned long (*total)(void);       /* 时间窗口内完成的操作数 */
+    int (*verify)(void);                /* 计数一致时返回非0 */
+} tm_test_t;
+
+/* Private variables ---------------------------------------------------------*/
+static volatile unsigned long tm_counter[5];        /* 各测试任务的计数 */
+static volatile unsigned long tm_isr_counter;       /* 中断处理函数的计数 */
+static volatile int tm_error;                       /* 接口返回错误或数据不符 */
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  计数器两两之差不超过1
+  * @param  n: 参与比较的计数器数
+  * @retval 非0表示一致
+  */
+static int tm_counters_balanced(uint32_t n)
+{
+    unsigned long min = tm_counter[0];
+    unsigned long max = tm_counter[0];
+    uint32_t i;
+
+    for (i = 1; i < n; i++) {
+        if (tm_counter[i] < min) min = tm_counter[i];
+        if (tm_counter[i] > max) max = tm_counter[i];
+    }
+    return !tm_error && max - min <= 1UL;
+}
+
+static unsigned long tm_sum5(void)
+{
+    return tm_counter[0] + tm_counter[1] + tm_counter[2] + tm_counter[3] + tm_counter[4];
+}
+
+static unsigned long tm_thread0_total(void)
+{
+    return tm_counter[0];
+}
+
+static int tm_no_error(void)
+{
+    return !tm_error;
+}
+
+/* 1. 协作调度：5个同优先级任务轮流计数并让出 ---------------------------------*/
+
+static void tm_cooperative_entry(uint32_t id)
+{
+    while (1) {
+        tm_counter[id]++;
+        tm_thread_relinquish();
+    }
+}
+
+static void tm_cooperative_0(void) { tm_cooperative_entry(0); }
+static void tm_cooperative_1(void) { tm_cooperative_entry(1); }
+static void tm_cooperative_2(void) { tm_cooperative_entry(2); }
+static void tm_cooperative_3(void) { tm_cooperative_entry(3); }
+static void tm_cooperative_4(void) { tm_cooperative_entry(4); }
+
+static void tm_cooperative_init(void)
+{
+    static void (* const entry[5])(void) = {
+        tm_cooperative_0, tm_cooperative_1, tm_cooperative_2, tm_cooperative_3, tm_cooperative_4
+    };
+    int i;
+
+    for (i = 0; i < 5; i++) {
+        tm_thread_create(i, 3, entry[i]);
+    }
+    for (i = 0; i < 5; i++) {
+        tm_thread_resume(i);
+    }
+}
+
+static int tm_cooperative_verify(void)
+{
+    return tm_counters_balanced(5);
+}
+
+/* 2. 抢占调度：低优先级任务逐级恢复更高优先级任务，后者计数后挂起 ------------*/
+
+static void tm_preemptive_0(void)
+{
+    while (1) {
+        tm_counter[0]++;
+        tm_thread_resume(1);            /* 立即被抢占，依次运行任务1到4 */
+    }
+}
+
+static void tm_preemptive_entry(uint32_t id)
+{
+    while (1) {
+        tm_counter[id]++;
+        if (id < 4U) {
+            tm_thread_resume((int)id + 1);
+        }
+        tm_thread_suspend((int)id);
+    }
+}
+
+static void tm_preemptive_1(void) { tm_preemptive_entry(1); }
+static void tm_preemptive_2(void) { tm_preemptive_entry(2); }
+static void tm_preemptive_3(void) { tm_preemptive_entry(3); }
+static void tm_preemptive_4(void) { tm_preemptive_entry(4); }
+
+static void tm_preemptive_init(void)
+{
+    tm_thread_create(0, 10, tm_preemptive_0);
+    tm_thread_create(1, 9, tm_preemptive_1);
+    tm_thread_create(2, 8, tm_preemptive_2);
+    tm_thread_create(3, 7, tm_preemptive_3);
+    tm_thread_create(4, 6, tm_preemptive_4);
+    tm_thread_resume(0);
+}
+
+static int tm_preemptive_verify(void)
+{
+    return tm_counters_balanced(5);
+}
+
+/* 3. 中断处理：任务触发中断，中断释放信号量，任务取回 --------------------------*/
+
+static void tm_interrupt_handler(void)
+{
+    tm_isr_counter++;
+    tm_semaphore_put(0);
+}
+
+static void tm_interrupt_0(void)
+{
+    while (1) {
+        tm_cause_interrupt();
+        if (tm_semaphore_get(0) != TM_SUCCESS) {
+            tm_error = 1;
+        }
+        tm_counter[0]++;
+    }
+}
+
+static void tm_interrupt_init(void)
+{
+    tm_semaphore_create(0);
+    tm_semaphore_get(0);                /* 从0开始，每次中断释放一次 */
+    tm_platform_interrupt_init(tm_interrupt_handler);
+    tm_thread_create(0, 10, tm_interrupt_0);
+    tm_thread_resume(0);
+}
+
+static int tm_interrupt_verify(void)
+{
+    return !tm_error && tm_isr_counter - tm_counter[0] <= 1UL;
+}
+
+/* 4. 中断抢占：中断恢复更高优先级的任务，该任务计数后挂起 ----------------------*/
+
+static void tm_interrupt_preemption_handler(void)
+{
+    tm_isr_counter++;
+    tm_thread_resume(1);                /* 中断返回时切换到任务1 */
+}
+
+static void tm_interrupt_preemption_0(void)
+{
+    while (1) {
+        tm_cause_interrupt();
+        tm_counter[0]++;
+    }
+}
+
+static void tm_interrupt_preemption_1(void)
+{
+    while (1) {
+        tm_counter[1]++;
+        tm_thread_suspend(1);
+    }
+}
+
+static void tm_interrupt_preemption_init(void)
+{
+    tm_platform_interrupt_init(tm_interrupt_preemption_handler);
+    tm_thread_create(0, 10, tm_interrupt_preemption_0);
+    tm_thread_create(1, 9, tm_interrupt_preemption_1);
+    tm_thread_resume(0);
+}
+
+static unsigned long tm_interrupt_preemption_total(void)
+{
+    return tm_isr_counter;
+}
+
+static int tm_interrupt_preemption_verify(void)
+{
+    return tm_isr_counter - tm_counter[1] <= 1UL && tm_isr_counter - tm_counter[0] <= 1UL;
+}
+
+/* 5. 消息传递：向队列发送4个字的消息再取回 ------------------------------------*/
+
+static void tm_message_0(void)
+{
+    unsigned long send[TM_MESSAGE_WORDS] = { 0x11112222UL, 0x33334444UL, 0x55556666UL, 0 };
+    unsigned long receive[TM_MESSAGE_WORDS];
+
+    while (1) {
+        send[TM_MESSAGE_WORDS - 1] = tm_counter[0];
+        if (tm_queue_send(0, send) != TM_SUCCESS ||
+            tm_queue_receive(0, receive) != TM_SUCCESS ||
+            receive[0] != send[0] || receive[TM_MESSAGE_WORDS - 1] != send[TM_MESSAGE_WORDS - 1]) {
+            tm_error = 1;
+        }
+        tm_counter[0]++;
+    }
+}
+
+static void tm_message_init(void)
+{
+    tm_queue_create(0);
+    tm_thread_create(0, 10, tm_message_0);
+    tm_thread_resume(0);
+}
+
+/* 6. 同步：获取并释放信号量 ----------------------------------------------------*/
+
+static void tm_synchronization_0(void)
+{
+    while (1) {
+        if (tm_semaphore_get(0) != TM_SUCCESS || tm_semaphore_put(0) != TM_SUCCESS) {
+            tm_error = 1;
+        }
+        tm_counter[0]++;
+    }
+}
+
+static void tm_synchronization_init(void)
+{
+    tm_semaphore_create(0);
+    tm_thread_create(0, 10, tm_synchronization_0);
+    tm_thread_resume(0);
+}
+
+/* 7. 内存分配：分配并释放128字节 -----------------------------------------------*/
+
+static void tm_memory_0(void)
+{
+    unsigned char* block;
+
+    while (1) {
+        if (tm_memory_pool_allocate(0, &block) != TM_SUCCESS ||
+            tm_memory_pool_deallocate(0, block) != TM_SUCCESS) {
+            tm_error = 1;
+        }
+        tm_counter[0]++;
+    }
+}
+
+static void tm_memory_init(void)
+{
+    tm_memory_pool_create(0);
+    tm_thread_create(0, 10, tm_memory_0);
+    tm_thread_resume(0);
+}
+
+/* 测试表 ----------------------------------------------------------------------*/
+
+static const tm_test_t tm_tests[] = {
+    { "cooperative",          tm_cooperative_init,          tm_sum5,                       tm_cooperative_verify },
+    { "preemptive",           tm_preemptive_init,           tm_sum5,                       tm_preemptive_verify },
+    { "interrupt",            tm_interrupt_init,            tm_thread0_total,              tm_interrupt_verify },
+    { "interrupt_preemption", tm_interrupt_preemption_init, tm_interrupt_preemption_total, tm_interrupt_preemption_verify },
+    { "message",              tm_message_init,              tm_thread0_total,              tm_no_error },
+    { "synchronization",      tm_synchronization_init,      tm_thread0_total,              tm_no_error },
+    { "memory",               tm_memory_init,               tm_thread0_total,              tm_no_error },
+};
+
+#define TM_TEST_COUNT   (sizeof(tm_tests) / sizeof(tm_tests[0]))
+
+/**
+  * @brief  报告任务 - 依次运行全部测试，每项完成后输出一行
+  * @param  arg: 未使用
+  * @retval None
+  */
+static void tm_report_task(void* arg)
+{
+    unsigned long total;
+    uint32_t i, j;
+    int ok;
+
+    (void)arg;
+    rtos_printf("Thread-Metric: %u tests, %d s each\r\n", (unsigned)TM_TEST_COUNT, TM_TEST_DURATION);
+    rtos_printf("%-22s %12s %12s %s\r\n", "test", "count", "per second", "check");
+
+    for (i = 0; i < TM_TEST_COUNT; i++) {
+        for (j = 0; j < 5U; j++) {
+            tm_counter[j] = 0;
+        }
+        tm_isr_counter = 0;
+        tm_error = 0;
+
+        tm_tests[i].init();
+        tm_thread_sleep(TM_TEST_DURATION);
+
+        /* 报告任务优先级最高，测试任务和由其触发的中断此时都已停止 */
+        total = tm_tests[i].total();
+        ok = tm_tests[i].verify();
+        tm_reset();
+
+        rtos_printf("%-22s %12lu %12lu %s\r\n", tm_tests[i].name, total,
+                    total / (unsigned long)TM_TEST_DURATION, ok ? "ok" : "ERROR");
+    }
+
+    tm_platform_done();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  创建报告任务，须在rtos_init和Time_Init之后、rtos_start之前调用
+  * @param  None
+  * @retval None
+  */
+void tm_start(void)
+{
+    task_create(tm_report_task, NULL, TM_REPORT_PRIORITY);
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,92 @@
+#!/bin/sh
+#
+# 在QEMU中运行测试镜像(QEMU_HARNESS=1)并检查结果
+#
+# 用法：qemu_run.sh [--baseline 文件] [--save 文件] [--tolerance 百分比] <镜像.elf>
+#   --baseline  与基线比较指令数，任一路径增长超过tolerance即失败
+#   --save      把本次的指令数写入文件作为新基线
+#   --tolerance 允许的增长百分比，默认5
+#
+# 环境变量：
+#   QEMU        QEMU可执行文件，默认qemu-system-arm
+#   QEMU_TIMEOUT 超时秒数，默认60
+#
+# 退出码：0 全部通过；1 场景失败、超时或指令数超出基线
+#
+
+QEMU=${QEMU:-qemu-system-arm}
+QEMU_TIMEOUT=${QEMU_TIMEOUT:-60}
+BASELINE=
+SAVE=
+TOLERANCE=5
+
+while [ $# -gt 1 ]; do
+    case "$1" in
+        --baseline)  BASELINE=$2; shift 2 ;;
+        --save)      SAVE=$2; shift 2 ;;
+        --tolerance) TOLERANCE=$2; shift 2 ;;
+        *) echo "unknown option: $1" >&2; exit 1 ;;
+    esac
+done
+
+ELF=$1
+if [ -z "$ELF" ] || [ ! -f "$ELF" ]; then
+    echo "usage: $0 [--baseline file] [--save file] [--tolerance pct] image.elf" >&2
+    exit 1
+fi
+
+LOG=${ELF%.elf}.log
+
+# netduinoplus2为STM32F405，与F407同核同存储布局(含64KB CCM)；
+# -icount shift=0使每条指令推进1ns虚拟时间，TIM2计数差即为指令数
+timeout "$QEMU_TIMEOUT" "$QEMU" -M netduinoplus2 -nographic -monitor none \
+    -serial null -icount shift=0 \
+    -semihosting-config enable=on,target=native \
+    -kernel "$ELF" > "$LOG.raw"
+STATUS=$?
+tr -d '\r' < "$LOG.raw" > "$LOG"
+rm -f "$LOG.raw"
+cat "$LOG"
+
+if [ $STATUS -eq 124 ]; then
+    echo "qemu_run: timeout after ${QEMU_TIMEOUT}s" >&2
+    exit 1
+fi
+if [ $STATUS -ne 0 ] || ! grep -q '^RESULT PASS' "$LOG"; then
+    echo "qemu_run: scenario failed (exit $STATUS)" >&2
+    exit 1
+fi
+
+if [ -n "$SAVE" ]; then
+    grep '^insns ' "$LOG" | awk '{ print $2, $3 }' > "$SAVE"
+    echo "qemu_run: baseline saved to $SAVE"
+fi
+
+if [ -n "$BASELINE" ]; then
+    printf "  %-28s %8s %8s\n" path baseline now
+    grep '^insns ' "$LOG" | awk -v tol="$TOLERANCE" -v base="$BASELINE" '
+        BEGIN {
+            while ((getline line < base) > 0) {
+                split(line, f, " ")
+                ref[f[1]] = f[2]
+            }
+        }
+        {
+            name = $2; now = $3
+            if (!(name in ref)) {
+                printf "  %-28s %8d   (new)\n", name, now
+                next
+            }
+            limit = ref[name] * (1 + tol / 100)
+            mark = (now > limit) ? "REGRESSION" : ""
+            printf "  %-28s %8d %8d %s\n", name, ref[name], now, mark
+            if (now > limit) bad = 1
+        }
+        END { exit bad }'
+    if [ $? -ne 0 ]; then
+        echo "qemu_run: instruction counts exceed baseline by more than ${TOLERANCE}%" >&2
+        exit 1
+    fi
+fi
+
+exit 0
@@ -0,0 +1,198 @@
+/**
+  ******************************************************************************
+  * @file    arena.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   任务临时内存区(arena)实现
+  ******************************************************************************
+  * @attention
+  *
+  * 对齐按绝对地址计算，存储区本身不需要按align对齐。分配失败时偏移量
+  * 不变，之前的分配仍然有效。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "arena.h"
+#include "mem.h"
+#include <stddef.h>
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  在给定存储区上建立arena
+  * @param  arena: arena
+  * @param  buf: 存储区
+  * @param  size: 存储区字节数
+  * @param  name: 名称，可为NULL
+  * @retval None
+  */
+void arena_init(arena_t* arena, void* buf, uint32_t size, const char* name)
+{
+    arena->base = (uint8_t*)buf;
+    arena->size = size;
+    arena->offset = 0;
+    arena->peak = 0;
+    arena->failures = 0;
+    arena->name = name;
+}
+
+/**
+  * @brief  从rtos_alloc取得存储区并建立arena
+  * @param  arena: arena
+  * @param  size: 存储区字节数
+  * @param  flags: rtos_alloc的区域要求，计算用数据通常为RTOS_MEM_FAST
+  * @param  name: 名称，可为NULL
+  * @retval 成功返回0，内存不足返回-1
+  */
+int arena_create(arena_t* arena, uint32_t size, uint32_t flags, const char* name)
+{
+    void* buf = rtos_alloc(size, flags);
+
+    if (buf == NULL) {
+        return -1;
+    }
+    arena_init(arena, buf, size, name);
+    return 0;
+}
+
+/**
+  * @brief  释放arena_create分配的存储区
+  * @param  arena: arena
+  * @retval None
+  */
+void arena_destroy(arena_t* arena)
+{
+    rtos_free(arena->base);
+    arena_init(arena, NULL, 0, arena->name);
+}
+
+/**
+  * @brief  分配，按ARENA_ALIGN对齐
+  * @param  arena: arena
+  * @param  size: 字节数
+  * @retval 地址，空间不足返回NULL
+  */
+void* arena_alloc(arena_t* arena, uint32_t size)
+{
+    return arena_alloc_aligned(arena, size, ARENA_ALIGN);
+}
+
+/**
+  * @brief  按对齐分配
+  * @param  arena: arena
+  * @param  size: 字节数
+  * @param  align: 对齐，2的幂
+  * @retval 地址，空间不足或align无效返回NULL
+  */
+void* arena_alloc_aligned(arena_t* arena, uint32_t size, uint32_t align)
+{
+    uintptr_t addr;
+    uint64_t end;
+
+    if (align == 0U || (align & (align - 1U)) != 0U) {
+        return NULL;
+    }
+
+    addr = (uintptr_t)arena->base + arena->offset;
+    addr = (addr + (align - 1U)) & ~((uintptr_t)align - 1U);
+    end = (uint64_t)(addr - (uintptr_t)arena->base) + size;
+    if (end > arena->size) {
+        arena->failures++;
+        return NULL;
+    }
+
+    arena->offset = (uint32_t)end;
+    if (arena->offset > arena->peak) {
+        arena->peak = arena->offset;
+    }
+    return (void*)addr;
+}
+
+/**
+  * @brief  记录当前位置
+  * @param  arena: arena
+  * @retval 位置标记
+  */
+arena_mark_t arena_save(const arena_t* arena)
+{
+    return arena->offset;
+}
+
+/**
+  * @brief  回到记录的位置，释放其后的全部分配
+  * @param  arena: arena
+  * @param  mark: arena_save的返回值
+  * @retval None
+  * @note   标记在当前位置之后(已被更早的回退或复位越过)时不改变
+  */
+void arena_rollback(arena_t* arena, arena_mark_t mark)
+{
+    if (mark <= arena->offset) {
+        arena->offset = mark;
+    }
+}
+
+/**
+  * @brief  释放全部分配
+  * @param  arena: arena
+  * @retval None
+  */
+void arena_reset(arena_t* arena)
+{
+    arena->offset = 0;
+}
+
+/**
+  * @brief  剩余字节数
+  * @param  arena: arena
+  * @retval 字节数，对齐可能使实际可分配的更少
+  */
+uint32_t arena_available(const arena_t* arena)
+{
+    return arena->size - arena->offset;
+}
+
+/**
+  * @brief  把arena挂到任务
+  * @param  task: 任务，NULL为当前任务
+  * @param  arena: arena，NULL为取消
+  * @retval None
+  */
+void arena_attach(task_t* task, arena_t* arena)
+{
+    if (task == NULL) {
+        task = scheduler.current_task;
+    }
+    if (task != NULL) {
+        task->arena = arena;
+    }
+}
+
+/**
+  * @brief  当前任务的arena
+  * @param  None
+  * @retval arena，调度器未运行或任务没有arena时返回NULL
+  */
+arena_t* arena_current(void)
+{
+    task_t* task = scheduler.current_task;
+
+    return (scheduler.running && task != NULL) ? task->arena : NULL;
+}
+
+/**
+  * @brief  从当前任务的arena分配
+  * @param  size: 字节数
+  * @retval 地址，没有arena或空间不足返回NULL
+  */
+void* arena_scratch(uint32_t size)
+{
+    arena_t* arena = arena_current();
+
+    return (arena != NULL) ? arena_alloc(arena, size) : NULL;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,96 @@
+/**
+  ******************************************************************************
+  * @file    arena.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   任务临时内存区(arena)头文件
+  *          移动指针分配，整体O(1)复位，适合周期性控制任务
+  ******************************************************************************
+  * @attention
+  *
+  * 使用方法：
+  *   ARENA_DEFINE_IN(ctrl_scratch, 4096, PORT_FAST_BSS);
+  *   arena_attach(NULL, &ctrl_scratch);            任务启动时挂到自己
+  *   for (;;) {
+  *       buf = arena_scratch(256);                 从当前任务的arena分配
+  *       m = arena_save(&ctrl_scratch);
+  *       tmp = arena_alloc_aligned(&ctrl_scratch, 64, 32);
+  *       arena_rollback(&ctrl_scratch, m);         撤销tmp及之后的分配
+  *       arena_reset(&ctrl_scratch);               周期结束，全部释放
+  *   }
+  *
+  * 分配只移动偏移量，没有块头部，也不能单独释放；arena_save记录当前
+  * 偏移量，arena_rollback回到记录处，可以嵌套；arena_reset回到开头。
+  * 三者都是O(1)。每个arena记录偏移量的高水位和失败次数，用于确定
+  * 大小。
+  *
+  * arena不加锁，只能由一个任务使用(通常是挂接它的任务)，不能在中断中
+  * 使用。存储区可以静态定义(ARENA_DEFINE/ARENA_DEFINE_IN)，也可以由
+  * arena_create从rtos_alloc取得。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "core.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define ARENA_ALIGN             8U              /* arena_alloc的默认对齐 */
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* 静态定义名为name、size字节的arena，存储区带有放置属性attr */
+#define ARENA_DEFINE_IN(name, size, attr)                                       \
+    static uint8_t name##_storage[size] __attribute__((aligned(ARENA_ALIGN))) attr; \
+    arena_t name = { name##_storage, (uint32_t)(size), 0, 0, 0, #name }
+
+/* 静态定义名为name、size字节的arena */
+#define ARENA_DEFINE(name, size)        ARENA_DEFINE_IN(name, size, )
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 临时内存区 - 字段顺序与ARENA_DEFINE_IN一致 */
+typedef struct arena {
+    uint8_t* base;              /* 存储区 */
+    uint32_t size;              /* 存储区字节数 */
+    uint32_t offset;            /* 下一次分配的位置 */
+    uint32_t peak;              /* offset的高水位 */
+    uint32_t failures;          /* 空间不足的次数 */
+    const char* name;
+} arena_t;
+
+/* 位置标记 - arena_save的返回值 */
+typedef uint32_t arena_mark_t;
+
+/* Exported functions ------------------------------------------------------- */
+void arena_init(arena_t* arena, void* buf, uint32_t size, const char* name);
+int arena_create(arena_t* arena, uint32_t size, uint32_t flags, const char* name);  /* 存储区由rtos_alloc(flags)分配，成功返回0 */
+void arena_destroy(arena_t* arena);                 /* 释放arena_create分配的存储区 */
+
+void* arena_alloc(arena_t* arena, uint32_t size);   /* ARENA_ALIGN对齐，空间不足返回NULL */
+void* arena_alloc_aligned(arena_t* arena, uint32_t size, uint32_t align);  /* align为2的幂 */
+arena_mark_t arena_save(const arena_t* arena);      /* 记录当前位置 */
+void arena_rollback(arena_t* arena, arena_mark_t mark);  /* 释放mark之后的全部分配 */
+void arena_reset(arena_t* arena);                   /* 释放全部分配 */
+uint32_t arena_available(const arena_t* arena);     /* 剩余字节数(不计对齐) */
+
+void arena_attach(task_t* task, arena_t* arena);    /* 挂到任务，NULL为当前任务 */
+arena_t* arena_current(void);                       /* 当前任务的arena，没有时返回NULL */
+void* arena_scratch(uint32_t size);                 /* 从当前任务的arena分配 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ARENA_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
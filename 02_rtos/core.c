@@ -1,25 +1,104 @@
 #include "core.h"
+#include "time.h"
+#include "ftrace.h"
 #include <string.h>
-#include "stm32f4xx.h"
 
-scheduler_t scheduler;  /* 全局调度器实例 */
+scheduler_t scheduler RTOS_KERNEL_BSS;  /* 全局调度器实例 */
+
+/* task_create使用的任务栈，按PORT_STACK_ALIGN对齐，每个都从对齐的地址开始 */
+typedef struct {
+    uint32_t words[STACK_SIZE];
+} __attribute__((aligned(PORT_STACK_ALIGN))) task_stack_t;
+
+static task_t task_pool[RTOS_TASK_POOL] RTOS_KERNEL_NOINIT;  /* 任务控制块池，task_func为NULL表示空闲 */
+static task_stack_t task_stacks[RTOS_TASK_POOL] RTOS_KERNEL_NOINIT;  /* 与task_pool一一对应 */
+
+/* 静态任务描述符表，由链接器给出；没有静态任务时弱引用为NULL */
+extern const rtos_task_desc_t __start_rtos_task[] __attribute__((weak));
+extern const rtos_task_desc_t __stop_rtos_task[] __attribute__((weak));
+
+/* 以绝对符号给出描述符大小和静态任务数上限(空闲任务占一个)，链接脚本据此检查rtos_task段；
+ * 函数本身不被调用，由--gc-sections丢弃 */
+__attribute__((used)) static void rtos_task_limits(void) {
+    __asm__ volatile(".global __rtos_task_desc_size\n\t.set __rtos_task_desc_size, %c0\n\t"
+                     ".global __rtos_static_task_max\n\t.set __rtos_static_task_max, %c1"
+                     : : "i"(sizeof(rtos_task_desc_t)), "i"(MAX_TASKS - 1));
+}
+
+static void task_setup(task_t* task, void (*func)(void*), void* arg, uint32_t priority);
+
+#if RTOS_PERF_ENABLE
+static port_perf_t perf_last;  /* 上次累计时的性能计数器快照 */
+
+/* 把上次快照以来的性能计数累加到任务 - 须在屏蔽中断的状态下调用
+ * 32位差值扩展为64位累计值，快照间隔须小于计数器回绕时间(CYCCNT在168MHz下约25秒，
+ * 8位事件计数器为256个事件) */
+static void perf_account(task_t* task) {
+    port_perf_t now;
+    
+    port_perf_read(&now);
+    task->perf.cycles += now.cycles - perf_last.cycles;
+    task->perf.cpi += (now.cpi - perf_last.cpi) & PORT_PERF_EVENT_MASK;
+    task->perf.exc += (now.exc - perf_last.exc) & PORT_PERF_EVENT_MASK;
+    task->perf.sleep += now.sleep - perf_last.sleep;
+    task->perf.lsu += (now.lsu - perf_last.lsu) & PORT_PERF_EVENT_MASK;
+    task->perf.fold += (now.fold - perf_last.fold) & PORT_PERF_EVENT_MASK;
+    perf_last = now;
+}
+#endif
+
+#if RTOS_STACK_CHECK
+/* 检查任务的栈 - 保存的栈指针低于栈底或哨兵被改写时调用rtos_stack_overflow
+ * 哨兵紧接在移植层保护区之上，保护区不可读(栈指针进入保护区时压栈已触发故障)；
+ * 主机移植层的stack_ptr固定指向栈底，只有哨兵检查起作用 */
+static void stack_check(task_t* task) {
+    if (task->stack_ptr < task->stack) {
+        rtos_stack_overflow(task);
+        return;
+    }
+    for (uint32_t i = PORT_STACK_GUARD_WORDS; i < PORT_STACK_GUARD_WORDS + RTOS_STACK_CANARY_WORDS; i++) {
+        if (task->stack[i] != RTOS_STACK_PATTERN) {
+            rtos_stack_overflow(task);
+            return;
+        }
+    }
+}
+#endif
 
 /* 空闲任务 - 当没有其他任务运行时执行 */
 static void idle_task(void* arg) {
+    (void)arg;
     while (1) {
-        __asm("wfi");  /* 等待中断指令，降低功耗 */
+        port_idle();  /* 等待中断，降低功耗 */
     }
 }
 
 /* RTOS初始化函数 */
 void rtos_init(void) {
     memset(&scheduler, 0, sizeof(scheduler_t));  /* 清空调度器结构体 */
+    for (uint8_t i = 0; i < RTOS_TASK_POOL; i++) {
+        task_pool[i].task_func = NULL;  /* 只清空闲标记，不清控制块和栈 */
+    }
     
     task_create(idle_task, NULL, MAX_PRIORITY);  /* 创建空闲任务 */
 }
 
-/* 启动RTOS调度 */
+/* 启动RTOS调度 - 先启动全部静态任务，再由移植层切换到最高优先级任务，正常情况下不返回
+ * 静态任务与已创建的任务合计超过MAX_TASKS时调用rtos_task_limit_exceeded，不启动任何静态任务 */
 void rtos_start(void) {
+    const rtos_task_desc_t* desc;
+    uint32_t count = scheduler.task_count + (uint32_t)(__stop_rtos_task - __start_rtos_task);
+    
+    if (count > MAX_TASKS) {
+        rtos_task_limit_exceeded(count);  /* 任务数超出调度器容量，默认停机 */
+        return;
+    }
+    for (desc = __start_rtos_task; desc < __stop_rtos_task; desc++) {
+        desc->task->stack = desc->stack;
+        desc->task->stack_size = desc->stack_size;
+        task_setup(desc->task, desc->func, desc->arg, desc->priority);
+    }
+    
     if (scheduler.task_count == 0) {
         return;  /* 没有任务可调度 */
     }
@@ -33,56 +112,90 @@ void rtos_start(void) {
     /* 设置当前任务 */
     scheduler.current_task = first_task;
     first_task->state = TASK_RUNNING;
+    scheduler.running = 1;
     
-    /* 直接调用第一个任务，不使用复杂的上下文切换 */
-    first_task->task_func(first_task->arg);
+#if FTRACE_ENABLE
+    ftrace_switch(NULL, first_task);  /* 函数跟踪切换到首个任务的缓冲区 */
+#endif
+#if RTOS_PERF_ENABLE
+    port_perf_read(&perf_last);  /* 此后的计数归入首个任务 */
+    first_task->perf.switches++;
+#endif
+    port_start_first_task();
 }
 
-/* 创建新任务 */
-task_t* task_create(void (*func)(void*), void* arg, uint32_t priority) {
-    if (scheduler.task_count >= MAX_TASKS || priority > MAX_PRIORITY) {
-        return NULL;  /* 任务数量或优先级超出限制 */
-    }
-    
-    /* 分配任务控制块内存 */
-    static task_t task_pool[MAX_TASKS];
-    task_t* task = &task_pool[scheduler.task_count];
-    
+/* 进入临界区 - 屏蔽可屏蔽中断并返回原屏蔽状态，支持嵌套调用 */
+uint32_t rtos_enter_critical(void) {
+    return port_enter_critical();
+}
+
+/* 退出临界区 - 仅当进入前中断处于开启状态时才重新开启，挂起的任务切换在此时发生 */
+void rtos_exit_critical(uint32_t state) {
+    port_exit_critical(state);
+}
+
+/* 初始化控制块并加入调度器 - stack和stack_size已设置，须在临界区内或调度器启动前调用 */
+static void task_setup(task_t* task, void (*func)(void*), void* arg, uint32_t priority) {
     task->task_func = func;      /* 设置任务函数 */
     task->arg = arg;             /* 设置任务参数 */
     task->priority = priority;   /* 设置任务优先级 */
     task->state = TASK_READY;    /* 设置任务状态为就绪 */
+    task->wait_next = NULL;      /* 不在任何等待队列中 */
+    task->wait_queue = NULL;
+    task->delay_next = NULL;     /* 不在延时链表中 */
+    task->delay_target = 0;
+    task->delaying = 0;
+    task->arena = NULL;          /* 没有临时内存区 */
+#if RTOS_PERF_ENABLE
+    memset(&task->perf, 0, sizeof(task->perf));
+#endif
     
-    /* 初始化任务堆栈 - 模拟异常返回时的堆栈帧 */
-    /* 确保堆栈8字节对齐 */
-    uint32_t* stack_top = &task->stack[STACK_SIZE - 16];
-    stack_top = (uint32_t*)((uint32_t)stack_top & ~0x7);  /* 8字节对齐 */
-    
-    /* 按照Cortex-M4异常返回时的堆栈帧格式初始化 */
-    /* 注意：Cortex-M4异常返回时自动恢复的寄存器顺序 */
-    /* 堆栈帧格式：xPSR, PC, LR, R12, R3, R2, R1, R0, R11, R10, R9, R8, R7, R6, R5, R4 */
-    stack_top[0] = 0x01000000;       /* xPSR - Thumb状态，无异常号 */
-    stack_top[1] = (uint32_t)func;   /* PC - 任务入口地址 */
-    stack_top[2] = 0xFFFFFFFD;       /* LR - 返回地址，使用特殊值表示从异常返回 */
-    stack_top[3] = 0;                /* R12 */
-    stack_top[4] = 0;                /* R3 */
-    stack_top[5] = 0;                /* R2 */
-    stack_top[6] = 0;                /* R1 */
-    stack_top[7] = (uint32_t)arg;    /* R0 - 任务参数 */
-    stack_top[8] = 0;                /* R11 */
-    stack_top[9] = 0;                /* R10 */
-    stack_top[10] = 0;               /* R9 */
-    stack_top[11] = 0;               /* R8 */
-    stack_top[12] = 0;               /* R7 */
-    stack_top[13] = 0;               /* R6 */
-    stack_top[14] = 0;               /* R5 */
-    stack_top[15] = 0;               /* R4 */
-    
-    /* 堆栈指针应该指向堆栈帧的顶部（第一个寄存器） */
-    task->stack_ptr = stack_top;
+#if RTOS_STACK_CHECK
+    /* 填充整个栈，高水位和栈底哨兵都以填充值为准 */
+    for (uint32_t i = 0; i < task->stack_size; i++) {
+        task->stack[i] = RTOS_STACK_PATTERN;
+    }
+#endif
+    
+    /* 构造首次运行时的上下文，由移植层设置stack_ptr */
+    port_task_init(task);
     
     scheduler.tasks[scheduler.task_count] = task;
     scheduler.task_count++;
+}
+
+/* 创建新任务 - 控制块和STACK_SIZE字的栈取自任务池 */
+task_t* task_create(void (*func)(void*), void* arg, uint32_t priority) {
+    task_t* task = NULL;
+    uint32_t primask;
+    
+    if (func == NULL || priority > MAX_PRIORITY) {
+        return NULL;  /* 参数无效 */
+    }
+    
+    primask = rtos_enter_critical();
+    
+    /* 分配任务控制块 - 任务删除后其控制块可被复用 */
+    if (scheduler.task_count < MAX_TASKS) {
+        for (uint8_t i = 0; i < RTOS_TASK_POOL; i++) {
+            if (task_pool[i].task_func == NULL) {
+                task = &task_pool[i];
+                task->stack = task_stacks[i].words;
+                task->stack_size = STACK_SIZE;
+                break;
+            }
+        }
+    }
+    if (task == NULL) {
+        rtos_exit_critical(primask);
+        return NULL;  /* 任务数量超出限制 */
+    }
+    
+    task_setup(task, func, arg, priority);
+    rtos_exit_critical(primask);
+    
+    /* 运行中创建更高优先级的任务时立即切换 */
+    rtos_schedule();
     
     return task;
 }
@@ -101,10 +214,16 @@ void task_resume(task_t* task) {
     }
 }
 
-/* 删除任务 */
+/* 删除任务 - 可删除任务自身，此时在退出函数时切换到其他任务 */
 void task_delete(task_t* task) {
+    uint32_t primask;
+    
     if (!task) return;
     
+    primask = rtos_enter_critical();
+    task_unwait(task);  /* 从等待队列中移除，避免悬空指针 */
+    Time_CancelDelay(task);
+    
     /* 在任务数组中查找并移除指定任务 */
     for (uint8_t i = 0; i < scheduler.task_count; i++) {
         if (scheduler.tasks[i] == task) {
@@ -115,6 +234,47 @@ void task_delete(task_t* task) {
             break;
         }
     }
+    
+    task->state = TASK_SUSPENDED;
+    task->task_func = NULL;  /* 释放控制块 */
+    if (task == scheduler.current_task) {
+        rtos_schedule();
+    }
+    rtos_exit_critical(primask);
+}
+
+/* 让出处理器 - 当前任务移到任务数组末尾，同优先级的就绪任务按轮转顺序运行
+ * find_highest_priority_task在同优先级中取数组靠前者；没有同优先级就绪任务时继续运行 */
+void task_yield(void) {
+    task_t* current = scheduler.current_task;
+    uint32_t primask;
+    
+    if (!scheduler.running || port_in_isr()) {
+        return;
+    }
+    
+    primask = rtos_enter_critical();
+    for (uint8_t i = 0; i < scheduler.task_count; i++) {
+        if (scheduler.tasks[i] == current) {
+            for (uint8_t j = i; j < scheduler.task_count - 1; j++) {
+                scheduler.tasks[j] = scheduler.tasks[j + 1];
+            }
+            scheduler.tasks[scheduler.task_count - 1] = current;
+            break;
+        }
+    }
+    current->state = TASK_READY;  /* 与被抢占相同，切换路径重新选择 */
+    port_pend_switch();
+    rtos_exit_critical(primask);
+}
+
+/* 任务函数返回后由移植层构造的返回地址进入，删除任务自身 */
+void rtos_task_exit(void) {
+    task_delete(scheduler.current_task);
+    
+    while (1) {
+        /* 不会执行到这里 */
+    }
 }
 
 /* 查找最高优先级的就绪任务 */
@@ -134,94 +294,334 @@ task_t* find_highest_priority_task(void) {
     return highest_priority_task;
 }
 
-/* 调度器核心函数 - 执行任务切换 */
+/* 将当前任务挂起到等待队列
+ * 调用者须已通过rtos_enter_critical()进入临界区并检查过等待条件；
+ * 函数返回后调用者退出临界区时发生任务切换，被唤醒后应重新检查条件。
+ * 在中断中或调度器尚未运行时无法阻塞，返回-1，调用者自行决定轮询或放弃 */
+int task_wait(wait_queue_t* queue) {
+    task_t* task = scheduler.current_task;
+    
+    if (!scheduler.running || port_in_isr()) {
+        return -1;
+    }
+    
+    /* 追加到队尾 */
+    task->wait_next = NULL;
+    task->wait_queue = queue;
+    if (queue->tail) {
+        queue->tail->wait_next = task;
+    } else {
+        queue->head = task;
+    }
+    queue->tail = task;
+    
+    task_suspend(task);
+    rtos_schedule();
+    return 0;
+}
+
+/* 带超时的等待 - 超时由TIM2延时链表负责唤醒，调用约定同task_wait
+ * 返回后调用者通过重新检查条件和剩余时间区分被唤醒与超时 */
+int task_wait_timeout(wait_queue_t* queue, uint32_t ticks) {
+    if (task_wait(queue) != 0) {
+        return -1;
+    }
+    
+    if (ticks != RTOS_WAIT_FOREVER) {
+        Time_AddDelay(scheduler.current_task, ticks);
+    }
+    return 0;
+}
+
+/* 将任务从其等待队列中移除 */
+void task_unwait(task_t* task) {
+    uint32_t primask = rtos_enter_critical();
+    wait_queue_t* queue = task->wait_queue;
+    
+    if (queue) {
+        task_t* prev = NULL;
+        task_t* cur = queue->head;
+        
+        while (cur && cur != task) {
+            prev = cur;
+            cur = cur->wait_next;
+        }
+        if (cur) {
+            if (prev) {
+                prev->wait_next = cur->wait_next;
+            } else {
+                queue->head = cur->wait_next;
+            }
+            if (queue->tail == cur) {
+                queue->tail = prev;
+            }
+        }
+        task->wait_next = NULL;
+        task->wait_queue = NULL;
+    }
+    rtos_exit_critical(primask);
+}
+
+/* 唤醒等待队列的队首任务，返回被唤醒的任务 */
+task_t* task_wake_one(wait_queue_t* queue) {
+    uint32_t primask = rtos_enter_critical();
+    task_t* task = queue->head;
+    
+    if (task) {
+        queue->head = task->wait_next;
+        if (queue->head == NULL) {
+            queue->tail = NULL;
+        }
+        task->wait_next = NULL;
+        task->wait_queue = NULL;
+        Time_CancelDelay(task);  /* 事件先于超时到达 */
+        task_resume(task);
+    }
+    rtos_exit_critical(primask);
+    
+    if (task) {
+        rtos_schedule();
+    }
+    return task;
+}
+
+/* 唤醒等待队列中的全部任务 */
+void task_wake_all(wait_queue_t* queue) {
+    uint32_t primask = rtos_enter_critical();
+    task_t* task = queue->head;
+    
+    queue->head = NULL;
+    queue->tail = NULL;
+    while (task) {
+        task_t* next = task->wait_next;
+        task->wait_next = NULL;
+        task->wait_queue = NULL;
+        Time_CancelDelay(task);
+        task_resume(task);
+        task = next;
+    }
+    rtos_exit_critical(primask);
+    
+    rtos_schedule();
+}
+
+/* 互斥锁加锁 - 被其他任务持有时挂起等待，ticks为0时不等待
+ * 调度器启动前只有main在运行，直接返回成功；中断中不能使用 */
+int rtos_mutex_lock(rtos_mutex_t* mutex, uint32_t ticks) {
+    task_t* self = scheduler.current_task;
+    uint32_t remaining = ticks;
+    uint32_t wait_ticks;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t primask;
+    
+    if (!scheduler.running) {
+        return 0;
+    }
+    if (port_in_isr()) {
+        return -1;
+    }
+    
+    primask = rtos_enter_critical();
+    while (mutex->owner != NULL && mutex->owner != self) {
+        if (remaining == 0) {
+            rtos_exit_critical(primask);
+            return -1;
+        }
+        if (ticks == RTOS_WAIT_FOREVER) {
+            wait_ticks = RTOS_WAIT_FOREVER;
+        } else {
+            wait_ticks = (remaining > DELAY_MAX_CHUNK_TICKS) ? DELAY_MAX_CHUNK_TICKS : remaining;
+        }
+        start = port_timer_now();
+        (void)task_wait_timeout(&mutex->waiters, wait_ticks);
+        rtos_exit_critical(primask);    /* 在此切换，解锁或超时后返回 */
+        primask = rtos_enter_critical();
+        if (ticks != RTOS_WAIT_FOREVER) {
+            elapsed = port_timer_now() - start;
+            remaining = (elapsed >= remaining) ? 0 : remaining - elapsed;
+        }
+    }
+    mutex->owner = self;
+    mutex->count++;
+    rtos_exit_critical(primask);
+    return 0;
+}
+
+/* 互斥锁解锁 - 只有持有者可以解锁
+ * 中断中加锁总是失败，中断中的解锁没有对应的加锁，忽略；否则会释放被打断任务持有的锁 */
+void rtos_mutex_unlock(rtos_mutex_t* mutex) {
+    uint32_t primask;
+    
+    if (!scheduler.running || port_in_isr()) {
+        return;
+    }
+    
+    primask = rtos_enter_critical();
+    if (mutex->owner == scheduler.current_task && --mutex->count == 0) {
+        mutex->owner = NULL;
+        (void)task_wake_one(&mutex->waiters);
+    }
+    rtos_exit_critical(primask);
+}
+
+/* 一次性初始化 - 第一个调用者执行func，同时到达的任务挂起等待其完成
+ * func执行期间不在临界区内，可以阻塞；中断中遇到正在进行的初始化时不能等待，返回-1 */
+int rtos_once(rtos_once_t* once, void (*func)(void)) {
+    uint32_t primask;
+    
+    if (once->state == RTOS_ONCE_DONE) {
+        return 0;
+    }
+    
+    primask = rtos_enter_critical();
+    while (once->state == RTOS_ONCE_RUNNING) {
+        if (task_wait(&once->waiters) != 0) {
+            rtos_exit_critical(primask);
+            return -1;  /* 中断中或调度器未运行，无法等待 */
+        }
+        rtos_exit_critical(primask);    /* 在此切换，初始化完成后返回 */
+        primask = rtos_enter_critical();
+    }
+    if (once->state == RTOS_ONCE_DONE) {
+        rtos_exit_critical(primask);
+        return 0;
+    }
+    once->state = RTOS_ONCE_RUNNING;
+    rtos_exit_critical(primask);
+    
+    func();
+    
+    primask = rtos_enter_critical();
+    once->state = RTOS_ONCE_DONE;
+    task_wake_all(&once->waiters);
+    rtos_exit_critical(primask);
+    return 0;
+}
+
+/* 调度器核心函数 - 判断是否需要切换任务
+ * 只挂起切换请求，实际切换在退出最外层临界区或中断返回时由移植层执行。
+ * 当前任务已阻塞或出现更高优先级的就绪任务时才切换，同优先级不抢占 */
 void rtos_schedule(void) {
-    task_t* next_task = find_highest_priority_task();  /* 找到最高优先级的就绪任务 */
+    task_t* current = scheduler.current_task;
+    task_t* next_task;
+    
+    if (!scheduler.running) {
+        return;
+    }
+    
+    next_task = find_highest_priority_task();  /* 找到最高优先级的就绪任务 */
+    if (current->state != TASK_RUNNING ||
+        (next_task && next_task->priority < current->priority)) {
+        port_pend_switch();
+    }
+}
+
+/* 任务切换 - 由移植层在切换路径中以屏蔽中断的状态调用
+ * 当前任务的上下文已保存，返回接下来运行的任务(可能仍为当前任务) */
+task_t* rtos_switch_task(void) {
+    task_t* current = scheduler.current_task;
+    task_t* next_task;
     
-    if (next_task && next_task != scheduler.current_task) {
-        if (scheduler.current_task) {
-            scheduler.current_task->state = TASK_READY;  /* 当前任务状态改为就绪 */
+#if RTOS_STACK_CHECK
+    stack_check(current);  /* 切出的任务检查栈是否溢出 */
+#endif
+    next_task = find_highest_priority_task();
+    if (current->state == TASK_RUNNING) {
+        if (next_task == NULL || next_task->priority >= current->priority) {
+            return current;  /* 切换请求已失效 */
         }
-        
-        next_task->state = TASK_RUNNING;      /* 新任务状态改为运行 */
-        scheduler.current_task = next_task;   /* 更新当前运行任务 */
-        
-        /* 触发PendSV中断进行上下文切换 */
-        SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
+        current->state = TASK_READY;  /* 被抢占，回到就绪状态 */
     }
+    
+#if RTOS_PERF_ENABLE
+    perf_account(current);  /* 切出的任务结算性能计数 */
+    next_task->perf.switches++;
+#endif
+    
+    /* 空闲任务始终就绪，next_task不为NULL */
+    next_task->state = TASK_RUNNING;
+    scheduler.current_task = next_task;
+#if FTRACE_ENABLE
+    ftrace_switch(current, next_task);  /* 函数跟踪切换缓冲区并扣除切出时间 */
+#endif
+    return next_task;
 }
 
-/* PendSV中断处理函数 - 执行实际的上下文切换 */
-void __attribute__((naked)) pend_sv_handler(void) {
-    __asm volatile(
-        "cpsid i\n"                     /* 禁用中断 */
-        "mrs r0, psp\n"                 /* 读取进程堆栈指针 */
-        "stmdb r0!, {r4-r11}\n"         /* 保存当前任务的寄存器R4-R11到堆栈 */
-        
-        /* 保存当前任务的堆栈指针 */
-        "ldr r1, =scheduler\n"          /* 加载调度器地址 */
-        "ldr r2, [r1, #132]\n"          /* 加载current_task指针 (偏移量132) */
-        "str r0, [r2, #8]\n"            /* 保存堆栈指针到当前任务的stack_ptr */
-        
-        /* 查找下一个要运行的任务 - 使用内联汇编实现 */
-        "ldr r3, [r1, #128]\n"          /* 加载task_count (偏移量128) */
-        "mov r4, #0\n"                  /* 初始化循环计数器 */
-        "mov r5, #32\n"                 /* 最大优先级值 */
-        "mov r6, #0\n"                  /* 最高优先级任务指针 */
-        
-        "find_loop:\n"
-        "cmp r4, r3\n"                  /* 检查是否遍历完所有任务 */
-        "bge find_done\n"               /* 如果遍历完，跳转到完成 */
-        
-        "ldr r7, [r1, r4, lsl #2]\n"    /* 加载tasks[i] (偏移量0) */
-        "ldrb r8, [r7, #20]\n"          /* 加载任务状态 */
-        "cmp r8, #0\n"                  /* 检查是否为TASK_READY */
-        "bne find_next\n"               /* 如果不是就绪状态，跳过 */
-        
-        "ldr r8, [r7, #16]\n"           /* 加载任务优先级 */
-        "cmp r8, r5\n"                  /* 比较优先级 */
-        "bge find_next\n"               /* 如果优先级不更高，跳过 */
-        
-        "mov r5, r8\n"                  /* 更新最高优先级 */
-        "mov r6, r7\n"                  /* 更新最高优先级任务指针 */
-        
-        "find_next:\n"
-        "add r4, r4, #1\n"              /* 增加循环计数器 */
-        "b find_loop\n"                 /* 继续循环 */
-        
-        "find_done:\n"
-        "str r6, [r1, #132]\n"          /* 保存新任务指针到current_task (偏移量132) */
-        
-        /* 恢复新任务的上下文 */
-        "ldr r0, [r6, #8]\n"            /* 加载新任务的堆栈指针 */
-        "ldmia r0!, {r4-r11}\n"         /* 从新任务的堆栈恢复寄存器R4-R11 */
-        "msr psp, r0\n"                /* 更新进程堆栈指针 */
-        
-        "cpsie i\n"                    /* 启用中断 */
-        "bx lr\n"                      /* 返回，自动恢复剩余的寄存器 */
-    );
-}
-
-/* SVC中断处理函数 - 处理系统调用 */
-void __attribute__((naked)) svc_handler(void) {
-    __asm volatile(
-        "tst lr, #4\n"                 /* 检查使用的是主堆栈还是进程堆栈 */
-        "ite eq\n"                     /* if-then-else指令 */
-        "mrseq r0, msp\n"              /* 如果使用主堆栈，读取MSP */
-        "mrsne r0, psp\n"              /* 如果使用进程堆栈，读取PSP */
-        
-        "ldr r1, [r0, #24]\n"         /* 从堆栈中加载PC值（SVC调用地址） */
-        "ldrb r1, [r1, #-2]\n"        /* 读取SVC指令的操作数 */
-        
-        "cmp r1, #0\n"                /* 检查SVC编号 */
-        "beq schedule\n"              /* 如果SVC 0，跳转到调度处理 */
-        
-        "bx lr\n"                     /* 返回，不处理其他SVC调用 */
-        
-        "schedule:\n"                 /* 调度处理标签 */
-        "ldr r0, =0xE000ED04\n"       /* 加载ICSR寄存器地址 */
-        "ldr r1, =0x10000000\n"       /* PendSV挂起位 */
-        "str r1, [r0]\n"              /* 触发PendSV中断 */
-        "bx lr\n"                     /* 返回 */
-    );
-}
\ No newline at end of file
+#if RTOS_STACK_CHECK
+/* 栈从未用到的字节数 - 从保护区之上统计仍为填充值的字，包括哨兵
+ * 保护区对当前任务不可读，不计入；哨兵检查只在切出时进行，据此确定栈大小时应留有余量 */
+uint32_t task_stack_unused(task_t* task) {
+    uint32_t words = PORT_STACK_GUARD_WORDS;
+    
+    if (!task) task = scheduler.current_task;
+    if (!task) return 0;
+    
+    while (words < task->stack_size && task->stack[words] == RTOS_STACK_PATTERN) {
+        words++;
+    }
+    return (words - PORT_STACK_GUARD_WORDS) * sizeof(uint32_t);
+}
+#endif
+
+/* 栈溢出处理 - 在切换路径或移植层的故障处理中以屏蔽中断的状态调用，task为溢出的任务
+ * 弱定义，应用可重新实现(例如记录任务后复位)；默认保持中断屏蔽并停在此处，
+ * 调试器可从参数看到出错的任务。重新实现的函数从切换路径返回后切换照常进行，
+ * 从故障处理返回后移植层停机 */
+__attribute__((weak)) void rtos_stack_overflow(task_t* task) {
+    (void)task;
+    (void)rtos_enter_critical();
+    for (;;) {
+    }
+}
+
+/* 静态任务与已创建的任务合计超过MAX_TASKS时由rtos_start调用，count为合计任务数
+ * 弱定义，应用可重新实现(例如输出后复位)；默认保持中断屏蔽并停在此处，调试器可从参数
+ * 看到需要的任务数。重新实现的函数返回后rtos_start不启动调度器，直接返回 */
+__attribute__((weak)) void rtos_task_limit_exceeded(uint32_t count) {
+    (void)count;
+    (void)rtos_enter_critical();
+    for (;;) {
+    }
+}
+
+#if RTOS_PERF_ENABLE
+/* 性能计数采样 - 把上次快照以来的计数累加到当前任务
+ * 任务切换时自动调用；Cortex-M4的8位事件计数器在两次切换之间可能回绕，
+ * 可在周期中断中调用以缩短采样间隔，中断中调用时计入被打断的任务 */
+void rtos_perf_sample(void) {
+    uint32_t primask;
+    
+    if (!scheduler.running) {
+        return;
+    }
+    primask = rtos_enter_critical();
+    perf_account(scheduler.current_task);
+    rtos_exit_critical(primask);
+}
+
+/* 清零全部任务的性能计数 */
+void rtos_perf_reset(void) {
+    uint32_t primask = rtos_enter_critical();
+    
+    for (uint8_t i = 0; i < scheduler.task_count; i++) {
+        memset(&scheduler.tasks[i]->perf, 0, sizeof(task_perf_t));
+    }
+    port_perf_read(&perf_last);
+    rtos_exit_critical(primask);
+}
+
+/* 读取任务的性能计数 - 64位累计值在临界区内复制，读取当前任务时先结算 */
+void task_get_perf(task_t* task, task_perf_t* perf) {
+    uint32_t primask;
+    
+    if (!task || !perf) return;
+    
+    primask = rtos_enter_critical();
+    if (scheduler.running && task == scheduler.current_task) {
+        perf_account(task);
+    }
+    *perf = task->perf;
+    rtos_exit_critical(primask);
+}
+#endif
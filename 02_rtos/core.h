@@ -2,47 +2,193 @@
 #define __CORE_H__
 
 #include <stdint.h>
+#include "port.h"
 
 /* RTOS核心头文件 - 定义任务管理和调度器接口 */
 
-#define MAX_TASKS 32         /* 最大任务数量 */
+#define MAX_TASKS 32         /* 最大任务数量(含空闲任务和静态定义的任务) */
 #define MAX_PRIORITY 31     /* 最大优先级值 (0最高, 31最低) */
-#define STACK_SIZE 256      /* 每个任务的堆栈大小 */
+#ifndef STACK_SIZE
+#define STACK_SIZE 256      /* task_create创建的任务的堆栈大小(字)，移植层可在port_cfg.h中修改 */
+#endif
+#ifndef RTOS_TASK_POOL
+#define RTOS_TASK_POOL MAX_TASKS  /* task_create可用的控制块和栈数(含空闲任务)，只用静态任务时可以减小 */
+#endif
 
 #define TASK_READY 0        /* 任务就绪状态 */
 #define TASK_RUNNING 1      /* 任务运行状态 */
 #define TASK_SUSPENDED 2    /* 任务挂起状态 */
 
-/* 任务控制块结构体 */
+#define RTOS_WAIT_FOREVER 0xFFFFFFFFUL  /* 无限等待 */
+
+/* 任务控制块池(含任务栈)和调度器的存放位置，默认为移植层的快速内存(Cortex-M4为CCM)；
+ * 定义为空时放在普通.bss，用于比较两种布局 */
+#ifndef RTOS_KERNEL_BSS
+#define RTOS_KERNEL_BSS PORT_FAST_BSS
+#endif
+
+/* 任务栈和任务控制块池启动时不清零，rtos_init只清除空闲标记，其余字段由task_create
+ * 设置、栈由task_create填充；定义为RTOS_KERNEL_BSS时恢复为零初始化 */
+#ifndef RTOS_KERNEL_NOINIT
+#define RTOS_KERNEL_NOINIT PORT_FAST_NOINIT
+#endif
+
+#ifndef RTOS_PERF_ENABLE
+#define RTOS_PERF_ENABLE 0  /* 为1时每次任务切换累计移植层性能计数器(port_perf_read)到任务 */
+#endif
+
+/* 栈检查 - 为1时task_create把栈填充为RTOS_STACK_PATTERN，每次任务切换检查切出任务
+ * 栈底(移植层保护区之上)的RTOS_STACK_CANARY_WORDS个字，被改写时调用rtos_stack_overflow */
+#ifndef RTOS_STACK_CHECK
+#define RTOS_STACK_CHECK 1
+#endif
+#ifndef RTOS_STACK_PATTERN
+#define RTOS_STACK_PATTERN 0xA5A5A5A5UL  /* 栈填充值 */
+#endif
+#ifndef RTOS_STACK_CANARY_WORDS
+#define RTOS_STACK_CANARY_WORDS 4  /* 保护区之上保留为哨兵的字数，任务实际可用的栈再减去此值 */
+#endif
+
+struct wait_queue;
+struct arena;
+
+/* 任务性能计数 - 64位累计值，任务被切出或调用rtos_perf_sample时更新
+ * 期间发生的中断计入被打断的任务 */
 typedef struct {
+    uint64_t cycles;           /* 运行周期 */
+    uint64_t cpi;              /* 多周期指令和取指/总线停顿的额外周期 */
+    uint64_t exc;              /* 异常进入和退出的开销周期 */
+    uint64_t sleep;            /* 睡眠周期(空闲任务WFI) */
+    uint64_t lsu;              /* 加载/存储指令的额外周期 */
+    uint64_t fold;             /* 被折叠(不占周期)的指令数 */
+    uint32_t switches;         /* 被切入的次数 */
+} task_perf_t;
+
+/* 任务控制块结构体 */
+typedef struct task {
     void (*task_func)(void*);  /* 任务函数指针 */
     void* arg;                 /* 任务参数 */
     uint32_t* stack_ptr;       /* 当前堆栈指针 */
     uint32_t priority;         /* 任务优先级 */
     uint8_t state;             /* 任务状态 */
-    uint32_t stack[STACK_SIZE]; /* 任务堆栈空间 */
+    struct task* wait_next;    /* 等待队列中的下一个任务 */
+    struct wait_queue* wait_queue; /* 当前所在的等待队列，NULL表示未等待 */
+    struct task* delay_next;   /* 延时链表中的下一个任务 */
+    uint32_t delay_target;     /* 延时到期时的TIM2计数值 */
+    uint8_t delaying;          /* 是否在延时链表中 */
+    struct arena* arena;       /* 任务的临时内存区(arena.h)，NULL表示没有 */
+    uint32_t* stack;           /* 任务堆栈空间，按PORT_STACK_ALIGN对齐，最低处为移植层的保护区 */
+    uint32_t stack_size;       /* 堆栈字数 */
+#if RTOS_PERF_ENABLE
+    task_perf_t perf;          /* 性能计数 */
+#endif
+    PORT_TASK_FIELDS           /* 移植层私有字段 */
 } task_t;
 
+/* 静态任务描述符 - 由RTOS_TASK_DEFINE放在rtos_task段(只读)，rtos_start逐个启动 */
+typedef struct {
+    task_t* task;              /* 控制块 */
+    void (*func)(void*);       /* 任务函数 */
+    void* arg;                 /* 任务参数 */
+    uint32_t priority;         /* 优先级 */
+    uint32_t* stack;           /* 堆栈 */
+    uint32_t stack_size;       /* 堆栈字数 */
+    const char* name;          /* 名称 */
+} rtos_task_desc_t;
+
+/* 静态任务的最小堆栈(字)：保护区 + 哨兵 + 移植层要求的最小用量 */
+#define RTOS_TASK_MIN_STACK (PORT_STACK_GUARD_WORDS + RTOS_STACK_CANARY_WORDS + PORT_MIN_STACK_WORDS)
+
+/* 静态定义任务 - 控制块和stack字的堆栈在编译时分配，描述符放在rtos_task段，
+ * rtos_start在启动调度前一次性启动全部静态任务，不会因控制块或内存不足失败。
+ * 省去的只是分配：rtos_start对每个静态任务仍与task_create相同地初始化控制块、
+ * 填充整个栈(RTOS_STACK_CHECK为1时，stack字)并由port_task_init构造初始帧。
+ * Cortex-M4上约为每字4~6个周期加50个周期左右(估算，未实测)，256字的栈约
+ * 1.1~1.6k周期，168MHz下7~10us。栈在.noinit中，预先填好的栈和初始帧只能
+ * 放进.data由启动代码从Flash拷贝，每字的代价相同，还占用Flash，因此不预先计算。
+ * 优先级和堆栈大小在编译时检查：prio须小于MAX_PRIORITY(留给空闲任务)，
+ * stack不小于RTOS_TASK_MIN_STACK；stack可取03_tools/stack_report生成的STACK_WORDS_<func>。
+ * 静态任务超过MAX_TASKS - 1个(空闲任务占一个)时固件的链接脚本报错，rtos_start在运行时
+ * 再加上已创建的任务检查一次。
+ * 定义的name为task_t，其他模块可以extern task_t name后以&name引用 */
+#define RTOS_TASK_DEFINE(name, func, arg, prio, stack)                                  \
+    _Static_assert((prio) >= 0 && (prio) < MAX_PRIORITY,                                \
+                   #name ": priority must be below MAX_PRIORITY");                      \
+    _Static_assert((stack) >= RTOS_TASK_MIN_STACK,                                      \
+                   #name ": stack smaller than RTOS_TASK_MIN_STACK");                   \
+    static uint32_t name##_stack[stack]                                                 \
+        __attribute__((aligned(PORT_STACK_ALIGN))) RTOS_KERNEL_NOINIT;                  \
+    task_t name RTOS_KERNEL_BSS;                                                        \
+    static const rtos_task_desc_t name##_desc                                           \
+        __attribute__((used, section("rtos_task"), aligned(sizeof(void*)))) =           \
+        { &name, (func), (arg), (prio), name##_stack, (stack), #name }
+
+/* 等待队列 - 记录因等待同一事件而挂起的任务，按入队顺序唤醒 */
+typedef struct wait_queue {
+    task_t* head;              /* 队首任务 */
+    task_t* tail;              /* 队尾任务 */
+} wait_queue_t;
+
+/* 互斥锁 - 同一任务可重复加锁，不做优先级继承；静态定义时清零即可 */
+typedef struct {
+    task_t* owner;             /* 持有者，NULL表示未加锁 */
+    uint32_t count;            /* 持有者的加锁次数 */
+    wait_queue_t waiters;      /* 等待加锁的任务 */
+} rtos_mutex_t;
+
+/* 一次性初始化 - 用于驱动在首次使用时初始化；静态定义时清零即可 */
+#define RTOS_ONCE_IDLE 0     /* 尚未执行 */
+#define RTOS_ONCE_RUNNING 1  /* 正在执行 */
+#define RTOS_ONCE_DONE 2     /* 已完成 */
+
+typedef struct {
+    volatile uint8_t state;    /* RTOS_ONCE_xxx */
+    wait_queue_t waiters;      /* 等待执行完成的任务 */
+} rtos_once_t;
+
 /* 调度器结构体 */
 typedef struct {
     task_t* tasks[MAX_TASKS];  /* 任务指针数组 */
     uint8_t task_count;        /* 当前任务数量 */
     task_t* current_task;      /* 当前运行的任务 */
+    uint8_t running;           /* 调度器是否已启动 */
 } scheduler_t;
 
 extern scheduler_t scheduler;  /* 全局调度器实例 */
 
 void rtos_init(void);        /* RTOS初始化 */
-void rtos_start(void);       /* 启动RTOS调度 */
+void rtos_start(void);       /* 启动全部静态任务并开始调度 */
 void rtos_schedule(void);    /* 调度器核心函数 */
 
+uint32_t rtos_enter_critical(void);        /* 进入临界区，返回进入前的中断屏蔽状态 */
+void rtos_exit_critical(uint32_t state);   /* 退出临界区，恢复进入前的中断屏蔽状态 */
+
 task_t* task_create(void (*func)(void*), void* arg, uint32_t priority);  /* 创建新任务 */
 void task_suspend(task_t* task);  /* 挂起指定任务 */
 void task_resume(task_t* task);   /* 恢复挂起的任务 */
 void task_delete(task_t* task);   /* 删除任务 */
+void task_yield(void);            /* 让出处理器给同优先级的就绪任务 */
 task_t* find_highest_priority_task(void);  /* 查找最高优先级任务 */
 
-void __attribute__((naked)) pend_sv_handler(void);  /* PendSV中断处理函数 */
-void __attribute__((naked)) svc_handler(void);       /* SVC中断处理函数 */
+int task_wait(wait_queue_t* queue);        /* 当前任务挂起到等待队列，须在临界区内调用 */
+int task_wait_timeout(wait_queue_t* queue, uint32_t ticks); /* 同上，最多等待ticks个TIM2周期 */
+task_t* task_wake_one(wait_queue_t* queue); /* 唤醒队首任务，可在中断中调用 */
+void task_wake_all(wait_queue_t* queue);   /* 唤醒队列中全部任务，可在中断中调用 */
+void task_unwait(task_t* task);            /* 将任务从其等待队列中移除(不改变任务状态) */
+int rtos_mutex_lock(rtos_mutex_t* mutex, uint32_t ticks); /* 加锁，最多等待ticks个TIM2周期，成功返回0 */
+void rtos_mutex_unlock(rtos_mutex_t* mutex);              /* 解锁，计数归零时唤醒一个等待者；中断中无效 */
+int rtos_once(rtos_once_t* once, void (*func)(void));     /* 只执行一次func，完成后返回0；中断中遇到执行中返回-1 */
+
+#if RTOS_STACK_CHECK
+uint32_t task_stack_unused(task_t* task);  /* 栈从未用到的字节数(高水位之下，不含保护区)，NULL为当前任务 */
+#endif
+void rtos_stack_overflow(task_t* task);    /* 检测到栈溢出时调用，弱定义，默认关中断停机 */
+void rtos_task_limit_exceeded(uint32_t count);  /* rtos_start发现任务总数超过MAX_TASKS时调用，弱定义，默认关中断停机 */
+
+#if RTOS_PERF_ENABLE
+void rtos_perf_sample(void);               /* 把上次快照以来的计数累加到当前任务，可在周期中断中调用 */
+void rtos_perf_reset(void);                /* 清零全部任务的性能计数 */
+void task_get_perf(task_t* task, task_perf_t* perf);  /* 读取任务的性能计数(当前任务先更新) */
+#endif
 
 #endif
\ No newline at end of file
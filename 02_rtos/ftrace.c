@@ -0,0 +1,247 @@
+/**
+  ******************************************************************************
+  * @file    ftrace.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   函数进出跟踪实现
+  ******************************************************************************
+  * @attention
+  *
+  * 本文件不能以-finstrument-functions编译，钩子函数另外标记了
+  * no_instrument_function，port_in_isr和port_cycles所在的port.c同样不能加。
+  *
+  * 钩子的开销：一次port_in_isr、一次port_cycles和8字节写入，Cortex-M4上
+  * 约30个周期。读出last和写回last之间被切出时，这一条记录的差值可能
+  * 包含切出的时间(差值为负时记为0)。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ftrace.h"
+#include "core.h"
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 每个任务一个单生产者/单消费者环形缓冲区 */
+typedef struct {
+    const task_t* task;         /* 绑定的任务，NULL为调度器启动前 */
+    uint32_t func;              /* 任务入口函数地址 */
+    uint32_t last;              /* 上一条记录的周期数，切回时加上切出的时间 */
+    uint32_t out;               /* 切出时刻 */
+    volatile uint32_t wr;       /* 写计数 - 由所属任务更新 */
+    volatile uint32_t rd;       /* 读计数 - 由ftrace_read更新 */
+    volatile uint32_t dropped;  /* 丢弃计数 - 由所属任务更新 */
+    uint32_t dropped_read;      /* 已报告的丢弃计数 */
+    uint8_t used;
+    ftrace_record_t rec[FTRACE_RING_RECORDS];
+} ftrace_ring_t;
+
+/* Private variables ---------------------------------------------------------*/
+static ftrace_ring_t ftrace_rings[FTRACE_RINGS];
+static ftrace_ring_t* volatile ftrace_current;     /* 当前任务的缓冲区，NULL不记录 */
+static volatile uint32_t ftrace_isr_count;          /* 中断中未记录的次数，不加锁 */
+static uint32_t ftrace_next;                        /* ftrace_read轮询的起点 */
+
+/* Private function prototypes -----------------------------------------------*/
+static void ftrace_put(void* fn, uint32_t kind) FTRACE_NO_INSTRUMENT;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  当前任务写一条记录
+  * @param  fn: 函数地址
+  * @param  kind: 0进入，FTRACE_EXIT返回
+  * @retval None
+  */
+static void ftrace_put(void* fn, uint32_t kind)
+{
+    ftrace_ring_t* r = ftrace_current;
+    ftrace_record_t* e;
+    uint32_t now, delta, wr;
+
+    if (r == NULL) {
+        return;
+    }
+    if (port_in_isr()) {
+        ftrace_isr_count++;
+        return;
+    }
+
+    now = port_cycles();
+    delta = now - r->last;
+    r->last = now;
+    if ((int32_t)delta < 0) {
+        delta = 0;
+    }
+
+    wr = r->wr;
+    if (wr - r->rd >= FTRACE_RING_RECORDS) {
+        r->dropped++;
+        return;
+    }
+    e = &r->rec[wr & (FTRACE_RING_RECORDS - 1U)];
+    e->addr = (uint32_t)(uintptr_t)fn;
+    e->delta_kind = (delta << 1) | kind;
+    __asm volatile("" ::: "memory");        /* 先写记录再发布写计数 */
+    r->wr = wr + 1U;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  清空全部缓冲区，调度器启动前的记录写入第一个缓冲区
+  * @param  None
+  * @retval None
+  */
+void ftrace_init(void)
+{
+    memset(ftrace_rings, 0, sizeof(ftrace_rings));
+    ftrace_rings[0].used = 1;
+    ftrace_rings[0].last = port_cycles();
+    ftrace_isr_count = 0;
+    ftrace_next = 0;
+    ftrace_current = &ftrace_rings[0];
+}
+
+/**
+  * @brief  任务切换 - 记录切出时刻，切换到下一个任务的缓冲区
+  * @param  from: 切出的任务，首个任务启动时为NULL
+  * @param  to: 切入的任务
+  * @retval None
+  * @note   由内核以屏蔽中断的状态调用；新任务在有空闲缓冲区时绑定
+  */
+void ftrace_switch(struct task* from, struct task* to)
+{
+    uint32_t now = port_cycles();
+    ftrace_ring_t* next = NULL;
+    uint32_t i;
+
+    (void)from;
+    if (ftrace_current != NULL) {
+        ftrace_current->out = now;
+    }
+
+    for (i = 1; i < FTRACE_RINGS; i++) {
+        if (ftrace_rings[i].used && ftrace_rings[i].task == to) {
+            next = &ftrace_rings[i];
+            next->last += now - next->out;
+            break;
+        }
+    }
+    for (i = 1; next == NULL && i < FTRACE_RINGS; i++) {
+        if (!ftrace_rings[i].used) {
+            next = &ftrace_rings[i];
+            next->used = 1;
+            next->task = to;
+            next->last = now;
+        }
+    }
+    if (next != NULL) {
+        next->func = (uint32_t)(uintptr_t)to->task_func;
+    }
+    ftrace_current = next;
+}
+
+/**
+  * @brief  取出数据块
+  * @param  buf: 输出缓冲区
+  * @param  size: 缓冲区大小，至少容纳一个块头和一条记录
+  * @retval 写入的字节数，只包含完整的数据块
+  * @note   只能由一个任务调用；空间不足时剩余记录留到下次
+  */
+uint32_t ftrace_read(void* buf, uint32_t size)
+{
+    uint8_t* out = (uint8_t*)buf;
+    uint32_t len = 0;
+    uint32_t k;
+
+    for (k = 0; k < FTRACE_RINGS; k++) {
+        ftrace_ring_t* r = &ftrace_rings[(ftrace_next + k) % FTRACE_RINGS];
+        ftrace_block_t hdr;
+        uint32_t wr, dropped, n, take, first, i;
+
+        if (!r->used) {
+            continue;
+        }
+        wr = r->wr;                     /* 先读写计数，之后的丢弃都在这些记录之后 */
+        dropped = r->dropped;
+        n = wr - r->rd;
+        if (n == 0U && dropped == r->dropped_read) {
+            continue;
+        }
+        if (size - len < sizeof(hdr) + ((n > 0U) ? sizeof(ftrace_record_t) : 0U)) {
+            break;
+        }
+        take = (size - len - (uint32_t)sizeof(hdr)) / (uint32_t)sizeof(ftrace_record_t);
+        if (take > n) {
+            take = n;
+        }
+
+        hdr.magic = FTRACE_BLOCK_MAGIC;
+        hdr.task = (uint32_t)(uintptr_t)r->task;
+        hdr.func = r->func;
+        hdr.count = take;
+        hdr.dropped = 0;
+        if (take == n) {
+            hdr.dropped = dropped - r->dropped_read;
+            r->dropped_read = dropped;
+        }
+        memcpy(out + len, &hdr, sizeof(hdr));
+        len += (uint32_t)sizeof(hdr);
+
+        first = r->rd;
+        for (i = 0; i < take; i++) {
+            memcpy(out + len, &r->rec[(first + i) & (FTRACE_RING_RECORDS - 1U)],
+                   sizeof(ftrace_record_t));
+            len += (uint32_t)sizeof(ftrace_record_t);
+        }
+        __asm volatile("" ::: "memory");    /* 先拷贝再释放空间 */
+        r->rd = first + take;
+
+        if (take < n) {
+            ftrace_next = (ftrace_next + k) % FTRACE_RINGS;   /* 下次从这里继续 */
+            return len;
+        }
+    }
+    ftrace_next = (ftrace_next + 1U) % FTRACE_RINGS;
+    return len;
+}
+
+/**
+  * @brief  中断上下文中未记录的函数进出次数
+  * @param  None
+  * @retval 次数(多个中断同时计数时可能偏小)
+  */
+uint32_t ftrace_skipped(void)
+{
+    return ftrace_isr_count;
+}
+
+/**
+  * @brief  函数进入钩子 - 由-finstrument-functions插入
+  * @param  this_fn: 被调用函数的地址
+  * @param  call_site: 调用处，未使用
+  * @retval None
+  */
+void __cyg_profile_func_enter(void* this_fn, void* call_site)
+{
+    (void)call_site;
+    ftrace_put(this_fn, 0);
+}
+
+/**
+  * @brief  函数返回钩子 - 由-finstrument-functions插入
+  * @param  this_fn: 返回的函数的地址
+  * @param  call_site: 调用处，未使用
+  * @retval None
+  */
+void __cyg_profile_func_exit(void* this_fn, void* call_site)
+{
+    (void)call_site;
+    ftrace_put(this_fn, FTRACE_EXIT);
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,106 @@
+/**
+  ******************************************************************************
+  * @file    ftrace.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   函数进出跟踪头文件
+  *          以-finstrument-functions编译的源文件在每个函数进出时写一条记录
+  ******************************************************************************
+  * @attention
+  *
+  * 使用方法：
+  * 1. 全部源文件以-DFTRACE_ENABLE=1编译(内核在任务切换时通知本模块)
+  * 2. 只给要跟踪的源文件加-finstrument-functions，例如02_rtos/core.c、
+  *    time.c和驱动；本文件、port.c和它们调用的函数不能加
+  * 3. 低优先级任务周期调用ftrace_read取出数据块，经RTT或文件交给主机，
+  *    主机端用03_tools/ftrace_report按ELF符号还原调用树
+  *
+  * 实现原理：
+  * 1. 每个任务绑定一个单生产者/单消费者环形缓冲区，只有该任务写入，
+  *    只有调用ftrace_read的任务读出，不需要临界区
+  * 2. 记录为(函数地址, 与上一条记录的port_cycles差值)，8字节
+  * 3. 任务被切出期间的时间在切回时从差值中扣除，调用树的耗时只包含
+  *    任务自身运行(含期间发生的中断)的时间
+  * 4. 中断上下文中的函数进出不记录(只计数)，中断中调用的被跟踪函数
+  *    因此不会破坏任务的调用树
+  * 5. 缓冲区满时丢弃新记录并计数，主机端在丢弃处清空该任务的调用栈
+  *
+  * 绑定环形缓冲区的任务数为FTRACE_RINGS，其余任务不记录。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __FTRACE_H__
+#define __FTRACE_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* 全局开关 - 为0时内核不调用本模块 */
+#ifndef FTRACE_ENABLE
+#define FTRACE_ENABLE           0
+#endif
+
+#ifndef FTRACE_RINGS
+#define FTRACE_RINGS            4           /* 环形缓冲区数，含调度器启动前的main */
+#endif
+
+#ifndef FTRACE_RING_RECORDS
+#define FTRACE_RING_RECORDS     256         /* 每个环形缓冲区的记录数，须为2的幂 */
+#endif
+
+/* 数据块：ftrace_block_t + count条ftrace_record_t，小端 */
+#define FTRACE_BLOCK_MAGIC      0x43525446UL    /* "FTRC" */
+#define FTRACE_EXIT             1UL             /* delta_kind的bit0：函数返回 */
+#define FTRACE_DELTA_MAX        0x7FFFFFFFUL
+
+/* Exported macro ------------------------------------------------------------*/
+#if defined(__GNUC__)
+#define FTRACE_NO_INSTRUMENT    __attribute__((no_instrument_function))
+#else
+#define FTRACE_NO_INSTRUMENT
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 一条记录 */
+typedef struct {
+    uint32_t addr;              /* 函数地址 */
+    uint32_t delta_kind;        /* 与上一条记录的周期差 << 1 | FTRACE_EXIT */
+} ftrace_record_t;
+
+/* 数据块头 */
+typedef struct {
+    uint32_t magic;
+    uint32_t task;              /* TCB地址，0为调度器启动前 */
+    uint32_t func;              /* 任务入口函数地址 */
+    uint32_t count;             /* 随后的记录数 */
+    uint32_t dropped;           /* 最后一条记录之后丢弃的记录数 */
+} ftrace_block_t;
+
+struct task;
+
+/* Exported functions ------------------------------------------------------- */
+void ftrace_init(void);                                 /* 须在rtos_init之前调用 */
+void ftrace_switch(struct task* from, struct task* to); /* 由内核在任务切换时调用 */
+uint32_t ftrace_read(void* buf, uint32_t size);         /* 取出完整的数据块，返回字节数 */
+uint32_t ftrace_skipped(void);                          /* 中断上下文中未记录的进出次数 */
+
+/* 编译器插入的钩子 */
+void __cyg_profile_func_enter(void* this_fn, void* call_site) FTRACE_NO_INSTRUMENT;
+void __cyg_profile_func_exit(void* this_fn, void* call_site) FTRACE_NO_INSTRUMENT;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FTRACE_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
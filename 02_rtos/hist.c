@@ -0,0 +1,350 @@
+/**
+  ******************************************************************************
+  * @file    hist.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   对数线性直方图实现
+  ******************************************************************************
+  * @attention
+  *
+  * 桶号(S = HIST_SUB_BITS)：
+  *   value < 2^(S+1)        index = value
+  *   否则 e = 31 - clz(value), shift = e - S
+  *                          index = (shift + 1) << S | (value >> shift) & (2^S - 1)
+  * 两段在2^(S+1)处连续，桶号随值单调递增。
+  *
+  * 序列化(小端)：
+  *   0   magic        HIST_MAGIC
+  *   4   sub_bits, max_bits, 保留2字节
+  *   8   count, overflow, min, max
+  *   24  sum(64位)
+  *   32  (前面连续空桶数, 桶计数)的LEB128对，直到最后一个非空桶
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hist.h"
+#include "port.h"
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define HIST_SUB_COUNT          (1UL << HIST_SUB_BITS)
+#define HIST_SUB_MASK           (HIST_SUB_COUNT - 1UL)
+#define HIST_OVERFLOW(v)        (((uint64_t)(v) >> HIST_MAX_BITS) != 0U)   /* HIST_MAX_BITS可为32 */
+
+#if (HIST_MAX_BITS > 32) || (HIST_SUB_BITS < 1) || (HIST_SUB_BITS >= HIST_MAX_BITS)
+#error "HIST_SUB_BITS/HIST_MAX_BITS out of range"
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t hist_put_varint(uint8_t* out, uint32_t value);
+static int hist_get_varint(const uint8_t* in, uint32_t size, uint32_t* pos, uint32_t* value);
+
+/* Private functions ---------------------------------------------------------*/
+
+static void hist_put32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t hist_get32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+  * @brief  LEB128编码一个32位无符号数
+  * @param  out: 输出位置
+  * @param  value: 数值
+  * @retval 编码长度(1-5字节)
+  */
+static uint32_t hist_put_varint(uint8_t* out, uint32_t value)
+{
+    uint32_t len = 0;
+
+    while (value >= 0x80U) {
+        out[len++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+    return len;
+}
+
+/**
+  * @brief  LEB128解码一个32位无符号数
+  * @param  in: 输入
+  * @param  size: 输入长度
+  * @param  pos: 读取位置，成功后前移
+  * @param  value: 输出
+  * @retval 成功返回0，数据截断或超过32位返回-1
+  */
+static int hist_get_varint(const uint8_t* in, uint32_t size, uint32_t* pos, uint32_t* value)
+{
+    uint32_t shift = 0;
+    uint32_t v = 0;
+
+    while (*pos < size && shift < 35U) {
+        uint8_t b = in[(*pos)++];
+        v |= (uint32_t)(b & 0x7FU) << shift;
+        if ((b & 0x80U) == 0U) {
+            *value = v;
+            return 0;
+        }
+        shift += 7U;
+    }
+    return -1;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  值所在的桶号
+  * @param  value: 样本值
+  * @retval 桶号，不小于2^HIST_MAX_BITS的值为最后一个桶
+  */
+uint32_t hist_bucket_index(uint32_t value)
+{
+    uint32_t shift;
+
+    if (value < (HIST_SUB_COUNT << 1)) {
+        return value;
+    }
+    if (HIST_OVERFLOW(value)) {
+        return HIST_BUCKETS - 1U;
+    }
+    shift = 31U - (uint32_t)__builtin_clz(value) - HIST_SUB_BITS;
+    return ((shift + 1U) << HIST_SUB_BITS) | ((value >> shift) & HIST_SUB_MASK);
+}
+
+/**
+  * @brief  桶的下界
+  * @param  index: 桶号
+  * @retval 落入该桶的最小值
+  */
+uint32_t hist_bucket_low(uint32_t index)
+{
+    uint32_t shift;
+
+    if (index < (HIST_SUB_COUNT << 1)) {
+        return index;
+    }
+    shift = (index >> HIST_SUB_BITS) - 1U;
+    return ((index & HIST_SUB_MASK) | HIST_SUB_COUNT) << shift;
+}
+
+/**
+  * @brief  桶的上界
+  * @param  index: 桶号
+  * @retval 落入该桶的最大值
+  */
+uint32_t hist_bucket_high(uint32_t index)
+{
+    if (index < (HIST_SUB_COUNT << 1)) {
+        return index;
+    }
+    return hist_bucket_low(index) + (1UL << ((index >> HIST_SUB_BITS) - 1U)) - 1U;
+}
+
+/**
+  * @brief  清空直方图
+  * @param  h: 直方图
+  * @retval None
+  */
+void hist_init(hist_t* h)
+{
+    memset(h, 0, sizeof(*h));
+    h->min = 0xFFFFFFFFUL;
+}
+
+/**
+  * @brief  记录一个样本
+  * @param  h: 直方图
+  * @param  value: 样本值
+  * @retval None
+  * @note   任务和中断上下文均可调用
+  */
+void hist_record(hist_t* h, uint32_t value)
+{
+    uint32_t index = hist_bucket_index(value);
+    uint32_t state = port_enter_critical();
+
+    h->buckets[index]++;
+    h->count++;
+    h->sum += value;
+    if (value < h->min) {
+        h->min = value;
+    }
+    if (value > h->max) {
+        h->max = value;
+    }
+    if (HIST_OVERFLOW(value)) {
+        h->overflow++;
+    }
+    port_exit_critical(state);
+}
+
+/**
+  * @brief  合并直方图
+  * @param  dst: 目标，合并期间不能有其他记录
+  * @param  src: 源，可以正在被记录
+  * @retval None
+  */
+void hist_merge(hist_t* dst, const hist_t* src)
+{
+    uint32_t i;
+
+    for (i = 0; i < HIST_BUCKETS; i++) {
+        dst->buckets[i] += src->buckets[i];
+    }
+    dst->count += src->count;
+    dst->overflow += src->overflow;
+    dst->sum += src->sum;
+    if (src->min < dst->min) {
+        dst->min = src->min;
+    }
+    if (src->max > dst->max) {
+        dst->max = src->max;
+    }
+}
+
+/**
+  * @brief  分位数
+  * @param  h: 直方图
+  * @param  ppm: 百万分比，例如990000为p99，1000000为最大值
+  * @retval 累计样本数首次达到ppm的桶的上界(不超过max，不小于min)，无样本返回0
+  */
+uint32_t hist_percentile(const hist_t* h, uint32_t ppm)
+{
+    uint64_t total = 0, target, seen = 0;
+    uint32_t i, value;
+
+    for (i = 0; i < HIST_BUCKETS; i++) {
+        total += h->buckets[i];
+    }
+    if (total == 0U) {
+        return 0;
+    }
+    if (ppm > 1000000U) {
+        ppm = 1000000U;
+    }
+    target = (total * ppm + 999999U) / 1000000U;
+    if (target == 0U) {
+        target = 1;
+    }
+
+    for (i = 0; i < HIST_BUCKETS - 1U; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            break;
+        }
+    }
+    value = hist_bucket_high(i);
+    if (i == HIST_BUCKETS - 1U || value > h->max) {
+        value = h->max;
+    }
+    if (value < h->min) {
+        value = h->min;
+    }
+    return value;
+}
+
+/**
+  * @brief  平均值
+  * @param  h: 直方图
+  * @retval 平均值，无样本返回0
+  */
+uint32_t hist_mean(const hist_t* h)
+{
+    return (h->count == 0U) ? 0U : (uint32_t)(h->sum / h->count);
+}
+
+/**
+  * @brief  序列化
+  * @param  h: 直方图
+  * @param  buf: 输出缓冲区
+  * @param  size: 缓冲区大小，HIST_SERIAL_MAX总是足够
+  * @retval 字节数，空间不足返回0
+  */
+uint32_t hist_serialize(const hist_t* h, void* buf, uint32_t size)
+{
+    uint8_t* out = (uint8_t*)buf;
+    uint8_t tmp[10];
+    uint32_t len = HIST_HEADER_SIZE;
+    uint32_t run = 0;
+    uint32_t i, n;
+
+    if (size < HIST_HEADER_SIZE) {
+        return 0;
+    }
+    hist_put32(out, HIST_MAGIC);
+    out[4] = HIST_SUB_BITS;
+    out[5] = HIST_MAX_BITS;
+    out[6] = 0;
+    out[7] = 0;
+    hist_put32(out + 8, h->count);
+    hist_put32(out + 12, h->overflow);
+    hist_put32(out + 16, h->min);
+    hist_put32(out + 20, h->max);
+    hist_put32(out + 24, (uint32_t)h->sum);
+    hist_put32(out + 28, (uint32_t)(h->sum >> 32));
+
+    for (i = 0; i < HIST_BUCKETS; i++) {
+        if (h->buckets[i] == 0U) {
+            run++;
+            continue;
+        }
+        n = hist_put_varint(tmp, run);
+        n += hist_put_varint(tmp + n, h->buckets[i]);
+        if (size - len < n) {
+            return 0;
+        }
+        memcpy(out + len, tmp, n);
+        len += n;
+        run = 0;
+    }
+    return len;
+}
+
+/**
+  * @brief  反序列化
+  * @param  h: 输出直方图
+  * @param  buf: hist_serialize的输出
+  * @param  size: 字节数
+  * @retval 成功返回0；格式错误或分桶参数不同返回-1
+  */
+int hist_deserialize(hist_t* h, const void* buf, uint32_t size)
+{
+    const uint8_t* in = (const uint8_t*)buf;
+    uint32_t pos = HIST_HEADER_SIZE;
+    uint32_t index = 0;
+    uint32_t run, count;
+
+    if (size < HIST_HEADER_SIZE || hist_get32(in) != HIST_MAGIC ||
+        in[4] != HIST_SUB_BITS || in[5] != HIST_MAX_BITS) {
+        return -1;
+    }
+    hist_init(h);
+    h->count = hist_get32(in + 8);
+    h->overflow = hist_get32(in + 12);
+    h->min = hist_get32(in + 16);
+    h->max = hist_get32(in + 20);
+    h->sum = (uint64_t)hist_get32(in + 24) | ((uint64_t)hist_get32(in + 28) << 32);
+
+    while (pos < size) {
+        if (hist_get_varint(in, size, &pos, &run) != 0 ||
+            hist_get_varint(in, size, &pos, &count) != 0 ||
+            run >= HIST_BUCKETS - index) {
+            return -1;
+        }
+        index += run;
+        h->buckets[index++] = count;
+    }
+    return 0;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
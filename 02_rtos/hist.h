@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    hist.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   对数线性直方图头文件
+  *          固定内存、O(1)记录，可在中断和任务中使用，支持合并、分位数和序列化
+  ******************************************************************************
+  * @attention
+  *
+  * 使用方法：
+  *   static hist_t wake_lat;
+  *   hist_init(&wake_lat);
+  *   hist_record(&wake_lat, cycles);                 中断或任务中
+  *   p99 = hist_percentile(&wake_lat, 990000);       百万分比
+  *   len = hist_serialize(&wake_lat, buf, sizeof(buf));
+  *
+  * 分桶(HDR风格)：
+  * 1. 小于2^(HIST_SUB_BITS+1)的值每个值一个桶，结果精确
+  * 2. 更大的值按最高位所在的2的幂分组，每组再线性分为2^HIST_SUB_BITS个桶，
+  *    桶宽与值的比例不超过2^-HIST_SUB_BITS(默认4位，6.25%)
+  * 3. 桶号由CLZ指令求得最高位后移位得到，记录的代价与值无关
+  * 4. 不小于2^HIST_MAX_BITS的值计入最后一个桶和overflow
+  *
+  * 分位数返回所在桶的上界(不超过max)，即"不大于该值的样本至少占p"，
+  * 误差不超过一个桶宽。
+  *
+  * 记录在移植层临界区内完成(几条指令)，读取不加锁：与记录并发时
+  * 分位数按读到的桶计数计算，结果对应读取过程中某个时刻附近的分布。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __HIST_H__
+#define __HIST_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+#ifndef HIST_SUB_BITS
+#define HIST_SUB_BITS           4           /* 每个2的幂分组的线性桶数为2^HIST_SUB_BITS */
+#endif
+
+#ifndef HIST_MAX_BITS
+#define HIST_MAX_BITS           24          /* 可区分的最大值为2^HIST_MAX_BITS-1 */
+#endif
+
+#define HIST_BUCKETS            ((HIST_MAX_BITS - HIST_SUB_BITS + 1) << HIST_SUB_BITS)
+
+/* 序列化格式：小端头部 + 桶计数的变长编码 */
+#define HIST_MAGIC              0x54534948UL    /* "HIST" */
+#define HIST_HEADER_SIZE        32U
+#define HIST_SERIAL_MAX         (HIST_HEADER_SIZE + HIST_BUCKETS * 6U)   /* 序列化结果的最大字节数 */
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef struct {
+    uint32_t count;             /* 样本数 */
+    uint32_t overflow;          /* 不小于2^HIST_MAX_BITS的样本数 */
+    uint32_t min;               /* 最小值，无样本时为0xFFFFFFFF */
+    uint32_t max;               /* 最大值 */
+    uint64_t sum;               /* 总和 */
+    uint32_t buckets[HIST_BUCKETS];
+} hist_t;
+
+/* Exported functions ------------------------------------------------------- */
+void hist_init(hist_t* h);                                  /* 清空 */
+void hist_record(hist_t* h, uint32_t value);                /* 记录一个样本，可在中断中调用 */
+void hist_merge(hist_t* dst, const hist_t* src);            /* 把src的样本加入dst */
+uint32_t hist_percentile(const hist_t* h, uint32_t ppm);    /* 分位数，ppm为百万分比 */
+uint32_t hist_mean(const hist_t* h);                        /* 平均值 */
+
+uint32_t hist_bucket_index(uint32_t value);                 /* 值所在的桶号 */
+uint32_t hist_bucket_low(uint32_t index);                   /* 桶的下界 */
+uint32_t hist_bucket_high(uint32_t index);                  /* 桶的上界(含) */
+
+uint32_t hist_serialize(const hist_t* h, void* buf, uint32_t size);         /* 返回字节数，空间不足返回0 */
+int hist_deserialize(hist_t* h, const void* buf, uint32_t size);            /* 成功返回0 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HIST_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,523 @@
+/**
+  ******************************************************************************
+  * @file    mem.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   按内存区域分配的动态内存实现
+  ******************************************************************************
+  * @attention
+  *
+  * 每个区域是一个TLSF(Two-Level Segregated Fit)堆，分配和释放都是O(1)：
+  * 1. 空闲块按大小分到两级链表：一级为最高位(2的幂区间)，二级把区间
+  *    再等分为MEM_SL_COUNT份；小于MEM_SMALL_BLOCK的块按8字节一级
+  * 2. 两级各有一个位图，非空链表对应的位为1，查找用CLZ/CTZ，不遍历
+  * 3. 分配时把请求大小向上取整到下一个二级区间的起点，该区间及以上的
+  *    任何块都足够大，取链表头即可，不需要在链表中搜索
+  * 4. 释放时借助块头部的prev_size与前后相邻空闲块立即合并
+  *
+  * 块布局(8字节对齐)：
+  *   prev_size  物理上前一块的大小，0表示区域首块
+  *   size       本块大小(含8字节头部)，bit0为1表示已分配
+  *   [next_free, prev_free]  仅空闲块，位于用户数据的位置
+  * 区域末尾是一个大小为0、标记为已分配的哨兵头部，合并时不会越过区域。
+  *
+  * 对齐分配：按最坏情况的前导长度多申请，用户数据地址向上对齐后，
+  * 前面空出的部分至少为一个最小块，作为独立的空闲块放回；尾部剩余
+  * 不小于最小块时同样拆出。
+  *
+  * 取整带来的内部浪费不超过1/MEM_SL_COUNT；区域不超过2^MEM_FL_MAX字节。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "mem.h"
+#include <stddef.h>
+
+/* Private define ------------------------------------------------------------*/
+#define MEM_ALIGN               8U
+#define MEM_HDR_SIZE            8U
+#define MEM_USED                1U
+#define MEM_ALIGN_UP(v, a)      (((v) + ((a) - 1U)) & ~((uintptr_t)(a) - 1U))
+#define MEM_MIN_BLOCK           MEM_ALIGN_UP(MEM_HDR_SIZE + 2U * sizeof(void*), MEM_ALIGN)
+
+#define MEM_SL_LOG2             3U                              /* 二级链表数的对数 */
+#define MEM_SL_COUNT            (1U << MEM_SL_LOG2)
+#define MEM_FL_SHIFT            (MEM_SL_LOG2 + 3U)              /* 3为MEM_ALIGN的对数 */
+#define MEM_SMALL_BLOCK         (1U << MEM_FL_SHIFT)            /* 小于此值的块线性分级 */
+#define MEM_FL_MAX              20U                             /* 块小于2^20字节 */
+#define MEM_FL_COUNT            (MEM_FL_MAX - MEM_FL_SHIFT + 1U)
+#define MEM_BLOCK_MAX           ((1UL << MEM_FL_MAX) - MEM_ALIGN)
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 块头部，空闲块的链表指针紧随其后 */
+typedef struct mem_block {
+    uint32_t prev_size;
+    uint32_t size;
+    struct mem_block* next_free;
+    struct mem_block* prev_free;
+} mem_block_t;
+
+/* 区域状态 */
+typedef struct {
+    const port_mem_region_t* desc;
+    uint8_t* start;             /* 对齐后的起始地址 */
+    uint8_t* end;               /* 哨兵头部之后 */
+    uint32_t fl_bitmap;         /* 非空的一级区间 */
+    uint32_t sl_bitmap[MEM_FL_COUNT];   /* 每个一级区间中非空的二级链表 */
+    mem_block_t* heads[MEM_FL_COUNT][MEM_SL_COUNT];
+    uint32_t size;
+    uint32_t used;
+    uint32_t peak;
+    uint32_t allocs;
+    uint32_t failures;
+    uint32_t free_blocks;
+} mem_region_t;
+
+/* Private variables ---------------------------------------------------------*/
+static mem_region_t mem_regions[RTOS_MEM_MAX_REGIONS];
+static uint32_t mem_region_count;
+static uint8_t mem_ready;
+
+/* Private functions ---------------------------------------------------------*/
+
+static mem_block_t* mem_next(mem_block_t* b)
+{
+    return (mem_block_t*)((uint8_t*)b + (b->size & ~MEM_USED));
+}
+
+static mem_block_t* mem_prev(mem_block_t* b)
+{
+    return b->prev_size ? (mem_block_t*)((uint8_t*)b - b->prev_size) : NULL;
+}
+
+/**
+  * @brief  块大小对应的链表
+  * @param  size: 块大小(含头部)
+  * @param  fl: 输出一级下标
+  * @param  sl: 输出二级下标
+  * @retval None
+  */
+static void mem_mapping(uint32_t size, uint32_t* fl, uint32_t* sl)
+{
+    uint32_t top;
+
+    if (size < MEM_SMALL_BLOCK) {
+        *fl = 0;
+        *sl = size / (MEM_SMALL_BLOCK / MEM_SL_COUNT);
+    } else {
+        top = 31U - (uint32_t)__builtin_clz(size);
+        *sl = (size >> (top - MEM_SL_LOG2)) ^ MEM_SL_COUNT;
+        *fl = top - (MEM_FL_SHIFT - 1U);
+    }
+}
+
+/**
+  * @brief  查找不小于size的空闲块
+  * @param  r: 区域
+  * @param  size: 块大小(含头部)
+  * @retval 空闲块(仍在链表中)，没有时返回NULL
+  * @note   size先取整到下一个二级区间的起点，找到的链表中任何块都足够大
+  */
+static mem_block_t* mem_find(mem_region_t* r, uint32_t size)
+{
+    uint32_t fl, sl, map;
+
+    if (size >= MEM_SMALL_BLOCK) {
+        size += (1U << (31U - (uint32_t)__builtin_clz(size) - MEM_SL_LOG2)) - 1U;
+    }
+    if (size > MEM_BLOCK_MAX) {
+        return NULL;
+    }
+    mem_mapping(size, &fl, &sl);
+
+    map = r->sl_bitmap[fl] & (~0U << sl);
+    if (map == 0U) {
+        map = r->fl_bitmap & (~0U << (fl + 1U));
+        if (map == 0U) {
+            return NULL;
+        }
+        fl = (uint32_t)__builtin_ctz(map);
+        map = r->sl_bitmap[fl];
+    }
+    sl = (uint32_t)__builtin_ctz(map);
+    return r->heads[fl][sl];
+}
+
+static void mem_list_insert(mem_region_t* r, mem_block_t* b)
+{
+    uint32_t fl, sl;
+
+    mem_mapping(b->size, &fl, &sl);
+    b->prev_free = NULL;
+    b->next_free = r->heads[fl][sl];
+    if (b->next_free) {
+        b->next_free->prev_free = b;
+    }
+    r->heads[fl][sl] = b;
+    r->sl_bitmap[fl] |= 1U << sl;
+    r->fl_bitmap |= 1U << fl;
+    r->free_blocks++;
+}
+
+static void mem_list_remove(mem_region_t* r, mem_block_t* b)
+{
+    uint32_t fl, sl;
+
+    mem_mapping(b->size, &fl, &sl);
+    if (b->prev_free) {
+        b->prev_free->next_free = b->next_free;
+    } else {
+        r->heads[fl][sl] = b->next_free;
+        if (b->next_free == NULL) {
+            r->sl_bitmap[fl] &= ~(1U << sl);
+            if (r->sl_bitmap[fl] == 0U) {
+                r->fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+    if (b->next_free) {
+        b->next_free->prev_free = b->prev_free;
+    }
+    r->free_blocks--;
+}
+
+/**
+  * @brief  把块b从offset处一分为二，后半部分为新的空闲块并加入链表
+  * @param  r: 区域
+  * @param  b: 被拆分的块(不在链表中)
+  * @param  offset: 前半部分的大小，不小于MEM_MIN_BLOCK
+  * @retval 后半部分
+  */
+static mem_block_t* mem_split(mem_region_t* r, mem_block_t* b, uint32_t offset)
+{
+    mem_block_t* rest = (mem_block_t*)((uint8_t*)b + offset);
+
+    rest->size = b->size - offset;
+    rest->prev_size = offset;
+    mem_next(rest)->prev_size = rest->size;
+    b->size = offset;
+    mem_list_insert(r, rest);
+    return rest;
+}
+
+/**
+  * @brief  从移植层读取区域表并建立每个区域的初始空闲块
+  * @param  None
+  * @retval None
+  * @note   在临界区内调用
+  */
+static void mem_init(void)
+{
+    const port_mem_region_t* desc;
+    uint32_t n = port_mem_regions(&desc);
+    uint32_t i;
+
+    if (n > RTOS_MEM_MAX_REGIONS) {
+        n = RTOS_MEM_MAX_REGIONS;
+    }
+    for (i = 0; i < n; i++) {
+        mem_region_t* r = &mem_regions[i];
+        uintptr_t start = MEM_ALIGN_UP((uintptr_t)desc[i].start, MEM_ALIGN);
+        uintptr_t end = (uintptr_t)desc[i].end & ~((uintptr_t)MEM_ALIGN - 1U);
+        mem_block_t* b;
+        mem_block_t* sentinel;
+
+        r->desc = &desc[i];
+        r->start = (uint8_t*)start;
+        r->end = (uint8_t*)start;
+        if (end <= start || end - start < MEM_MIN_BLOCK + MEM_HDR_SIZE) {
+            continue;               /* 区域为空或太小 */
+        }
+        if (end - start > MEM_BLOCK_MAX + MEM_HDR_SIZE) {
+            end = start + MEM_BLOCK_MAX + MEM_HDR_SIZE;     /* 超出的部分不使用 */
+        }
+
+        b = (mem_block_t*)start;
+        b->prev_size = 0;
+        b->size = (uint32_t)(end - start - MEM_HDR_SIZE);
+        sentinel = mem_next(b);
+        sentinel->prev_size = b->size;
+        sentinel->size = MEM_USED;
+        mem_list_insert(r, b);
+        r->end = (uint8_t*)end;
+        r->size = b->size;
+    }
+    mem_region_count = n;
+    mem_ready = 1;
+}
+
+/**
+  * @brief  在一个区域中分配
+  * @param  r: 区域
+  * @param  need: 用户数据字节数，已按MEM_ALIGN补齐
+  * @param  align: 用户数据对齐，不小于MEM_ALIGN
+  * @retval 用户数据地址，失败返回NULL
+  */
+static void* mem_region_alloc(mem_region_t* r, uint32_t need, uint32_t align)
+{
+    uint64_t want = (uint64_t)MEM_HDR_SIZE + need;
+    mem_block_t* b;
+    uintptr_t payload;
+    uintptr_t aligned;
+    uint32_t lead;
+
+    if (align > MEM_ALIGN) {
+        want += align + MEM_MIN_BLOCK;      /* 最坏情况的前导部分 */
+    }
+    b = (want > MEM_BLOCK_MAX) ? NULL : mem_find(r, (uint32_t)want);
+    if (b == NULL) {
+        r->failures++;
+        return NULL;
+    }
+
+    payload = (uintptr_t)b + MEM_HDR_SIZE;
+    aligned = MEM_ALIGN_UP(payload, align);
+    if (aligned != payload && aligned - payload < MEM_MIN_BLOCK) {
+        aligned = MEM_ALIGN_UP(payload + MEM_MIN_BLOCK, align);
+    }
+    lead = (uint32_t)(aligned - payload);
+
+    mem_list_remove(r, b);
+    if (lead > 0U) {
+        mem_block_t* head = b;
+        b = mem_split(r, head, lead);   /* 前导部分留作空闲块 */
+        mem_list_remove(r, b);
+        mem_list_insert(r, head);
+    }
+    if (b->size - (MEM_HDR_SIZE + need) >= MEM_MIN_BLOCK) {
+        (void)mem_split(r, b, MEM_HDR_SIZE + need);
+    }
+
+    b->size |= MEM_USED;
+    r->used += b->size & ~MEM_USED;
+    if (r->used > r->peak) {
+        r->peak = r->used;
+    }
+    r->allocs++;
+    return (uint8_t*)b + MEM_HDR_SIZE;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  按区域要求分配内存
+  * @param  size: 字节数
+  * @param  flags: RTOS_MEM_DMA和/或RTOS_MEM_FAST
+  * @retval 8字节对齐(DMA为RTOS_MEM_DMA_ALIGN)的地址，失败返回NULL
+  */
+void* rtos_alloc(uint32_t size, uint32_t flags)
+{
+    return rtos_alloc_aligned(size, MEM_ALIGN, flags);
+}
+
+/**
+  * @brief  按区域要求分配对齐的内存
+  * @param  size: 字节数
+  * @param  align: 对齐，2的幂
+  * @param  flags: RTOS_MEM_DMA和/或RTOS_MEM_FAST
+  * @retval 地址，失败返回NULL
+  * @note   第一轮只在首选区域中分配(有RTOS_MEM_FAST时为快速区域，否则为
+  *         普通区域)，失败后第二轮在其余区域中分配；RTOS_MEM_DMA在两轮中
+  *         都是硬性要求
+  */
+void* rtos_alloc_aligned(uint32_t size, uint32_t align, uint32_t flags)
+{
+    void* ptr = NULL;
+    uint32_t need, state, pass, i;
+
+    if (size == 0U || (align & (align - 1U)) != 0U) {
+        return NULL;
+    }
+    if (align < MEM_ALIGN) {
+        align = MEM_ALIGN;
+    }
+    need = size;
+    if (flags & RTOS_MEM_DMA) {
+        /* 长度也补齐，突发传输不会越过块尾触及相邻的数据 */
+        if (align < RTOS_MEM_DMA_ALIGN) {
+            align = RTOS_MEM_DMA_ALIGN;
+        }
+        need = (uint32_t)MEM_ALIGN_UP((uint64_t)need, RTOS_MEM_DMA_ALIGN);
+    }
+    need = (uint32_t)MEM_ALIGN_UP((uint64_t)need, MEM_ALIGN);
+    if (need < size) {
+        return NULL;                /* 补齐后溢出 */
+    }
+    if (need < MEM_MIN_BLOCK - MEM_HDR_SIZE) {
+        need = MEM_MIN_BLOCK - MEM_HDR_SIZE;   /* 释放后要容纳链表指针 */
+    }
+
+    state = port_enter_critical();
+    if (!mem_ready) {
+        mem_init();
+    }
+    for (pass = 0; pass < 2U && ptr == NULL; pass++) {
+        for (i = 0; i < mem_region_count && ptr == NULL; i++) {
+            mem_region_t* r = &mem_regions[i];
+            uint32_t caps = r->desc->caps;
+            int fast = (caps & RTOS_MEM_FAST) != 0U;
+            int preferred = (flags & RTOS_MEM_FAST) ? fast : !fast;
+
+            if ((flags & RTOS_MEM_DMA) && !(caps & RTOS_MEM_DMA)) {
+                continue;
+            }
+            if (preferred != (pass == 0U) || r->fl_bitmap == 0U) {
+                continue;
+            }
+            ptr = mem_region_alloc(r, need, align);
+        }
+    }
+    port_exit_critical(state);
+    return ptr;
+}
+
+/**
+  * @brief  释放rtos_alloc分配的内存
+  * @param  ptr: 地址，NULL时无操作
+  * @retval None
+  * @note   不属于任何区域或未分配(重复释放)的地址被忽略
+  */
+void rtos_free(void* ptr)
+{
+    mem_region_t* r;
+    mem_block_t* b;
+    mem_block_t* n;
+    mem_block_t* p;
+    uint32_t state;
+    int index;
+
+    if (ptr == NULL) {
+        return;
+    }
+
+    state = port_enter_critical();
+    index = rtos_mem_region_of(ptr);
+    b = (mem_block_t*)((uint8_t*)ptr - MEM_HDR_SIZE);
+    if (index < 0 || (b->size & MEM_USED) == 0U) {
+        port_exit_critical(state);
+        return;
+    }
+    r = &mem_regions[index];
+
+    b->size &= ~MEM_USED;
+    r->used -= b->size;
+    r->allocs--;
+
+    /* 与后一块、前一块合并 */
+    n = mem_next(b);
+    if ((n->size & MEM_USED) == 0U) {
+        mem_list_remove(r, n);
+        b->size += n->size;
+    }
+    p = mem_prev(b);
+    if (p != NULL && (p->size & MEM_USED) == 0U) {
+        mem_list_remove(r, p);
+        p->size += b->size;
+        b = p;
+    }
+    mem_next(b)->prev_size = b->size;
+    mem_list_insert(r, b);
+    port_exit_critical(state);
+}
+
+/**
+  * @brief  区域数
+  * @param  None
+  * @retval 移植层提供的区域数
+  */
+uint32_t rtos_mem_region_count(void)
+{
+    uint32_t state = port_enter_critical();
+
+    if (!mem_ready) {
+        mem_init();
+    }
+    port_exit_critical(state);
+    return mem_region_count;
+}
+
+/**
+  * @brief  读取区域的使用统计
+  * @param  region: 区域序号
+  * @param  stats: 输出
+  * @retval 成功返回0，序号无效返回-1
+  */
+int rtos_mem_get_stats(uint32_t region, rtos_mem_stats_t* stats)
+{
+    const mem_region_t* r;
+    const mem_block_t* b;
+    uint32_t state;
+
+    if (region >= rtos_mem_region_count() || stats == NULL) {
+        return -1;
+    }
+    r = &mem_regions[region];
+
+    state = port_enter_critical();
+    stats->name = r->desc->name;
+    stats->caps = r->desc->caps;
+    stats->size = r->size;
+    stats->used = r->used;
+    stats->peak = r->peak;
+    stats->allocs = r->allocs;
+    stats->failures = r->failures;
+    stats->free_blocks = r->free_blocks;
+    stats->largest_free = 0;
+    stats->fragmentation = 0;
+
+    /* 最大的块在最高的非空链表中，只需遍历这一条 */
+    if (r->fl_bitmap != 0U) {
+        uint32_t fl = 31U - (uint32_t)__builtin_clz(r->fl_bitmap);
+        uint32_t sl = 31U - (uint32_t)__builtin_clz(r->sl_bitmap[fl]);
+        uint32_t largest = 0;
+        uint32_t free_bytes = r->size - r->used;
+
+        for (b = r->heads[fl][sl]; b != NULL; b = b->next_free) {
+            if (b->size > largest) {
+                largest = b->size;
+            }
+        }
+        stats->largest_free = largest - MEM_HDR_SIZE;
+        stats->fragmentation = (uint32_t)(((uint64_t)(free_bytes - largest) * 100U) / free_bytes);
+    }
+    port_exit_critical(state);
+    return 0;
+}
+
+/**
+  * @brief  已分配块可用的字节数
+  * @param  ptr: rtos_alloc返回的地址
+  * @retval 字节数，不小于申请的大小；ptr无效时返回0
+  */
+uint32_t rtos_mem_usable_size(const void* ptr)
+{
+    const mem_block_t* b;
+
+    if (ptr == NULL || rtos_mem_region_of(ptr) < 0) {
+        return 0;
+    }
+    b = (const mem_block_t*)((const uint8_t*)ptr - MEM_HDR_SIZE);
+    return (b->size & MEM_USED) ? (b->size & ~MEM_USED) - MEM_HDR_SIZE : 0U;
+}
+
+/**
+  * @brief  地址所在的区域
+  * @param  ptr: 地址
+  * @retval 区域序号，不在任何区域中返回-1
+  */
+int rtos_mem_region_of(const void* ptr)
+{
+    uint32_t i;
+
+    for (i = 0; i < mem_region_count; i++) {
+        if ((const uint8_t*)ptr >= mem_regions[i].start && (const uint8_t*)ptr < mem_regions[i].end) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    mem.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   按内存区域分配的动态内存头文件
+  *          区分DMA可访问的SRAM和CPU专用的快速内存(CCM)
+  ******************************************************************************
+  * @attention
+  *
+  * 使用方法：
+  *   buf = rtos_alloc(512, RTOS_MEM_DMA);          DMA缓冲区，不会落在CCM
+  *   work = rtos_alloc(2048, RTOS_MEM_FAST);       计算用数据，优先放在CCM
+  *   rtos_free(buf);
+  *
+  * 区域由移植层的port_mem_regions给出(Cortex-M4为链接脚本中各段之后的
+  * CCM、SRAM1、SRAM2空闲部分)。选择规则：
+  * 1. RTOS_MEM_DMA是硬性要求，只在DMA可访问的区域中分配
+  * 2. RTOS_MEM_FAST是偏好，先在快速区域中分配，不足时退到其他区域
+  * 3. 两者都没有时先用普通区域，把快速内存留给有RTOS_MEM_FAST的请求
+  *
+  * DMA分配按RTOS_MEM_DMA_ALIGN对齐并补齐长度：4拍字突发为16字节，
+  * 对齐后一次突发不会跨越DMA要求的1KB地址边界。
+  *
+  * 每个区域是一个TLSF堆，分配和释放为O(1)，耗时与空闲块数无关，相邻
+  * 空闲块在释放时合并。操作在临界区内完成，可在任务和中断中调用。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __MEM_H__
+#define __MEM_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "port.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+#define RTOS_MEM_ANY            0U              /* 没有要求 */
+#define RTOS_MEM_DMA            PORT_MEM_DMA    /* 必须DMA可访问 */
+#define RTOS_MEM_FAST           PORT_MEM_FAST   /* 优先快速内存 */
+
+#ifndef RTOS_MEM_DMA_ALIGN
+#define RTOS_MEM_DMA_ALIGN      16U             /* DMA分配的最小对齐和长度粒度 */
+#endif
+
+#define RTOS_MEM_MAX_REGIONS    4U
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 区域使用统计 */
+typedef struct {
+    const char* name;
+    uint32_t caps;              /* RTOS_MEM_DMA/RTOS_MEM_FAST */
+    uint32_t size;              /* 区域总字节数 */
+    uint32_t used;              /* 已分配的字节数(含块头部) */
+    uint32_t peak;              /* used的高水位 */
+    uint32_t largest_free;      /* 最大空闲块可分配的字节数 */
+    uint32_t free_blocks;       /* 空闲块数 */
+    uint32_t fragmentation;     /* 碎片率(%)：不在最大空闲块中的空闲字节占比 */
+    uint32_t allocs;            /* 当前未释放的分配数 */
+    uint32_t failures;          /* 在此区域中失败的分配次数 */
+} rtos_mem_stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+void* rtos_alloc(uint32_t size, uint32_t flags);                    /* 失败返回NULL */
+void* rtos_alloc_aligned(uint32_t size, uint32_t align, uint32_t flags);   /* align为2的幂 */
+void rtos_free(void* ptr);                                          /* NULL时无操作 */
+
+uint32_t rtos_mem_region_count(void);
+int rtos_mem_get_stats(uint32_t region, rtos_mem_stats_t* stats);   /* 成功返回0 */
+int rtos_mem_region_of(const void* ptr);                            /* 地址所在区域，不在任何区域返回-1 */
+uint32_t rtos_mem_usable_size(const void* ptr);                     /* 已分配块可用的字节数 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MEM_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,260 @@
+/**
+  ******************************************************************************
+  * @file    pool.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   固定大小内存块池实现
+  ******************************************************************************
+  * @attention
+  *
+  * 分配先从已释放块的链表取，链表为空时再取fresh指向的新块；两者都
+  * 是一次原子操作，与块数无关。
+  *
+  * 阻塞等待不丢失唤醒：等待者在临界区内先增加waiting再检查池是否为空，
+  * 检查与挂起之间不会被打断；释放者先放回块再读取waiting，因此释放
+  * 要么发生在检查之前(等待者取到块)，要么能看到waiting并唤醒等待者。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "pool.h"
+#include "time.h"
+#include <stddef.h>
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  原子加1，返回新值
+  * @param  value: 计数器
+  * @retval 加1后的值
+  */
+static uint32_t pool_inc(volatile uint32_t* value)
+{
+    uint32_t old;
+
+    do {
+        old = *value;
+    } while (!port_atomic_cas(value, old, old + 1U));
+    return old + 1U;
+}
+
+/**
+  * @brief  原子减1
+  * @param  value: 计数器
+  * @retval None
+  */
+static void pool_dec(volatile uint32_t* value)
+{
+    uint32_t old;
+
+    do {
+        old = *value;
+    } while (!port_atomic_cas(value, old, old - 1U));
+}
+
+/**
+  * @brief  取出一个空闲块并更新使用计数，不计失败
+  * @param  pool: 池
+  * @retval 块地址，池空时返回NULL
+  */
+static void* pool_take(pool_t* pool)
+{
+    void* block = port_lifo_pop(&pool->free_list);
+    uint32_t index;
+    uint32_t used;
+    uint32_t peak;
+
+    /* 链表为空时取一个从未分配过的块 */
+    while (block == NULL) {
+        index = pool->fresh;
+        if (index >= pool->block_count) {
+            return NULL;
+        }
+        if (port_atomic_cas(&pool->fresh, index, index + 1U)) {
+            block = pool->storage + index * pool->block_size;
+        }
+    }
+
+    used = pool_inc(&pool->used);
+    do {
+        peak = pool->peak;
+    } while (used > peak && !port_atomic_cas(&pool->peak, peak, used));
+    return block;
+}
+
+/**
+  * @brief  池中是否还有可分配的块
+  * @param  pool: 池
+  * @retval 非0表示有
+  */
+static int pool_available(const pool_t* pool)
+{
+    return pool->free_list != NULL || pool->fresh < pool->block_count;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  在给定存储区上建立池
+  * @param  pool: 池
+  * @param  storage: 存储区，不小于POOL_BLOCK_BYTES(block_size) * block_count字节
+  * @param  block_size: 块大小，按POOL_BLOCK_BYTES补齐
+  * @param  block_count: 块数
+  * @param  name: 名称，可为NULL
+  * @retval None
+  * @note   池正在使用时不能重新初始化
+  */
+void pool_init(pool_t* pool, void* storage, uint32_t block_size, uint32_t block_count,
+               const char* name)
+{
+    pool->free_list = NULL;
+    pool->storage = (uint8_t*)storage;
+    pool->block_size = (uint32_t)POOL_BLOCK_BYTES(block_size);
+    pool->block_count = block_count;
+    pool->name = name;
+    pool->fresh = 0;
+    pool->used = 0;
+    pool->peak = 0;
+    pool->failures = 0;
+    pool->waiting = 0;
+    pool->waiters.head = NULL;
+    pool->waiters.tail = NULL;
+}
+
+/**
+  * @brief  分配一个块
+  * @param  pool: 池
+  * @retval 块地址，池空时返回NULL并计入失败次数
+  */
+void* pool_alloc(pool_t* pool)
+{
+    void* block = pool_take(pool);
+
+    if (block == NULL) {
+        pool_inc(&pool->failures);
+    }
+    return block;
+}
+
+/**
+  * @brief  分配一个块，池空时等待其他任务或中断释放
+  * @param  pool: 池
+  * @param  ticks: 最长等待的TIM2周期数，0表示不等待
+  * @retval 块地址，超时返回NULL并计入失败次数
+  * @note   中断中或调度器未运行时不等待
+  */
+void* pool_alloc_wait(pool_t* pool, uint32_t ticks)
+{
+    void* block;
+    uint32_t remaining = ticks;
+    uint32_t wait_ticks;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t primask;
+
+    if (port_in_isr() || !scheduler.running) {
+        ticks = 0;
+    }
+
+    for (;;) {
+        block = pool_take(pool);
+        if (block != NULL || ticks == 0 || remaining == 0) {
+            break;
+        }
+
+        primask = rtos_enter_critical();
+        pool->waiting++;
+        if (!pool_available(pool)) {
+            if (ticks == RTOS_WAIT_FOREVER) {
+                wait_ticks = RTOS_WAIT_FOREVER;
+            } else {
+                wait_ticks = (remaining > DELAY_MAX_CHUNK_TICKS) ? DELAY_MAX_CHUNK_TICKS : remaining;
+            }
+            start = port_timer_now();
+            (void)task_wait_timeout(&pool->waiters, wait_ticks);
+            rtos_exit_critical(primask);    /* 在此切换，被唤醒或超时后返回 */
+            primask = rtos_enter_critical();
+
+            if (ticks != RTOS_WAIT_FOREVER) {
+                elapsed = port_timer_now() - start;
+                remaining = (elapsed >= remaining) ? 0 : remaining - elapsed;
+            }
+        }
+        pool->waiting--;
+        rtos_exit_critical(primask);
+    }
+
+    if (block == NULL) {
+        pool_inc(&pool->failures);
+    }
+    return block;
+}
+
+/**
+  * @brief  释放一个块
+  * @param  pool: 池
+  * @param  block: pool_alloc返回的地址
+  * @retval None
+  * @note   不检查重复释放
+  */
+void pool_free(pool_t* pool, void* block)
+{
+    if (!pool_contains(pool, block)) {
+        return;
+    }
+
+    /* 先减计数再放回，其他任务或中断随即取走时used不会超过块数 */
+    pool_dec(&pool->used);
+    port_lifo_push(&pool->free_list, block);
+    if (pool->waiting != 0U) {
+        (void)task_wake_one(&pool->waiters);
+    }
+}
+
+/**
+  * @brief  地址是否为池中某块的起始地址
+  * @param  pool: 池
+  * @param  block: 地址
+  * @retval 非0表示是
+  */
+int pool_contains(const pool_t* pool, const void* block)
+{
+    uintptr_t offset;
+
+    if (block == NULL || (const uint8_t*)block < pool->storage) {
+        return 0;
+    }
+    offset = (uintptr_t)((const uint8_t*)block - pool->storage);
+    return offset < (uintptr_t)pool->block_size * pool->block_count &&
+           offset % pool->block_size == 0U;
+}
+
+/**
+  * @brief  读取池的使用统计
+  * @param  pool: 池
+  * @param  stats: 输出
+  * @retval None
+  */
+void pool_get_stats(pool_t* pool, pool_stats_t* stats)
+{
+    stats->name = pool->name;
+    stats->block_size = pool->block_size;
+    stats->block_count = pool->block_count;
+    stats->used = pool->used;
+    stats->peak = pool->peak;
+    stats->failures = pool->failures;
+}
+
+/**
+  * @brief  把高水位复位为当前使用数
+  * @param  pool: 池
+  * @retval None
+  */
+void pool_reset_peak(pool_t* pool)
+{
+    pool->peak = pool->used;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    pool.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   固定大小内存块池头文件
+  *          O(1)无锁分配和释放，可在中断中调用
+  ******************************************************************************
+  * @attention
+  *
+  * 使用方法：
+  *   POOL_DEFINE(msg_pool, sizeof(msg_t), 32);     静态定义，不需要初始化
+  *   msg = pool_alloc(&msg_pool);                  池空时返回NULL
+  *   msg = pool_alloc_wait(&msg_pool, MS_TO_TICKS(10));   池空时阻塞等待
+  *   pool_free(&msg_pool, msg);
+  *
+  * 实现：
+  * 1. 已释放的块组成单链表(LIFO)，链表指针存放在块的第一个字中；
+  *    取出和放回由移植层的port_lifo_pop/port_lifo_push完成，Cortex-M4上
+  *    为LDREX/STREX循环，不关中断
+  * 2. 从未分配过的块不在链表中，由fresh下标按顺序取出，因此池不需要
+  *    初始化循环，静态定义后即可使用
+  * 3. 使用计数、高水位和失败次数以port_atomic_cas更新
+  * 4. pool_alloc_wait在池空时挂起到池的等待队列；pool_free放回块后，
+  *    有任务等待时唤醒队首任务
+  *
+  * 块按POOL_ALIGN对齐，块大小按POOL_ALIGN补齐。块在池的存储区中，
+  * POOL_DEFINE的存储区在普通.bss(DMA可访问)，POOL_DEFINE_IN可指定放置
+  * 属性，例如PORT_FAST_BSS。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "core.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define POOL_ALIGN              8U              /* 块的对齐和大小粒度 */
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* 补齐后的块大小，不小于一个链表指针 */
+#define POOL_BLOCK_BYTES(size)                                                  \
+    ((((size) < sizeof(void*) ? sizeof(void*) : (size)) + (POOL_ALIGN - 1U)) & ~(POOL_ALIGN - 1U))
+
+/* 静态定义名为name的池，存储区带有放置属性attr */
+#define POOL_DEFINE_IN(name, size, count, attr)                                 \
+    static uint8_t name##_storage[POOL_BLOCK_BYTES(size) * (count)]             \
+        __attribute__((aligned(POOL_ALIGN))) attr;                             \
+    pool_t name = { NULL, name##_storage, (uint32_t)POOL_BLOCK_BYTES(size),     \
+                    (uint32_t)(count), #name, 0, 0, 0, 0, 0, { NULL, NULL } }
+
+/* 静态定义名为name的池，count个size字节的块 */
+#define POOL_DEFINE(name, size, count)  POOL_DEFINE_IN(name, size, count, )
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 内存块池 - 字段顺序与POOL_DEFINE_IN一致 */
+typedef struct pool {
+    void* volatile free_list;   /* 已释放块的链表 */
+    uint8_t* storage;           /* 存储区 */
+    uint32_t block_size;        /* 补齐后的块大小 */
+    uint32_t block_count;       /* 块数 */
+    const char* name;
+    volatile uint32_t fresh;    /* 下一个从未分配过的块的下标 */
+    volatile uint32_t used;     /* 当前已分配的块数 */
+    volatile uint32_t peak;     /* used的高水位 */
+    volatile uint32_t failures; /* 分配失败(含等待超时)次数 */
+    volatile uint32_t waiting;  /* 阻塞等待的任务数 */
+    wait_queue_t waiters;       /* 等待空闲块的任务 */
+} pool_t;
+
+/* 池使用统计 */
+typedef struct {
+    const char* name;
+    uint32_t block_size;
+    uint32_t block_count;
+    uint32_t used;
+    uint32_t peak;
+    uint32_t failures;
+} pool_stats_t;
+
+/* Exported functions ------------------------------------------------------- */
+void pool_init(pool_t* pool, void* storage, uint32_t block_size, uint32_t block_count,
+               const char* name);                   /* 运行时建立池，storage按POOL_ALIGN对齐 */
+void* pool_alloc(pool_t* pool);                     /* 池空时返回NULL，可在中断中调用 */
+void* pool_alloc_wait(pool_t* pool, uint32_t ticks);  /* 最多等待ticks个TIM2周期，RTOS_WAIT_FOREVER为无限等待 */
+void pool_free(pool_t* pool, void* block);          /* 可在中断中调用，NULL和不属于池的地址被忽略 */
+int pool_contains(const pool_t* pool, const void* block);   /* 是否为池中某块的起始地址 */
+void pool_get_stats(pool_t* pool, pool_stats_t* stats);
+void pool_reset_peak(pool_t* pool);                 /* 高水位复位为当前使用数 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __POOL_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,177 @@
+/**
+  ******************************************************************************
+  * @file    port.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   内核移植层接口
+  *          上下文切换、临界区、定时器和中断挂起由移植层实现，内核源码与硬件无关
+  ******************************************************************************
+  * @attention
+  *
+  * 目录结构：
+  * - port/cm4    STM32F407 (Cortex-M4F)，PendSV切换上下文，TIM2作为定时器
+  * - port/posix  Linux主机，ucontext切换上下文，SIGALRM模拟定时器中断
+  * 构建时只把其中一个目录加入头文件路径和源文件列表，目录下的port_cfg.h
+  * 提供移植相关的类型和常量。
+  *
+  * 移植层须满足的约定：
+  * 1. port_enter_critical/port_exit_critical可嵌套，屏蔽会调用内核的全部中断
+  * 2. port_pend_switch只挂起一次切换请求；请求在退出最外层临界区或中断
+  *    返回时执行，执行时调用rtos_switch_task选出下一个任务
+  * 3. 定时器是以TIM2_CLOCK_FREQ计数的32位自由运行计数器，带一个比较中断；
+  *    比较中断中调用Time_TimerIsr
+  * 4. port_cycles是以PORT_CYCLES_HZ计数的32位自由运行计数器，只用于性能测量
+  * 5. port_perf_read读取一组自由运行的性能计数器，cycles与port_cycles相同；
+  *    cpi/exc/lsu/fold只有PORT_PERF_EVENT_MASK内的位有效，没有的计数器为0
+  * 6. PORT_FAST_BSS把零初始化变量放到CPU专用的快速内存(可以不被DMA访问)，
+  *    PORT_DMA_BSS放到DMA可访问的内存；PORT_DMA_REACHABLE判断一段地址DMA
+  *    能否访问。PORT_FAST_NOINIT/PORT_DMA_NOINIT与前两者放在同类内存，但
+  *    启动时不清零，用于使用前由所有者初始化的任务栈和大缓冲区。没有这种
+  *    区分的移植层全部取默认值
+  * 7. port_mem_regions返回可供rtos_alloc分配的内存区域，按地址互不重叠，
+  *    同类区域按优先使用的顺序排列
+  * 8. port_lifo_pop/port_lifo_push/port_atomic_cas对任务和中断之间原子，
+  *    可以在中断中调用；单核Cortex-M以LDREX/STREX实现(异常进出会清除独占
+  *    监视器，因此LIFO没有ABA问题)，其他移植层可以在临界区内实现
+  * 9. 有栈保护的移植层把每个任务栈最低的PORT_STACK_GUARD_WORDS个字作为
+  *    保护区，当前任务访问保护区时触发故障并调用rtos_stack_overflow；
+  *    内核的栈检查和高水位统计不读写保护区。任务栈按PORT_STACK_ALIGN对齐
+  *
+  ******************************************************************************
+  */
+
+#ifndef __PORT_H__
+#define __PORT_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "port_cfg.h"
+
+/* Exported constants --------------------------------------------------------*/
+
+/* 任务控制块中移植层私有的字段，未定义时为空 */
+#ifndef PORT_TASK_FIELDS
+#define PORT_TASK_FIELDS
+#endif
+
+/* port_perf_read中cpi/exc/lsu/fold的有效位，Cortex-M4的DWT为8位 */
+#ifndef PORT_PERF_EVENT_MASK
+#define PORT_PERF_EVENT_MASK        0xFFFFFFFFUL
+#endif
+
+/* 快速内存中的零初始化变量，内核的任务控制块和栈默认放在这里 */
+#ifndef PORT_FAST_BSS
+#define PORT_FAST_BSS
+#endif
+
+/* DMA可访问内存中的零初始化变量 */
+#ifndef PORT_DMA_BSS
+#define PORT_DMA_BSS
+#endif
+
+/* 快速内存中启动时不清零的变量，内容在使用前由所有者初始化；默认同普通.bss */
+#ifndef PORT_FAST_NOINIT
+#define PORT_FAST_NOINIT
+#endif
+
+/* DMA可访问内存中启动时不清零的变量 */
+#ifndef PORT_DMA_NOINIT
+#define PORT_DMA_NOINIT
+#endif
+
+/* 地址范围[addr, addr+len)是否全部可被DMA访问 */
+#ifndef PORT_DMA_REACHABLE
+#define PORT_DMA_REACHABLE(addr, len)   1
+#endif
+
+/* 任务栈底保护区的字数，没有栈保护的移植层为0 */
+#ifndef PORT_STACK_GUARD_WORDS
+#define PORT_STACK_GUARD_WORDS      0
+#endif
+
+/* 任务栈除保护区和哨兵外至少需要的字数，RTOS_TASK_DEFINE在编译时检查 */
+#ifndef PORT_MIN_STACK_WORDS
+#define PORT_MIN_STACK_WORDS        64
+#endif
+
+/* 任务栈的对齐字节数，保护区的硬件可能要求更大的对齐 */
+#ifndef PORT_STACK_ALIGN
+#define PORT_STACK_ALIGN            8
+#endif
+
+/* 内存区域的属性 */
+#define PORT_MEM_DMA                0x01U       /* DMA可访问 */
+#define PORT_MEM_FAST               0x02U       /* CPU专用的快速内存 */
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 可分配的内存区域 */
+typedef struct {
+    const char* name;
+    uint8_t* start;             /* 起始地址 */
+    uint8_t* end;               /* 结束地址(不含) */
+    uint32_t caps;              /* PORT_MEM_xxx */
+} port_mem_region_t;
+
+/* 性能计数器快照 */
+typedef struct {
+    uint32_t cycles;            /* CPU周期，同port_cycles */
+    uint32_t cpi;               /* 多周期指令和停顿的额外周期 */
+    uint32_t exc;               /* 异常进入和退出的开销周期 */
+    uint32_t sleep;             /* 睡眠周期 */
+    uint32_t lsu;               /* 加载/存储的额外周期 */
+    uint32_t fold;              /* 折叠指令数 */
+} port_perf_t;
+
+/* Exported functions ------------------------------------------------------- */
+
+struct task;
+
+/* 临界区 - 返回进入前的屏蔽状态(非0表示已屏蔽) */
+uint32_t port_enter_critical(void);
+void port_exit_critical(uint32_t state);
+int port_in_isr(void);                          /* 当前是否处于中断上下文 */
+
+/* 上下文 */
+void port_task_init(struct task* task);         /* 在task->stack的stack_size个字上构造首次运行时的上下文 */
+void port_start_first_task(void);               /* 切换到scheduler.current_task */
+void port_pend_switch(void);                    /* 挂起一次任务切换请求 */
+void port_idle(void);                           /* 空闲任务中等待中断 */
+
+/* 定时器 */
+void port_timer_init(void);
+void port_timer_deinit(void);
+uint32_t port_timer_now(void);                  /* 当前计数值 */
+void port_timer_set_compare(uint32_t target);   /* 设置比较值，目标已过去时立即触发 */
+void port_timer_cancel(void);                   /* 关闭比较中断 */
+
+/* 周期计数 - 频率为port_cfg.h中的PORT_CYCLES_HZ */
+uint32_t port_cycles(void);
+void port_perf_read(port_perf_t* perf);         /* 读取性能计数器快照 */
+
+/* 内存区域 - 返回区域数，*regions指向区域表 */
+uint32_t port_mem_regions(const port_mem_region_t** regions);
+
+/* 原子操作 - 链表节点的第一个字为next指针 */
+void* port_lifo_pop(void* volatile* head);      /* 取出链表头，链表为空返回NULL */
+void port_lifo_push(void* volatile* head, void* node);  /* 放回链表头 */
+int port_atomic_cas(volatile uint32_t* addr, uint32_t expected, uint32_t desired);  /* *addr等于expected时写入desired，成功返回非0 */
+
+/* 内核提供给移植层的回调 */
+struct task* rtos_switch_task(void);            /* 选出下一个任务并设为当前任务 */
+void rtos_task_exit(void);                      /* 任务函数返回后调用，不返回 */
+void rtos_stack_overflow(struct task* task);    /* 检测到任务栈溢出 */
+void Time_TimerIsr(void);                       /* 定时器比较中断 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PORT_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
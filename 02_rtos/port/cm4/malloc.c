@@ -0,0 +1,211 @@
+/**
+  ******************************************************************************
+  * @file    malloc.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   newlib内存分配接口
+  *          malloc/free等接到rtos_alloc的TLSF堆，以内核互斥锁保护
+  ******************************************************************************
+  * @attention
+  *
+  * 替换newlib-nano的分配器：
+  * 1. malloc、free、realloc、calloc、memalign及其_r版本在此定义，链接时
+  *    不再从libc中取nano-mallocr，链接脚本也不再为_sbrk保留内存；
+  *    end之后直到RAM末尾的全部空闲内存都由02_rtos/mem.c管理
+  * 2. __malloc_lock/__malloc_unlock以rtos_mutex_t实现，可在同一任务中
+  *    重复加锁；newlib内部和本文件的每个接口都先加锁，任务之间互斥，
+  *    等待的任务挂起而不是关中断
+  * 3. 内存按RTOS_MEM_DMA分配，与原来的newlib堆一样只在SRAM中，可用作
+  *    DMA缓冲区；CCM留给rtos_alloc(RTOS_MEM_FAST)
+  * 4. _sbrk总是失败，防止libnosys的实现越过end改写堆
+  *
+  * malloc只能在任务中或调度器启动前调用，中断中使用pool_alloc或rtos_alloc。
+  * 中断中rtos_mutex_lock不能等待而失败，__malloc_lock/__malloc_unlock在中断中
+  * 直接返回，不会解开被打断任务持有的锁；此时堆不受保护，被打断的任务正在
+  * 分配或释放时堆会被破坏，因此中断中(包括经newlib stdio)不得调用malloc。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "mem.h"
+#include <errno.h>
+#include <reent.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define MALLOC_FLAGS            RTOS_MEM_DMA
+
+/* Private variables ---------------------------------------------------------*/
+static rtos_mutex_t malloc_mutex;
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  newlib分配器加锁
+  * @param  r: 重入结构
+  * @retval None
+  */
+void __malloc_lock(struct _reent* r)
+{
+    (void)r;
+    if (port_in_isr()) {
+        return;     /* 不能等待，与__malloc_unlock一致地跳过 */
+    }
+    (void)rtos_mutex_lock(&malloc_mutex, RTOS_WAIT_FOREVER);
+}
+
+/**
+  * @brief  newlib分配器解锁
+  * @param  r: 重入结构
+  * @retval None
+  */
+void __malloc_unlock(struct _reent* r)
+{
+    (void)r;
+    if (port_in_isr()) {
+        return;     /* __malloc_lock没有加锁 */
+    }
+    rtos_mutex_unlock(&malloc_mutex);
+}
+
+/**
+  * @brief  按对齐分配
+  * @param  r: 重入结构
+  * @param  align: 对齐，2的幂
+  * @param  size: 字节数，0按1字节分配
+  * @retval 地址，失败返回NULL并置ENOMEM
+  */
+void* _memalign_r(struct _reent* r, size_t align, size_t size)
+{
+    void* ptr;
+
+    __malloc_lock(r);
+    ptr = rtos_alloc_aligned(size ? (uint32_t)size : 1U, (uint32_t)align, MALLOC_FLAGS);
+    __malloc_unlock(r);
+    if (ptr == NULL) {
+        r->_errno = ENOMEM;
+    }
+    return ptr;
+}
+
+/**
+  * @brief  分配
+  * @param  r: 重入结构
+  * @param  size: 字节数
+  * @retval 地址，失败返回NULL并置ENOMEM
+  */
+void* _malloc_r(struct _reent* r, size_t size)
+{
+    return _memalign_r(r, 0U, size);
+}
+
+/**
+  * @brief  释放
+  * @param  r: 重入结构
+  * @param  ptr: 地址，NULL时无操作
+  * @retval None
+  */
+void _free_r(struct _reent* r, void* ptr)
+{
+    __malloc_lock(r);
+    rtos_free(ptr);
+    __malloc_unlock(r);
+}
+
+/**
+  * @brief  分配并清零
+  * @param  r: 重入结构
+  * @param  count: 元素数
+  * @param  size: 元素大小
+  * @retval 地址，溢出或失败返回NULL并置ENOMEM
+  */
+void* _calloc_r(struct _reent* r, size_t count, size_t size)
+{
+    void* ptr;
+
+    if (size != 0U && count > (size_t)-1 / size) {
+        r->_errno = ENOMEM;
+        return NULL;
+    }
+    ptr = _malloc_r(r, count * size);
+    if (ptr != NULL) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+/**
+  * @brief  调整大小
+  * @param  r: 重入结构
+  * @param  ptr: 原地址，NULL时等同于malloc
+  * @param  size: 新字节数，0时释放并返回NULL
+  * @retval 新地址，失败返回NULL并置ENOMEM，原内存不变
+  * @note   块中剩余空间足够时原地返回，否则分配新块并拷贝，整个过程持有锁
+  */
+void* _realloc_r(struct _reent* r, void* ptr, size_t size)
+{
+    void* out;
+    uint32_t old_size;
+
+    if (ptr == NULL) {
+        return _malloc_r(r, size);
+    }
+    if (size == 0U) {
+        _free_r(r, ptr);
+        return NULL;
+    }
+
+    __malloc_lock(r);
+    old_size = rtos_mem_usable_size(ptr);
+    if (old_size >= size) {
+        out = ptr;
+    } else {
+        out = rtos_alloc((uint32_t)size, MALLOC_FLAGS);
+        if (out != NULL) {
+            memcpy(out, ptr, old_size);
+            rtos_free(ptr);
+        }
+    }
+    __malloc_unlock(r);
+    if (out == NULL) {
+        r->_errno = ENOMEM;
+    }
+    return out;
+}
+
+/**
+  * @brief  已分配块可用的字节数
+  * @param  r: 重入结构
+  * @param  ptr: 地址
+  * @retval 字节数
+  */
+size_t _malloc_usable_size_r(struct _reent* r, void* ptr)
+{
+    (void)r;
+    return rtos_mem_usable_size(ptr);
+}
+
+void* malloc(size_t size) { return _malloc_r(_REENT, size); }
+void free(void* ptr) { _free_r(_REENT, ptr); }
+void* calloc(size_t count, size_t size) { return _calloc_r(_REENT, count, size); }
+void* realloc(void* ptr, size_t size) { return _realloc_r(_REENT, ptr, size); }
+void* memalign(size_t align, size_t size) { return _memalign_r(_REENT, align, size); }
+size_t malloc_usable_size(void* ptr) { return _malloc_usable_size_r(_REENT, ptr); }
+
+/**
+  * @brief  堆扩展 - 堆由mem.c管理，总是失败
+  * @param  incr: 增量
+  * @retval (void*)-1
+  */
+void* _sbrk(ptrdiff_t incr)
+{
+    (void)incr;
+    errno = ENOMEM;
+    return (void*)-1;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,528 @@
+/**
+  ******************************************************************************
+  * @file    port.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   Cortex-M4F移植层实现
+  *          PendSV上下文切换、SVC启动首个任务、PRIMASK临界区和TIM2定时器
+  ******************************************************************************
+  * @attention
+  *
+  * 实现原理：
+  * 1. 任务运行在线程模式并使用PSP，中断和内核切换路径使用MSP
+  * 2. PendSV设为最低优先级，挂起的切换在所有中断返回后才执行；
+  *    PRIMASK同时屏蔽PendSV，因此切换总是发生在退出最外层临界区时
+  * 3. PendSV只负责保存和恢复寄存器，选择任务由rtos_switch_task完成，
+  *    汇编中不依赖任何结构体偏移
+  * 4. 任务使用过FPU时(EXC_RETURN bit4为0)额外保存S16-S31
+  * 5. TIM2以84MHz自由运行，比较通道1作为延时链表的到期中断
+  * 6. PORT_MPU_STACK_GUARD为1时MPU区域7是当前任务栈底的32字节禁止访问区，
+  *    切换路径的C部分改写RBAR使其跟随当前任务；stm32f4xx_it.c中的
+  *    MemManage_Handler和HardFault_Handler直接跳转到port_fault_handler。
+  *    每次切换多5条指令(取栈地址、取RBAR地址、ORR、STR RBAR、DSB)：按M4 TRM
+  *    的指令周期约6~8个周期(DSB为1+等待写缓冲排空，RBAR在PPB上无等待)，
+  *    llvm-mca(cortex-m4)给出6个周期；为0时没有这部分开销。未在板上实测，
+  *    实测值为make MPU_GUARD=0与默认构建的bench_ccm switch项之差
+  *
+  * stm32f4xx_it.c中的PendSV_Handler和SVC_Handler须为naked函数并直接跳转到
+  * 本文件的处理函数，否则EXC_RETURN会被C函数调用覆盖。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "stm32f4xx.h"
+#include <stddef.h>
+
+/* Private variables ---------------------------------------------------------*/
+static volatile uint32_t port_sleep_cycles;     /* WFI累计周期，RTOS_PERF_ENABLE时更新 */
+static port_mem_region_t port_regions[3];       /* CCM、SRAM1、SRAM2 */
+
+/* 链接脚本定义的空闲内存边界 */
+extern uint8_t __ccm_heap_start[], __ccm_heap_end[];
+extern uint8_t __sram_heap_start[], __sram_heap_end[];
+
+/* Private function prototypes -----------------------------------------------*/
+uint32_t* port_switch_context(uint32_t* sp);
+uint32_t* port_first_context(void);
+void port_fault_handler(void);
+void __attribute__((naked)) pend_sv_handler(void);
+void __attribute__((naked)) svc_handler(void);
+static void __attribute__((naked)) port_svc_start(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  切换路径的C部分（由PendSV调用，中断已屏蔽）
+  * @param  sp: 当前任务保存完寄存器后的栈指针
+  * @retval 下一个任务的栈指针
+  */
+uint32_t* port_switch_context(uint32_t* sp)
+{
+    task_t* next;
+
+    scheduler.current_task->stack_ptr = sp;
+    next = rtos_switch_task();
+#if PORT_MPU_STACK_GUARD
+    /* RBAR带VALID位同时选择区域，大小和属性不变，一次写入即完成移动 */
+    MPU->RBAR = (uint32_t)next->stack | MPU_RBAR_VALID_Msk | PORT_MPU_GUARD_REGION;
+    __DSB();
+#endif
+    return next->stack_ptr;
+}
+
+/**
+  * @brief  返回首个任务的栈指针（由SVC 0调用）
+  * @param  None
+  * @retval 栈指针
+  */
+uint32_t* port_first_context(void)
+{
+    return scheduler.current_task->stack_ptr;
+}
+
+/**
+  * @brief  MemManage和HardFault处理（由stm32f4xx_it.c的故障处理函数跳转）
+  * @param  None
+  * @retval None
+  * @note   PRIMASK置位时MemManage升级为HardFault，两者都到这里，由CFSR判断：
+  *         异常压栈或FPU惰性压栈越界(MSTKERR/MLSPERR)，或访问地址落在当前
+  *         任务的保护区时按栈溢出处理，调用rtos_stack_overflow；该函数返回
+  *         或是其他故障时停在此处，调试器可从SCB->CFSR、SCB->HFSR和
+  *         SCB->MMFAR查看原因
+  */
+void port_fault_handler(void)
+{
+    task_t* task = scheduler.current_task;
+    uint32_t cfsr = SCB->CFSR;
+
+    __disable_irq();
+#if PORT_MPU_STACK_GUARD
+    if (scheduler.running && task != NULL &&
+        ((cfsr & (SCB_CFSR_MSTKERR_Msk | SCB_CFSR_MLSPERR_Msk)) != 0U ||
+         ((cfsr & SCB_CFSR_MMARVALID_Msk) != 0U &&
+          SCB->MMFAR - (uint32_t)task->stack < PORT_STACK_GUARD_WORDS * 4U))) {
+        rtos_stack_overflow(task);
+    }
+#else
+    (void)task;
+    (void)cfsr;
+#endif
+    for (;;) {
+    }
+}
+
+/**
+  * @brief  PendSV中断处理函数 - 执行实际的上下文切换
+  * @param  None
+  * @retval None
+  */
+void __attribute__((naked)) pend_sv_handler(void)
+{
+    __asm volatile(
+        "mrs r0, psp\n"                 /* 当前任务的栈指针，硬件已压入R0-R3,R12,LR,PC,xPSR */
+        "isb\n"
+#if (__FPU_USED == 1U)
+        "tst lr, #0x10\n"               /* EXC_RETURN bit4为0表示任务使用过FPU */
+        "it eq\n"
+        "vstmdbeq r0!, {s16-s31}\n"
+#endif
+        "stmdb r0!, {r4-r11, lr}\n"     /* 保存R4-R11和EXC_RETURN */
+
+        "cpsid i\n"                     /* 选择任务期间屏蔽中断 */
+        "bl port_switch_context\n"      /* r0 = 下一个任务的栈指针 */
+        "cpsie i\n"
+
+        "ldmia r0!, {r4-r11, lr}\n"     /* 恢复R4-R11和EXC_RETURN */
+#if (__FPU_USED == 1U)
+        "tst lr, #0x10\n"
+        "it eq\n"
+        "vldmiaeq r0!, {s16-s31}\n"
+#endif
+        "msr psp, r0\n"
+        "isb\n"
+        "bx lr\n"                       /* 异常返回，硬件恢复其余寄存器 */
+    );
+}
+
+/**
+  * @brief  SVC中断处理函数 - SVC 0启动首个任务
+  * @param  None
+  * @retval None
+  */
+void __attribute__((naked)) svc_handler(void)
+{
+    __asm volatile(
+        "tst lr, #4\n"                  /* 检查使用的是主堆栈还是进程堆栈 */
+        "ite eq\n"
+        "mrseq r0, msp\n"
+        "mrsne r0, psp\n"
+
+        "ldr r1, [r0, #24]\n"           /* 从堆栈中加载PC值（SVC调用地址） */
+        "ldrb r1, [r1, #-2]\n"          /* 读取SVC指令的操作数 */
+        "cmp r1, #0\n"
+        "bne 1f\n"                      /* 不处理其他SVC调用 */
+
+        "bl port_first_context\n"       /* r0 = 首个任务的栈指针 */
+        "ldmia r0!, {r4-r11, lr}\n"     /* 初始帧中的EXC_RETURN：线程模式+PSP */
+        "msr psp, r0\n"
+        "isb\n"
+        "bx lr\n"
+
+        "1:\n"
+        "bx lr\n"
+    );
+}
+
+/**
+  * @brief  复位主栈并通过SVC 0进入首个任务
+  * @param  None
+  * @retval None
+  */
+static void __attribute__((naked)) port_svc_start(void)
+{
+    __asm volatile(
+        "ldr r0, =0xE000ED08\n"         /* SCB->VTOR */
+        "ldr r0, [r0]\n"
+        "ldr r0, [r0]\n"                /* 向量表首项为主栈初值 */
+        "msr msp, r0\n"                 /* main的栈帧不再使用，留给中断 */
+        "cpsie i\n"
+        "cpsie f\n"
+        "dsb\n"
+        "isb\n"
+        "svc 0\n"
+        "nop\n"
+    );
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  进入临界区 - 屏蔽可屏蔽中断并返回原PRIMASK
+  * @param  None
+  * @retval 进入前的PRIMASK
+  */
+uint32_t port_enter_critical(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    return primask;
+}
+
+/**
+  * @brief  退出临界区 - 恢复进入前的PRIMASK
+  * @param  state: port_enter_critical的返回值
+  * @retval None
+  */
+void port_exit_critical(uint32_t state)
+{
+    __set_PRIMASK(state);
+}
+
+/**
+  * @brief  当前是否处于中断上下文
+  * @param  None
+  * @retval 非0表示在中断中
+  */
+int port_in_isr(void)
+{
+    return __get_IPSR() != 0;
+}
+
+/**
+  * @brief  构造任务首次运行时的栈帧
+  * @param  task: 任务指针，task_func和arg已设置
+  * @retval None
+  * @note   硬件异常帧须8字节对齐；任务函数返回时进入rtos_task_exit
+  */
+void port_task_init(struct task* task)
+{
+    uint32_t* sp = (uint32_t*)((uint32_t)&task->stack[task->stack_size] & ~0x7UL);
+    uint32_t i;
+
+    /* 硬件异常帧 */
+    *(--sp) = PORT_INITIAL_XPSR;                    /* xPSR */
+    *(--sp) = (uint32_t)task->task_func & ~0x1UL;   /* PC - 任务入口地址 */
+    *(--sp) = (uint32_t)rtos_task_exit;             /* LR - 任务函数返回后删除任务 */
+    *(--sp) = 0;                                    /* R12 */
+    *(--sp) = 0;                                    /* R3 */
+    *(--sp) = 0;                                    /* R2 */
+    *(--sp) = 0;                                    /* R1 */
+    *(--sp) = (uint32_t)task->arg;                  /* R0 - 任务参数 */
+
+    /* 软件保存部分 */
+    *(--sp) = PORT_INITIAL_EXC_RETURN;              /* EXC_RETURN */
+    for (i = 0; i < 8; i++) {
+        *(--sp) = 0;                                /* R11-R4 */
+    }
+
+    task->stack_ptr = sp;
+}
+
+/**
+  * @brief  启动首个任务
+  * @param  None
+  * @retval None
+  */
+void port_start_first_task(void)
+{
+    NVIC_SetPriority(SVCall_IRQn, 0);       /* SVC中断优先级设为最高 */
+    NVIC_SetPriority(PendSV_IRQn, 15);      /* PendSV中断优先级设为最低 */
+
+#if PORT_MPU_STACK_GUARD
+    /* 32字节(SIZE=4)、AP=000禁止访问、XN；其余地址按默认映射 */
+    MPU->RBAR = (uint32_t)scheduler.current_task->stack | MPU_RBAR_VALID_Msk | PORT_MPU_GUARD_REGION;
+    MPU->RASR = MPU_RASR_XN_Msk | (4UL << MPU_RASR_SIZE_Pos) | MPU_RASR_ENABLE_Msk;
+    MPU->CTRL = MPU_CTRL_PRIVDEFENA_Msk | MPU_CTRL_ENABLE_Msk;
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk;
+    __DSB();
+    __ISB();
+#endif
+
+    port_svc_start();
+}
+
+/**
+  * @brief  挂起一次任务切换请求(PendSV)
+  * @param  None
+  * @retval None
+  */
+void port_pend_switch(void)
+{
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+/**
+  * @brief  空闲任务中等待中断
+  * @param  None
+  * @retval None
+  */
+void port_idle(void)
+{
+#if RTOS_PERF_ENABLE
+    uint32_t start;
+
+    /* 屏蔽中断时WFI仍可被唤醒，先记录睡眠周期再响应中断 */
+    __disable_irq();
+    start = DWT->CYCCNT;
+    __DSB();
+    __WFI();
+    port_sleep_cycles += DWT->CYCCNT - start;
+    __enable_irq();
+#else
+    __WFI();
+#endif
+}
+
+/**
+  * @brief  TIM2定时器配置
+  * @param  None
+  * @retval None
+  * @note   比较中断在port_timer_set_compare中使能
+  */
+void port_timer_init(void)
+{
+    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
+    TIM_OCInitTypeDef TIM_OCInitStructure;
+
+    /* 使能TIM2时钟 */
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
+
+    /* 配置TIM2时基单元 */
+    TIM_TimeBaseStructure.TIM_Period = 0xFFFFFFFF;        /* 32位最大值 */
+    TIM_TimeBaseStructure.TIM_Prescaler = 0;              /* 无分频，直接使用84MHz */
+    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
+    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
+    TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure);
+
+    /* 配置TIM2输出比较通道1 */
+    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;   /* 输出比较模式：定时模式 */
+    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable; /* 禁用输出 */
+    TIM_OCInitStructure.TIM_Pulse = 0;                    /* 初始比较值 */
+    TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
+    TIM_OC1Init(TIM2, &TIM_OCInitStructure);
+    TIM_OC1PreloadConfig(TIM2, TIM_OCPreload_Disable);
+
+    /* 设置TIM2中断优先级 */
+    NVIC_SetPriority(TIM2_IRQn, PORT_TIMER_IRQ_PRIORITY);
+    NVIC_EnableIRQ(TIM2_IRQn);
+
+    /* 启动TIM2 */
+    TIM_Cmd(TIM2, ENABLE);
+
+    /* port_cycles使用DWT周期计数器，不清零 */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#if RTOS_PERF_ENABLE
+    DWT->CTRL |= DWT_CTRL_CPIEVTENA_Msk | DWT_CTRL_EXCEVTENA_Msk |
+                 DWT_CTRL_LSUEVTENA_Msk | DWT_CTRL_FOLDEVTENA_Msk;
+#endif
+}
+
+/**
+  * @brief  停止TIM2及其中断
+  * @param  None
+  * @retval None
+  */
+void port_timer_deinit(void)
+{
+    TIM_Cmd(TIM2, DISABLE);
+    TIM_ITConfig(TIM2, TIM_IT_CC1, DISABLE);
+    NVIC_DisableIRQ(TIM2_IRQn);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, DISABLE);
+}
+
+/**
+  * @brief  读取TIM2计数值
+  * @param  None
+  * @retval 当前计数值
+  */
+uint32_t port_timer_now(void)
+{
+    return TIM2->CNT;
+}
+
+/**
+  * @brief  读取DWT周期计数
+  * @param  None
+  * @retval CPU周期数，须先调用port_timer_init
+  */
+uint32_t port_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+  * @brief  读取DWT性能计数器
+  * @param  perf: 输出快照
+  * @retval None
+  * @note   CPICNT/EXCCNT/LSUCNT/FOLDCNT为8位(PORT_PERF_EVENT_MASK)，两次读取
+  *         之间超过256个事件的部分丢失；睡眠周期的8位SLEEPCNT在一次WFI内
+  *         就会回绕，改由port_idle以CYCCNT计时
+  */
+void port_perf_read(port_perf_t* perf)
+{
+    perf->cycles = DWT->CYCCNT;
+    perf->cpi = DWT->CPICNT;
+    perf->exc = DWT->EXCCNT;
+    perf->sleep = port_sleep_cycles;
+    perf->lsu = DWT->LSUCNT;
+    perf->fold = DWT->FOLDCNT;
+}
+
+/**
+  * @brief  可供rtos_alloc分配的内存区域
+  * @param  regions: 输出区域表
+  * @retval 区域数
+  * @note   SRAM的空闲部分在SRAM1/SRAM2分界处拆开，.bss已越过分界时SRAM1区域为空
+  */
+uint32_t port_mem_regions(const port_mem_region_t** regions)
+{
+    uint8_t* sram2 = (uint8_t*)PORT_SRAM2_BASE;
+    uint8_t* split = (__sram_heap_start > sram2) ? __sram_heap_start : sram2;
+
+    port_regions[0] = (port_mem_region_t){ "ccm", __ccm_heap_start, __ccm_heap_end, PORT_MEM_FAST };
+    port_regions[1] = (port_mem_region_t){ "sram1", __sram_heap_start, split, PORT_MEM_DMA };
+    port_regions[2] = (port_mem_region_t){ "sram2", split, __sram_heap_end, PORT_MEM_DMA };
+    *regions = port_regions;
+    return 3;
+}
+
+/**
+  * @brief  原子取出链表头
+  * @param  head: 链表头指针
+  * @retval 取出的节点，链表为空返回NULL
+  * @note   LDREX与STREX之间发生异常时独占监视器被清除，STREX失败后重试；
+  *         因此读取node->next时节点不会被中断取走再放回(无ABA问题)
+  */
+void* port_lifo_pop(void* volatile* head)
+{
+    void* node;
+
+    do {
+        node = (void*)__LDREXW((volatile uint32_t*)head);
+        if (node == NULL) {
+            __CLREX();
+            return NULL;
+        }
+    } while (__STREXW((uint32_t)*(void**)node, (volatile uint32_t*)head) != 0U);
+    return node;
+}
+
+/**
+  * @brief  原子放回链表头
+  * @param  head: 链表头指针
+  * @param  node: 节点
+  * @retval None
+  */
+void port_lifo_push(void* volatile* head, void* node)
+{
+    void* top;
+
+    do {
+        top = (void*)__LDREXW((volatile uint32_t*)head);
+        *(void**)node = top;
+    } while (__STREXW((uint32_t)node, (volatile uint32_t*)head) != 0U);
+}
+
+/**
+  * @brief  比较并交换
+  * @param  addr: 地址
+  * @param  expected: 期望的旧值
+  * @param  desired: 新值
+  * @retval 写入成功返回1，*addr不等于expected返回0
+  */
+int port_atomic_cas(volatile uint32_t* addr, uint32_t expected, uint32_t desired)
+{
+    do {
+        if (__LDREXW(addr) != expected) {
+            __CLREX();
+            return 0;
+        }
+    } while (__STREXW(desired, addr) != 0U);
+    return 1;
+}
+
+/**
+  * @brief  设置TIM2比较值并使能比较中断
+  * @param  target: 目标计数值
+  * @retval None
+  * @note   设置时目标已经过去则软件触发一次CC1事件，避免等待计数器回绕
+  */
+void port_timer_set_compare(uint32_t target)
+{
+    TIM_SetCompare1(TIM2, target);
+    TIM_ITConfig(TIM2, TIM_IT_CC1, ENABLE);
+    if ((int32_t)(TIM_GetCounter(TIM2) - target) >= 0) {
+        TIM_GenerateEvent(TIM2, TIM_EventSource_CC1);
+    }
+}
+
+/**
+  * @brief  关闭TIM2比较中断
+  * @param  None
+  * @retval None
+  */
+void port_timer_cancel(void)
+{
+    TIM_ITConfig(TIM2, TIM_IT_CC1, DISABLE);
+    TIM_ClearITPendingBit(TIM2, TIM_IT_CC1);
+}
+
+/**
+  * @brief  TIM2中断处理函数（由stm32f4xx_it.c调用）
+  * @param  None
+  * @retval None
+  */
+void TIM2_IRQHandler_Internal(void)
+{
+    if (TIM_GetITStatus(TIM2, TIM_IT_CC1) != RESET) {
+        TIM_ClearITPendingBit(TIM2, TIM_IT_CC1);
+        Time_TimerIsr();
+    }
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    port_cfg.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   Cortex-M4F移植层配置
+  ******************************************************************************
+  * @attention
+  *
+  * 任务栈初始帧(低地址在前)：
+  *   R4-R11, EXC_RETURN      软件保存，PendSV入栈
+  *   [S16-S31]               仅当任务使用过FPU时由PendSV保存
+  *   R0-R3, R12, LR, PC, xPSR 硬件异常帧，[S0-S15, FPSCR]由硬件惰性保存
+  *
+  * 内存布局(EIDE/STM32F407VGTx_FLASH.ld)：
+  *   0x10000000 CCM 64KB     只连接到CPU的D总线，DMA不能访问，不与DMA争用总线矩阵；
+  *                           主栈、.ccm_bss(PORT_FAST_BSS)和.noinit.ccm(PORT_FAST_NOINIT)
+  *   0x20000000 SRAM1/SRAM2  DMA可访问；.data、.bss、.dma_bss(PORT_DMA_BSS)和
+  *                           .noinit(PORT_DMA_NOINIT)
+  * .noinit段在链接脚本中为NOLOAD且在_sbss/_ebss之外，启动文件不清零。
+  * 各段之后的空闲部分由port_mem_regions交给rtos_alloc，SRAM在SRAM1(112KB)
+  * 和SRAM2(16KB)的分界处分为两个区域。
+  *
+  * 栈保护(PORT_MPU_STACK_GUARD)：MPU区域7覆盖当前任务栈最低的32字节，
+  * 特权和非特权访问都禁止，其余地址按默认映射(PRIVDEFENA)。区域大小和
+  * 属性固定，PendSV切换时只改写一次RBAR把它移到下一个任务的栈底。
+  * 任务越界或异常压栈进入保护区时触发MemManage故障(临界区内升级为
+  * HardFault)，由port_fault_handler调用rtos_stack_overflow(当前任务)。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __PORT_CFG_H__
+#define __PORT_CFG_H__
+
+/* Exported constants --------------------------------------------------------*/
+
+#define PORT_TIMER_IRQ_PRIORITY     3           /* TIM2优先级：高于PendSV(15)，低于SVC(0) */
+#define PORT_INITIAL_XPSR           0x01000000UL /* Thumb状态 */
+#define PORT_INITIAL_EXC_RETURN     0xFFFFFFFDUL /* 返回线程模式，使用PSP，无FPU帧 */
+#define PORT_CYCLES_HZ              168000000UL /* DWT->CYCCNT，CPU时钟 */
+#define PORT_PERF_EVENT_MASK        0xFFUL      /* DWT CPICNT/EXCCNT/LSUCNT/FOLDCNT为8位 */
+
+#define PORT_CCM_BASE               0x10000000UL
+#define PORT_CCM_SIZE               0x00010000UL
+#define PORT_SRAM2_BASE             0x2001C000UL
+
+/* MPU栈保护，为0时不使用MPU */
+#ifndef PORT_MPU_STACK_GUARD
+#define PORT_MPU_STACK_GUARD        1
+#endif
+#define PORT_MPU_GUARD_REGION       7           /* 编号最大的区域在重叠时优先 */
+#if PORT_MPU_STACK_GUARD
+#define PORT_STACK_GUARD_WORDS      8           /* 32字节，MPU区域的最小尺寸 */
+#define PORT_STACK_ALIGN            32          /* MPU区域基址须按尺寸对齐 */
+#endif
+
+/* 专用段名，不与-fdata-sections生成的.bss.<变量名>重名；编译器按PROGBITS输出，
+   链接脚本中收集它们的.bss1/.bss2为NOLOAD，由启动文件清零 */
+#define PORT_FAST_BSS               __attribute__((section(".ccm_bss")))
+#define PORT_DMA_BSS                __attribute__((section(".dma_bss")))
+
+/* .noinit开头的段名同样按NOBITS输出，链接脚本放在清零范围之外 */
+#define PORT_FAST_NOINIT            __attribute__((section(".noinit.ccm")))
+#define PORT_DMA_NOINIT             __attribute__((section(".noinit.dma")))
+
+/* 与CCM没有交集的地址范围DMA可以访问(Flash和SRAM) */
+#define PORT_DMA_REACHABLE(addr, len) \
+    ((uint32_t)(addr) + (uint32_t)(len) <= PORT_CCM_BASE || \
+     (uint32_t)(addr) >= PORT_CCM_BASE + PORT_CCM_SIZE)
+
+#endif /* __PORT_CFG_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,481 @@
+/**
+  ******************************************************************************
+  * @file    port.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   POSIX(Linux主机)移植层实现
+  *          ucontext切换上下文，信号模拟中断，内核源码不经修改在主机上运行
+  ******************************************************************************
+  * @attention
+  *
+  * 与Cortex-M4的对应关系：
+  * - PRIMASK        阻塞SIGALRM和SIGUSR1的信号屏蔽字
+  * - TIM2比较中断   setitimer到期产生的SIGALRM
+  * - 外设中断       SIGUSR1，见port_posix_trigger_irq
+  * - PendSV         switch_pending标志，在退出最外层临界区或信号处理函数
+  *                  返回前执行，执行时信号保持屏蔽
+  * - TIM2计数值     CLOCK_MONOTONIC按TIM2_CLOCK_FREQ换算的32位计数
+  *
+  * 信号屏蔽状态另用irq_masked变量记录，嵌套的临界区不产生系统调用。
+  * 任务切换总是在屏蔽状态下发生，被切换出去的任务恢复运行时仍处于屏蔽状态，
+  * 因此irq_masked不需要按任务保存。
+  *
+  * 信号处理函数中调用swapcontext切换到其他任务，被抢占任务的处理函数栈帧
+  * 留在其自身的栈上，再次切换回来时处理函数正常返回。整个进程只有一个线程，
+  * 不能与其他线程混用。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Private variables ---------------------------------------------------------*/
+
+static sigset_t irq_mask;                       /* 模拟中断使用的信号 */
+static volatile sig_atomic_t port_ready;        /* 信号处理函数已安装 */
+static volatile sig_atomic_t irq_masked;        /* 当前是否屏蔽中断 */
+static volatile sig_atomic_t in_isr;            /* 是否在信号处理函数中 */
+static volatile sig_atomic_t switch_pending;    /* 挂起的任务切换请求 */
+static ucontext_t main_context;                 /* rtos_start调用者的上下文 */
+static uint64_t timer_epoch_ns;                 /* 计数值0对应的单调时钟 */
+static void (*user_irq_handler)(void);          /* SIGUSR1对应的中断处理函数 */
+
+/* rtos_alloc的内存区域 - 大小与目标板的CCM和SRAM相同 */
+static uint8_t mem_fast[64 * 1024] __attribute__((aligned(16)));
+static uint8_t mem_sram[128 * 1024] __attribute__((aligned(16)));
+static const port_mem_region_t port_regions[2] = {
+    { "fast", mem_fast, mem_fast + sizeof(mem_fast), PORT_MEM_FAST },
+    { "sram", mem_sram, mem_sram + sizeof(mem_sram), PORT_MEM_DMA },
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static void posix_setup(void);
+static void posix_irq_signal(int sig);
+static void posix_switch(void);
+static void posix_task_entry(void);
+static uint64_t posix_now_ns(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  安装信号处理函数
+  * @param  None
+  * @retval None
+  * @note   处理期间屏蔽全部模拟中断，相当于所有中断同一优先级
+  */
+static void posix_setup(void)
+{
+    struct sigaction sa;
+
+    sigemptyset(&irq_mask);
+    sigaddset(&irq_mask, SIGALRM);
+    sigaddset(&irq_mask, SIGUSR1);
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = posix_irq_signal;
+    sa.sa_mask = irq_mask;
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGALRM, &sa, NULL);
+    sigaction(SIGUSR1, &sa, NULL);
+
+    port_ready = 1;
+}
+
+/**
+  * @brief  模拟中断入口 - 信号处理函数
+  * @param  sig: 信号编号
+  * @retval None
+  */
+static void posix_irq_signal(int sig)
+{
+    int saved_errno = errno;
+
+    irq_masked = 1;
+    in_isr = 1;
+    if (sig == SIGALRM) {
+        Time_TimerIsr();
+    } else if (user_irq_handler) {
+        user_irq_handler();
+    }
+    in_isr = 0;
+
+    /* 中断返回前执行挂起的切换，相当于PendSV尾链 */
+    while (switch_pending) {
+        posix_switch();
+    }
+    irq_masked = 0;
+    errno = saved_errno;
+}
+
+/**
+  * @brief  执行一次任务切换（信号已屏蔽）
+  * @param  None
+  * @retval None
+  */
+static void posix_switch(void)
+{
+    task_t* prev = scheduler.current_task;
+    task_t* next;
+
+    switch_pending = 0;
+    next = rtos_switch_task();
+    if (next != prev) {
+        swapcontext(&prev->port_context, &next->port_context);
+    }
+}
+
+/**
+  * @brief  任务首次运行的入口
+  * @param  None
+  * @retval None
+  * @note   首次切入时处于切换路径的屏蔽状态，先开放中断
+  */
+static void posix_task_entry(void)
+{
+    task_t* task = scheduler.current_task;
+
+    irq_masked = 0;
+    sigprocmask(SIG_UNBLOCK, &irq_mask, NULL);
+
+    task->task_func(task->arg);
+    rtos_task_exit();
+}
+
+/**
+  * @brief  读取单调时钟
+  * @param  None
+  * @retval 纳秒
+  */
+static uint64_t posix_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  进入临界区 - 阻塞模拟中断信号
+  * @param  None
+  * @retval 进入前的屏蔽状态，1表示已屏蔽
+  */
+uint32_t port_enter_critical(void)
+{
+    if (!port_ready) {
+        posix_setup();
+    }
+    if (irq_masked) {
+        return 1U;
+    }
+    sigprocmask(SIG_BLOCK, &irq_mask, NULL);
+    irq_masked = 1;
+    return 0U;
+}
+
+/**
+  * @brief  退出临界区 - 退出最外层时先执行挂起的切换，再开放中断
+  * @param  state: port_enter_critical的返回值
+  * @retval None
+  */
+void port_exit_critical(uint32_t state)
+{
+    if (state != 0U || in_isr) {
+        return;
+    }
+    while (switch_pending) {
+        posix_switch();
+    }
+    irq_masked = 0;
+    sigprocmask(SIG_UNBLOCK, &irq_mask, NULL);
+}
+
+/**
+  * @brief  当前是否处于中断上下文
+  * @param  None
+  * @retval 非0表示在信号处理函数中
+  */
+int port_in_isr(void)
+{
+    return in_isr;
+}
+
+/**
+  * @brief  构造任务首次运行时的上下文
+  * @param  task: 任务指针
+  * @retval None
+  */
+void port_task_init(struct task* task)
+{
+    getcontext(&task->port_context);
+    task->port_context.uc_stack.ss_sp = task->stack;
+    task->port_context.uc_stack.ss_size = task->stack_size * sizeof(uint32_t);
+    task->port_context.uc_link = NULL;
+    sigaddset(&task->port_context.uc_sigmask, SIGALRM);
+    sigaddset(&task->port_context.uc_sigmask, SIGUSR1);
+    makecontext(&task->port_context, posix_task_entry, 0);
+
+    task->stack_ptr = task->stack;  /* 主机上仅作标记，栈指针保存在ucontext中 */
+}
+
+/**
+  * @brief  启动首个任务，port_posix_stop后返回
+  * @param  None
+  * @retval None
+  */
+void port_start_first_task(void)
+{
+    uint32_t state = port_enter_critical();
+
+    switch_pending = 0;
+    swapcontext(&main_context, &scheduler.current_task->port_context);
+
+    /* 由port_posix_stop返回 */
+    port_exit_critical(state);
+}
+
+/**
+  * @brief  停止调度器，回到rtos_start的调用者
+  * @param  None
+  * @retval None
+  */
+void port_posix_stop(void)
+{
+    (void)port_enter_critical();
+    port_timer_cancel();
+#if RTOS_PERF_ENABLE
+    rtos_perf_sample();                         /* 停止前结算当前任务 */
+#endif
+    scheduler.running = 0;
+    switch_pending = 0;
+    setcontext(&main_context);
+}
+
+/**
+  * @brief  挂起一次任务切换请求
+  * @param  None
+  * @retval None
+  * @note   不在临界区和中断中时立即切换，与PendSV优先级最低的行为一致
+  */
+void port_pend_switch(void)
+{
+    switch_pending = 1;
+    if (!in_isr && !irq_masked) {
+        port_exit_critical(port_enter_critical());
+    }
+}
+
+/**
+  * @brief  空闲任务中等待信号
+  * @param  None
+  * @retval None
+  */
+void port_idle(void)
+{
+    pause();
+}
+
+/**
+  * @brief  设置SIGUSR1对应的中断处理函数
+  * @param  handler: 中断处理函数，NULL表示忽略
+  * @retval None
+  */
+void port_posix_set_irq_handler(void (*handler)(void))
+{
+    user_irq_handler = handler;
+}
+
+/**
+  * @brief  触发一次模拟外设中断
+  * @param  None
+  * @retval None
+  * @note   在任务中调用时处理函数立即在当前栈上执行；临界区内调用时延迟到退出临界区
+  */
+void port_posix_trigger_irq(void)
+{
+    if (!port_ready) {
+        posix_setup();
+    }
+    raise(SIGUSR1);
+}
+
+/**
+  * @brief  定时器初始化 - 以当前时刻为计数值0
+  * @param  None
+  * @retval None
+  */
+void port_timer_init(void)
+{
+    if (!port_ready) {
+        posix_setup();
+    }
+    timer_epoch_ns = posix_now_ns();
+    port_timer_cancel();
+}
+
+/**
+  * @brief  停止定时器
+  * @param  None
+  * @retval None
+  */
+void port_timer_deinit(void)
+{
+    port_timer_cancel();
+}
+
+/**
+  * @brief  读取模拟TIM2计数值
+  * @param  None
+  * @retval 当前计数值
+  */
+uint32_t port_timer_now(void)
+{
+    uint64_t ns = posix_now_ns() - timer_epoch_ns;
+    return (uint32_t)(ns * TIM2_TICKS_PER_US / 1000U);
+}
+
+/**
+  * @brief  读取单调时钟
+  * @param  None
+  * @retval 纳秒数的低32位
+  */
+uint32_t port_cycles(void)
+{
+    return (uint32_t)posix_now_ns();
+}
+
+/**
+  * @brief  读取性能计数器
+  * @param  perf: 输出快照
+  * @retval None
+  * @note   主机上只有cycles(纳秒)，其余为0
+  */
+void port_perf_read(port_perf_t* perf)
+{
+    perf->cycles = port_cycles();
+    perf->cpi = 0;
+    perf->exc = 0;
+    perf->sleep = 0;
+    perf->lsu = 0;
+    perf->fold = 0;
+}
+
+/**
+  * @brief  可供rtos_alloc分配的内存区域
+  * @param  regions: 输出区域表
+  * @retval 区域数
+  */
+uint32_t port_mem_regions(const port_mem_region_t** regions)
+{
+    *regions = port_regions;
+    return 2;
+}
+
+/**
+  * @brief  原子取出链表头
+  * @param  head: 链表头指针
+  * @retval 取出的节点，链表为空返回NULL
+  * @note   主机上在临界区内完成，与模拟中断之间原子
+  */
+void* port_lifo_pop(void* volatile* head)
+{
+    uint32_t state = port_enter_critical();
+    void* node = *head;
+
+    if (node != NULL) {
+        *head = *(void**)node;
+    }
+    port_exit_critical(state);
+    return node;
+}
+
+/**
+  * @brief  原子放回链表头
+  * @param  head: 链表头指针
+  * @param  node: 节点
+  * @retval None
+  */
+void port_lifo_push(void* volatile* head, void* node)
+{
+    uint32_t state = port_enter_critical();
+
+    *(void**)node = *head;
+    *head = node;
+    port_exit_critical(state);
+}
+
+/**
+  * @brief  比较并交换
+  * @param  addr: 地址
+  * @param  expected: 期望的旧值
+  * @param  desired: 新值
+  * @retval 写入成功返回1，*addr不等于expected返回0
+  * @note   单条原子指令，对信号处理函数同样原子，不需要屏蔽信号
+  */
+int port_atomic_cas(volatile uint32_t* addr, uint32_t expected, uint32_t desired)
+{
+    return __atomic_compare_exchange_n(addr, &expected, desired, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+/**
+  * @brief  设置比较值 - 换算为setitimer的相对时间
+  * @param  target: 目标计数值
+  * @retval None
+  * @note   目标已过去时直接产生SIGALRM，在退出临界区或中断返回后处理
+  */
+void port_timer_set_compare(uint32_t target)
+{
+    struct itimerval it;
+    int32_t delta = (int32_t)(target - port_timer_now());
+    uint64_t us;
+
+    memset(&it, 0, sizeof(it));
+    if (delta <= 0) {
+        setitimer(ITIMER_REAL, &it, NULL);
+        raise(SIGALRM);
+        return;
+    }
+
+    us = ((uint64_t)delta + TIM2_TICKS_PER_US - 1U) / TIM2_TICKS_PER_US;
+    it.it_value.tv_sec = (time_t)(us / 1000000U);
+    it.it_value.tv_usec = (suseconds_t)(us % 1000000U);
+    setitimer(ITIMER_REAL, &it, NULL);
+}
+
+/**
+  * @brief  关闭比较中断
+  * @param  None
+  * @retval None
+  */
+void port_timer_cancel(void)
+{
+    struct itimerval it;
+
+    memset(&it, 0, sizeof(it));
+    setitimer(ITIMER_REAL, &it, NULL);
+}
+
+/**
+  * @brief  标准输出 - 供rtos_printf使用，对应目标板main.c中的_write
+  * @param  fd: 文件描述符
+  * @param  ptr: 数据
+  * @param  len: 长度
+  * @retval 写入的字节数
+  */
+int _write(int fd, char* ptr, int len)
+{
+    return (int)write(fd, ptr, (size_t)len);
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,47 @@
+/**
+  ******************************************************************************
+  * @file    port_cfg.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   POSIX(Linux主机)移植层配置
+  ******************************************************************************
+  * @attention
+  *
+  * 内核头文件目录须以-iquote而不是-I加入，否则02_rtos/time.h会遮蔽系统<time.h>。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __PORT_CFG_H__
+#define __PORT_CFG_H__
+
+/* Includes ------------------------------------------------------------------*/
+#include <ucontext.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* 主机上的C库函数栈用量远大于目标板，默认每个任务64KB */
+#ifndef STACK_SIZE
+#define STACK_SIZE                  16384
+#endif
+#define PORT_MIN_STACK_WORDS        4096        /* 静态任务至少16KB，C库函数在主机上栈用量大 */
+
+/* port_cycles为CLOCK_MONOTONIC纳秒数 */
+#define PORT_CYCLES_HZ              1000000000UL
+
+/* 每个任务保存一份ucontext */
+#define PORT_TASK_FIELDS            ucontext_t port_context;
+
+/* Exported functions ------------------------------------------------------- */
+
+/* 停止调度器，rtos_start返回到其调用者；须在任务中调用 */
+void port_posix_stop(void);
+
+/* 模拟外设中断：SIGUSR1作为一个中断源，处理函数在中断上下文中执行 */
+void port_posix_set_irq_handler(void (*handler)(void));
+void port_posix_trigger_irq(void);
+
+#endif /* __PORT_CFG_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
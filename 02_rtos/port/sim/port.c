@@ -0,0 +1,716 @@
+/**
+  ******************************************************************************
+  * @file    port.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   虚拟时间仿真移植层实现
+  *          离散事件模型：TIM2计数器和比较中断、NVIC优先级和挂起位、PendSV尾链
+  ******************************************************************************
+  * @attention
+  *
+  * 执行模型：
+  * 1. 全部任务在同一个主机线程中以ucontext运行，中断处理函数在被中断任务
+  *    的栈上直接调用，不使用信号，结果完全确定
+  * 2. 虚拟时间只在sim_run、空闲等待和异常进出时前进；前进过程中到达的
+  *    事件(TIM2比较匹配、脚本中断)只置挂起位，再由sim_dispatch按NVIC规则执行
+  * 3. sim_dispatch只执行优先级高于当前执行优先级的挂起中断；PRIMASK为1时
+  *    不执行任何中断。连续执行多个中断时按尾链计时
+  * 4. PendSV在dispatch中执行，内部调用rtos_switch_task并swapcontext；
+  *    被切换出去的任务恢复时从自己的dispatch栈帧继续，恢复其执行优先级
+  * 5. 被中断或抢占的sim_run只累计自己消耗的周期，剩余部分在恢复后继续执行
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 模拟的中断线 */
+typedef struct {
+    const char* name;
+    uint32_t priority;
+    sim_isr_t isr;
+    void* arg;
+    uint8_t pending;                            /* NVIC挂起位 */
+    uint64_t at;                                /* 脚本触发时刻，SIM_NEVER表示无 */
+} sim_irq_t;
+
+/* Private variables ---------------------------------------------------------*/
+
+static sim_irq_t sim_irqs[SIM_MAX_IRQS];
+static int sim_irq_count;
+
+static uint64_t sim_cycles;                     /* 虚拟时钟 */
+static uint64_t sim_exc_cycles;                 /* 异常进入/退出/尾链累计周期 */
+static uint64_t sim_sleep_cycles;               /* 空闲等待跳过的累计周期 */
+static uint64_t sim_end;                        /* 停止时刻 */
+static uint32_t sim_primask;                    /* 模拟PRIMASK */
+static uint32_t sim_active;                     /* 当前执行优先级 */
+
+static uint8_t tim2_cc_enabled;                 /* CC1中断使能 */
+static uint64_t tim2_match_at;                  /* 下一次CNT == CCR1的时刻 */
+
+static ucontext_t sim_main_context;             /* rtos_start调用者的上下文 */
+static void (*sim_trace_out)(const char* line);
+
+/* rtos_alloc的内存区域 - 大小与目标板的CCM和SRAM相同 */
+static uint8_t mem_fast[64 * 1024] __attribute__((aligned(16)));
+static uint8_t mem_sram[128 * 1024] __attribute__((aligned(16)));
+static const port_mem_region_t port_regions[2] = {
+    { "fast", mem_fast, mem_fast + sizeof(mem_fast), PORT_MEM_FAST },
+    { "sram", mem_sram, mem_sram + sizeof(mem_sram), PORT_MEM_DMA },
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint64_t sim_next_event(void);
+static void sim_fire_events(void);
+static void sim_charge(uint32_t cycles);
+static int sim_highest_pending(void);
+static void sim_dispatch(void);
+static void sim_tim2_isr(void* arg);
+static void sim_pendsv_isr(void* arg);
+static void sim_task_entry(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  最早的未到达事件时刻
+  * @param  None
+  * @retval 周期数，无事件时为SIM_NEVER
+  */
+static uint64_t sim_next_event(void)
+{
+    uint64_t next = SIM_NEVER;
+    int i;
+
+    if (tim2_cc_enabled && tim2_match_at < next) {
+        next = tim2_match_at;
+    }
+    for (i = 0; i < sim_irq_count; i++) {
+        if (sim_irqs[i].at < next) {
+            next = sim_irqs[i].at;
+        }
+    }
+    return next;
+}
+
+/**
+  * @brief  为已到达的事件置挂起位
+  * @param  None
+  * @retval None
+  */
+static void sim_fire_events(void)
+{
+    int i;
+
+    if (tim2_cc_enabled && tim2_match_at <= sim_cycles) {
+        sim_irqs[SIM_IRQ_TIM2].pending = 1;
+        tim2_match_at += (uint64_t)SIM_CYCLES_PER_TICK << 32;   /* 计数器回绕后再次匹配 */
+    }
+    for (i = 0; i < sim_irq_count; i++) {
+        if (sim_irqs[i].at <= sim_cycles) {
+            sim_irqs[i].pending = 1;
+            sim_irqs[i].at = SIM_NEVER;
+        }
+    }
+}
+
+/**
+  * @brief  消耗周期但不执行中断(异常进出、切换路径)
+  * @param  cycles: 周期数
+  * @retval None
+  */
+static void sim_charge(uint32_t cycles)
+{
+    sim_cycles += cycles;
+    sim_fire_events();
+}
+
+/**
+  * @brief  消耗异常进入、退出或尾链的周期，另计入异常开销
+  * @param  cycles: 周期数
+  * @retval None
+  */
+static void sim_charge_exc(uint32_t cycles)
+{
+    sim_exc_cycles += cycles;
+    sim_charge(cycles);
+}
+
+/**
+  * @brief  查找可抢占当前执行优先级的最高优先级挂起中断
+  * @param  None
+  * @retval 中断编号，无则为-1
+  * @note   优先级相同时编号小者优先
+  */
+static int sim_highest_pending(void)
+{
+    int best = -1;
+    int i;
+
+    for (i = 0; i < sim_irq_count; i++) {
+        if (sim_irqs[i].pending && sim_irqs[i].priority < sim_active &&
+            (best < 0 || sim_irqs[i].priority < sim_irqs[best].priority)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+  * @brief  按NVIC规则执行挂起的中断
+  * @param  None
+  * @retval None
+  */
+static void sim_dispatch(void)
+{
+    uint32_t saved = sim_active;
+    uint8_t in_exception = 0;
+    int n;
+
+    while (!sim_primask && (n = sim_highest_pending()) >= 0) {
+        sim_charge_exc(in_exception ? SIM_TAIL_CHAIN_CYCLES : SIM_IRQ_ENTRY_CYCLES);
+        in_exception = 1;
+
+        /* 压栈期间可能到达更高优先级的中断(迟到)，重新选择 */
+        n = sim_highest_pending();
+        sim_irqs[n].pending = 0;
+        sim_active = sim_irqs[n].priority;
+        sim_irqs[n].isr(sim_irqs[n].arg);
+        sim_active = saved;
+
+        if (sim_highest_pending() < 0) {
+            sim_charge_exc(SIM_IRQ_EXIT_CYCLES);
+            in_exception = 0;
+        }
+    }
+}
+
+/**
+  * @brief  TIM2比较中断
+  * @param  arg: 未使用
+  * @retval None
+  */
+static void sim_tim2_isr(void* arg)
+{
+    (void)arg;
+    sim_trace("irq", "TIM2 cnt=%lu", (unsigned long)port_timer_now());
+    Time_TimerIsr();
+}
+
+/**
+  * @brief  PendSV - 选择下一个任务并切换上下文
+  * @param  arg: 未使用
+  * @retval None
+  */
+static void sim_pendsv_isr(void* arg)
+{
+    task_t* prev = scheduler.current_task;
+    task_t* next;
+
+    (void)arg;
+    sim_charge(SIM_SWITCH_CYCLES);
+    next = rtos_switch_task();
+    if (next != prev) {
+        sim_trace("switch", "%s -> %s", sim_task_name(prev), sim_task_name(next));
+        swapcontext(&prev->port_context, &next->port_context);
+    }
+}
+
+/**
+  * @brief  任务首次运行的入口 - 相当于从PendSV/SVC异常返回到新任务
+  * @param  None
+  * @retval None
+  */
+static void sim_task_entry(void)
+{
+    task_t* task = scheduler.current_task;
+
+    sim_active = SIM_THREAD_PRIORITY;
+    sim_primask = 0;
+    sim_charge_exc(SIM_IRQ_EXIT_CYCLES);
+    sim_dispatch();
+
+    task->task_func(task->arg);
+    rtos_task_exit();
+}
+
+/* Public functions - 仿真器 -------------------------------------------------*/
+
+/**
+  * @brief  复位仿真器
+  * @param  None
+  * @retval None
+  */
+void sim_reset(void)
+{
+    memset(sim_irqs, 0, sizeof(sim_irqs));
+    sim_irqs[SIM_IRQ_TIM2].name = "TIM2";
+    sim_irqs[SIM_IRQ_TIM2].priority = SIM_TIM2_PRIORITY;
+    sim_irqs[SIM_IRQ_TIM2].isr = sim_tim2_isr;
+    sim_irqs[SIM_IRQ_TIM2].at = SIM_NEVER;
+    sim_irqs[SIM_IRQ_PENDSV].name = "PendSV";
+    sim_irqs[SIM_IRQ_PENDSV].priority = SIM_PENDSV_PRIORITY;
+    sim_irqs[SIM_IRQ_PENDSV].isr = sim_pendsv_isr;
+    sim_irqs[SIM_IRQ_PENDSV].at = SIM_NEVER;
+    sim_irq_count = SIM_IRQ_USER;
+
+    sim_cycles = 0;
+    sim_exc_cycles = 0;
+    sim_sleep_cycles = 0;
+    sim_end = SIM_NEVER;
+    sim_primask = 0;
+    sim_active = SIM_THREAD_PRIORITY;
+    tim2_cc_enabled = 0;
+    tim2_match_at = SIM_NEVER;
+}
+
+/**
+  * @brief  设置停止时刻
+  * @param  cycles: 周期数
+  * @retval None
+  */
+void sim_set_end(uint64_t cycles)
+{
+    sim_end = cycles;
+}
+
+/**
+  * @brief  停止仿真，回到rtos_start的调用者
+  * @param  None
+  * @retval None
+  */
+void sim_stop(void)
+{
+    sim_trace("sim", "stop");
+#if RTOS_PERF_ENABLE
+    rtos_perf_sample();                         /* 停止前结算当前任务 */
+#endif
+    sim_primask = 1;
+    scheduler.running = 0;
+    setcontext(&sim_main_context);
+}
+
+/**
+  * @brief  当前虚拟周期数
+  * @param  None
+  * @retval 周期数
+  */
+uint64_t sim_now(void)
+{
+    return sim_cycles;
+}
+
+/**
+  * @brief  当前上下文执行指定周期数
+  * @param  cycles: 周期数
+  * @retval None
+  * @note   期间到达的事件按NVIC规则执行；被中断和抢占的时间不计入cycles
+  */
+void sim_run(uint32_t cycles)
+{
+    uint64_t remaining = cycles;
+    uint64_t step;
+
+    sim_dispatch();
+    while (remaining > 0) {
+        step = sim_next_event() - sim_cycles;
+        if (step > remaining) {
+            step = remaining;
+        }
+        if (sim_cycles + step > sim_end) {
+            sim_cycles = sim_end;
+            sim_stop();
+        }
+        sim_cycles += step;
+        remaining -= step;
+        sim_fire_events();
+        sim_dispatch();
+    }
+}
+
+/**
+  * @brief  注册一个中断源
+  * @param  name: 名称，用于跟踪输出
+  * @param  priority: NVIC优先级(0-15)
+  * @param  isr: 处理函数
+  * @param  arg: 处理函数参数
+  * @retval 中断编号，表满时为-1
+  */
+int sim_irq_register(const char* name, uint32_t priority, sim_isr_t isr, void* arg)
+{
+    sim_irq_t* irq;
+
+    if (sim_irq_count >= SIM_MAX_IRQS) {
+        return -1;
+    }
+    irq = &sim_irqs[sim_irq_count];
+    irq->name = name;
+    irq->priority = priority;
+    irq->isr = isr;
+    irq->arg = arg;
+    irq->pending = 0;
+    irq->at = SIM_NEVER;
+    return sim_irq_count++;
+}
+
+/**
+  * @brief  在指定时刻触发中断
+  * @param  irq: 中断编号
+  * @param  at: 周期数，不早于当前时刻；SIM_NEVER取消
+  * @retval None
+  */
+void sim_irq_schedule(int irq, uint64_t at)
+{
+    sim_irqs[irq].at = (at < sim_cycles) ? sim_cycles : at;
+}
+
+/**
+  * @brief  立即置中断挂起位
+  * @param  irq: 中断编号
+  * @retval None
+  */
+void sim_irq_pend(int irq)
+{
+    sim_irqs[irq].pending = 1;
+    if (scheduler.running) {
+        sim_dispatch();
+    }
+}
+
+/**
+  * @brief  设置跟踪输出函数，NULL关闭跟踪
+  * @param  out: 输出一行文本(不含换行)
+  * @retval None
+  */
+void sim_set_trace(void (*out)(const char* line))
+{
+    sim_trace_out = out;
+}
+
+/**
+  * @brief  输出一行跟踪
+  * @param  who: 来源
+  * @param  fmt: 格式
+  * @retval None
+  */
+void sim_trace(const char* who, const char* fmt, ...)
+{
+    char line[160];
+    int len;
+    va_list ap;
+
+    if (sim_trace_out == NULL) {
+        return;
+    }
+    len = snprintf(line, sizeof(line), "%12llu  %-8s ", (unsigned long long)sim_cycles, who);
+    va_start(ap, fmt);
+    vsnprintf(line + len, sizeof(line) - (size_t)len, fmt, ap);
+    va_end(ap);
+    sim_trace_out(line);
+}
+
+/**
+  * @brief  设置任务名称
+  * @param  task: 任务指针
+  * @param  name: 名称
+  * @retval None
+  */
+void sim_set_task_name(struct task* task, const char* name)
+{
+    task->port_name = name;
+}
+
+/**
+  * @brief  读取任务名称，未命名的为空闲任务
+  * @param  task: 任务指针
+  * @retval 名称
+  */
+const char* sim_task_name(const struct task* task)
+{
+    return (task && task->port_name) ? task->port_name : "idle";
+}
+
+/* Public functions - 移植层 -------------------------------------------------*/
+
+/**
+  * @brief  进入临界区 - 置模拟PRIMASK
+  * @param  None
+  * @retval 进入前的PRIMASK
+  */
+uint32_t port_enter_critical(void)
+{
+    uint32_t primask = sim_primask;
+    sim_primask = 1;
+    return primask;
+}
+
+/**
+  * @brief  退出临界区 - 恢复PRIMASK，开放时执行挂起的中断和PendSV
+  * @param  state: port_enter_critical的返回值
+  * @retval None
+  */
+void port_exit_critical(uint32_t state)
+{
+    sim_primask = state;
+    if (!state) {
+        sim_dispatch();
+    }
+}
+
+/**
+  * @brief  当前是否处于中断上下文
+  * @param  None
+  * @retval 非0表示在中断中
+  */
+int port_in_isr(void)
+{
+    return sim_active != SIM_THREAD_PRIORITY;
+}
+
+/**
+  * @brief  构造任务首次运行时的上下文
+  * @param  task: 任务指针
+  * @retval None
+  */
+void port_task_init(struct task* task)
+{
+    getcontext(&task->port_context);
+    task->port_context.uc_stack.ss_sp = task->stack;
+    task->port_context.uc_stack.ss_size = task->stack_size * sizeof(uint32_t);
+    task->port_context.uc_link = NULL;
+    makecontext(&task->port_context, sim_task_entry, 0);
+
+    task->port_name = NULL;
+    task->stack_ptr = task->stack;  /* 仅作标记，栈指针保存在ucontext中 */
+}
+
+/**
+  * @brief  启动首个任务，仿真停止后返回
+  * @param  None
+  * @retval None
+  */
+void port_start_first_task(void)
+{
+    sim_trace("sim", "start %s", sim_task_name(scheduler.current_task));
+    sim_charge_exc(SIM_IRQ_ENTRY_CYCLES);   /* SVC 0 */
+    swapcontext(&sim_main_context, &scheduler.current_task->port_context);
+    sim_primask = 0;
+    sim_active = SIM_THREAD_PRIORITY;
+}
+
+/**
+  * @brief  挂起PendSV
+  * @param  None
+  * @retval None
+  */
+void port_pend_switch(void)
+{
+    sim_irqs[SIM_IRQ_PENDSV].pending = 1;
+    if (!sim_primask) {
+        sim_dispatch();
+    }
+}
+
+/**
+  * @brief  空闲等待 - 虚拟时间直接跳到下一个事件(WFI)
+  * @param  None
+  * @retval None
+  * @note   没有任何未来事件时所有任务都已阻塞，仿真结束
+  */
+void port_idle(void)
+{
+    uint64_t next = sim_next_event();
+
+    if (next == SIM_NEVER || next > sim_end) {
+        if (sim_end != SIM_NEVER) {
+            if (sim_end > sim_cycles) {
+                sim_sleep_cycles += sim_end - sim_cycles;
+            }
+            sim_cycles = sim_end;
+        }
+        sim_stop();
+    }
+    if (next > sim_cycles) {
+        sim_sleep_cycles += next - sim_cycles;
+        sim_cycles = next;
+    }
+    sim_fire_events();
+    sim_dispatch();
+}
+
+/**
+  * @brief  定时器初始化 - 比较中断关闭，计数值随虚拟时钟
+  * @param  None
+  * @retval None
+  */
+void port_timer_init(void)
+{
+    tim2_cc_enabled = 0;
+    tim2_match_at = SIM_NEVER;
+}
+
+/**
+  * @brief  停止定时器
+  * @param  None
+  * @retval None
+  */
+void port_timer_deinit(void)
+{
+    port_timer_cancel();
+}
+
+/**
+  * @brief  读取TIM2计数值
+  * @param  None
+  * @retval 当前计数值
+  */
+uint32_t port_timer_now(void)
+{
+    return (uint32_t)(sim_cycles / SIM_CYCLES_PER_TICK);
+}
+
+/**
+  * @brief  读取虚拟周期数
+  * @param  None
+  * @retval 低32位
+  */
+uint32_t port_cycles(void)
+{
+    return (uint32_t)sim_cycles;
+}
+
+/**
+  * @brief  读取虚拟性能计数器
+  * @param  perf: 输出快照
+  * @retval None
+  * @note   exc为模型中的异常进入/退出/尾链周期，sleep为port_idle跳过的
+  *         周期；内核C代码不消耗周期，cpi/lsu/fold为0
+  */
+void port_perf_read(port_perf_t* perf)
+{
+    perf->cycles = (uint32_t)sim_cycles;
+    perf->cpi = 0;
+    perf->exc = (uint32_t)sim_exc_cycles;
+    perf->sleep = (uint32_t)sim_sleep_cycles;
+    perf->lsu = 0;
+    perf->fold = 0;
+}
+
+/**
+  * @brief  可供rtos_alloc分配的内存区域
+  * @param  regions: 输出区域表
+  * @retval 区域数
+  */
+uint32_t port_mem_regions(const port_mem_region_t** regions)
+{
+    *regions = port_regions;
+    return 2;
+}
+
+/**
+  * @brief  原子取出链表头
+  * @param  head: 链表头指针
+  * @retval 取出的节点，链表为空返回NULL
+  * @note   主机上在临界区内完成，与模拟中断之间原子
+  */
+void* port_lifo_pop(void* volatile* head)
+{
+    uint32_t state = port_enter_critical();
+    void* node = *head;
+
+    if (node != NULL) {
+        *head = *(void**)node;
+    }
+    port_exit_critical(state);
+    return node;
+}
+
+/**
+  * @brief  原子放回链表头
+  * @param  head: 链表头指针
+  * @param  node: 节点
+  * @retval None
+  */
+void port_lifo_push(void* volatile* head, void* node)
+{
+    uint32_t state = port_enter_critical();
+
+    *(void**)node = *head;
+    *head = node;
+    port_exit_critical(state);
+}
+
+/**
+  * @brief  比较并交换
+  * @param  addr: 地址
+  * @param  expected: 期望的旧值
+  * @param  desired: 新值
+  * @retval 写入成功返回1，*addr不等于expected返回0
+  */
+int port_atomic_cas(volatile uint32_t* addr, uint32_t expected, uint32_t desired)
+{
+    uint32_t state = port_enter_critical();
+    int ok = (*addr == expected);
+
+    if (ok) {
+        *addr = desired;
+    }
+    port_exit_critical(state);
+    return ok;
+}
+
+/**
+  * @brief  设置比较值 - 计算下一次CNT == CCR1的时刻
+  * @param  target: 目标计数值
+  * @retval None
+  * @note   目标已过去时立即置挂起位，对应cm4移植层的软件CC1事件
+  */
+void port_timer_set_compare(uint32_t target)
+{
+    uint64_t cnt = sim_cycles / SIM_CYCLES_PER_TICK;
+    uint64_t delta = (uint32_t)(target - (uint32_t)cnt);
+
+    if (delta == 0) {
+        delta = 1ULL << 32;
+    }
+    tim2_match_at = (cnt + delta) * SIM_CYCLES_PER_TICK;
+    tim2_cc_enabled = 1;
+
+    if ((int32_t)((uint32_t)cnt - target) >= 0) {
+        sim_irqs[SIM_IRQ_TIM2].pending = 1;
+    }
+}
+
+/**
+  * @brief  关闭比较中断并清除挂起位
+  * @param  None
+  * @retval None
+  */
+void port_timer_cancel(void)
+{
+    tim2_cc_enabled = 0;
+    sim_irqs[SIM_IRQ_TIM2].pending = 0;
+}
+
+/**
+  * @brief  标准输出 - 供rtos_printf使用
+  * @param  fd: 文件描述符
+  * @param  ptr: 数据
+  * @param  len: 长度
+  * @retval 写入的字节数
+  */
+int _write(int fd, char* ptr, int len)
+{
+    (void)fd;
+    return (int)fwrite(ptr, 1, (size_t)len, stdout);
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,89 @@
+/**
+  ******************************************************************************
+  * @file    port_cfg.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   虚拟时间仿真移植层配置和仿真器接口
+  *          以虚拟CPU周期模拟TIM2、NVIC和PendSV，结果与主机负载无关
+  ******************************************************************************
+  * @attention
+  *
+  * 时间模型：
+  * - 虚拟时钟以SIM_CPU_HZ计数，TIM2计数值 = 周期数 / SIM_CYCLES_PER_TICK
+  * - 只有sim_run和异常进出消耗虚拟时间，内核C代码本身视为0周期，
+  *   切换路径的代价用SIM_SWITCH_CYCLES近似
+  * - 中断进入、退出和尾链的周期数取Cortex-M4手册的典型值
+  *
+  * 内核头文件目录须以-iquote加入，见port/posix/port_cfg.h。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __PORT_CFG_H__
+#define __PORT_CFG_H__
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <ucontext.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+#ifndef STACK_SIZE
+#define STACK_SIZE                  16384       /* 每个任务64KB主机栈 */
+#endif
+#define PORT_MIN_STACK_WORDS        4096        /* 静态任务至少16KB，C库函数在主机上栈用量大 */
+
+#define SIM_CPU_HZ                  168000000UL /* 虚拟CPU频率 */
+#define SIM_CYCLES_PER_TICK         2U          /* TIM2为84MHz */
+#define PORT_CYCLES_HZ              SIM_CPU_HZ  /* port_cycles为虚拟周期数 */
+
+/* 异常时序模型(周期) */
+#define SIM_IRQ_ENTRY_CYCLES        12U         /* 压栈并取向量 */
+#define SIM_IRQ_EXIT_CYCLES         10U         /* 出栈返回 */
+#define SIM_TAIL_CHAIN_CYCLES       6U          /* 尾链，跳过出栈和压栈 */
+#define SIM_SWITCH_CYCLES           40U         /* PendSV中保存/恢复寄存器和选择任务 */
+
+/* 中断编号与优先级 - 数值越小优先级越高 */
+#define SIM_IRQ_TIM2                0
+#define SIM_IRQ_PENDSV              1
+#define SIM_IRQ_USER                2           /* 场景脚本注册的中断从此编号开始 */
+#define SIM_MAX_IRQS                16
+#define SIM_TIM2_PRIORITY           3
+#define SIM_PENDSV_PRIORITY         15
+#define SIM_THREAD_PRIORITY         256         /* 线程模式的执行优先级 */
+
+#define SIM_NEVER                   UINT64_MAX
+
+/* 每个任务保存一份ucontext和名称 */
+#define PORT_TASK_FIELDS            ucontext_t port_context; const char* port_name;
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef void (*sim_isr_t)(void* arg);
+
+/* Exported functions ------------------------------------------------------- */
+
+struct task;
+
+/* 仿真控制 */
+void sim_reset(void);                           /* 时钟归零，清除全部中断，须在rtos_init前调用 */
+void sim_set_end(uint64_t cycles);              /* 到达该时刻后停止，rtos_start返回 */
+void sim_stop(void);                            /* 立即停止，须在任务或中断中调用 */
+uint64_t sim_now(void);                         /* 当前虚拟周期数 */
+void sim_run(uint32_t cycles);                  /* 当前上下文执行cycles个周期，期间可被中断和抢占 */
+
+/* 中断 */
+int sim_irq_register(const char* name, uint32_t priority, sim_isr_t isr, void* arg);
+void sim_irq_schedule(int irq, uint64_t at);    /* 在指定时刻置挂起位，SIM_NEVER取消 */
+void sim_irq_pend(int irq);                     /* 立即置挂起位 */
+
+/* 跟踪输出 - 每行以当前周期数开头 */
+void sim_set_trace(void (*out)(const char* line));
+void sim_trace(const char* who, const char* fmt, ...);
+void sim_set_task_name(struct task* task, const char* name);
+const char* sim_task_name(const struct task* task);
+
+#endif /* __PORT_CFG_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,589 @@
+/**
+  ******************************************************************************
+  * @file    rtos_printf.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   轻量级可重入格式化输出实现
+  ******************************************************************************
+  * @attention
+  *
+  * 实现原理：
+  * 1. 格式串中的普通文本按整段交给输出回调，不逐字符调用
+  * 2. 每个转换先在栈上的小缓冲区中生成数字，再统一处理符号、前缀、
+  *    精度补零和宽度填充，缓冲区大小固定(最长为64位八进制22位)
+  * 3. 32位数值只用32位除法，只有ll/j修饰的64位数值才走64位除法
+  * 4. %f用整数运算拼接整数部分和小数部分，小数按value的精确二进制值舍入，
+  *    恰在中点时取偶数(与glibc相同)
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "rtos_printf.h"
+#include <math.h>
+
+/* Private define ------------------------------------------------------------*/
+#define FLAG_LEFT       0x01U       /* '-' 左对齐 */
+#define FLAG_PLUS       0x02U       /* '+' 正数显示加号 */
+#define FLAG_SPACE      0x04U       /* ' ' 正数前加空格 */
+#define FLAG_ALT        0x08U       /* '#' 替代形式 */
+#define FLAG_ZERO       0x10U       /* '0' 用0填充宽度 */
+#define FLAG_UPPER      0x20U       /* 大写十六进制 */
+
+#define NUM_BUF_SIZE    32          /* 数字缓冲区：64位八进制22位，定点浮点20+1+9位 */
+#define FLOAT_MAX_PREC  9
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 一次格式化调用的输出状态 */
+typedef struct {
+    rtos_out_fn out;
+    void* ctx;
+    uint32_t count;             /* 已输出字符数 */
+} fmt_out_t;
+
+/* rtos_snprintf的输出目标 */
+typedef struct {
+    char* buf;
+    size_t size;
+    size_t pos;
+} buf_ctx_t;
+
+/* rtos_printf的栈上输出缓冲 */
+typedef struct {
+    char data[RTOS_PRINTF_BUFFER_SIZE];
+    uint32_t len;
+} stdout_ctx_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const char pad_spaces[16] = { ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ',
+                                     ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ' };
+static const char pad_zeros[16] = { '0', '0', '0', '0', '0', '0', '0', '0',
+                                    '0', '0', '0', '0', '0', '0', '0', '0' };
+static const char digits_lower[] = "0123456789abcdef";
+static const char digits_upper[] = "0123456789ABCDEF";
+static const uint32_t pow10_table[FLOAT_MAX_PREC + 1] = {
+    1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U
+};
+
+/* newlib输出系统调用，定义在main.c中 */
+extern int _write(int fd, char* ptr, int len);
+
+/* Private functions ---------------------------------------------------------*/
+
+static void emit(fmt_out_t* o, const char* s, uint32_t len)
+{
+    if (len > 0U) {
+        o->out(o->ctx, s, len);
+        o->count += len;
+    }
+}
+
+static void emit_pad(fmt_out_t* o, const char* pad, int n)
+{
+    while (n > 0) {
+        uint32_t chunk = (n > 16) ? 16U : (uint32_t)n;
+        emit(o, pad, chunk);
+        n -= (int)chunk;
+    }
+}
+
+/**
+  * @brief  输出一个字段：[空格][前缀][补零][正文][空格]
+  * @param  prefix: 符号或进制前缀
+  * @param  body: 正文(数字)
+  * @param  zeros: 精度要求的前导零个数
+  */
+static void emit_field(fmt_out_t* o, const char* prefix, uint32_t prefix_len,
+                       const char* body, uint32_t body_len, int zeros,
+                       uint32_t flags, int width)
+{
+    int pad = width - (int)(prefix_len + body_len) - zeros;
+
+    if ((flags & (FLAG_LEFT | FLAG_ZERO)) == 0U) {
+        emit_pad(o, pad_spaces, pad);
+    }
+    emit(o, prefix, prefix_len);
+    if ((flags & (FLAG_LEFT | FLAG_ZERO)) == FLAG_ZERO) {
+        emit_pad(o, pad_zeros, pad);
+    }
+    emit_pad(o, pad_zeros, zeros);
+    emit(o, body, body_len);
+    if ((flags & FLAG_LEFT) != 0U) {
+        emit_pad(o, pad_spaces, pad);
+    }
+}
+
+/* 把无符号数按进制写到缓冲区末尾，返回起始位置 */
+static char* utoa_rev(char* end, uint64_t value, uint32_t base, const char* digits)
+{
+    char* p = end;
+    uint32_t v32;
+
+    /* 超过32位的部分才使用64位除法 */
+    while (value > 0xFFFFFFFFULL) {
+        *--p = digits[value % base];
+        value /= base;
+    }
+    v32 = (uint32_t)value;
+    do {
+        *--p = digits[v32 % base];
+        v32 /= base;
+    } while (v32 != 0U);
+    return p;
+}
+
+static void format_integer(fmt_out_t* o, uint64_t value, int negative, uint32_t base,
+                           uint32_t flags, int width, int prec)
+{
+    char buf[NUM_BUF_SIZE];
+    char prefix[2];
+    uint32_t prefix_len = 0;
+    char* start = &buf[NUM_BUF_SIZE];
+    uint32_t len = 0;
+    int zeros;
+
+    if (negative) {
+        prefix[prefix_len++] = '-';
+    } else if ((flags & FLAG_PLUS) != 0U) {
+        prefix[prefix_len++] = '+';
+    } else if ((flags & FLAG_SPACE) != 0U) {
+        prefix[prefix_len++] = ' ';
+    }
+
+    /* 精度为0且值为0时不输出数字 */
+    if (value != 0U || prec != 0) {
+        start = utoa_rev(&buf[NUM_BUF_SIZE], value, base,
+                         ((flags & FLAG_UPPER) != 0U) ? digits_upper : digits_lower);
+        len = (uint32_t)(&buf[NUM_BUF_SIZE] - start);
+    }
+
+    if ((flags & FLAG_ALT) != 0U) {
+        if (base == 16U && value != 0U) {
+            prefix[prefix_len++] = '0';
+            prefix[prefix_len++] = ((flags & FLAG_UPPER) != 0U) ? 'X' : 'x';
+        } else if (base == 8U && (len == 0U || *start != '0') && (prec < 0 || prec <= (int)len)) {
+            *--start = '0';
+            len++;
+        }
+    }
+
+    /* 指定精度时忽略'0'标志 */
+    if (prec >= 0) {
+        flags &= ~FLAG_ZERO;
+    }
+    zeros = (prec > (int)len) ? prec - (int)len : 0;
+    emit_field(o, prefix, prefix_len, start, len, zeros, flags, width);
+}
+
+/* 把a拆成高低两半，各不超过26位有效位，两半之积没有舍入(Veltkamp) */
+static void split_double(double a, double* hi, double* lo)
+{
+    double c = 134217729.0 * a;     /* 2^27 + 1 */
+
+    *hi = c - (c - a);
+    *lo = a - *hi;
+}
+
+/* a*b = 乘积 + *err，*err为double乘法的精确舍入误差(Dekker)；各步须分别
+ * 舍入，不能被编译器合并为融合乘加 */
+static double two_product(double a, double b, double* err)
+{
+    double p = a * b;
+    double ah, al, bh, bl;
+
+    split_double(a, &ah, &al);
+    split_double(b, &bh, &bl);
+    *err = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+    return p;
+}
+
+static void format_float(fmt_out_t* o, double value, uint32_t flags, int width, int prec, int upper)
+{
+    char buf[NUM_BUF_SIZE];
+    char sign = 0;
+    char* start;
+    char* end = &buf[NUM_BUF_SIZE];
+    uint64_t ipart;
+    uint32_t fpart = 0;
+    double frac, diff, err;
+    int round_up;
+    uint32_t i;
+
+    if (signbit(value)) {
+        sign = '-';
+        value = -value;
+    } else if ((flags & FLAG_PLUS) != 0U) {
+        sign = '+';
+    } else if ((flags & FLAG_SPACE) != 0U) {
+        sign = ' ';
+    }
+
+    /* nan/inf/超出64位整数范围：不补零 */
+    if (isnan(value) || value >= 18446744073709551616.0) {
+        const char* text = isnan(value) ? (upper ? "NAN" : "nan")
+                         : isinf(value) ? (upper ? "INF" : "inf") : "ovf";
+        emit_field(o, &sign, (sign != 0) ? 1U : 0U, text, 3U, 0, flags & ~FLAG_ZERO, width);
+        return;
+    }
+
+    if (prec < 0) {
+        prec = 6;
+    } else if (prec > FLOAT_MAX_PREC) {
+        prec = FLOAT_MAX_PREC;
+    }
+
+    /* 整数部分和按精度放大的小数部分。小数部分value - ipart没有舍入，放大后
+     * 的积frac加err是精确值；舍去的部分frac - fpart + err与0.5比较，按
+     * value的精确二进制值舍入(与glibc一致，1.115实为1.11499...，%.2f为1.11)。
+     * frac恰为整数且err < 0时精确值略小于fpart，舍去部分接近1，仍取fpart */
+    ipart = (uint64_t)value;
+    frac = two_product(value - (double)ipart, (double)pow10_table[prec], &err);
+    fpart = (uint32_t)frac;
+    diff = frac - (double)fpart;
+    if (diff == 0.0 && err < 0.0) {
+        round_up = 0;
+    } else {
+        diff = (diff - 0.5) + err;
+        round_up = (diff > 0.0 ||
+                    (diff == 0.0 && ((prec > 0) ? (fpart & 1U) : (uint32_t)(ipart & 1U)) != 0U));
+    }
+    if (round_up) {
+        fpart++;
+    }
+    if (fpart >= pow10_table[prec]) {
+        fpart -= pow10_table[prec];
+        ipart++;
+    }
+
+    start = end;
+    if (prec > 0) {
+        for (i = 0; i < (uint32_t)prec; i++) {
+            *--start = (char)('0' + fpart % 10U);
+            fpart /= 10U;
+        }
+    }
+    if (prec > 0 || (flags & FLAG_ALT) != 0U) {
+        *--start = '.';
+    }
+    start = utoa_rev(start, ipart, 10U, digits_lower);
+    emit_field(o, &sign, (sign != 0) ? 1U : 0U, start, (uint32_t)(end - start), 0, flags, width);
+}
+
+static void buf_out(void* ctx, const char* data, uint32_t len)
+{
+    buf_ctx_t* b = (buf_ctx_t*)ctx;
+    uint32_t i;
+
+    for (i = 0; i < len && b->pos + 1U < b->size; i++) {
+        b->buf[b->pos++] = data[i];
+    }
+}
+
+static void stdout_flush(stdout_ctx_t* s)
+{
+    if (s->len > 0U) {
+        (void)_write(1, s->data, (int)s->len);
+        s->len = 0;
+    }
+}
+
+static void stdout_out(void* ctx, const char* data, uint32_t len)
+{
+    stdout_ctx_t* s = (stdout_ctx_t*)ctx;
+    uint32_t chunk;
+
+    while (len > 0U) {
+        if (s->len == RTOS_PRINTF_BUFFER_SIZE) {
+            stdout_flush(s);
+        }
+        chunk = RTOS_PRINTF_BUFFER_SIZE - s->len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        for (uint32_t i = 0; i < chunk; i++) {
+            s->data[s->len + i] = data[i];
+        }
+        s->len += chunk;
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  格式化输出到回调
+  * @param  out: 输出回调
+  * @param  ctx: 回调上下文
+  * @param  fmt: 格式字符串
+  * @param  ap: 参数列表
+  * @retval 输出的字符总数
+  */
+int rtos_vprintf_to(rtos_out_fn out, void* ctx, const char* fmt, va_list ap)
+{
+    fmt_out_t o;
+    const char* run;
+
+    o.out = out;
+    o.ctx = ctx;
+    o.count = 0;
+
+    while (*fmt != '\0') {
+        uint32_t flags = 0;
+        int width = 0;
+        int prec = -1;
+        int length = 0;         /* -2:hh -1:h 0:int 1:l 2:ll/j 3:z/t */
+        uint64_t uval;
+        int64_t sval;
+        char c;
+
+        /* 普通文本整段输出 */
+        run = fmt;
+        while (*fmt != '\0' && *fmt != '%') {
+            fmt++;
+        }
+        emit(&o, run, (uint32_t)(fmt - run));
+        if (*fmt == '\0') {
+            break;
+        }
+        fmt++;
+
+        /* 标志 */
+        for (;;) {
+            if (*fmt == '-') {
+                flags |= FLAG_LEFT;
+            } else if (*fmt == '+') {
+                flags |= FLAG_PLUS;
+            } else if (*fmt == ' ') {
+                flags |= FLAG_SPACE;
+            } else if (*fmt == '#') {
+                flags |= FLAG_ALT;
+            } else if (*fmt == '0') {
+                flags |= FLAG_ZERO;
+            } else {
+                break;
+            }
+            fmt++;
+        }
+
+        /* 宽度 */
+        if (*fmt == '*') {
+            width = va_arg(ap, int);
+            if (width < 0) {
+                flags |= FLAG_LEFT;
+                width = -width;
+            }
+            fmt++;
+        } else {
+            while (*fmt >= '0' && *fmt <= '9') {
+                width = width * 10 + (*fmt++ - '0');
+            }
+        }
+
+        /* 精度 */
+        if (*fmt == '.') {
+            fmt++;
+            prec = 0;
+            if (*fmt == '*') {
+                prec = va_arg(ap, int);
+                if (prec < 0) {
+                    prec = -1;
+                }
+                fmt++;
+            } else {
+                while (*fmt >= '0' && *fmt <= '9') {
+                    prec = prec * 10 + (*fmt++ - '0');
+                }
+            }
+        }
+
+        /* 长度修饰 */
+        switch (*fmt) {
+        case 'h':
+            length = (fmt[1] == 'h') ? -2 : -1;
+            fmt += (fmt[1] == 'h') ? 2 : 1;
+            break;
+        case 'l':
+            length = (fmt[1] == 'l') ? 2 : 1;
+            fmt += (fmt[1] == 'l') ? 2 : 1;
+            break;
+        case 'j':
+            length = 2;
+            fmt++;
+            break;
+        case 'z':
+        case 't':
+            length = 3;
+            fmt++;
+            break;
+        case 'L':
+            fmt++;
+            break;
+        default:
+            break;
+        }
+
+        c = *fmt;
+        if (c == '\0') {
+            break;
+        }
+        fmt++;
+
+        switch (c) {
+        case 'd':
+        case 'i':
+            if (length == 2) {
+                sval = va_arg(ap, long long);
+            } else if (length == 1) {
+                sval = va_arg(ap, long);
+            } else if (length == 3) {
+                sval = (int64_t)va_arg(ap, ptrdiff_t);
+            } else {
+                sval = va_arg(ap, int);
+                if (length == -1) {
+                    sval = (short)sval;
+                } else if (length == -2) {
+                    sval = (signed char)sval;
+                }
+            }
+            uval = (sval < 0) ? (0U - (uint64_t)sval) : (uint64_t)sval;
+            format_integer(&o, uval, sval < 0, 10U, flags, width, prec);
+            break;
+
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            if (length == 2) {
+                uval = va_arg(ap, unsigned long long);
+            } else if (length == 1) {
+                uval = va_arg(ap, unsigned long);
+            } else if (length == 3) {
+                uval = va_arg(ap, size_t);
+            } else {
+                uval = va_arg(ap, unsigned int);
+                if (length == -1) {
+                    uval = (unsigned short)uval;
+                } else if (length == -2) {
+                    uval = (unsigned char)uval;
+                }
+            }
+            flags &= ~(FLAG_PLUS | FLAG_SPACE);
+            if (c == 'X') {
+                flags |= FLAG_UPPER;
+            }
+            format_integer(&o, uval, 0, (c == 'u') ? 10U : (c == 'o') ? 8U : 16U, flags, width, prec);
+            break;
+
+        case 'p': {
+            void* p = va_arg(ap, void*);
+            if (p == NULL) {
+                emit_field(&o, "", 0, "(nil)", 5U, 0, flags & ~FLAG_ZERO, width);
+            } else {
+                format_integer(&o, (uint64_t)(uintptr_t)p, 0, 16U,
+                               (flags & FLAG_LEFT) | FLAG_ALT, width, -1);
+            }
+            break;
+        }
+
+        case 'c': {
+            char ch = (char)va_arg(ap, int);
+            emit_field(&o, "", 0, &ch, 1U, 0, flags & FLAG_LEFT, width);
+            break;
+        }
+
+        case 's': {
+            const char* s = va_arg(ap, const char*);
+            uint32_t len = 0;
+            if (s == NULL) {
+                s = "(null)";
+            }
+            while (s[len] != '\0' && (prec < 0 || len < (uint32_t)prec)) {
+                len++;
+            }
+            emit_field(&o, "", 0, s, len, 0, flags & FLAG_LEFT, width);
+            break;
+        }
+
+        case 'f':
+        case 'F':
+            format_float(&o, va_arg(ap, double), flags, width, prec, c == 'F');
+            break;
+
+        case '%':
+            emit(&o, "%", 1U);
+            break;
+
+        default:
+            /* 不支持的转换原样输出 */
+            emit(&o, "%", 1U);
+            emit(&o, &c, 1U);
+            break;
+        }
+    }
+
+    return (int)o.count;
+}
+
+int rtos_printf_to(rtos_out_fn out, void* ctx, const char* fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = rtos_vprintf_to(out, ctx, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+int rtos_vsnprintf(char* buf, size_t size, const char* fmt, va_list ap)
+{
+    buf_ctx_t b;
+    int n;
+
+    b.buf = buf;
+    b.size = size;
+    b.pos = 0;
+    n = rtos_vprintf_to(buf_out, &b, fmt, ap);
+    if (size > 0U) {
+        buf[b.pos] = '\0';
+    }
+    return n;
+}
+
+int rtos_snprintf(char* buf, size_t size, const char* fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = rtos_vsnprintf(buf, size, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+int rtos_vprintf(const char* fmt, va_list ap)
+{
+    stdout_ctx_t s;
+    int n;
+
+    s.len = 0;
+    n = rtos_vprintf_to(stdout_out, &s, fmt, ap);
+    stdout_flush(&s);
+    return n;
+}
+
+int rtos_printf(const char* fmt, ...)
+{
+    va_list ap;
+    int n;
+
+    va_start(ap, fmt);
+    n = rtos_vprintf(fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,79 @@
+/**
+  ******************************************************************************
+  * @file    rtos_printf.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   轻量级可重入格式化输出头文件
+  *          替代newlib printf，不使用堆，栈用量有上界
+  ******************************************************************************
+  * @attention
+  *
+  * 支持的格式：
+  * - 标志：'-' '+' ' ' '#' '0'，宽度和精度(含'*')
+  * - 长度修饰：hh h l ll z j t (L被忽略)
+  * - 转换：d i u x X o c s p % f F
+  * - %f为定点输出，精度默认6、最大9；|x| >= 2^64时输出"ovf"
+  * - 不支持%e/%g/%a和%n
+  *
+  * 可重入性：不使用任何静态可写数据，多个任务和中断可同时调用。
+  *
+  * 栈用量：无递归、无变长数组，最深调用链为
+  *   rtos_vprintf_to -> format_integer/format_float -> emit_field -> emit_pad -> 输出回调
+  * Cortex-M4上按AAPCS逐帧估算(未实测)约350字节(rtos_snprintf起，含局部缓冲区
+  * buf[32]和各帧push {r4-r11,lr})：rtos_snprintf/rtos_vsnprintf各约24，
+  * rtos_vprintf_to(format_float内联)约120，format_integer约80，emit_field约48，
+  * emit_pad/emit/buf_out合计约48。精确值以固件的make stack(03_tools/stack_report
+  * 按arm-none-eabi-gcc -fstack-usage的.su/.ci计算)或RUN_BENCHMARKS下bench_printf
+  * 的栈着色结果为准。主机x86-64 -Os下stack_report给出752字节，其中变参函数各有
+  * 176字节的寄存器保存区，ARM上没有，不能作为目标板的数值。rtos_printf另需
+  * RTOS_PRINTF_BUFFER_SIZE字节的输出缓冲。以上均不含输出回调自身的栈用量。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __RTOS_PRINTF_H__
+#define __RTOS_PRINTF_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* rtos_printf的栈上输出缓冲区大小，满后交给_write输出 */
+#ifndef RTOS_PRINTF_BUFFER_SIZE
+#define RTOS_PRINTF_BUFFER_SIZE     64
+#endif
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 输出回调：格式化结果按片段交给回调，data不以'\0'结尾 */
+typedef void (*rtos_out_fn)(void* ctx, const char* data, uint32_t len);
+
+/* Exported functions ------------------------------------------------------- */
+
+/* 输出到指定回调，返回输出的字符总数 */
+int rtos_vprintf_to(rtos_out_fn out, void* ctx, const char* fmt, va_list ap);
+int rtos_printf_to(rtos_out_fn out, void* ctx, const char* fmt, ...);
+
+/* 输出到缓冲区，语义同C99 snprintf：总是以'\0'结尾，返回完整结果的长度 */
+int rtos_vsnprintf(char* buf, size_t size, const char* fmt, va_list ap);
+int rtos_snprintf(char* buf, size_t size, const char* fmt, ...);
+
+/* 输出到标准输出(_write，即UART1或RTT，见main.h中的STDIO_USE_RTT) */
+int rtos_vprintf(const char* fmt, va_list ap);
+int rtos_printf(const char* fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RTOS_PRINTF_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,451 @@
+/**
+  ******************************************************************************
+  * @file    rtt.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   基于RAM控制块的实时传输(RTT)通道实现
+  ******************************************************************************
+  * @attention
+  *
+  * 实现原理：
+  * 1. 目标端只更新上行通道的wr_off和下行通道的rd_off，调试器只更新
+  *    上行通道的rd_off和下行通道的wr_off，双方无需加锁
+  * 2. 先拷贝数据再以DMB保证顺序后发布新的偏移，调试器不会读到半条数据
+  * 3. 多个任务/中断写同一通道时，写入过程在临界区内完成(仅一次memcpy)
+  * 4. 阻塞模式下通道满时任务以Delay_ms睡眠，其他任务和中断照常运行；
+  *    调试器超过RTT_BLOCK_TIMEOUT_MS没有读取时丢弃剩余数据并记住该读偏移，
+  *    此后调试器仍未读取时直接丢弃，不再逐条等待。中断中和调度器启动前
+  *    不能睡眠，按截断模式处理
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "rtt.h"
+#include "core.h"
+#include "time.h"
+#include "stm32f4xx.h"
+#include <string.h>
+
+/* Private variables ---------------------------------------------------------*/
+
+/* 控制块 - 放在.bss中(RAM1, 0x2000xxxx)，便于调试器按默认范围扫描 */
+rtt_control_block_t _SEGGER_RTT;
+
+/* 通道0缓冲区 */
+static char rtt_up_buffer[RTT_UP_BUFFER_SIZE];
+static char rtt_down_buffer[RTT_DOWN_BUFFER_SIZE];
+
+/* 上行通道溢出丢弃计数(字节) - 不放入控制块，保持与调试器的布局兼容 */
+static volatile uint32_t rtt_drop_count[RTT_MAX_UP_BUFFERS];
+
+/* 阻塞模式超时时的读偏移加1，0表示未超时；调试器读走数据后失效 */
+static volatile uint32_t rtt_stall_rd[RTT_MAX_UP_BUFFERS];
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t rtt_get_avail_write(const rtt_buffer_t* ring);
+static void rtt_write_no_check(rtt_buffer_t* ring, const uint8_t* data, uint32_t len);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  计算上行缓冲区可写空间
+  * @param  ring: 通道描述符
+  * @retval 可写字节数 (保留1字节区分空/满)
+  */
+static uint32_t rtt_get_avail_write(const rtt_buffer_t* ring)
+{
+    uint32_t rd = ring->rd_off;
+    uint32_t wr = ring->wr_off;
+
+    if (rd <= wr) {
+        return ring->size - 1U - wr + rd;
+    }
+    return rd - wr - 1U;
+}
+
+/**
+  * @brief  向上行缓冲区写入数据(调用者保证空间足够)
+  * @param  ring: 通道描述符
+  * @param  data: 数据指针
+  * @param  len: 数据长度
+  * @retval None
+  */
+static void rtt_write_no_check(rtt_buffer_t* ring, const uint8_t* data, uint32_t len)
+{
+    uint32_t wr = ring->wr_off;
+    uint32_t first = ring->size - wr;
+
+    if (first > len) {
+        first = len;
+    }
+
+    /* 最多两段拷贝：缓冲区尾部 + 回绕到头部 */
+    memcpy(ring->buffer + wr, data, first);
+    if (len > first) {
+        memcpy(ring->buffer, data + first, len - first);
+    }
+
+    wr += len;
+    if (wr >= ring->size) {
+        wr -= ring->size;
+    }
+
+    /* 数据落地后再发布写偏移 */
+    __DMB();
+    ring->wr_off = wr;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  RTT初始化 - 建立控制块并配置通道0
+  * @param  None
+  * @retval None
+  * @note   魔术字符串最后写入，调试器不会定位到未初始化完毕的控制块
+  */
+void RTT_Init(void)
+{
+    rtt_control_block_t* cb = &_SEGGER_RTT;
+
+    memset(cb, 0, sizeof(*cb));
+    memset((void*)rtt_drop_count, 0, sizeof(rtt_drop_count));
+    memset((void*)rtt_stall_rd, 0, sizeof(rtt_stall_rd));
+
+    cb->max_up_buffers = RTT_MAX_UP_BUFFERS;
+    cb->max_down_buffers = RTT_MAX_DOWN_BUFFERS;
+
+    cb->up[0].name = "Terminal";
+    cb->up[0].buffer = rtt_up_buffer;
+    cb->up[0].size = sizeof(rtt_up_buffer);
+    cb->up[0].flags = RTT_MODE_NO_BLOCK_SKIP;
+
+    cb->down[0].name = "Terminal";
+    cb->down[0].buffer = rtt_down_buffer;
+    cb->down[0].size = sizeof(rtt_down_buffer);
+    cb->down[0].flags = RTT_MODE_NO_BLOCK_SKIP;
+
+    __DMB();
+    memcpy(cb->id, RTT_CB_ID, sizeof(RTT_CB_ID));
+    __DMB();
+}
+
+/**
+  * @brief  配置上行通道
+  * @param  ch: 通道号
+  * @param  name: 通道名称 (调试器显示用)
+  * @param  buf: 缓冲区 (NULL表示保留原缓冲区，仅修改名称和模式)
+  * @param  size: 缓冲区大小，至少2字节
+  * @param  flags: 写入模式 RTT_MODE_xxx
+  * @retval 0成功，-1参数错误
+  */
+int RTT_ConfigUpBuffer(uint32_t ch, const char* name, void* buf, uint32_t size, uint32_t flags)
+{
+    rtt_buffer_t* ring;
+    uint32_t primask;
+
+    if (ch >= RTT_MAX_UP_BUFFERS || (buf != NULL && size < 2U)) {
+        return -1;
+    }
+
+    ring = &_SEGGER_RTT.up[ch];
+    primask = rtos_enter_critical();
+    if (buf != NULL) {
+        ring->buffer = (char*)buf;
+        ring->size = size;
+        ring->rd_off = 0;
+        ring->wr_off = 0;
+    }
+    ring->name = name;
+    ring->flags = flags;
+    rtt_drop_count[ch] = 0;
+    rtt_stall_rd[ch] = 0;
+    rtos_exit_critical(primask);
+
+    return 0;
+}
+
+/**
+  * @brief  配置下行通道
+  * @param  ch: 通道号
+  * @param  name: 通道名称
+  * @param  buf: 缓冲区 (NULL表示保留原缓冲区)
+  * @param  size: 缓冲区大小，至少2字节
+  * @param  flags: 保留
+  * @retval 0成功，-1参数错误
+  */
+int RTT_ConfigDownBuffer(uint32_t ch, const char* name, void* buf, uint32_t size, uint32_t flags)
+{
+    rtt_buffer_t* ring;
+    uint32_t primask;
+
+    if (ch >= RTT_MAX_DOWN_BUFFERS || (buf != NULL && size < 2U)) {
+        return -1;
+    }
+
+    ring = &_SEGGER_RTT.down[ch];
+    primask = rtos_enter_critical();
+    if (buf != NULL) {
+        ring->buffer = (char*)buf;
+        ring->size = size;
+        ring->rd_off = 0;
+        ring->wr_off = 0;
+    }
+    ring->name = name;
+    ring->flags = flags;
+    rtos_exit_critical(primask);
+
+    return 0;
+}
+
+/**
+  * @brief  修改上行通道写入模式
+  * @param  ch: 通道号
+  * @param  mode: RTT_MODE_xxx
+  * @retval 0成功，-1参数错误
+  */
+int RTT_SetUpMode(uint32_t ch, uint32_t mode)
+{
+    rtt_buffer_t* ring;
+
+    if (ch >= RTT_MAX_UP_BUFFERS) {
+        return -1;
+    }
+
+    ring = &_SEGGER_RTT.up[ch];
+    ring->flags = (ring->flags & ~RTT_MODE_MASK) | (mode & RTT_MODE_MASK);
+    return 0;
+}
+
+/**
+  * @brief  向上行通道写入数据
+  * @param  ch: 通道号
+  * @param  data: 数据指针
+  * @param  len: 数据长度
+  * @retval 实际写入的字节数
+  * @note   RTT_MODE_BLOCK_IF_FULL模式下通道满时睡眠等待，调试器
+  *         RTT_BLOCK_TIMEOUT_MS内没有读取则丢弃剩余数据；中断中和调度器
+  *         启动前不等待，按截断处理
+  */
+uint32_t RTT_Write(uint32_t ch, const void* data, uint32_t len)
+{
+    rtt_buffer_t* ring;
+    const uint8_t* p = (const uint8_t*)data;
+    uint32_t written = 0;
+    uint32_t avail;
+    uint32_t chunk;
+    uint32_t primask;
+    uint32_t idle_ms;
+    int can_wait;
+
+    if (ch >= RTT_MAX_UP_BUFFERS || len == 0) {
+        return 0;
+    }
+
+    ring = &_SEGGER_RTT.up[ch];
+    if (ring->buffer == NULL) {
+        return 0;
+    }
+
+    switch (ring->flags & RTT_MODE_MASK) {
+    case RTT_MODE_NO_BLOCK_SKIP:
+        primask = rtos_enter_critical();
+        if (rtt_get_avail_write(ring) >= len) {
+            rtt_write_no_check(ring, p, len);
+            written = len;
+        } else {
+            rtt_drop_count[ch] += len;
+        }
+        rtos_exit_critical(primask);
+        break;
+
+    case RTT_MODE_NO_BLOCK_TRIM:
+        primask = rtos_enter_critical();
+        avail = rtt_get_avail_write(ring);
+        written = (avail < len) ? avail : len;
+        if (written > 0) {
+            rtt_write_no_check(ring, p, written);
+        }
+        rtt_drop_count[ch] += len - written;
+        rtos_exit_critical(primask);
+        break;
+
+    default:
+        /* 阻塞模式：分段写入，通道满时睡眠等待调试器读取 */
+        can_wait = scheduler.running && !port_in_isr();
+        idle_ms = 0;
+        while (written < len) {
+            primask = rtos_enter_critical();
+            avail = rtt_get_avail_write(ring);
+            chunk = len - written;
+            if (chunk > avail) {
+                chunk = avail;
+            }
+            if (chunk > 0) {
+                rtt_write_no_check(ring, p + written, chunk);
+                written += chunk;
+                idle_ms = 0;
+                rtt_stall_rd[ch] = 0;
+            } else if (!can_wait || idle_ms >= RTT_BLOCK_TIMEOUT_MS ||
+                       rtt_stall_rd[ch] == ring->rd_off + 1U) {
+                /* 不能睡眠、等待超时或上次超时后调试器仍未读取：丢弃剩余数据 */
+                if (can_wait) {
+                    rtt_stall_rd[ch] = ring->rd_off + 1U;
+                }
+                rtt_drop_count[ch] += len - written;
+                rtos_exit_critical(primask);
+                break;
+            }
+            rtos_exit_critical(primask);
+
+            if (chunk == 0) {
+                Delay_ms(RTT_BLOCK_POLL_MS);
+                idle_ms += RTT_BLOCK_POLL_MS;
+            }
+        }
+        break;
+    }
+
+    return written;
+}
+
+/**
+  * @brief  向上行通道写入字符串
+  * @param  ch: 通道号
+  * @param  s: 以'\0'结尾的字符串
+  * @retval 实际写入的字节数
+  */
+uint32_t RTT_WriteString(uint32_t ch, const char* s)
+{
+    return RTT_Write(ch, s, (uint32_t)strlen(s));
+}
+
+/**
+  * @brief  向上行通道写入单个字符
+  * @param  ch: 通道号
+  * @param  c: 字符
+  * @retval 1成功，0被丢弃
+  */
+int RTT_PutChar(uint32_t ch, char c)
+{
+    return (int)RTT_Write(ch, &c, 1);
+}
+
+/**
+  * @brief  从下行通道读取数据
+  * @param  ch: 通道号
+  * @param  buf: 接收缓冲区
+  * @param  len: 最大读取长度
+  * @retval 实际读出的字节数
+  */
+uint32_t RTT_Read(uint32_t ch, void* buf, uint32_t len)
+{
+    rtt_buffer_t* ring;
+    uint8_t* p = (uint8_t*)buf;
+    uint32_t rd;
+    uint32_t wr;
+    uint32_t chunk;
+    uint32_t count = 0;
+    uint32_t primask;
+
+    if (ch >= RTT_MAX_DOWN_BUFFERS) {
+        return 0;
+    }
+
+    ring = &_SEGGER_RTT.down[ch];
+    if (ring->buffer == NULL) {
+        return 0;
+    }
+
+    primask = rtos_enter_critical();
+    rd = ring->rd_off;
+    wr = ring->wr_off;
+    __DMB();
+
+    /* 先读到缓冲区尾部，再处理回绕部分 */
+    while (count < len && rd != wr) {
+        chunk = (wr > rd) ? (wr - rd) : (ring->size - rd);
+        if (chunk > len - count) {
+            chunk = len - count;
+        }
+        memcpy(p + count, ring->buffer + rd, chunk);
+        count += chunk;
+        rd += chunk;
+        if (rd >= ring->size) {
+            rd = 0;
+        }
+    }
+
+    if (count > 0) {
+        __DMB();
+        ring->rd_off = rd;
+    }
+    rtos_exit_critical(primask);
+
+    return count;
+}
+
+/**
+  * @brief  从通道0读取一个字节
+  * @param  None
+  * @retval 读到的字节，无数据返回-1
+  */
+int RTT_GetKey(void)
+{
+    uint8_t c;
+
+    if (RTT_Read(0, &c, 1) == 1) {
+        return (int)c;
+    }
+    return -1;
+}
+
+/**
+  * @brief  查询下行通道可读字节数
+  * @param  ch: 通道号
+  * @retval 可读字节数
+  */
+uint32_t RTT_HasData(uint32_t ch)
+{
+    const rtt_buffer_t* ring;
+    uint32_t rd;
+    uint32_t wr;
+
+    if (ch >= RTT_MAX_DOWN_BUFFERS) {
+        return 0;
+    }
+
+    ring = &_SEGGER_RTT.down[ch];
+    rd = ring->rd_off;
+    wr = ring->wr_off;
+    return (wr >= rd) ? (wr - rd) : (ring->size - rd + wr);
+}
+
+/**
+  * @brief  查询上行通道剩余空间
+  * @param  ch: 通道号
+  * @retval 可写字节数
+  */
+uint32_t RTT_GetFreeSpace(uint32_t ch)
+{
+    if (ch >= RTT_MAX_UP_BUFFERS || _SEGGER_RTT.up[ch].buffer == NULL) {
+        return 0;
+    }
+    return rtt_get_avail_write(&_SEGGER_RTT.up[ch]);
+}
+
+/**
+  * @brief  查询上行通道因溢出而丢弃的字节数
+  * @param  ch: 通道号
+  * @retval 丢弃字节数
+  */
+uint32_t RTT_GetDropCount(uint32_t ch)
+{
+    if (ch >= RTT_MAX_UP_BUFFERS) {
+        return 0;
+    }
+    return rtt_drop_count[ch];
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,124 @@
+/**
+  ******************************************************************************
+  * @file    rtt.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   基于RAM控制块的实时传输(RTT)通道头文件
+  *          通过调试器后台读写内存实现高带宽日志输出和命令输入
+  ******************************************************************************
+  * @attention
+  *
+  * 本文件实现了与SEGGER RTT内存布局兼容的上行/下行环形缓冲区：
+  * 1. 控制块以魔术字符串"SEGGER RTT"开头，调试器扫描RAM即可定位
+  * 2. 上行通道(目标->主机)和下行通道(主机->目标)均为单生产者/单消费者
+  *    无锁环形缓冲区，调试器在CPU运行时后台访问，不占用任何外设
+  * 3. 上行通道支持三种写入模式：丢弃整条(计数)、截断写入(计数)、阻塞等待
+  *    (有超时，调试器断开时不会卡住任务)
+  * 4. 可通过main.h中的STDIO_USE_RTT将printf/fputc重定向到通道0
+  *
+  * J-Link RTT Viewer、OpenOCD(rtt setup)、pyOCD均可直接识别该控制块，
+  * 无硬件时可用03_tools/rtt_reader解析RAM转储文件。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __RTT_H__
+#define __RTT_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* 通道配置 - 可在编译选项中覆盖 */
+#ifndef RTT_MAX_UP_BUFFERS
+#define RTT_MAX_UP_BUFFERS      4           /* 上行通道数量 */
+#endif
+
+#ifndef RTT_MAX_DOWN_BUFFERS
+#define RTT_MAX_DOWN_BUFFERS    3           /* 下行通道数量 */
+#endif
+
+#ifndef RTT_UP_BUFFER_SIZE
+#define RTT_UP_BUFFER_SIZE      1024        /* 通道0上行缓冲区大小(字节) */
+#endif
+
+#ifndef RTT_DOWN_BUFFER_SIZE
+#define RTT_DOWN_BUFFER_SIZE    16          /* 通道0下行缓冲区大小(字节) */
+#endif
+
+#ifndef RTT_BLOCK_POLL_MS
+#define RTT_BLOCK_POLL_MS       1           /* 阻塞模式下通道满时每次睡眠的时间 */
+#endif
+
+#ifndef RTT_BLOCK_TIMEOUT_MS
+#define RTT_BLOCK_TIMEOUT_MS    100         /* 阻塞模式下调试器无读取的最长等待，超时丢弃剩余数据 */
+#endif
+
+#define RTT_CB_ID               "SEGGER RTT"  /* 控制块魔术字符串，调试器据此定位 */
+#define RTT_CB_ID_SIZE          16            /* 魔术字符串区域长度 */
+
+/* 上行通道写入模式 (flags低2位) */
+#define RTT_MODE_NO_BLOCK_SKIP  0UL         /* 空间不足时丢弃整条数据并计数 */
+#define RTT_MODE_NO_BLOCK_TRIM  1UL         /* 空间不足时写入能写下的部分，其余计数 */
+#define RTT_MODE_BLOCK_IF_FULL  2UL         /* 空间不足时睡眠等待调试器读走数据，超时丢弃 */
+#define RTT_MODE_MASK           3UL
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 环形缓冲区描述符 - 布局与SEGGER RTT一致，调试器按此偏移读写 */
+typedef struct {
+    const char* name;           /* 通道名称 */
+    char* buffer;               /* 缓冲区首地址 */
+    uint32_t size;              /* 缓冲区大小 */
+    volatile uint32_t wr_off;   /* 写偏移 - 由生产者更新 */
+    volatile uint32_t rd_off;   /* 读偏移 - 由消费者更新 */
+    uint32_t flags;             /* 写入模式等标志 */
+} rtt_buffer_t;
+
+/* RTT控制块 */
+typedef struct {
+    char id[RTT_CB_ID_SIZE];                    /* 魔术字符串 */
+    int32_t max_up_buffers;                     /* 上行通道数量 */
+    int32_t max_down_buffers;                   /* 下行通道数量 */
+    rtt_buffer_t up[RTT_MAX_UP_BUFFERS];        /* 上行通道 (目标->主机) */
+    rtt_buffer_t down[RTT_MAX_DOWN_BUFFERS];    /* 下行通道 (主机->目标) */
+} rtt_control_block_t;
+
+/* Exported variables --------------------------------------------------------*/
+extern rtt_control_block_t _SEGGER_RTT;        /* 控制块，符号名与SEGGER保持一致 */
+
+/* Exported functions ------------------------------------------------------- */
+
+/* 初始化与配置 */
+void RTT_Init(void);
+int RTT_ConfigUpBuffer(uint32_t ch, const char* name, void* buf, uint32_t size, uint32_t flags);
+int RTT_ConfigDownBuffer(uint32_t ch, const char* name, void* buf, uint32_t size, uint32_t flags);
+int RTT_SetUpMode(uint32_t ch, uint32_t mode);
+
+/* 上行写入 - 返回实际写入的字节数 */
+uint32_t RTT_Write(uint32_t ch, const void* data, uint32_t len);
+uint32_t RTT_WriteString(uint32_t ch, const char* s);
+int RTT_PutChar(uint32_t ch, char c);
+
+/* 下行读取 - 返回实际读出的字节数 */
+uint32_t RTT_Read(uint32_t ch, void* buf, uint32_t len);
+int RTT_GetKey(void);               /* 从通道0读取一个字节，无数据返回-1 */
+uint32_t RTT_HasData(uint32_t ch);  /* 下行通道可读字节数 */
+
+/* 状态查询 */
+uint32_t RTT_GetFreeSpace(uint32_t ch);   /* 上行通道剩余空间 */
+uint32_t RTT_GetDropCount(uint32_t ch);   /* 上行通道因溢出丢弃的字节数 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RTT_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -10,10 +10,12 @@
   * @attention
   *
   * 实现原理：
-  * 1. 使用TIM2作为高精度定时器，时钟频率84MHz
-  * 2. 延时开始时挂起当前任务，设置定时器目标值
-  * 3. 定时器中断触发时恢复任务，进行任务调度
-  * 4. 支持100ns级别的精确延时
+  * 1. 使用移植层定时器(目标板为TIM2)作为高精度定时器，时钟频率84MHz
+  * 2. 延时开始时挂起当前任务，按到期时间插入延时链表
+  * 3. TIM2比较值始终对应链表中最早到期的任务，多个任务可同时延时
+  * 4. 定时器中断触发时恢复所有到期任务，进行任务调度
+  * 5. 等待队列的超时同样由延时链表实现 (task_wait_timeout)
+  * 6. 支持100ns级别的精确延时
   *
   ******************************************************************************
   */
@@ -21,7 +23,7 @@
 /* Includes ------------------------------------------------------------------*/
 #include "time.h"
 #include "core.h"
-#include "../User/config/stm32f4/core/main.h"
+#include <stddef.h>
 
 /* Private typedef -----------------------------------------------------------*/
 
@@ -31,113 +33,89 @@
 
 /* Private variables ---------------------------------------------------------*/
 
-/* 延时控制结构体 */
+/* 延时控制结构体 - 镜像延时链表的队首，供状态查询接口使用 */
 static delay_control_t delay_ctrl = {
     .state = DELAY_IDLE,
     .target_count = 0,
     .waiting_task = NULL
 };
 
-/* 延时开始时的基准计数值 */
-static uint32_t delay_start_count = 0;
+/* 延时链表 - 按到期时间升序排列，TIM2比较值始终对应链表首个任务 */
+static task_t* delay_list = NULL;
 
 /* Private function prototypes -----------------------------------------------*/
-static void tim2_config(void);
+static void tim2_program_compare(void);
 static void tim2_start_delay(uint32_t ticks);
-static void tim2_stop_delay(void);
+static void delay_ticks64(uint64_t ticks);
 
 /* Private functions ---------------------------------------------------------*/
 
 /**
-  * @brief  TIM2定时器配置
+  * @brief  按延时链表首个任务设置TIM2比较值
   * @param  None
   * @retval None
+  * @note   须在临界区或定时器中断中调用；若设置时目标已经过去，
+  *         移植层立即触发一次比较中断，避免等待计数器回绕
   */
-static void tim2_config(void)
+static void tim2_program_compare(void)
 {
-    TIM_TimeBaseInitTypeDef TIM_TimeBaseStructure;
-    TIM_OCInitTypeDef TIM_OCInitStructure;
-    
-    /* 使能TIM2时钟 */
-    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, ENABLE);
-    
-    /* 配置TIM2时基单元 */
-    TIM_TimeBaseStructure.TIM_Period = 0xFFFFFFFF;        /* 32位最大值 */
-    TIM_TimeBaseStructure.TIM_Prescaler = 0;              /* 无分频，直接使用84MHz */
-    TIM_TimeBaseStructure.TIM_ClockDivision = TIM_CKD_DIV1;
-    TIM_TimeBaseStructure.TIM_CounterMode = TIM_CounterMode_Up;
-    TIM_TimeBaseInit(TIM2, &TIM_TimeBaseStructure);
-    
-    /* 配置TIM2输出比较通道1 */
-    TIM_OCInitStructure.TIM_OCMode = TIM_OCMode_Timing;   /* 输出比较模式：定时模式 */
-    TIM_OCInitStructure.TIM_OutputState = TIM_OutputState_Disable; /* 禁用输出 */
-    TIM_OCInitStructure.TIM_Pulse = 0;                    /* 初始比较值 */
-    TIM_OCInitStructure.TIM_OCPolarity = TIM_OCPolarity_High;
-    TIM_OC1Init(TIM2, &TIM_OCInitStructure);
-    TIM_OC1PreloadConfig(TIM2, TIM_OCPreload_Disable);
-    
-    /* 使能TIM2比较中断 */
-    TIM_ITConfig(TIM2, TIM_IT_CC1, ENABLE);
+    if (delay_list == NULL) {
+        delay_ctrl.state = DELAY_IDLE;
+        delay_ctrl.waiting_task = NULL;
+        port_timer_cancel();
+        return;
+    }
     
-    /* 设置TIM2中断优先级 */
-    NVIC_SetPriority(TIM2_IRQn, 3);  /* 优先级高于PendSV(15)，低于SVC(0) */
-    NVIC_EnableIRQ(TIM2_IRQn);
+    delay_ctrl.state = DELAY_ACTIVE;
+    delay_ctrl.target_count = delay_list->delay_target;
+    delay_ctrl.waiting_task = (void*)delay_list;
     
-    /* 启动TIM2 */
-    TIM_Cmd(TIM2, ENABLE);
+    port_timer_set_compare(delay_list->delay_target);
 }
 
 /**
-  * @brief  启动TIM2延时
-  * @param  ticks: 延时时钟周期数
+  * @brief  启动TIM2延时 - 挂起当前任务直到延时到期
+  * @param  ticks: 延时时钟周期数，不超过DELAY_MAX_CHUNK_TICKS
   * @retval None
   */
 static void tim2_start_delay(uint32_t ticks)
 {
-    uint32_t current_count;
-    
-    /* 获取当前计数值 */
-    current_count = TIM_GetCounter(TIM2);
-    
-    /* 计算目标计数值 */
-    delay_ctrl.target_count = current_count + ticks;
-    
-    /* 设置比较值 */
-    TIM_SetCompare1(TIM2, delay_ctrl.target_count);
-    
-    /* 设置延时状态 */
-    delay_ctrl.state = DELAY_ACTIVE;
-    delay_ctrl.waiting_task = (void*)scheduler.current_task;
-    
-    /* 挂起当前任务 */
-    if (delay_ctrl.waiting_task) {
-        task_suspend((task_t*)delay_ctrl.waiting_task);
+    task_t* task = scheduler.current_task;
+    uint32_t primask;
+    uint32_t start;
+    
+    /* 调度器启动前或中断中无法挂起，直接轮询计数器 */
+    if (!scheduler.running || port_in_isr()) {
+        start = port_timer_now();
+        while (port_timer_now() - start < ticks);
+        return;
     }
     
+    primask = rtos_enter_critical();
+    Time_AddDelay(task, ticks);
+    task_suspend(task);
+    
     /* 进行任务调度 - 让出CPU给其他任务 */
     rtos_schedule();
+    rtos_exit_critical(primask);
     
     /* 延时完成后，任务会从这里继续执行 */
 }
 
 /**
-  * @brief  停止TIM2延时
-  * @param  None
+  * @brief  64位时钟周期延时 - 供时钟周期、微秒和毫秒延时使用
+  * @param  ticks: 延时时钟周期数
   * @retval None
   */
-static void tim2_stop_delay(void)
+static void delay_ticks64(uint64_t ticks)
 {
-    /* 清除延时状态 */
-    delay_ctrl.state = DELAY_IDLE;
-    
-    /* 恢复等待的任务 */
-    if (delay_ctrl.waiting_task) {
-        task_resume((task_t*)delay_ctrl.waiting_task);
-        delay_ctrl.waiting_task = NULL;
+    while (ticks > DELAY_MAX_CHUNK_TICKS) {
+        tim2_start_delay(DELAY_MAX_CHUNK_TICKS);
+        ticks -= DELAY_MAX_CHUNK_TICKS;
+    }
+    if (ticks > 0) {
+        tim2_start_delay((uint32_t)ticks);
     }
-    
-    /* 进行任务调度 */
-    rtos_schedule();
 }
 
 /* Public functions ----------------------------------------------------------*/
@@ -149,14 +127,14 @@ static void tim2_stop_delay(void)
   */
 void Time_Init(void)
 {
-    /* 配置TIM2定时器 */
-    tim2_config();
+    /* 配置定时器 */
+    port_timer_init();
     
     /* 初始化延时控制结构体 */
     delay_ctrl.state = DELAY_IDLE;
     delay_ctrl.target_count = 0;
     delay_ctrl.waiting_task = NULL;
-    delay_start_count = 0;
+    delay_list = NULL;
 }
 
 /**
@@ -166,21 +144,90 @@ void Time_Init(void)
   */
 void Time_DeInit(void)
 {
-    /* 停止TIM2 */
-    TIM_Cmd(TIM2, DISABLE);
-    
-    /* 禁用TIM2中断 */
-    TIM_ITConfig(TIM2, TIM_IT_CC1, DISABLE);
-    NVIC_DisableIRQ(TIM2_IRQn);
-    
-    /* 禁用TIM2时钟 */
-    RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM2, DISABLE);
+    /* 停止定时器及其中断 */
+    port_timer_deinit();
     
     /* 重置延时控制结构体 */
     delay_ctrl.state = DELAY_IDLE;
     delay_ctrl.target_count = 0;
     delay_ctrl.waiting_task = NULL;
-    delay_start_count = 0;
+    delay_list = NULL;
+}
+
+/**
+  * @brief  将任务按到期时间插入延时链表
+  * @param  task: 任务指针
+  * @param  ticks: 延时时钟周期数，超过DELAY_MAX_CHUNK_TICKS时截断
+  * @retval None
+  * @note   只登记到期时间，不改变任务状态；须在临界区内调用。
+  *         链表按与当前计数值的有符号差排序，单次延时不超过2^31个周期
+  */
+void Time_AddDelay(struct task* task, uint32_t ticks)
+{
+    task_t** link;
+    uint32_t primask = rtos_enter_critical();
+    
+    if (task->delaying) {
+        Time_CancelDelay(task);
+    }
+    if (ticks > DELAY_MAX_CHUNK_TICKS) {
+        ticks = DELAY_MAX_CHUNK_TICKS;
+    }
+    
+    task->delay_target = port_timer_now() + ticks;
+    task->delaying = 1;
+    
+    /* 找到第一个比新任务晚到期的位置 */
+    link = &delay_list;
+    while (*link && (int32_t)((*link)->delay_target - task->delay_target) <= 0) {
+        link = &(*link)->delay_next;
+    }
+    task->delay_next = *link;
+    *link = task;
+    
+    /* 新任务成为队首时重新设置比较值 */
+    if (delay_list == task) {
+        tim2_program_compare();
+    }
+    rtos_exit_critical(primask);
+}
+
+/**
+  * @brief  将任务从延时链表中移除（事件先于超时到达时调用）
+  * @param  task: 任务指针
+  * @retval None
+  */
+void Time_CancelDelay(struct task* task)
+{
+    task_t** link;
+    uint32_t primask;
+    
+    if (!task->delaying) {
+        return;
+    }
+    
+    primask = rtos_enter_critical();
+    for (link = &delay_list; *link; link = &(*link)->delay_next) {
+        if (*link == task) {
+            *link = task->delay_next;
+            break;
+        }
+    }
+    task->delay_next = NULL;
+    task->delaying = 0;
+    tim2_program_compare();
+    rtos_exit_critical(primask);
+}
+
+/**
+  * @brief  时钟周期级延时函数
+  * @param  ticks: 延时时钟周期数 (1/84MHz)
+  * @retval None
+  */
+void Delay_ticks(uint32_t ticks)
+{
+    /* 超过单次上限的延时分段完成 */
+    delay_ticks64((uint64_t)ticks);
 }
 
 /**
@@ -206,7 +253,7 @@ void Delay_ns(uint32_t ns)
     }
     
     /* 启动延时 */
-    tim2_start_delay(ticks);
+    Delay_ticks(ticks);
 }
 
 /**
@@ -216,68 +263,66 @@ void Delay_ns(uint32_t ns)
   */
 void Delay_us(uint32_t us)
 {
-    uint32_t ticks;
-    
     /* 参数检查 */
     if (us == 0) {
         return;
     }
     
-    /* 转换为时钟周期数 */
-    ticks = US_TO_TICKS(us);
-    
-    /* 检查是否超出最大延时范围 */
-    if (ticks > 0xFFFFFFF0) {  /* 留一些余量避免溢出 */
-        ticks = 0xFFFFFFF0;
-    }
-    
-    /* 启动延时 */
-    tim2_start_delay(ticks);
+    /* 转换为时钟周期数 - 按64位计算，超过约51s的部分分段完成 */
+    delay_ticks64((uint64_t)us * TIM2_TICKS_PER_US);
 }
 
 /**
   * @brief  毫秒级延时函数
-  * @param  ms: 延时时间，单位毫秒
+  * @param  ms: 延时时间，单位毫秒，不超过DELAY_MAX_MS
   * @retval None
   */
 void Delay_ms(uint32_t ms)
 {
-    uint32_t ticks;
-    
     /* 参数检查 */
     if (ms == 0) {
         return;
     }
-    
-    /* 转换为时钟周期数 */
-    ticks = MS_TO_TICKS(ms);
-    
-    /* 检查是否超出最大延时范围 */
-    if (ticks > 0xFFFFFFF0) {  /* 留一些余量避免溢出 */
-        ticks = 0xFFFFFFF0;
+    if (ms > DELAY_MAX_MS) {
+        ms = DELAY_MAX_MS;
     }
     
-    /* 启动延时 */
-    tim2_start_delay(ticks);
+    /* 转换为时钟周期数 */
+    delay_ticks64((uint64_t)ms * TIM2_TICKS_PER_MS);
 }
 
 /**
-  * @brief  TIM2中断处理函数（内部调用）
+  * @brief  定时器比较中断处理函数（由移植层在中断中调用）
   * @param  None
   * @retval None
+  * @note   比较中断可能提前或重复触发，以当前计数值为准处理到期任务
   */
-void TIM2_IRQHandler_Internal(void)
+void Time_TimerIsr(void)
 {
-    /* 检查TIM2比较中断 */
-    if (TIM_GetITStatus(TIM2, TIM_IT_CC1) != RESET) {
-        /* 清除中断标志 */
-        TIM_ClearITPendingBit(TIM2, TIM_IT_CC1);
+    task_t* task;
+    uint32_t now;
+    uint8_t woken = 0;
+    
+    /* 恢复所有已到期的任务 */
+    now = port_timer_now();
+    while (delay_list && (int32_t)(now - delay_list->delay_target) >= 0) {
+        task = delay_list;
+        delay_list = task->delay_next;
+        task->delay_next = NULL;
+        task->delaying = 0;
         
-        /* 检查是否在延时状态 */
-        if (delay_ctrl.state == DELAY_ACTIVE) {
-            /* 延时完成，停止延时 */
-            tim2_stop_delay();
-        }
+        /* 带超时的等待到期：离开等待队列 */
+        task_unwait(task);
+        task_resume(task);
+        woken = 1;
+    }
+    
+    /* 为下一个到期任务设置比较值 */
+    tim2_program_compare();
+    
+    /* 进行任务调度 */
+    if (woken) {
+        rtos_schedule();
     }
 }
 
@@ -302,8 +347,8 @@ uint32_t Time_GetRemainingTicks(void)
     uint32_t remaining_ticks = 0;
     
     if (delay_ctrl.state == DELAY_ACTIVE) {
-        current_count = TIM_GetCounter(TIM2);
-        if (current_count < delay_ctrl.target_count) {
+        current_count = port_timer_now();
+        if ((int32_t)(delay_ctrl.target_count - current_count) > 0) {
             remaining_ticks = delay_ctrl.target_count - current_count;
         }
     }
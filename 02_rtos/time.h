@@ -11,7 +11,7 @@
   *
   * 本文件实现了基于TIM2定时器的高精度延时功能，具有以下特性：
   * 1. 支持毫秒(ms)、微秒(us)、纳秒(ns)级延时
-  * 2. 延时期间任务挂起，进行RTOS任务调度
+  * 2. 延时期间任务挂起，进行RTOS任务调度，多个任务可同时延时
   * 3. 定时器到时后恢复任务，再次进行调度
   * 4. 纳秒级精度可达100ns级别
   *
@@ -26,7 +26,6 @@
 #endif
 
 /* Includes ------------------------------------------------------------------*/
-#include "stm32f4xx.h"
 #include <stdint.h>
 
 /* Exported types ------------------------------------------------------------*/
@@ -47,30 +46,34 @@ typedef struct {
 
 /* Exported constants --------------------------------------------------------*/
 
-/* TIM2相关定义 */
+/* TIM2相关定义 - 移植层的定时器均以此频率计数 */
 #define TIM2_CLOCK_FREQ         84000000UL    /* TIM2时钟频率: 84MHz */
 #define TIM2_NS_PER_TICK        12UL          /* 每个时钟周期约12ns (1/84MHz) */
-#define TIM2_US_PER_TICK        1000UL        /* 每微秒需要的时钟周期数 */
-#define TIM2_MS_PER_TICK        1000000UL     /* 每毫秒需要的时钟周期数 */
+#define TIM2_TICKS_PER_US       (TIM2_CLOCK_FREQ / 1000000UL)  /* 每微秒的实际计数值: 84 */
+#define TIM2_TICKS_PER_MS       (TIM2_CLOCK_FREQ / 1000UL)     /* 每毫秒的实际计数值: 84000 */
 
 /* 延时精度定义 */
 #define DELAY_MIN_NS            100UL         /* 最小延时100ns */
-#define DELAY_MAX_MS            4294967UL     /* 最大延时约49.7天 (2^32/84MHz) */
+#define DELAY_MAX_MS            4294967UL     /* Delay_ms参数上限 */
+#define DELAY_MAX_CHUNK_TICKS   0x7FFFFFFFUL  /* 单次登记的最大延时(约25.5s)，更长的延时分段完成 */
 
 /* Exported macro ------------------------------------------------------------*/
 
-/* 时间转换宏 */
+/* 时间转换宏 - US/MS转换结果超过32位时须由调用者先转为64位 */
 #define NS_TO_TICKS(ns)         ((ns) / TIM2_NS_PER_TICK)
-#define US_TO_TICKS(us)         ((us) * TIM2_US_PER_TICK)
-#define MS_TO_TICKS(ms)         ((ms) * TIM2_MS_PER_TICK)
+#define US_TO_TICKS(us)         ((us) * TIM2_TICKS_PER_US)
+#define MS_TO_TICKS(ms)         ((ms) * TIM2_TICKS_PER_MS)
 
 #define TICKS_TO_NS(ticks)      ((ticks) * TIM2_NS_PER_TICK)
-#define TICKS_TO_US(ticks)      ((ticks) / TIM2_US_PER_TICK)
-#define TICKS_TO_MS(ticks)      ((ticks) / TIM2_MS_PER_TICK)
+#define TICKS_TO_US(ticks)      ((ticks) / TIM2_TICKS_PER_US)
+#define TICKS_TO_MS(ticks)      ((ticks) / TIM2_TICKS_PER_MS)
 
 /* Exported functions ------------------------------------------------------- */
 
+struct task;
+
 /* 延时函数 */
+void Delay_ticks(uint32_t ticks); /* 时钟周期级延时 */
 void Delay_ns(uint32_t ns);     /* 纳秒级延时 */
 void Delay_us(uint32_t us);     /* 微秒级延时 */
 void Delay_ms(uint32_t ms);     /* 毫秒级延时 */
@@ -79,8 +82,10 @@ void Delay_ms(uint32_t ms);     /* 毫秒级延时 */
 void Time_Init(void);           /* 延时系统初始化 */
 void Time_DeInit(void);         /* 延时系统反初始化 */
 
-/* 内部函数（供中断处理使用） */
-void TIM2_IRQHandler_Internal(void);  /* TIM2中断处理函数 */
+/* 内部函数（供移植层和内核使用） */
+void Time_TimerIsr(void);             /* 定时器比较中断处理函数 */
+void Time_AddDelay(struct task* task, uint32_t ticks);  /* 登记任务的到期时间 */
+void Time_CancelDelay(struct task* task);               /* 取消任务的延时 */
 
 /* 延时状态查询函数 */
 delay_state_t Time_GetDelayState(void);  /* 获取当前延时状态 */
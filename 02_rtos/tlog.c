@@ -0,0 +1,120 @@
+/**
+  ******************************************************************************
+  * @file    tlog.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   令牌化二进制日志实现
+  ******************************************************************************
+  * @attention
+  *
+  * 实现原理：
+  * 1. 目标端不做任何格式化，只把编号和参数按LEB128变长整数编码，
+  *    小数值参数只占1字节，一条典型日志约4-8字节
+  * 2. 整帧通过一次RTT_Write写入，通道配置为空间不足时整帧丢弃，
+  *    主机端看到的数据流不会出现半帧
+  * 3. 帧头带同步位和参数个数，主机端可在数据损坏后重新同步
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "tlog.h"
+#include "rtt.h"
+#include "port.h"
+
+/* Private variables ---------------------------------------------------------*/
+
+/* RTT通道缓冲区 */
+static char tlog_buffer[TLOG_BUFFER_SIZE];
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t tlog_put_varint(uint8_t* out, uint32_t value);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  LEB128编码一个32位无符号数
+  * @param  out: 输出位置
+  * @param  value: 数值
+  * @retval 编码长度(1-5字节)
+  */
+static uint32_t tlog_put_varint(uint8_t* out, uint32_t value)
+{
+    uint32_t len = 0;
+
+    while (value >= 0x80U) {
+        out[len++] = (uint8_t)(value | 0x80U);
+        value >>= 7;
+    }
+    out[len++] = (uint8_t)value;
+    return len;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  配置日志输出通道
+  * @param  None
+  * @retval None
+  * @note   须在RTT_Init之后调用
+  */
+void TLOG_Init(void)
+{
+    (void)RTT_ConfigUpBuffer(TLOG_RTT_CHANNEL, "TLog", tlog_buffer, sizeof(tlog_buffer),
+                             RTT_MODE_NO_BLOCK_SKIP);
+}
+
+/**
+  * @brief  编码并输出一条日志
+  * @param  id: 格式字符串编号
+  * @param  args: 参数数组
+  * @param  nargs: 参数个数
+  * @retval None
+  * @note   由TLOG宏调用，任务和中断上下文均可使用
+  */
+void TLOG_Write(uint32_t id, const uint32_t* args, uint32_t nargs)
+{
+    uint8_t frame[TLOG_FRAME_MAX];
+    uint32_t len = 0;
+    uint32_t i;
+
+    if (nargs > TLOG_MAX_ARGS) {
+        nargs = TLOG_MAX_ARGS;
+    }
+
+#if TLOG_USE_TIMESTAMP
+    frame[len++] = (uint8_t)(TLOG_SYNC | TLOG_FLAG_TIMESTAMP | nargs);
+#else
+    frame[len++] = (uint8_t)(TLOG_SYNC | nargs);
+#endif
+    len += tlog_put_varint(&frame[len], id);
+
+#if TLOG_USE_TIMESTAMP
+    {
+        uint32_t ts = port_timer_now();
+        frame[len++] = (uint8_t)ts;
+        frame[len++] = (uint8_t)(ts >> 8);
+        frame[len++] = (uint8_t)(ts >> 16);
+        frame[len++] = (uint8_t)(ts >> 24);
+    }
+#endif
+
+    for (i = 0; i < nargs; i++) {
+        len += tlog_put_varint(&frame[len], args[i]);
+    }
+
+    (void)RTT_Write(TLOG_RTT_CHANNEL, frame, len);
+}
+
+/**
+  * @brief  读取因通道满丢弃的字节数
+  * @param  None
+  * @retval 字节数
+  */
+uint32_t TLOG_GetDropCount(void)
+{
+    return RTT_GetDropCount(TLOG_RTT_CHANNEL);
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
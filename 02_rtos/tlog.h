@@ -0,0 +1,143 @@
+/**
+  ******************************************************************************
+  * @file    tlog.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   令牌化二进制日志头文件
+  *          目标端只输出格式字符串编号和原始参数，文本由主机端还原
+  ******************************************************************************
+  * @attention
+  *
+  * 使用方法：
+  *   TLOG("Hellow rtos! Counter: %lu\r\n", counter);
+  *   TLOG("state=%s temp=%f\r\n", TLOG_STR("idle"), TLOG_FLOAT(t));
+  *
+  * 实现原理：
+  * 1. 格式字符串放入tlog_fmt段，链接脚本将该段声明为INFO(不加载)，
+  *    不占用Flash，只保留在ELF文件中供主机端查找
+  * 2. 字符串编号为其在tlog_fmt段内的偏移，调用处为链接期常量
+  * 3. 每个参数转换为32位后以变长整数编码，连同编号写入RTT通道
+  * 4. 主机端用03_tools/tlog_decode读取ELF中的tlog_fmt段还原文本
+  *
+  * 参数限制：
+  * - 最多8个参数，均按32位传递；64位整数和double会被截断
+  * - 浮点数须用TLOG_FLOAT()包装，按float位模式传递
+  * - %s参数须为TLOG_STR()驻留的常量字符串，不能传递运行时字符串
+  *
+  * 非GCC编译器不支持段属性和语句表达式，TLOG退化为printf。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __TLOG_H__
+#define __TLOG_H__
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+
+/* 全局开关 - 为0时TLOG不产生任何代码，参数也不会被求值 */
+#ifndef TLOG_ENABLE
+#define TLOG_ENABLE             1
+#endif
+
+/* 是否在每条日志中附带TIM2计数值时间戳(4字节) */
+#ifndef TLOG_USE_TIMESTAMP
+#define TLOG_USE_TIMESTAMP      0
+#endif
+
+/* 输出通道配置 */
+#ifndef TLOG_RTT_CHANNEL
+#define TLOG_RTT_CHANNEL        1           /* 使用的RTT上行通道 */
+#endif
+
+#ifndef TLOG_BUFFER_SIZE
+#define TLOG_BUFFER_SIZE        1024        /* 通道缓冲区大小(字节) */
+#endif
+
+#define TLOG_MAX_ARGS           8           /* 单条日志最大参数个数 */
+
+/* 帧格式：头字节 + 编号(变长) + [时间戳(4字节小端)] + 参数(变长) × n
+ * 头字节：bit7-5 = 101b 同步标志，bit4 = 时间戳存在，bit3-0 = 参数个数 */
+#define TLOG_SYNC               0xA0U
+#define TLOG_SYNC_MASK          0xE0U
+#define TLOG_FLAG_TIMESTAMP     0x10U
+#define TLOG_NARGS_MASK         0x0FU
+#define TLOG_FRAME_MAX          (1 + 5 + 4 + TLOG_MAX_ARGS * 5)
+
+/* Exported macro ------------------------------------------------------------*/
+
+#if defined(__GNUC__)
+
+#define TLOG_SECTION            __attribute__((section("tlog_fmt"), used))
+
+/* 字符串编号 = 段内偏移；__start_tlog_fmt由链接器提供 */
+extern const char __start_tlog_fmt[];
+#define TLOG_ID(s)              ((uint32_t)((uintptr_t)(s) - (uintptr_t)__start_tlog_fmt))
+
+/* 驻留一个常量字符串，返回其编号，用作%s参数 */
+#define TLOG_STR(s)             (__extension__({                               \
+                                    static const char tlog_str_[] TLOG_SECTION = s; \
+                                    TLOG_ID(tlog_str_);                        \
+                                }))
+
+/* 按位模式传递float参数，主机端按%f/%e/%g解释 */
+#define TLOG_FLOAT(x)           (((union { float f; uint32_t u; }){ .f = (float)(x) }).u)
+
+/* 参数计数与逐个转换为32位 - 格式字符串计入首个参数，不依赖##__VA_ARGS__扩展 */
+#define TLOG_NARGS(...)         TLOG_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0, ~)
+#define TLOG_NARGS_(f, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define TLOG_FIRST(f, ...)      f
+#define TLOG_CAT(a, b)          TLOG_CAT_(a, b)
+#define TLOG_CAT_(a, b)         a##b
+
+#define TLOG_ARG(a)                            , (uint32_t)(a)
+#define TLOG_ARGS_0(f)
+#define TLOG_ARGS_1(f, a)                      TLOG_ARG(a)
+#define TLOG_ARGS_2(f, a, b)                   TLOG_ARGS_1(f, a) TLOG_ARG(b)
+#define TLOG_ARGS_3(f, a, b, c)                TLOG_ARGS_2(f, a, b) TLOG_ARG(c)
+#define TLOG_ARGS_4(f, a, b, c, d)             TLOG_ARGS_3(f, a, b, c) TLOG_ARG(d)
+#define TLOG_ARGS_5(f, a, b, c, d, e)          TLOG_ARGS_4(f, a, b, c, d) TLOG_ARG(e)
+#define TLOG_ARGS_6(f, a, b, c, d, e, g)       TLOG_ARGS_5(f, a, b, c, d, e) TLOG_ARG(g)
+#define TLOG_ARGS_7(f, a, b, c, d, e, g, h)    TLOG_ARGS_6(f, a, b, c, d, e, g) TLOG_ARG(h)
+#define TLOG_ARGS_8(f, a, b, c, d, e, g, h, i) TLOG_ARGS_7(f, a, b, c, d, e, g, h) TLOG_ARG(i)
+
+#if TLOG_ENABLE
+#define TLOG(...)               TLOG_(TLOG_NARGS(__VA_ARGS__), __VA_ARGS__)
+#define TLOG_(n, ...)                                                           \
+    do {                                                                        \
+        static const char tlog_fmt_[] TLOG_SECTION = TLOG_FIRST(__VA_ARGS__, ~); \
+        const uint32_t tlog_args_[] = { 0U TLOG_CAT(TLOG_ARGS_, n)(__VA_ARGS__) }; \
+        TLOG_Write(TLOG_ID(tlog_fmt_), &tlog_args_[1], n);                      \
+    } while (0)
+#else
+#define TLOG(...)               do { } while (0)
+#endif
+
+#else /* !__GNUC__ */
+
+#include <stdio.h>
+#define TLOG_STR(s)             (s)
+#define TLOG_FLOAT(x)           ((double)(x))
+#define TLOG(...)               printf(__VA_ARGS__)
+
+#endif /* __GNUC__ */
+
+/* Exported functions ------------------------------------------------------- */
+void TLOG_Init(void);                                           /* 配置RTT输出通道 */
+void TLOG_Write(uint32_t id, const uint32_t* args, uint32_t nargs); /* 编码并输出一帧 */
+uint32_t TLOG_GetDropCount(void);                               /* 通道满丢弃的字节数 */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TLOG_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
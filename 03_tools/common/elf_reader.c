@@ -0,0 +1,256 @@
+/**
+  ******************************************************************************
+  * @file    elf_reader.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   主机端工具共用的ELF文件读取实现
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "elf_reader.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint64_t rd_le(const uint8_t* p, uint32_t n)
+{
+    uint64_t v = 0;
+
+    while (n-- > 0U) {
+        v = (v << 8) | p[n];
+    }
+    return v;
+}
+
+/* 按字宽读取一个字段：ELF32中为4字节，ELF64中为8字节 */
+static uint64_t rd_word(const elf_file_t* elf, const uint8_t* p)
+{
+    return rd_le(p, elf->is64 ? 8U : 4U);
+}
+
+/* 按地址排序，同地址时有大小的在前 */
+static int cmp_symbol(const void* a, const void* b)
+{
+    const elf_symbol_t* x = (const elf_symbol_t*)a;
+    const elf_symbol_t* y = (const elf_symbol_t*)b;
+
+    if (x->addr != y->addr) {
+        return (x->addr < y->addr) ? -1 : 1;
+    }
+    return (x->size > y->size) ? -1 : (x->size < y->size) ? 1 : 0;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int elf_open(const char* path, elf_file_t* elf)
+{
+    FILE* f = fopen(path, "rb");
+    long len;
+    const uint8_t* h;
+
+    memset(elf, 0, sizeof(*elf));
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len < 52) {
+        fprintf(stderr, "%s: not an ELF file\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    elf->data = (uint8_t*)malloc((size_t)len);
+    elf->size = (size_t)len;
+    if (elf->data == NULL || fread(elf->data, 1, (size_t)len, f) != (size_t)len) {
+        fprintf(stderr, "%s: read failed\n", path);
+        fclose(f);
+        elf_close(elf);
+        return -1;
+    }
+    fclose(f);
+
+    h = elf->data;
+    if (memcmp(h, "\177ELF", 4) != 0 || (h[4] != 1 && h[4] != 2) || h[5] != 1) {
+        fprintf(stderr, "%s: not a little-endian ELF file\n", path);
+        elf_close(elf);
+        return -1;
+    }
+    elf->is64 = (h[4] == 2);
+    elf->machine = (uint32_t)rd_le(h + 18, 2);
+    if (elf->is64) {
+        elf->shoff = rd_le(h + 40, 8);
+        elf->shentsize = (uint32_t)rd_le(h + 58, 2);
+        elf->shnum = (uint32_t)rd_le(h + 60, 2);
+        elf->shstrndx = (uint32_t)rd_le(h + 62, 2);
+    } else {
+        elf->shoff = rd_le(h + 32, 4);
+        elf->shentsize = (uint32_t)rd_le(h + 46, 2);
+        elf->shnum = (uint32_t)rd_le(h + 48, 2);
+        elf->shstrndx = (uint32_t)rd_le(h + 50, 2);
+    }
+    if (elf->shentsize < (elf->is64 ? 64U : 40U) ||
+        elf->shoff + (uint64_t)elf->shnum * elf->shentsize > elf->size ||
+        elf->shstrndx >= elf->shnum) {
+        fprintf(stderr, "%s: bad section header table\n", path);
+        elf_close(elf);
+        return -1;
+    }
+    return 0;
+}
+
+void elf_close(elf_file_t* elf)
+{
+    free(elf->data);
+    memset(elf, 0, sizeof(*elf));
+}
+
+int elf_get_section(const elf_file_t* elf, uint32_t index, elf_section_t* sec)
+{
+    const uint8_t* sh;
+    const uint8_t* strtab;
+    uint64_t stroff, strsize;
+    uint32_t name;
+
+    if (index >= elf->shnum) {
+        return -1;
+    }
+
+    /* 段名字符串表 */
+    sh = elf->data + elf->shoff + (uint64_t)elf->shstrndx * elf->shentsize;
+    stroff = elf->is64 ? rd_le(sh + 24, 8) : rd_le(sh + 16, 4);
+    strsize = elf->is64 ? rd_le(sh + 32, 8) : rd_le(sh + 20, 4);
+    if (stroff + strsize > elf->size) {
+        return -1;
+    }
+    strtab = elf->data + stroff;
+
+    sh = elf->data + elf->shoff + (uint64_t)index * elf->shentsize;
+    name = (uint32_t)rd_le(sh, 4);
+    sec->type = (uint32_t)rd_le(sh + 4, 4);
+    sec->flags = rd_word(elf, sh + 8);
+    if (elf->is64) {
+        sec->addr = rd_le(sh + 16, 8);
+        sec->offset = rd_le(sh + 24, 8);
+        sec->size = rd_le(sh + 32, 8);
+    } else {
+        sec->addr = rd_le(sh + 12, 4);
+        sec->offset = rd_le(sh + 16, 4);
+        sec->size = rd_le(sh + 20, 4);
+    }
+    sec->name = (name < strsize && memchr(strtab + name, 0, (size_t)(strsize - name)) != NULL)
+                ? (const char*)strtab + name : "";
+    return 0;
+}
+
+int elf_find_section(const elf_file_t* elf, const char* name, elf_section_t* sec)
+{
+    uint32_t i;
+
+    for (i = 1; i < elf->shnum; i++) {
+        if (elf_get_section(elf, i, sec) == 0 && strcmp(sec->name, name) == 0) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const uint8_t* elf_section_data(const elf_file_t* elf, const elf_section_t* sec)
+{
+    if (sec->type == ELF_SHT_NOBITS || sec->offset + sec->size > elf->size) {
+        return NULL;
+    }
+    return elf->data + sec->offset;
+}
+
+long elf_read_functions(const elf_file_t* elf, elf_symbol_t** syms)
+{
+    elf_section_t symtab, strtab;
+    const uint8_t* sym;
+    const uint8_t* str;
+    uint32_t entsize = elf->is64 ? 24U : 16U;
+    uint64_t i, count;
+    size_t n = 0, out;
+    uint32_t link;
+
+    *syms = NULL;
+    for (i = 1; i < elf->shnum; i++) {
+        if (elf_get_section(elf, (uint32_t)i, &symtab) == 0 && symtab.type == ELF_SHT_SYMTAB) {
+            break;
+        }
+    }
+    if (i >= elf->shnum || (sym = elf_section_data(elf, &symtab)) == NULL) {
+        return -1;
+    }
+
+    /* 符号名字符串表为sh_link指向的段 */
+    link = (uint32_t)rd_le(elf->data + elf->shoff + i * elf->shentsize + (elf->is64 ? 40U : 24U), 4);
+    if (elf_get_section(elf, link, &strtab) != 0 || (str = elf_section_data(elf, &strtab)) == NULL) {
+        return -1;
+    }
+
+    count = symtab.size / entsize;
+    *syms = (elf_symbol_t*)malloc((size_t)(count + 1U) * sizeof(elf_symbol_t));
+    if (*syms == NULL) {
+        return -1;
+    }
+    for (i = 0; i < count; i++) {
+        const uint8_t* p = sym + i * entsize;
+        uint32_t name = (uint32_t)rd_le(p, 4);
+        uint8_t info = elf->is64 ? p[4] : p[12];
+        uint64_t addr = elf->is64 ? rd_le(p + 8, 8) : rd_le(p + 4, 4);
+        uint64_t size = elf->is64 ? rd_le(p + 16, 8) : rd_le(p + 8, 4);
+
+        if ((info & 0x0FU) != ELF_STT_FUNC || addr == 0U || name >= strtab.size ||
+            memchr(str + name, 0, (size_t)(strtab.size - name)) == NULL) {
+            continue;
+        }
+        if (elf->machine == ELF_EM_ARM) {
+            addr &= ~(uint64_t)1U;
+        }
+        (*syms)[n].name = (const char*)str + name;
+        (*syms)[n].addr = addr;
+        (*syms)[n].size = size;
+        n++;
+    }
+
+    qsort(*syms, n, sizeof(elf_symbol_t), cmp_symbol);
+    for (i = 0, out = 0; i < n; i++) {
+        if (out == 0U || (*syms)[i].addr != (*syms)[out - 1U].addr) {
+            (*syms)[out++] = (*syms)[i];
+        }
+    }
+    return (long)out;
+}
+
+const elf_symbol_t* elf_find_function(const elf_symbol_t* syms, size_t count, uint64_t addr)
+{
+    size_t lo = 0, hi = count;
+    const elf_symbol_t* s;
+
+    /* 最后一个起始地址不大于addr的符号 */
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2U;
+        if (syms[mid].addr <= addr) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0U) {
+        return NULL;
+    }
+    s = &syms[lo - 1U];
+    if (s->size != 0U && addr >= s->addr + s->size) {
+        return NULL;
+    }
+    return s;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    elf_reader.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   主机端工具共用的ELF文件读取接口
+  ******************************************************************************
+  * @attention
+  *
+  * 只读解析小端ELF32(目标固件)和ELF64(主机程序)，整个文件读入内存，
+  * 返回的名称和数据指针在elf_close之前有效。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __ELF_READER_H__
+#define __ELF_READER_H__
+
+/* Includes ------------------------------------------------------------------*/
+#include <stddef.h>
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define ELF_SHT_NOBITS      8U          /* 无文件内容的段(.bss等) */
+#define ELF_SHF_ALLOC       0x2U        /* 段在运行时占用内存 */
+#define ELF_SHT_SYMTAB      2U          /* 符号表 */
+#define ELF_STT_FUNC        2U          /* 函数符号 */
+#define ELF_EM_ARM          40U         /* ARM目标，函数符号地址bit0为Thumb标志 */
+
+/* Exported types ------------------------------------------------------------*/
+
+/* 已加载的ELF文件 */
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    int is64;
+    uint32_t machine;           /* e_machine */
+    uint64_t shoff;             /* 段表偏移 */
+    uint32_t shnum;             /* 段数量 */
+    uint32_t shentsize;         /* 段表项大小 */
+    uint32_t shstrndx;          /* 段名字符串表索引 */
+} elf_file_t;
+
+/* 段描述 */
+typedef struct {
+    const char* name;
+    uint32_t type;
+    uint64_t flags;
+    uint64_t addr;
+    uint64_t offset;
+    uint64_t size;
+} elf_section_t;
+
+/* 函数符号 */
+typedef struct {
+    const char* name;
+    uint64_t addr;              /* ARM目标已去掉Thumb标志位 */
+    uint64_t size;              /* 0表示大小未知(汇编函数)，延伸到下一个符号 */
+} elf_symbol_t;
+
+/* Exported functions ------------------------------------------------------- */
+int elf_open(const char* path, elf_file_t* elf);               /* 成功返回0 */
+void elf_close(elf_file_t* elf);
+int elf_get_section(const elf_file_t* elf, uint32_t index, elf_section_t* sec);
+int elf_find_section(const elf_file_t* elf, const char* name, elf_section_t* sec);
+const uint8_t* elf_section_data(const elf_file_t* elf, const elf_section_t* sec);
+
+/* 读取.symtab中的全部函数符号，按地址排序并去掉同地址的别名。
+   返回符号数，失败返回-1；*syms由调用者free */
+long elf_read_functions(const elf_file_t* elf, elf_symbol_t** syms);
+/* 查找包含addr的函数，没有时返回NULL */
+const elf_symbol_t* elf_find_function(const elf_symbol_t* syms, size_t count, uint64_t addr);
+
+#endif /* __ELF_READER_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
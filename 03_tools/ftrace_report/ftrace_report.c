@@ -0,0 +1,502 @@
+/**
+  ******************************************************************************
+  * @file    ftrace_report.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   函数进出跟踪主机端报告工具 (Linux)
+  *          把02_rtos/ftrace输出的记录还原为每个任务的调用树
+  ******************************************************************************
+  * @attention
+  *
+  * 用法：
+  *   ftrace_report -e fw.elf [-d depth] [-f hz] [trace.bin | -]
+  *
+  *   -e elf      被跟踪程序的ELF(目标固件或04_host中的主机程序)
+  *   -d depth    调用树输出的最大深度，默认不限
+  *   -f hz       周期计数频率，给出时另外输出微秒数
+  *
+  * 输出：
+  *   1. 每个任务的调用树：调用次数、包含子函数的周期数(inclusive)、
+  *      不含子函数的周期数(exclusive)、平均inclusive
+  *   2. 全部任务的函数汇总，递归调用只计最外层的inclusive
+  *
+  * 跟踪开始前已进入的函数没有进入记录，其返回记录被忽略；结束时仍未
+  * 返回的函数不计入。数据块报告丢弃时清空该任务的调用栈重新开始。
+  *
+  * 数据流来源示例：
+  *   J-Link RTT Logger:  JLinkRTTLogger -Device STM32F407VG -RTTChannel 3 trace.bin
+  *   RAM转储:           rtt_reader -c 3 ram.bin > trace.bin
+  *   主机:              04_host中make ftrace
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common/elf_reader.h"
+#include "../../02_rtos/ftrace.h"
+
+/* Private define ------------------------------------------------------------*/
+#define BLOCK_SIZE          20U         /* ftrace_block_t */
+#define RECORD_SIZE         8U          /* ftrace_record_t */
+#define MAX_TASKS           64
+#define MAX_DEPTH           256
+#define NO_SYMBOL           (-1)
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 调用树节点：同一调用路径上的同一函数合并为一个节点 */
+typedef struct node {
+    int32_t func;
+    uint32_t addr;              /* 无符号时显示地址 */
+    uint64_t calls;
+    uint64_t incl;
+    uint64_t excl;
+    struct node* child;
+    struct node* sibling;
+} node_t;
+
+/* 调用栈帧 */
+typedef struct {
+    node_t* node;
+    uint64_t enter;             /* 进入时刻 */
+    uint64_t child_time;        /* 已返回的子函数inclusive之和 */
+} frame_t;
+
+/* 一个任务的跟踪状态 */
+typedef struct {
+    uint32_t task;
+    uint32_t func;
+    node_t root;
+    frame_t stack[MAX_DEPTH];
+    int depth;
+    uint64_t now;               /* 任务自身的周期时钟 */
+    uint64_t records;
+    uint64_t dropped;
+    uint64_t unmatched;
+} task_state_t;
+
+/* 函数汇总 */
+typedef struct {
+    uint64_t calls;
+    uint64_t incl;
+    uint64_t excl;
+} flat_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const elf_symbol_t* symbols;
+static size_t symbol_count;
+static int strip_thumb;                 /* ARM目标：函数地址bit0为Thumb标志 */
+
+static task_state_t* tasks[MAX_TASKS];
+static int task_count;
+static flat_t* flat;                    /* symbol_count + 1项，最后一项为无符号 */
+
+static double cycles_hz;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int32_t symbolize(uint32_t addr)
+{
+    const elf_symbol_t* s;
+
+    if (strip_thumb) {
+        addr &= ~1U;
+    }
+    s = elf_find_function(symbols, symbol_count, addr);
+    return (s != NULL) ? (int32_t)(s - symbols) : NO_SYMBOL;
+}
+
+static void node_name(const node_t* n, char* buf, size_t size)
+{
+    if (n->func != NO_SYMBOL) {
+        snprintf(buf, size, "%s", symbols[n->func].name);
+    } else {
+        snprintf(buf, size, "0x%08x", (unsigned)n->addr);
+    }
+}
+
+static int load_stream(const char* path, uint8_t** data, size_t* size)
+{
+    FILE* f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    size_t cap = 4096;
+    size_t len = 0;
+    size_t n;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    *data = (uint8_t*)malloc(cap);
+    while (*data != NULL && (n = fread(*data + len, 1, cap - len, f)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            *data = (uint8_t*)realloc(*data, cap);
+        }
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+    if (*data == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return -1;
+    }
+    *size = len;
+    return 0;
+}
+
+static task_state_t* find_task(uint32_t task, uint32_t func)
+{
+    int i;
+
+    for (i = 0; i < task_count; i++) {
+        if (tasks[i]->task == task && tasks[i]->func == func) {
+            return tasks[i];
+        }
+    }
+    if (task_count == MAX_TASKS) {
+        return NULL;
+    }
+    tasks[task_count] = (task_state_t*)calloc(1, sizeof(task_state_t));
+    if (tasks[task_count] == NULL) {
+        return NULL;
+    }
+    tasks[task_count]->task = task;
+    tasks[task_count]->func = func;
+    tasks[task_count]->root.func = NO_SYMBOL;
+    return tasks[task_count++];
+}
+
+static node_t* child_of(node_t* parent, uint32_t addr)
+{
+    int32_t func = symbolize(addr);
+    node_t* n;
+
+    for (n = parent->child; n != NULL; n = n->sibling) {
+        if (n->func == func && (func != NO_SYMBOL || n->addr == addr)) {
+            return n;
+        }
+    }
+    n = (node_t*)calloc(1, sizeof(node_t));
+    if (n == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    n->func = func;
+    n->addr = addr;
+    n->sibling = parent->child;
+    parent->child = n;
+    return n;
+}
+
+/* 弹出栈顶帧，时刻为t->now */
+static void pop_frame(task_state_t* t)
+{
+    frame_t* f = &t->stack[--t->depth];
+    uint64_t incl = t->now - f->enter;
+    flat_t* fl = &flat[(f->node->func == NO_SYMBOL) ? symbol_count : (size_t)f->node->func];
+    int i, outer = 1;
+
+    f->node->calls++;
+    f->node->incl += incl;
+    f->node->excl += incl - f->child_time;
+    if (t->depth > 0) {
+        t->stack[t->depth - 1].child_time += incl;
+    }
+
+    /* 递归调用只计最外层的inclusive */
+    for (i = 0; i < t->depth; i++) {
+        if (t->stack[i].node->func == f->node->func && f->node->func != NO_SYMBOL) {
+            outer = 0;
+        }
+    }
+    fl->calls++;
+    fl->excl += incl - f->child_time;
+    if (outer) {
+        fl->incl += incl;
+    }
+}
+
+static void process_record(task_state_t* t, uint32_t addr, uint32_t delta_kind)
+{
+    int i;
+
+    t->now += delta_kind >> 1;
+    t->records++;
+
+    if ((delta_kind & FTRACE_EXIT) == 0U) {
+        node_t* parent = (t->depth > 0) ? t->stack[t->depth - 1].node : &t->root;
+        if (t->depth == MAX_DEPTH) {
+            t->unmatched++;
+            return;
+        }
+        t->stack[t->depth].node = child_of(parent, addr);
+        t->stack[t->depth].enter = t->now;
+        t->stack[t->depth].child_time = 0;
+        t->depth++;
+        return;
+    }
+
+    /* 返回：与栈中最近的同一函数匹配，其上的帧视为同时返回 */
+    for (i = t->depth - 1; i >= 0; i--) {
+        if (t->stack[i].node->addr == addr) {
+            break;
+        }
+    }
+    if (i < 0) {
+        t->unmatched++;
+        return;
+    }
+    while (t->depth > i) {
+        pop_frame(t);
+    }
+}
+
+static int parse(const uint8_t* p, size_t size)
+{
+    size_t off = 0;
+    uint32_t skipped = 0;
+
+    while (off + BLOCK_SIZE <= size) {
+        uint32_t count = rd32(p + off + 12U);
+        uint32_t dropped = rd32(p + off + 16U);
+        task_state_t* t;
+        uint32_t i;
+
+        if (rd32(p + off) != FTRACE_BLOCK_MAGIC || off + BLOCK_SIZE + (size_t)count * RECORD_SIZE > size) {
+            skipped++;
+            off++;
+            continue;
+        }
+        if (skipped > 0U) {
+            fprintf(stderr, "ftrace: skipped %u bytes\n", (unsigned)skipped);
+            skipped = 0;
+        }
+        t = find_task(rd32(p + off + 4U), rd32(p + off + 8U));
+        if (t == NULL) {
+            fprintf(stderr, "too many tasks\n");
+            return -1;
+        }
+        off += BLOCK_SIZE;
+        for (i = 0; i < count; i++, off += RECORD_SIZE) {
+            process_record(t, rd32(p + off), rd32(p + off + 4U));
+        }
+        if (dropped > 0U) {
+            t->dropped += dropped;
+            t->depth = 0;       /* 丢弃处之后无法配对，重新开始 */
+        }
+    }
+    skipped += (uint32_t)(size - off);
+    if (skipped > 0U) {
+        fprintf(stderr, "ftrace: skipped %u bytes\n", (unsigned)skipped);
+    }
+    return 0;
+}
+
+static void print_cycles(uint64_t cycles)
+{
+    if (cycles_hz > 0.0) {
+        printf(" %12llu %10.2f", (unsigned long long)cycles, (double)cycles * 1e6 / cycles_hz);
+    } else {
+        printf(" %12llu", (unsigned long long)cycles);
+    }
+}
+
+static int cmp_node(const void* a, const void* b)
+{
+    const node_t* x = *(const node_t* const*)a;
+    const node_t* y = *(const node_t* const*)b;
+
+    if (x->incl != y->incl) {
+        return (x->incl > y->incl) ? -1 : 1;
+    }
+    return (x->addr < y->addr) ? -1 : (x->addr > y->addr) ? 1 : 0;
+}
+
+static void print_tree(const node_t* parent, int level, int max_depth)
+{
+    const node_t* n;
+    const node_t** sorted;
+    size_t count = 0, i;
+    char name[128];
+
+    if (max_depth > 0 && level >= max_depth) {
+        return;
+    }
+    for (n = parent->child; n != NULL; n = n->sibling) {
+        count++;
+    }
+    sorted = (const node_t**)malloc((count + 1U) * sizeof(node_t*));
+    if (sorted == NULL) {
+        return;
+    }
+    for (n = parent->child, i = 0; n != NULL; n = n->sibling) {
+        sorted[i++] = n;
+    }
+    qsort(sorted, count, sizeof(node_t*), cmp_node);
+
+    for (i = 0; i < count; i++) {
+        n = sorted[i];
+        if (n->calls == 0U) {
+            continue;                   /* 只有未返回的调用 */
+        }
+        node_name(n, name, sizeof(name));
+        printf("  %8llu", (unsigned long long)n->calls);
+        print_cycles(n->incl);
+        print_cycles(n->excl);
+        printf(" %10llu  %*s%s\n", (unsigned long long)(n->incl / n->calls), level * 2, "", name);
+        print_tree(n, level + 1, max_depth);
+    }
+    free(sorted);
+}
+
+static void print_header(const char* first)
+{
+    if (cycles_hz > 0.0) {
+        printf("  %8s %12s %10s %12s %10s %10s  %s\n", "calls", "inclusive", "incl us",
+               "exclusive", "excl us", "avg incl", first);
+    } else {
+        printf("  %8s %12s %12s %10s  %s\n", "calls", "inclusive", "exclusive", "avg incl", first);
+    }
+}
+
+static int cmp_flat(const void* a, const void* b)
+{
+    size_t x = *(const size_t*)a;
+    size_t y = *(const size_t*)b;
+
+    if (flat[x].excl != flat[y].excl) {
+        return (flat[x].excl > flat[y].excl) ? -1 : 1;
+    }
+    return (x < y) ? -1 : 1;
+}
+
+static void report(int max_depth)
+{
+    size_t* order;
+    size_t i, n = 0;
+    int k;
+
+    for (k = 0; k < task_count; k++) {
+        task_state_t* t = tasks[k];
+        char name[128];
+
+        if (t->task == 0U) {
+            snprintf(name, sizeof(name), "[main]");
+        } else {
+            int32_t f = symbolize(t->func);
+            snprintf(name, sizeof(name), "%s@0x%08x", (f != NO_SYMBOL) ? symbols[f].name : "?",
+                     (unsigned)t->task);
+        }
+        printf("%s: %llu records, %llu dropped, %llu unmatched, %d open\n", name,
+               (unsigned long long)t->records, (unsigned long long)t->dropped,
+               (unsigned long long)t->unmatched, t->depth);
+        print_header("call tree");
+        print_tree(&t->root, 0, max_depth);
+        printf("\n");
+    }
+
+    order = (size_t*)malloc((symbol_count + 1U) * sizeof(size_t));
+    if (order == NULL) {
+        return;
+    }
+    for (i = 0; i <= symbol_count; i++) {
+        if (flat[i].calls > 0U) {
+            order[n++] = i;
+        }
+    }
+    qsort(order, n, sizeof(size_t), cmp_flat);
+    printf("all tasks, by exclusive cycles:\n");
+    print_header("function");
+    for (i = 0; i < n; i++) {
+        const flat_t* f = &flat[order[i]];
+        printf("  %8llu", (unsigned long long)f->calls);
+        print_cycles(f->incl);
+        print_cycles(f->excl);
+        printf(" %10llu  %s\n", (unsigned long long)(f->incl / f->calls),
+               (order[i] < symbol_count) ? symbols[order[i]].name : "[unknown]");
+    }
+    free(order);
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: ftrace_report -e fw.elf [-d depth] [-f hz] [trace.bin | -]\n");
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(int argc, char** argv)
+{
+    const char* elf_path = NULL;
+    const char* in_path = "-";
+    int max_depth = 0, status;
+    elf_file_t elf;
+    elf_symbol_t* syms;
+    uint8_t* stream;
+    size_t size;
+    long n;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            elf_path = argv[++i];
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            max_depth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            cycles_hz = strtod(argv[++i], NULL);
+        } else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            in_path = argv[i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (elf_path == NULL || max_depth < 0) {
+        usage();
+        return 1;
+    }
+
+    if (elf_open(elf_path, &elf) != 0) {
+        return 1;
+    }
+    n = elf_read_functions(&elf, &syms);
+    if (n <= 0) {
+        fprintf(stderr, "%s: no function symbols\n", elf_path);
+        free(syms);
+        elf_close(&elf);
+        return 1;
+    }
+    symbols = syms;
+    symbol_count = (size_t)n;
+    strip_thumb = (elf.machine == ELF_EM_ARM);
+    flat = (flat_t*)calloc(symbol_count + 1U, sizeof(flat_t));
+
+    if (flat == NULL || load_stream(in_path, &stream, &size) != 0) {
+        free(flat);
+        free(syms);
+        elf_close(&elf);
+        return 1;
+    }
+    status = parse(stream, size);
+    if (status == 0) {
+        report(max_depth);
+    }
+    free(stream);
+    free(flat);
+    free(syms);
+    elf_close(&elf);
+    return (status == 0) ? 0 : 1;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
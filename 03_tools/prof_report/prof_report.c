@@ -0,0 +1,578 @@
+/**
+  ******************************************************************************
+  * @file    prof_report.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   采样性能分析主机端报告工具 (Linux)
+  *          按固件ELF的函数符号统计目标端User/prof输出的PC样本
+  ******************************************************************************
+  * @attention
+  *
+  * 用法：
+  *   prof_report -e fw.elf [-n top] [-r hz] [-F folded.txt] [-c] [samples.bin | -]
+  *   prof_report -s samples.bin           用本工具自身的符号生成模拟样本
+  *
+  *   -e elf      固件ELF (或-s模式下的本工具)
+  *   -n top      每张表输出的函数数，默认20，0表示全部
+  *   -r hz       采样率，给出时按样本数估算时间
+  *   -F file     输出折叠栈(task;function count)，可直接交给flamegraph.pl
+  *   -c          折叠栈中加入由LR得到的调用者(task;caller;function)，
+  *               只在被采样的是叶子函数时准确
+  *
+  * 输出：
+  *   1. 样本数、丢弃数和采样开销(来自目标端的统计记录)
+  *   2. 全部样本的函数排行(flat profile)
+  *   3. 每个任务(以入口函数命名)和每个中断的函数排行
+  *
+  * 数据流来源示例：
+  *   J-Link RTT Logger:  JLinkRTTLogger -Device STM32F407VG -RTTChannel 2 prof.bin
+  *   RAM转储:           rtt_reader -c 2 ram.bin > prof.bin
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common/elf_reader.h"
+
+/* Private define ------------------------------------------------------------*/
+#define RECORD_SIZE         16U         /* 与User/prof/prof.h中prof_record_t一致 */
+#define STATS_MARK          0xFFFFFFFFUL
+#define EXC_MAX             256U        /* ctx小于该值时为异常号 */
+#define CTX_MAX             64          /* 最多区分的上下文(任务和中断)数 */
+#define DEFAULT_TOP         20
+#define NO_SYMBOL           (-1)
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 执行上下文：一个任务(TCB)、一个中断或调度器启动前的main */
+typedef struct {
+    uint32_t task;
+    uint32_t ctx;
+    char name[96];
+    uint64_t samples;
+} context_t;
+
+/* 聚合计数：(上下文, 调用者, 函数) -> 样本数 */
+typedef struct {
+    int32_t ctx;
+    int32_t caller;
+    int32_t func;
+    uint64_t count;
+    int used;
+} bucket_t;
+
+typedef struct {
+    bucket_t* slots;
+    size_t cap;
+    size_t used;
+} table_t;
+
+/* 排序用 */
+typedef struct {
+    int32_t func;
+    uint64_t count;
+} rank_t;
+
+/* Private variables ---------------------------------------------------------*/
+static const elf_symbol_t* symbols;
+static size_t symbol_count;
+
+static context_t contexts[CTX_MAX];
+static int context_count;
+
+/* STM32F407中本工程使用的外设中断，其余以编号显示 */
+static const struct {
+    uint32_t exc;
+    const char* name;
+} exc_names[] = {
+    { 2, "NMI" }, { 3, "HardFault" }, { 4, "MemManage" }, { 5, "BusFault" },
+    { 6, "UsageFault" }, { 11, "SVCall" }, { 14, "PendSV" }, { 15, "SysTick" },
+    { 16 + 7, "EXTI1" }, { 16 + 27, "TIM1_CC" }, { 16 + 28, "TIM2" },
+    { 16 + 37, "USART1" }, { 16 + 50, "TIM5" }, { 16 + 58, "DMA2_Stream2" },
+    { 16 + 70, "DMA2_Stream7" },
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rd32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void wr32(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/* 地址对应的符号编号，没有时返回NO_SYMBOL */
+static int32_t symbolize(uint32_t addr)
+{
+    const elf_symbol_t* s = elf_find_function(symbols, symbol_count, addr);
+    return (s != NULL) ? (int32_t)(s - symbols) : NO_SYMBOL;
+}
+
+static const char* symbol_name(int32_t func)
+{
+    return (func == NO_SYMBOL) ? "[unknown]" : symbols[func].name;
+}
+
+static int load_stream(const char* path, uint8_t** data, size_t* size)
+{
+    FILE* f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    size_t cap = 4096;
+    size_t len = 0;
+    size_t n;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    *data = (uint8_t*)malloc(cap);
+    while (*data != NULL && (n = fread(*data + len, 1, cap - len, f)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            *data = (uint8_t*)realloc(*data, cap);
+        }
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+    if (*data == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return -1;
+    }
+    *size = len;
+    return 0;
+}
+
+/* 样本所属的上下文编号，超过CTX_MAX时归入最后一个 */
+static int find_context(uint32_t task, uint32_t ctx)
+{
+    int i;
+
+    for (i = 0; i < context_count; i++) {
+        if (contexts[i].task == task && contexts[i].ctx == ctx) {
+            return i;
+        }
+    }
+    if (context_count == CTX_MAX) {
+        return CTX_MAX - 1;
+    }
+    contexts[context_count].task = task;
+    contexts[context_count].ctx = ctx;
+    return context_count++;
+}
+
+/* 上下文名称：任务以入口函数命名，同一入口有多个TCB时附加TCB地址 */
+static void name_contexts(void)
+{
+    int i, j, shared;
+    size_t k;
+
+    for (i = 0; i < context_count; i++) {
+        context_t* c = &contexts[i];
+
+        if (c->task == 0U && c->ctx == 0U) {
+            snprintf(c->name, sizeof(c->name), "[main]");
+        } else if (c->ctx < EXC_MAX) {
+            snprintf(c->name, sizeof(c->name), "[irq %u]", (unsigned)c->ctx);
+            for (k = 0; k < sizeof(exc_names) / sizeof(exc_names[0]); k++) {
+                if (exc_names[k].exc == c->ctx) {
+                    snprintf(c->name, sizeof(c->name), "[%s]", exc_names[k].name);
+                }
+            }
+        } else {
+            shared = 0;
+            for (j = 0; j < context_count; j++) {
+                if (j != i && contexts[j].ctx == c->ctx && contexts[j].task != c->task) {
+                    shared = 1;
+                }
+            }
+            if (shared) {
+                snprintf(c->name, sizeof(c->name), "%s@0x%08x",
+                         symbol_name(symbolize(c->ctx & ~1U)), (unsigned)c->task);
+            } else {
+                snprintf(c->name, sizeof(c->name), "%s", symbol_name(symbolize(c->ctx & ~1U)));
+            }
+        }
+    }
+}
+
+static size_t hash_key(int32_t ctx, int32_t caller, int32_t func, size_t cap)
+{
+    uint64_t h = (uint64_t)(uint32_t)ctx * 0x9E3779B97F4A7C15ULL;
+    h ^= (uint64_t)(uint32_t)caller * 0xC2B2AE3D27D4EB4FULL;
+    h ^= (uint64_t)(uint32_t)func * 0x165667B19E3779F9ULL;
+    return (size_t)(h ^ (h >> 29)) & (cap - 1U);
+}
+
+static void table_add(table_t* t, int32_t ctx, int32_t caller, int32_t func, uint64_t count)
+{
+    size_t i;
+
+    if ((t->used + 1U) * 2U > t->cap) {
+        table_t bigger;
+        bigger.cap = (t->cap == 0U) ? 256U : t->cap * 2U;
+        bigger.used = 0;
+        bigger.slots = (bucket_t*)calloc(bigger.cap, sizeof(bucket_t));
+        if (bigger.slots == NULL) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+        for (i = 0; i < t->cap; i++) {
+            if (t->slots[i].used) {
+                table_add(&bigger, t->slots[i].ctx, t->slots[i].caller, t->slots[i].func,
+                          t->slots[i].count);
+            }
+        }
+        free(t->slots);
+        *t = bigger;
+    }
+
+    i = hash_key(ctx, caller, func, t->cap);
+    while (t->slots[i].used &&
+           (t->slots[i].ctx != ctx || t->slots[i].caller != caller || t->slots[i].func != func)) {
+        i = (i + 1U) & (t->cap - 1U);
+    }
+    if (!t->slots[i].used) {
+        t->slots[i].used = 1;
+        t->slots[i].ctx = ctx;
+        t->slots[i].caller = caller;
+        t->slots[i].func = func;
+        t->used++;
+    }
+    t->slots[i].count += count;
+}
+
+static int cmp_rank(const void* a, const void* b)
+{
+    const rank_t* x = (const rank_t*)a;
+    const rank_t* y = (const rank_t*)b;
+
+    if (x->count != y->count) {
+        return (x->count > y->count) ? -1 : 1;
+    }
+    return strcmp(symbol_name(x->func), symbol_name(y->func));
+}
+
+/* 输出一个上下文(ctx为-1时为全部)的函数排行 */
+static void print_ranking(const table_t* t, int32_t ctx, uint64_t total, int top)
+{
+    rank_t* rank = (rank_t*)calloc(symbol_count + 1U, sizeof(rank_t));
+    size_t i, n = 0;
+
+    if (rank == NULL) {
+        return;
+    }
+    for (i = 0; i <= symbol_count; i++) {
+        rank[i].func = (i < symbol_count) ? (int32_t)i : NO_SYMBOL;
+    }
+    for (i = 0; i < t->cap; i++) {
+        const bucket_t* b = &t->slots[i];
+        if (b->used && (ctx < 0 || b->ctx == ctx)) {
+            rank[(b->func == NO_SYMBOL) ? symbol_count : (size_t)b->func].count += b->count;
+        }
+    }
+    qsort(rank, symbol_count + 1U, sizeof(rank_t), cmp_rank);
+
+    printf("  %10s %7s  %s\n", "samples", "%", "function");
+    for (i = 0; i <= symbol_count && rank[i].count > 0U; i++) {
+        if (top > 0 && n == (size_t)top) {
+            printf("  ...\n");
+            break;
+        }
+        printf("  %10llu %6.2f%%  %s\n", (unsigned long long)rank[i].count,
+               100.0 * (double)rank[i].count / (double)total, symbol_name(rank[i].func));
+        n++;
+    }
+    free(rank);
+}
+
+/* 折叠栈：每行"上下文;[调用者;]函数 样本数" */
+static int write_folded(const char* path, const table_t* t)
+{
+    FILE* f = fopen(path, "w");
+    size_t i;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    for (i = 0; i < t->cap; i++) {
+        const bucket_t* b = &t->slots[i];
+        if (!b->used) {
+            continue;
+        }
+        fprintf(f, "%s;", contexts[b->ctx].name);
+        if (b->caller != NO_SYMBOL) {
+            fprintf(f, "%s;", symbols[b->caller].name);
+        }
+        fprintf(f, "%s %llu\n", symbol_name(b->func), (unsigned long long)b->count);
+    }
+    fclose(f);
+    return 0;
+}
+
+static int report(const uint8_t* p, size_t size, int top, double rate,
+                  const char* folded_path, int with_caller)
+{
+    table_t table = { NULL, 0, 0 };
+    table_t folded = { NULL, 0, 0 };
+    uint64_t samples = 0, dropped = 0, isr_cycles = 0, total_cycles = 0;
+    size_t off;
+    int i;
+
+    if (size % RECORD_SIZE != 0U) {
+        fprintf(stderr, "prof: ignoring %u trailing bytes\n", (unsigned)(size % RECORD_SIZE));
+    }
+
+    for (off = 0; off + RECORD_SIZE <= size; off += RECORD_SIZE) {
+        uint32_t pc = rd32(p + off);
+        uint32_t lr = rd32(p + off + 4U);
+        uint32_t task = rd32(p + off + 8U);
+        uint32_t ctx = rd32(p + off + 12U);
+        int32_t func, caller = NO_SYMBOL;
+        int c;
+
+        if (pc == STATS_MARK) {
+            isr_cycles += lr;
+            total_cycles += task;
+            dropped += ctx;
+            continue;
+        }
+        c = find_context(task, ctx);
+        contexts[c].samples++;
+        samples++;
+
+        func = symbolize(pc);
+        table_add(&table, c, NO_SYMBOL, func, 1);
+
+        /* LR为EXC_RETURN(0xFFFFFFxx)或不是Thumb返回地址时不作调用者 */
+        if (with_caller && (lr & 1U) != 0U && lr < 0xFFFFFF00UL) {
+            caller = symbolize((lr & ~1U) - 2U);
+            if (caller == func) {
+                caller = NO_SYMBOL;
+            }
+        }
+        table_add(&folded, c, caller, func, 1);
+    }
+    name_contexts();
+
+    printf("samples: %llu", (unsigned long long)samples);
+    if (rate > 0.0) {
+        printf(" (%.3f s at %.0f Hz)", (double)samples / rate, rate);
+    }
+    printf(", dropped: %llu\n", (unsigned long long)dropped);
+    if (total_cycles > 0U) {
+        printf("overhead: %.3f%% (%llu of %llu cycles in the sampling interrupt)\n",
+               100.0 * (double)isr_cycles / (double)total_cycles,
+               (unsigned long long)isr_cycles, (unsigned long long)total_cycles);
+    }
+    if (samples == 0U) {
+        free(table.slots);
+        free(folded.slots);
+        return 0;
+    }
+
+    printf("\nflat profile:\n");
+    print_ranking(&table, -1, samples, top);
+
+    for (i = 0; i < context_count; i++) {
+        printf("\n%s: %llu samples (%.2f%%)\n", contexts[i].name,
+               (unsigned long long)contexts[i].samples,
+               100.0 * (double)contexts[i].samples / (double)samples);
+        print_ranking(&table, i, contexts[i].samples, top);
+    }
+
+    if (folded_path != NULL && write_folded(folded_path, &folded) != 0) {
+        free(table.slots);
+        free(folded.slots);
+        return -1;
+    }
+    free(table.slots);
+    free(folded.slots);
+    return 0;
+}
+
+/* 模拟样本：两个"任务"和一个中断，样本按固定权重落在本工具的若干函数中。
+   只使用elf_reader.c的外部函数，不受编译器内联影响 */
+static int make_simulated_stream(const char* path)
+{
+    static const char* const funcs[] = {
+        "elf_read_functions", "elf_get_section", "elf_find_function", "elf_section_data"
+    };
+    static const uint32_t weights[] = { 50, 25, 15, 10 };
+    const elf_symbol_t* f[4];
+    const elf_symbol_t* task_a = NULL;
+    const elf_symbol_t* task_b = NULL;
+    elf_file_t elf;
+    elf_symbol_t* syms;
+    uint8_t rec[RECORD_SIZE];
+    uint32_t seed = 1, i, k, w;
+    long n;
+    size_t j;
+    FILE* out;
+
+    if (elf_open("/proc/self/exe", &elf) != 0 || (n = elf_read_functions(&elf, &syms)) < 0) {
+        fprintf(stderr, "cannot read own symbols\n");
+        return -1;
+    }
+    for (k = 0; k < 4U; k++) {
+        f[k] = NULL;
+        for (j = 0; j < (size_t)n; j++) {
+            if (strcmp(syms[j].name, funcs[k]) == 0) {
+                f[k] = &syms[j];
+            }
+            if (strcmp(syms[j].name, "main") == 0) {
+                task_a = &syms[j];
+            }
+            if (strcmp(syms[j].name, "elf_open") == 0) {
+                task_b = &syms[j];
+            }
+        }
+        if (f[k] == NULL || f[k]->size < 4U) {
+            fprintf(stderr, "symbol %s not found\n", funcs[k]);
+            free(syms);
+            elf_close(&elf);
+            return -1;
+        }
+    }
+    if (task_a == NULL || task_b == NULL) {
+        fprintf(stderr, "task symbols not found\n");
+        free(syms);
+        elf_close(&elf);
+        return -1;
+    }
+
+    out = fopen(path, "wb");
+    if (out == NULL) {
+        perror(path);
+        free(syms);
+        elf_close(&elf);
+        return -1;
+    }
+    for (i = 0; i < 10000U; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        w = (seed >> 8) % 100U;
+        for (k = 0; k < 3U && w >= weights[k]; k++) {
+            w -= weights[k];
+        }
+        wr32(rec, (uint32_t)(f[k]->addr + ((seed >> 4) % (f[k]->size / 2U)) * 2U));
+        wr32(rec + 4U, (uint32_t)(task_a->addr + 9U));
+        switch (i % 10U) {
+        case 0:                                     /* 10%：TIM2中断 */
+            wr32(rec + 8U, 0);
+            wr32(rec + 12U, 16U + 28U);
+            break;
+        case 1:
+        case 2:
+        case 3:                                     /* 30%：任务B */
+            wr32(rec + 8U, 0x20000400U);
+            wr32(rec + 12U, (uint32_t)task_b->addr | 1U);
+            break;
+        default:                                    /* 60%：任务A */
+            wr32(rec + 8U, 0x20000000U);
+            wr32(rec + 12U, (uint32_t)task_a->addr | 1U);
+            break;
+        }
+        fwrite(rec, 1, sizeof(rec), out);
+
+        /* 每256个样本一条统计记录：中断耗时约0.07%(1kHz, 120周期) */
+        if ((i + 1U) % 256U == 0U) {
+            wr32(rec, STATS_MARK);
+            wr32(rec + 4U, 256U * 120U);
+            wr32(rec + 8U, 256U * 168000U);
+            wr32(rec + 12U, 0);
+            fwrite(rec, 1, sizeof(rec), out);
+        }
+    }
+    fclose(out);
+    free(syms);
+    elf_close(&elf);
+    printf("wrote %s, report with: prof_report -e <this tool> %s\n", path, path);
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: prof_report -e fw.elf [-n top] [-r hz] [-F folded.txt] [-c] [samples.bin | -]\n"
+            "       prof_report -s samples.bin\n");
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(int argc, char** argv)
+{
+    const char* elf_path = NULL;
+    const char* in_path = "-";
+    const char* folded_path = NULL;
+    int top = DEFAULT_TOP, with_caller = 0, status;
+    double rate = 0.0;
+    elf_file_t elf;
+    elf_symbol_t* syms;
+    uint8_t* stream;
+    size_t size;
+    long n;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            return make_simulated_stream(argv[i + 1]) == 0 ? 0 : 1;
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            elf_path = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            top = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rate = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "-F") == 0 && i + 1 < argc) {
+            folded_path = argv[++i];
+        } else if (strcmp(argv[i], "-c") == 0) {
+            with_caller = 1;
+        } else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            in_path = argv[i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (elf_path == NULL || top < 0) {
+        usage();
+        return 1;
+    }
+
+    if (elf_open(elf_path, &elf) != 0) {
+        return 1;
+    }
+    n = elf_read_functions(&elf, &syms);
+    if (n <= 0) {
+        fprintf(stderr, "%s: no function symbols\n", elf_path);
+        free(syms);
+        elf_close(&elf);
+        return 1;
+    }
+    symbols = syms;
+    symbol_count = (size_t)n;
+
+    if (load_stream(in_path, &stream, &size) != 0) {
+        free(syms);
+        elf_close(&elf);
+        return 1;
+    }
+    status = report(stream, size, top, rate, folded_path, with_caller);
+    free(stream);
+    free(syms);
+    elf_close(&elf);
+    return (status == 0) ? 0 : 1;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,421 @@
+/**
+  ******************************************************************************
+  * @file    rtt_reader.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   RTT控制块主机端解析工具 (Linux)
+  *          从RAM转储文件或模拟内存镜像中定位RTT控制块并读写各通道
+  ******************************************************************************
+  * @attention
+  *
+  * 用法：
+  *   rtt_reader [-b base] [-c ch] [-l] [-x] [-d] [-w ch:text] [-o out] image.bin
+  *   rtt_reader -s image.bin              生成一个模拟内存镜像
+  *
+  *   -b base     镜像起始地址，默认0x20000000 (RAM1)
+  *   -c ch       输出指定上行通道的待读数据，默认通道0
+  *   -l          列出控制块中的全部通道
+  *   -x          以十六进制输出数据
+  *   -d          消费数据：将上行通道rd_off推进到wr_off (需配合-o)
+  *   -w ch:text  向下行通道写入文本 (需配合-o)，模拟调试器发送命令
+  *   -o out      修改后的镜像输出文件，可再写回目标RAM
+  *
+  * 转储方法示例：
+  *   J-Link:  savebin ram.bin 0x20000000 0x20000
+  *   OpenOCD: dump_image ram.bin 0x20000000 0x20000
+  *   GDB:     dump binary memory ram.bin 0x20000000 0x20020000
+  *
+  * 04_host的make test中test_rtt把rtt.c的通道转储为目标端布局的镜像，
+  * 以回绕的上行通道和下行通道检查-l、-c、-d和-w的结果。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define RTT_CB_ID           "SEGGER RTT"
+#define RTT_CB_ID_SIZE      16U
+#define RTT_BUFFER_DESC     24U         /* rtt_buffer_t在目标端的大小 */
+#define RTT_MAX_CHANNELS    32          /* 合理性检查上限 */
+#define DEFAULT_BASE        0x20000000UL
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 内存镜像 */
+typedef struct {
+    uint8_t* data;
+    uint32_t size;
+    uint32_t base;
+} image_t;
+
+/* 解析后的通道描述 (地址均为目标地址) */
+typedef struct {
+    uint32_t desc_off;          /* 描述符在镜像中的偏移 */
+    uint32_t name;
+    uint32_t buffer;
+    uint32_t size;
+    uint32_t wr_off;
+    uint32_t rd_off;
+    uint32_t flags;
+} channel_t;
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint32_t rd32(const image_t* img, uint32_t off)
+{
+    const uint8_t* p = img->data + off;
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void wr32(image_t* img, uint32_t off, uint32_t v)
+{
+    uint8_t* p = img->data + off;
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/* 目标地址转换为镜像偏移，越界返回-1 */
+static int64_t addr_to_off(const image_t* img, uint32_t addr, uint32_t len)
+{
+    if (addr < img->base || (uint64_t)addr - img->base + len > img->size) {
+        return -1;
+    }
+    return (int64_t)(addr - img->base);
+}
+
+static int load_image(const char* path, image_t* img)
+{
+    FILE* f = fopen(path, "rb");
+    long len;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (len <= 0) {
+        fprintf(stderr, "%s: empty image\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    img->data = (uint8_t*)malloc((size_t)len);
+    img->size = (uint32_t)len;
+    if (img->data == NULL || fread(img->data, 1, (size_t)len, f) != (size_t)len) {
+        fprintf(stderr, "%s: read failed\n", path);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    return 0;
+}
+
+static int save_image(const char* path, const image_t* img)
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL || fwrite(img->data, 1, img->size, f) != img->size) {
+        perror(path);
+        if (f != NULL) {
+            fclose(f);
+        }
+        return -1;
+    }
+    fclose(f);
+    return 0;
+}
+
+/* 在镜像中按4字节对齐扫描魔术字符串，返回控制块偏移或-1 */
+static int64_t find_control_block(const image_t* img)
+{
+    uint32_t off;
+
+    for (off = 0; off + RTT_CB_ID_SIZE + 8U <= img->size; off += 4U) {
+        if (memcmp(img->data + off, RTT_CB_ID, sizeof(RTT_CB_ID)) == 0) {
+            int32_t up = (int32_t)rd32(img, off + RTT_CB_ID_SIZE);
+            int32_t down = (int32_t)rd32(img, off + RTT_CB_ID_SIZE + 4U);
+            if (up > 0 && up <= RTT_MAX_CHANNELS && down >= 0 && down <= RTT_MAX_CHANNELS) {
+                return (int64_t)off;
+            }
+        }
+    }
+    return -1;
+}
+
+static void read_channel(const image_t* img, uint32_t desc_off, channel_t* ch)
+{
+    ch->desc_off = desc_off;
+    ch->name = rd32(img, desc_off + 0U);
+    ch->buffer = rd32(img, desc_off + 4U);
+    ch->size = rd32(img, desc_off + 8U);
+    ch->wr_off = rd32(img, desc_off + 12U);
+    ch->rd_off = rd32(img, desc_off + 16U);
+    ch->flags = rd32(img, desc_off + 20U);
+}
+
+static int channel_valid(const image_t* img, const channel_t* ch)
+{
+    return ch->size >= 2U && ch->wr_off < ch->size && ch->rd_off < ch->size &&
+           addr_to_off(img, ch->buffer, ch->size) >= 0;
+}
+
+static const char* channel_name(const image_t* img, const channel_t* ch)
+{
+    int64_t off = addr_to_off(img, ch->name, 1);
+    uint32_t i;
+
+    if (ch->name == 0U) {
+        return "";
+    }
+    if (off < 0) {
+        return "(name outside image)";
+    }
+    /* 名称必须在镜像内以'\0'结尾 */
+    for (i = (uint32_t)off; i < img->size; i++) {
+        if (img->data[i] == 0U) {
+            return (const char*)img->data + off;
+        }
+    }
+    return "(unterminated)";
+}
+
+static uint32_t channel_pending(const channel_t* ch)
+{
+    return (ch->wr_off >= ch->rd_off) ? (ch->wr_off - ch->rd_off) : (ch->size - ch->rd_off + ch->wr_off);
+}
+
+/* 输出上行通道中尚未被读取的数据 */
+static void dump_pending(const image_t* img, const channel_t* ch, int hex)
+{
+    uint32_t off = (uint32_t)addr_to_off(img, ch->buffer, ch->size);
+    uint32_t n = channel_pending(ch);
+    uint32_t pos = ch->rd_off;
+    uint32_t i;
+
+    for (i = 0; i < n; i++) {
+        uint8_t c = img->data[off + pos];
+        if (hex) {
+            printf("%02x%c", c, ((i & 15U) == 15U || i + 1U == n) ? '\n' : ' ');
+        } else {
+            putchar(c);
+        }
+        if (++pos == ch->size) {
+            pos = 0;
+        }
+    }
+}
+
+/* 向下行通道写入数据，返回写入字节数 */
+static uint32_t push_down(image_t* img, channel_t* ch, const char* text)
+{
+    uint32_t off = (uint32_t)addr_to_off(img, ch->buffer, ch->size);
+    uint32_t len = (uint32_t)strlen(text);
+    uint32_t avail = (ch->rd_off <= ch->wr_off) ? (ch->size - 1U - ch->wr_off + ch->rd_off)
+                                                : (ch->rd_off - ch->wr_off - 1U);
+    uint32_t i;
+
+    if (len > avail) {
+        len = avail;
+    }
+    for (i = 0; i < len; i++) {
+        img->data[off + ch->wr_off] = (uint8_t)text[i];
+        if (++ch->wr_off == ch->size) {
+            ch->wr_off = 0;
+        }
+    }
+    wr32(img, ch->desc_off + 12U, ch->wr_off);
+    return len;
+}
+
+/* 生成模拟镜像：控制块 + 两个上行通道(其中一个回绕) + 一个下行通道 */
+static int make_simulated_image(const char* path)
+{
+    static const char terminal_text[] = "Hellow rtos! Counter: 41\r\nHellow rtos! Counter: 42\r\n";
+    static const char log_text[] = "wrapped-log-line\n";
+    image_t img;
+    uint32_t cb = 0x100U;
+    uint32_t names = 0x400U;
+    uint32_t buf0 = 0x800U, buf1 = 0xC00U, down0 = 0xD00U;
+    uint32_t size0 = 256U, size1 = 16U, dsize0 = 16U;
+    uint32_t i, pos;
+
+    img.base = DEFAULT_BASE;
+    img.size = 0x1000U;
+    img.data = (uint8_t*)calloc(1, img.size);
+    if (img.data == NULL) {
+        return -1;
+    }
+
+    memcpy(img.data + cb, RTT_CB_ID, sizeof(RTT_CB_ID));
+    wr32(&img, cb + 16U, 2U);
+    wr32(&img, cb + 20U, 1U);
+    memcpy(img.data + names, "Terminal", 9);
+    memcpy(img.data + names + 16U, "Log", 4);
+
+    /* 上行通道0：从偏移0写入两行文本 */
+    memcpy(img.data + buf0, terminal_text, sizeof(terminal_text) - 1U);
+    wr32(&img, cb + 24U + 0U, img.base + names);
+    wr32(&img, cb + 24U + 4U, img.base + buf0);
+    wr32(&img, cb + 24U + 8U, size0);
+    wr32(&img, cb + 24U + 12U, (uint32_t)sizeof(terminal_text) - 1U);
+    wr32(&img, cb + 24U + 16U, 0U);
+
+    /* 上行通道1：数据跨越缓冲区尾部回绕 */
+    pos = 10U;
+    for (i = 0; i < sizeof(log_text) - 1U && i < size1 - 1U; i++) {
+        img.data[buf1 + pos] = (uint8_t)log_text[i];
+        pos = (pos + 1U) % size1;
+    }
+    wr32(&img, cb + 48U + 0U, img.base + names + 16U);
+    wr32(&img, cb + 48U + 4U, img.base + buf1);
+    wr32(&img, cb + 48U + 8U, size1);
+    wr32(&img, cb + 48U + 12U, pos);
+    wr32(&img, cb + 48U + 16U, 10U);
+    wr32(&img, cb + 48U + 20U, 1U);
+
+    /* 下行通道0：空 */
+    wr32(&img, cb + 72U + 0U, img.base + names);
+    wr32(&img, cb + 72U + 4U, img.base + down0);
+    wr32(&img, cb + 72U + 8U, dsize0);
+
+    i = (uint32_t)save_image(path, &img);
+    free(img.data);
+    return (int)i;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: rtt_reader [-b base] [-c ch] [-l] [-x] [-d] [-w ch:text] [-o out] image.bin\n"
+            "       rtt_reader -s image.bin\n");
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(int argc, char** argv)
+{
+    image_t img = { NULL, 0, DEFAULT_BASE };
+    const char* in_path = NULL;
+    const char* out_path = NULL;
+    const char* down_text = NULL;
+    uint32_t down_ch = 0;
+    uint32_t up_ch = 0;
+    int list = 0, hex = 0, consume = 0;
+    int64_t cb;
+    int32_t max_up, max_down;
+    channel_t ch;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            return make_simulated_image(argv[i + 1]) == 0 ? 0 : 1;
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            img.base = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            up_ch = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-l") == 0) {
+            list = 1;
+        } else if (strcmp(argv[i], "-x") == 0) {
+            hex = 1;
+        } else if (strcmp(argv[i], "-d") == 0) {
+            consume = 1;
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            char* sep;
+            down_ch = (uint32_t)strtoul(argv[++i], &sep, 0);
+            if (*sep != ':') {
+                usage();
+                return 1;
+            }
+            down_text = sep + 1;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (argv[i][0] != '-' && in_path == NULL) {
+            in_path = argv[i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    if (in_path == NULL || ((down_text != NULL || consume) && out_path == NULL)) {
+        usage();
+        return 1;
+    }
+    if (load_image(in_path, &img) != 0) {
+        return 1;
+    }
+
+    cb = find_control_block(&img);
+    if (cb < 0) {
+        fprintf(stderr, "RTT control block not found in %s\n", in_path);
+        return 1;
+    }
+    max_up = (int32_t)rd32(&img, (uint32_t)cb + RTT_CB_ID_SIZE);
+    max_down = (int32_t)rd32(&img, (uint32_t)cb + RTT_CB_ID_SIZE + 4U);
+
+    if (list) {
+        printf("control block @ 0x%08x, %d up, %d down\n",
+               (unsigned)(img.base + (uint32_t)cb), (int)max_up, (int)max_down);
+        for (i = 0; i < max_up + max_down; i++) {
+            read_channel(&img, (uint32_t)cb + 24U + (uint32_t)i * RTT_BUFFER_DESC, &ch);
+            if (ch.buffer == 0U) {
+                continue;
+            }
+            printf("%-4s %2d  %-16s buf=0x%08x size=%-6u wr=%-6u rd=%-6u mode=%u%s\n",
+                   (i < max_up) ? "up" : "down", (i < max_up) ? i : i - max_up,
+                   channel_name(&img, &ch), (unsigned)ch.buffer, (unsigned)ch.size,
+                   (unsigned)ch.wr_off, (unsigned)ch.rd_off, (unsigned)(ch.flags & 3U),
+                   channel_valid(&img, &ch) ? "" : "  (invalid)");
+        }
+    }
+
+    if (up_ch >= (uint32_t)max_up) {
+        fprintf(stderr, "up channel %u out of range\n", (unsigned)up_ch);
+        return 1;
+    }
+    read_channel(&img, (uint32_t)cb + 24U + up_ch * RTT_BUFFER_DESC, &ch);
+    if (!list) {
+        if (!channel_valid(&img, &ch)) {
+            fprintf(stderr, "up channel %u not configured or outside image\n", (unsigned)up_ch);
+            return 1;
+        }
+        dump_pending(&img, &ch, hex);
+    }
+    if (consume && channel_valid(&img, &ch)) {
+        wr32(&img, ch.desc_off + 16U, ch.wr_off);
+    }
+
+    if (down_text != NULL) {
+        if (down_ch >= (uint32_t)max_down) {
+            fprintf(stderr, "down channel %u out of range\n", (unsigned)down_ch);
+            return 1;
+        }
+        read_channel(&img, (uint32_t)cb + 24U + ((uint32_t)max_up + down_ch) * RTT_BUFFER_DESC, &ch);
+        if (!channel_valid(&img, &ch)) {
+            fprintf(stderr, "down channel %u not configured or outside image\n", (unsigned)down_ch);
+            return 1;
+        }
+        if (push_down(&img, &ch, down_text) != strlen(down_text)) {
+            fprintf(stderr, "down channel %u full, text truncated\n", (unsigned)down_ch);
+        }
+    }
+
+    if (out_path != NULL && save_image(out_path, &img) != 0) {
+        return 1;
+    }
+
+    free(img.data);
+    return 0;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
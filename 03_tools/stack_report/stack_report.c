@@ -0,0 +1,835 @@
+/**
+  ******************************************************************************
+  * @file    stack_report.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   最坏栈用量分析工具 (Linux)
+  *          由GCC的-fstack-usage/-fcallgraph-info输出计算每个任务和主栈的
+  *          最大深度，并生成栈大小头文件
+  ******************************************************************************
+  * @attention
+  *
+  * 用法：
+  *   stack_report [-t task]... [-i isr:prio]... [-m main] [-c cfg]
+  *                [-f bytes] [-n bytes] [-r bytes] [-o header] file.ci|file.su ...
+  *
+  *   -t task     任务入口函数，可重复；任务函数返回后进入的rtos_task_exit
+  *               也计入同一个栈
+  *   -i isr:prio 中断处理函数和抢占优先级(数值小的优先)，可重复
+  *   -m main     调度器启动前在主栈上运行的函数，通常为main
+  *   -c cfg      补充文件，每行一条：
+  *                 stack <func> <bytes>     没有.ci/.su的函数(库、汇编)的栈用量
+  *                 call <caller> <callee>   调用图中没有的调用(汇编跳转、函数指针)
+  *               #之后为注释
+  *
+  * static函数在调用图中名为"源文件:函数名"，-t/-i/-m和补充文件中没有同名
+  * 全局函数时可以只写函数名。
+  *   -f bytes    任务被中断时压入任务栈的上下文，默认204(Cortex-M4F：带FPU的
+  *               硬件帧104 + PendSV保存的R4-R11/EXC_RETURN 36 + S16-S31 64)
+  *   -n bytes    中断嵌套时压入主栈的硬件帧，默认104
+  *   -r bytes    每个任务栈另外保留的字节数(移植层保护区和内核哨兵)，默认0
+  *   -o header   输出头文件
+  *
+  * 输入为编译时以-fstack-usage -fcallgraph-info=su生成的.ci和.su文件，
+  * 同一目标文件的.ci和.su按去掉扩展名的路径视为同一编译单元；调用边先在
+  * 本单元中查找被调函数(static函数)，再在其他单元中查找。
+  *
+  * 计算：
+  *   任务栈 = max(入口函数, rtos_task_exit)的最深调用链 + -f + -r
+  *   主栈   = 各优先级中最深的中断处理函数之和 + (优先级数 - 1) * -n，
+  *            第一层中断的硬件帧压在被打断任务的栈上(已计入-f)；
+  *            给出-m时与main的调用链加上全部中断比较取大者
+  * 结果按8字节取整。调用链中有以下情况时结果只是下限，在报告和头文件中标出：
+  *   unknown   函数没有栈用量(库函数、汇编)，按0计算，可在补充文件中给出
+  *   indirect  函数指针调用，补充文件中给出该函数的call后视为已解决
+  *   recursive 递归，环只计一次
+  *   dynamic   alloca或变长数组，栈用量无上界
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define MAX_ROOTS           64
+#define MAX_LINE            4096
+#define HASH_SIZE           4096U
+#define MAX_PATH_PRINT      64
+
+#define DEFAULT_TASK_CONTEXT    204U
+#define DEFAULT_NEST_FRAME      104U
+
+/* 函数标志 */
+#define F_UNKNOWN           0x01U       /* 没有栈用量 */
+#define F_INDIRECT          0x02U       /* 有未解决的函数指针调用 */
+#define F_RECURSIVE         0x04U       /* 在调用环上 */
+#define F_DYNAMIC           0x08U       /* 栈用量无上界 */
+#define F_RESOLVED          0x10U       /* 补充文件给出了函数指针调用的目标 */
+
+/* 分析状态 */
+#define S_NEW               0
+#define S_ACTIVE            1
+#define S_DONE              2
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 函数：同名static函数按编译单元区分 */
+typedef struct {
+    char* name;
+    char* unit;                 /* 定义所在的编译单元，NULL表示未定义 */
+    uint32_t self;              /* 自身栈帧字节数 */
+    int has_size;
+    uint32_t flags;
+    int* callees;
+    int ncallees;
+    int cap;
+    int hnext;                  /* 同一散列桶中的下一个函数 */
+    /* 分析结果 */
+    int state;
+    uint32_t worst;             /* 包含最深调用链的字节数 */
+    uint32_t reach;             /* 可达函数的标志 */
+    int next;                   /* 最深调用链上的被调函数，-1表示叶子 */
+} func_t;
+
+/* 待解析的调用边 */
+typedef struct {
+    int caller;
+    char* callee;
+    char* unit;                 /* 调用所在的编译单元，补充文件为NULL */
+} edge_t;
+
+/* 分析入口 */
+typedef struct {
+    const char* name;
+    int prio;
+} root_t;
+
+/* Private variables ---------------------------------------------------------*/
+static func_t* funcs;
+static int func_count;
+static int func_cap;
+static int hash_head[HASH_SIZE];
+
+static edge_t* edges;
+static int edge_count;
+static int edge_cap;
+
+static root_t tasks[MAX_ROOTS];
+static int task_count;
+static root_t isrs[MAX_ROOTS];
+static int isr_count;
+static const char* main_name;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void* xrealloc(void* ptr, size_t size)
+{
+    void* p = realloc(ptr, size);
+
+    if (p == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static char* xstrdup(const char* s)
+{
+    char* p = (char*)xrealloc(NULL, strlen(s) + 1);
+
+    strcpy(p, s);
+    return p;
+}
+
+static uint32_t hash(const char* s)
+{
+    uint32_t h = 2166136261U;
+
+    while (*s != '\0') {
+        h = (h ^ (uint8_t)*s++) * 16777619U;
+    }
+    return h % HASH_SIZE;
+}
+
+static int same_unit(const char* a, const char* b)
+{
+    return a != NULL && b != NULL && strcmp(a, b) == 0;
+}
+
+/* 查找函数：unit非NULL时只找该单元中的定义；unit为NULL时先找任意定义，再找未定义的引用 */
+static int func_find(const char* name, const char* unit)
+{
+    int i;
+    int undefined = -1;
+
+    for (i = hash_head[hash(name)]; i >= 0; i = funcs[i].hnext) {
+        if (strcmp(funcs[i].name, name) != 0) {
+            continue;
+        }
+        if (unit != NULL) {
+            if (same_unit(funcs[i].unit, unit)) {
+                return i;
+            }
+        } else if (funcs[i].unit != NULL) {
+            return i;
+        } else {
+            undefined = i;
+        }
+    }
+    return (unit != NULL) ? -1 : undefined;
+}
+
+static int func_add(const char* name, const char* unit)
+{
+    uint32_t h = hash(name);
+    func_t* f;
+
+    if (func_count == func_cap) {
+        func_cap = func_cap ? func_cap * 2 : 256;
+        funcs = (func_t*)xrealloc(funcs, (size_t)func_cap * sizeof(func_t));
+    }
+    f = &funcs[func_count];
+    memset(f, 0, sizeof(*f));
+    f->name = xstrdup(name);
+    f->unit = (unit != NULL) ? xstrdup(unit) : NULL;
+    f->next = -1;
+    f->hnext = hash_head[h];
+    hash_head[h] = func_count;
+    return func_count++;
+}
+
+/* 取得单元中的定义，没有时新建 */
+static int func_define(const char* name, const char* unit)
+{
+    int i = func_find(name, unit);
+
+    return (i >= 0) ? i : func_add(name, unit);
+}
+
+/* 按名称查找已定义的函数；static函数在调用图中名为"源文件:函数名"，
+   没有同名的全局函数时也可以只给函数名 */
+static int func_lookup(const char* name)
+{
+    int i = func_find(name, NULL);
+    size_t len = strlen(name);
+    size_t n;
+    int k;
+
+    if (i >= 0 && funcs[i].unit != NULL) {
+        return i;
+    }
+    for (k = 0; k < func_count; k++) {
+        n = strlen(funcs[k].name);
+        if (funcs[k].unit != NULL && n > len + 1 && funcs[k].name[n - len - 1] == ':' &&
+            strcmp(funcs[k].name + n - len, name) == 0) {
+            return k;
+        }
+    }
+    return i;
+}
+
+static void func_set_size(int i, uint32_t bytes, const char* qual)
+{
+    funcs[i].self = bytes;
+    funcs[i].has_size = 1;
+    if (qual != NULL && strstr(qual, "dynamic") != NULL && strstr(qual, "bounded") == NULL) {
+        funcs[i].flags |= F_DYNAMIC;
+    }
+}
+
+static void call_add(int caller, int callee)
+{
+    func_t* f = &funcs[caller];
+    int k;
+
+    for (k = 0; k < f->ncallees; k++) {
+        if (f->callees[k] == callee) {
+            return;
+        }
+    }
+    if (f->ncallees == f->cap) {
+        f->cap = f->cap ? f->cap * 2 : 4;
+        f->callees = (int*)xrealloc(f->callees, (size_t)f->cap * sizeof(int));
+    }
+    f->callees[f->ncallees++] = callee;
+}
+
+static void edge_add(int caller, const char* callee, const char* unit)
+{
+    if (edge_count == edge_cap) {
+        edge_cap = edge_cap ? edge_cap * 2 : 1024;
+        edges = (edge_t*)xrealloc(edges, (size_t)edge_cap * sizeof(edge_t));
+    }
+    edges[edge_count].caller = caller;
+    edges[edge_count].callee = xstrdup(callee);
+    edges[edge_count].unit = (unit != NULL) ? xstrdup(unit) : NULL;
+    edge_count++;
+}
+
+/* 编译单元：去掉扩展名的路径 */
+static char* unit_of(const char* path)
+{
+    char* unit = xstrdup(path);
+    char* dot = strrchr(unit, '.');
+    char* slash = strrchr(unit, '/');
+
+    if (dot != NULL && (slash == NULL || dot > slash)) {
+        *dot = '\0';
+    }
+    return unit;
+}
+
+/* 取出key: "..."中的字符串，返回结束引号之后的位置 */
+static const char* quoted(const char* line, const char* key, char* out, size_t size)
+{
+    const char* p = strstr(line, key);
+    size_t n = 0;
+
+    if (p == NULL) {
+        return NULL;
+    }
+    p += strlen(key);
+    while (*p == ' ') {
+        p++;
+    }
+    if (*p++ != '"') {
+        return NULL;
+    }
+    while (*p != '\0' && *p != '"') {
+        if (*p == '\\' && p[1] != '\0') {
+            if (n + 2 < size) {
+                out[n++] = *p;
+                out[n++] = p[1];
+            }
+            p += 2;
+            continue;
+        }
+        if (n + 1 < size) {
+            out[n++] = *p;
+        }
+        p++;
+    }
+    out[n] = '\0';
+    return (*p == '"') ? p + 1 : NULL;
+}
+
+/* 读取-fcallgraph-info输出(VCG格式) */
+static int load_ci(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    char* unit;
+    char line[MAX_LINE];
+    char title[512];
+    char label[1024];
+    char target[512];
+    const char* bytes;
+    int i;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    unit = unit_of(path);
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (strncmp(line, "node:", 5) == 0) {
+            if (quoted(line, "title:", title, sizeof(title)) == NULL ||
+                quoted(line, "label:", label, sizeof(label)) == NULL) {
+                continue;
+            }
+            /* 只有本单元定义的函数带有"N bytes (qualifier)"，其余是外部函数的声明 */
+            bytes = strstr(label, " bytes (");
+            if (bytes == NULL || strcmp(title, "__indirect_call") == 0) {
+                continue;
+            }
+            while (bytes > label && bytes[-1] >= '0' && bytes[-1] <= '9') {
+                bytes--;
+            }
+            i = func_define(title, unit);
+            func_set_size(i, (uint32_t)strtoul(bytes, NULL, 10), strchr(bytes, '('));
+        } else if (strncmp(line, "edge:", 5) == 0) {
+            if (quoted(line, "sourcename:", title, sizeof(title)) == NULL ||
+                quoted(line, "targetname:", target, sizeof(target)) == NULL) {
+                continue;
+            }
+            i = func_define(title, unit);
+            if (strcmp(target, "__indirect_call") == 0) {
+                funcs[i].flags |= F_INDIRECT;
+            } else {
+                edge_add(i, target, unit);
+            }
+        }
+    }
+    free(unit);
+    fclose(f);
+    return 0;
+}
+
+/* 读取-fstack-usage输出：file:line:col:name<TAB>bytes<TAB>qualifier */
+static int load_su(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    char* unit;
+    char line[MAX_LINE];
+    char* tab;
+    char* name;
+    char* qual;
+    uint32_t bytes;
+    int i;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    unit = unit_of(path);
+    while (fgets(line, sizeof(line), f) != NULL) {
+        tab = strchr(line, '\t');
+        if (tab == NULL) {
+            continue;
+        }
+        *tab = '\0';
+        name = strrchr(line, ':');
+        name = (name != NULL) ? name + 1 : line;
+        bytes = (uint32_t)strtoul(tab + 1, &qual, 10);
+        i = func_define(name, unit);
+        if (!funcs[i].has_size) {
+            func_set_size(i, bytes, qual);
+        }
+    }
+    free(unit);
+    fclose(f);
+    return 0;
+}
+
+/* 读取补充文件 */
+static int load_cfg(const char* path)
+{
+    FILE* f = fopen(path, "r");
+    char line[MAX_LINE];
+    char kind[32];
+    char a[512];
+    char b[512];
+    unsigned lineno = 0;
+    char* hash_mark;
+    int n;
+    int i;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f) != NULL) {
+        lineno++;
+        hash_mark = strchr(line, '#');
+        if (hash_mark != NULL) {
+            *hash_mark = '\0';
+        }
+        n = sscanf(line, "%31s %511s %511s", kind, a, b);
+        if (n <= 0) {
+            continue;
+        }
+        if (n == 3 && strcmp(kind, "stack") == 0) {
+            i = func_lookup(a);
+            if (i < 0) {
+                i = func_add(a, NULL);
+            }
+            funcs[i].self = (uint32_t)strtoul(b, NULL, 0);
+            funcs[i].has_size = 1;
+        } else if (n == 3 && strcmp(kind, "call") == 0) {
+            i = func_lookup(a);
+            if (i < 0) {
+                i = func_add(a, NULL);
+            }
+            funcs[i].flags |= F_RESOLVED;
+            edge_add(i, b, NULL);  /* 被调函数在resolve_edges中查找 */
+        } else {
+            fprintf(stderr, "%s:%u: expected 'stack <func> <bytes>' or 'call <caller> <callee>'\n",
+                    path, lineno);
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+/* 把全部调用边解析为函数编号 */
+static void resolve_edges(void)
+{
+    int k;
+    int callee;
+
+    for (k = 0; k < edge_count; k++) {
+        if (edges[k].unit != NULL) {
+            callee = func_find(edges[k].callee, edges[k].unit);
+            if (callee < 0) {
+                callee = func_find(edges[k].callee, NULL);
+            }
+        } else {
+            callee = func_lookup(edges[k].callee);
+        }
+        if (callee < 0) {
+            callee = func_add(edges[k].callee, NULL);
+        }
+        call_add(edges[k].caller, callee);
+    }
+}
+
+/* 函数自身的标志 */
+static uint32_t self_flags(const func_t* f)
+{
+    uint32_t flags = f->flags & (F_DYNAMIC | F_RECURSIVE);
+
+    if (!f->has_size) {
+        flags |= F_UNKNOWN;
+    }
+    if ((f->flags & F_INDIRECT) != 0U && (f->flags & F_RESOLVED) == 0U) {
+        flags |= F_INDIRECT;
+    }
+    return flags;
+}
+
+/* 深度优先计算最深调用链，回边(递归)计0并标记 */
+static void analyze(int i)
+{
+    func_t* f = &funcs[i];
+    func_t* c;
+    int k;
+
+    if (f->state == S_DONE) {
+        return;
+    }
+    f->state = S_ACTIVE;
+    f->worst = 0;
+    f->next = -1;
+    f->reach = 0;
+    for (k = 0; k < f->ncallees; k++) {
+        c = &funcs[f->callees[k]];
+        if (c->state == S_ACTIVE) {
+            c->flags |= F_RECURSIVE;
+            f->reach |= F_RECURSIVE;
+            continue;
+        }
+        analyze(f->callees[k]);
+        f = &funcs[i];
+        c = &funcs[f->callees[k]];
+        f->reach |= c->reach;
+        if (c->worst > f->worst || f->next < 0) {
+            f->worst = c->worst;
+            f->next = f->callees[k];
+        }
+    }
+    f->worst += f->self;
+    f->reach |= self_flags(f);
+    f->state = S_DONE;
+}
+
+static void flags_text(uint32_t flags, char* buf, size_t size)
+{
+    buf[0] = '\0';
+    if (flags & F_UNKNOWN) {
+        strncat(buf, " unknown", size - strlen(buf) - 1);
+    }
+    if (flags & F_INDIRECT) {
+        strncat(buf, " indirect", size - strlen(buf) - 1);
+    }
+    if (flags & F_RECURSIVE) {
+        strncat(buf, " recursive", size - strlen(buf) - 1);
+    }
+    if (flags & F_DYNAMIC) {
+        strncat(buf, " dynamic", size - strlen(buf) - 1);
+    }
+}
+
+/* 输出最深调用链 */
+static void print_path(int i)
+{
+    char flags[64];
+    int n = 0;
+
+    while (i >= 0 && n++ < MAX_PATH_PRINT) {
+        flags_text(self_flags(&funcs[i]), flags, sizeof(flags));
+        printf("    %-40s %6u%s\n", funcs[i].name, (unsigned)funcs[i].self, flags);
+        i = funcs[i].next;
+    }
+}
+
+/* 列出可达函数中使结果成为下限的函数 */
+static void print_causes(int root)
+{
+    char* seen = (char*)calloc((size_t)func_count, 1);
+    int* stack = (int*)xrealloc(NULL, (size_t)func_count * sizeof(int));
+    char flags[64];
+    int top = 0;
+    int i;
+    int k;
+
+    if (seen == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    stack[top++] = root;
+    seen[root] = 1;
+    while (top > 0) {
+        i = stack[--top];
+        if (self_flags(&funcs[i]) != 0U) {
+            flags_text(self_flags(&funcs[i]), flags, sizeof(flags));
+            printf("    ! %s:%s\n", funcs[i].name, flags);
+        }
+        for (k = 0; k < funcs[i].ncallees; k++) {
+            if (!seen[funcs[i].callees[k]]) {
+                seen[funcs[i].callees[k]] = 1;
+                stack[top++] = funcs[i].callees[k];
+            }
+        }
+    }
+    free(stack);
+    free(seen);
+}
+
+/* 分析一个入口，找不到时返回-1 */
+static int analyze_root(const char* name)
+{
+    int i = func_lookup(name);
+
+    if (i < 0 || funcs[i].unit == NULL) {
+        fprintf(stderr, "function '%s' not found in the call graph\n", name);
+        return -1;
+    }
+    analyze(i);
+    return i;
+}
+
+static uint32_t round8(uint32_t bytes)
+{
+    return (bytes + 7U) & ~7U;
+}
+
+static int cmp_prio(const void* a, const void* b)
+{
+    return ((const root_t*)a)->prio - ((const root_t*)b)->prio;
+}
+
+static void usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [-t task]... [-i isr:prio]... [-m main] [-c cfg]\n"
+            "          [-f bytes] [-n bytes] [-r bytes] [-o header] file.ci|file.su ...\n",
+            prog);
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(int argc, char** argv)
+{
+    const char* cfg = NULL;
+    const char* header = NULL;
+    uint32_t task_context = DEFAULT_TASK_CONTEXT;
+    uint32_t nest_frame = DEFAULT_NEST_FRAME;
+    uint32_t reserve = 0;
+    uint32_t task_bytes[MAX_ROOTS];
+    uint32_t task_flags[MAX_ROOTS];
+    uint32_t max_task = 0;
+    uint32_t msp = 0;
+    uint32_t msp_flags = 0;
+    uint32_t isr_chain = 0;
+    uint32_t level_worst;
+    uint32_t bytes;
+    uint32_t flags;
+    int levels = 0;
+    int files = 0;
+    int exit_fn;
+    int root;
+    int i;
+    int k;
+    char text[64];
+    char* colon;
+    FILE* out;
+
+    for (i = 0; i < (int)HASH_SIZE; i++) {
+        hash_head[i] = -1;
+    }
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc && task_count < MAX_ROOTS) {
+            tasks[task_count++].name = argv[++i];
+        } else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc && isr_count < MAX_ROOTS) {
+            colon = strchr(argv[++i], ':');
+            if (colon == NULL) {
+                usage(argv[0]);
+                return 1;
+            }
+            *colon = '\0';
+            isrs[isr_count].name = argv[i];
+            isrs[isr_count++].prio = atoi(colon + 1);
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            main_name = argv[++i];
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            cfg = argv[++i];
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            task_context = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            nest_frame = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            reserve = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            header = argv[++i];
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 1;
+        } else {
+            size_t len = strlen(argv[i]);
+
+            if (len > 3 && strcmp(argv[i] + len - 3, ".ci") == 0) {
+                if (load_ci(argv[i]) != 0) {
+                    return 1;
+                }
+            } else if (len > 3 && strcmp(argv[i] + len - 3, ".su") == 0) {
+                if (load_su(argv[i]) != 0) {
+                    return 1;
+                }
+            } else {
+                fprintf(stderr, "%s: expected a .ci or .su file\n", argv[i]);
+                return 1;
+            }
+            files++;
+        }
+    }
+    if (files == 0 || (task_count == 0 && isr_count == 0 && main_name == NULL)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (cfg != NULL && load_cfg(cfg) != 0) {
+        return 1;
+    }
+    resolve_edges();
+
+    /* 任务栈：入口函数和返回后的rtos_task_exit取大者 */
+    exit_fn = func_find("rtos_task_exit", NULL);
+    if (exit_fn >= 0 && funcs[exit_fn].unit != NULL) {
+        analyze(exit_fn);
+    } else {
+        exit_fn = -1;
+    }
+    for (k = 0; k < task_count; k++) {
+        root = analyze_root(tasks[k].name);
+        if (root < 0) {
+            return 1;
+        }
+        flags = funcs[root].reach;
+        if (exit_fn >= 0) {
+            flags |= funcs[exit_fn].reach;
+            if (funcs[exit_fn].worst > funcs[root].worst) {
+                root = exit_fn;
+            }
+        }
+        bytes = funcs[root].worst;
+        task_bytes[k] = round8(bytes + task_context + reserve);
+        task_flags[k] = flags;
+        if (task_bytes[k] > max_task) {
+            max_task = task_bytes[k];
+        }
+        flags_text(flags, text, sizeof(text));
+        printf("task %s: %u bytes (call chain %u + context %u + reserve %u)%s%s\n",
+               tasks[k].name, (unsigned)task_bytes[k], (unsigned)bytes, (unsigned)task_context,
+               (unsigned)reserve, flags ? " lower bound:" : "", text);
+        print_path(root);
+        if (flags != 0U) {
+            print_causes(root);
+        }
+    }
+
+    /* 主栈：每个优先级取最深的中断，逐级嵌套 */
+    qsort(isrs, (size_t)isr_count, sizeof(root_t), cmp_prio);
+    for (k = 0; k < isr_count; k = i) {
+        level_worst = 0;
+        for (i = k; i < isr_count && isrs[i].prio == isrs[k].prio; i++) {
+            root = analyze_root(isrs[i].name);
+            if (root < 0) {
+                return 1;
+            }
+            if (funcs[root].worst > level_worst) {
+                level_worst = funcs[root].worst;
+            }
+            msp_flags |= funcs[root].reach;
+            flags_text(funcs[root].reach, text, sizeof(text));
+            printf("isr %s (prio %d): %u bytes%s%s\n", isrs[i].name, isrs[i].prio,
+                   (unsigned)funcs[root].worst, funcs[root].reach ? " lower bound:" : "", text);
+            print_path(root);
+            if (funcs[root].reach != 0U) {
+                print_causes(root);
+            }
+        }
+        isr_chain += level_worst;
+        levels++;
+    }
+    if (levels > 1) {
+        isr_chain += (uint32_t)(levels - 1) * nest_frame;
+    }
+    msp = isr_chain;
+    if (main_name != NULL) {
+        root = analyze_root(main_name);
+        if (root < 0) {
+            return 1;
+        }
+        /* 调度器启动前第一层中断的硬件帧也压在主栈上 */
+        bytes = funcs[root].worst + (levels > 0 ? nest_frame : 0U) + isr_chain;
+        if (bytes > msp) {
+            msp = bytes;
+        }
+        msp_flags |= funcs[root].reach;
+        flags_text(funcs[root].reach, text, sizeof(text));
+        printf("main %s: %u bytes%s%s\n", main_name, (unsigned)funcs[root].worst,
+               funcs[root].reach ? " lower bound:" : "", text);
+        print_path(root);
+        if (funcs[root].reach != 0U) {
+            print_causes(root);
+        }
+    }
+    msp = round8(msp);
+    if (isr_count > 0 || main_name != NULL) {
+        flags_text(msp_flags, text, sizeof(text));
+        printf("msp: %u bytes (%d priority levels)%s%s\n", (unsigned)msp, levels,
+               msp_flags ? " lower bound:" : "", text);
+    }
+
+    if (header == NULL) {
+        return 0;
+    }
+    out = fopen(header, "w");
+    if (out == NULL) {
+        perror(header);
+        return 1;
+    }
+    fprintf(out, "/* 由03_tools/stack_report生成，不要手工修改 */\n\n");
+    fprintf(out, "#ifndef __STACK_CFG_H__\n#define __STACK_CFG_H__\n\n");
+    fprintf(out, "/* 任务栈(字)：最深调用链 + 被中断时的上下文%u字节 + 保留%u字节 */\n",
+            (unsigned)task_context, (unsigned)reserve);
+    for (k = 0; k < task_count; k++) {
+        flags_text(task_flags[k], text, sizeof(text));
+        fprintf(out, "#define STACK_WORDS_%-32s %5u   /* %u bytes%s%s */\n", tasks[k].name,
+                (unsigned)(task_bytes[k] / 4U), (unsigned)task_bytes[k],
+                task_flags[k] ? ", lower bound:" : "", text);
+    }
+    if (isr_count > 0 || main_name != NULL) {
+        flags_text(msp_flags, text, sizeof(text));
+        fprintf(out, "\n/* 主栈(字节)：%d级中断嵌套%s */\n", levels,
+                main_name != NULL ? "，与调度器启动前的main比较" : "");
+        fprintf(out, "#define STACK_MSP_BYTES%-30s %5u%s%s%s\n", "", (unsigned)msp,
+                msp_flags ? "   /* lower bound:" : "", text, msp_flags ? " */" : "");
+    }
+    if (task_count > 0) {
+        fprintf(out, "\n/* 全部任务共用的栈大小(字)取最大值 */\n");
+        fprintf(out, "#ifndef STACK_SIZE\n#define STACK_SIZE%-35s %5u\n#endif\n", "",
+                (unsigned)(max_task / 4U));
+    }
+    fprintf(out, "\n#endif /* __STACK_CFG_H__ */\n");
+    fclose(out);
+    return 0;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
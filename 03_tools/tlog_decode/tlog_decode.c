@@ -0,0 +1,429 @@
+/**
+  ******************************************************************************
+  * @file    tlog_decode.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   令牌化日志主机端解码工具 (Linux)
+  *          根据ELF中tlog_fmt段的格式字符串还原目标端输出的二进制日志
+  ******************************************************************************
+  * @attention
+  *
+  * 用法：
+  *   tlog_decode -e fw.elf [-t] [-f hz] [stream.bin | -]
+  *   tlog_decode -e fw.elf -l             列出全部格式字符串及其编号
+  *   tlog_decode -s stream.bin            用本工具自身的TLOG调用生成模拟数据流
+  *
+  *   -e elf      含tlog_fmt段的ELF文件 (目标固件，或-s模式下的本工具)
+  *   -t          显示时间戳 (需目标端开启TLOG_USE_TIMESTAMP)
+  *   -f hz       时间戳计数频率，默认84000000 (TIM2)
+  *
+  * 数据流来源示例：
+  *   J-Link RTT Logger:  JLinkRTTLogger -Device STM32F407VG -RTTChannel 1 tlog.bin
+  *   RAM转储:           rtt_reader -c 1 ram.bin > tlog.bin
+  *
+  * 无硬件时的验证：
+  *   tlog_decode -s sim.bin && tlog_decode -e build/tlog_decode sim.bin
+  *   04_host中make test的tlog项以目标端tlog.c编码，逐字检查本工具的输出
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../common/elf_reader.h"
+#include "../../02_rtos/tlog.h"
+
+/* Private define ------------------------------------------------------------*/
+#define TLOG_SECTION_NAME   "tlog_fmt"
+#define DEFAULT_TIMER_HZ    84000000.0
+#define LINE_MAX_LEN        1024
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 格式字符串表 - 即ELF中的tlog_fmt段 */
+typedef struct {
+    const char* data;
+    uint32_t size;
+} fmt_table_t;
+
+/* Private variables ---------------------------------------------------------*/
+static FILE* sim_out;               /* -s模式下TLOG_Write的输出文件 */
+static uint32_t sim_timestamp;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* 编号对应的字符串，编号无效时返回NULL */
+static const char* lookup(const fmt_table_t* t, uint32_t id)
+{
+    if (id >= t->size || (id > 0U && t->data[id - 1U] != '\0') ||
+        memchr(t->data + id, 0, t->size - id) == NULL) {
+        return NULL;
+    }
+    return t->data + id;
+}
+
+/* 解码LEB128，返回消耗的字节数，数据不完整返回0 */
+static uint32_t get_varint(const uint8_t* p, size_t avail, uint32_t* value)
+{
+    uint32_t v = 0;
+    uint32_t i;
+
+    for (i = 0; i < 5U && i < avail; i++) {
+        v |= (uint32_t)(p[i] & 0x7FU) << (7U * i);
+        if ((p[i] & 0x80U) == 0U) {
+            *value = v;
+            return i + 1U;
+        }
+    }
+    return 0;
+}
+
+/* 按格式字符串和参数还原文本，参数个数与格式不符时返回-1 */
+static int format_record(const fmt_table_t* t, const char* fmt,
+                         const uint32_t* args, uint32_t nargs, char* out, size_t outsz)
+{
+    char spec[32];
+    size_t pos = 0;
+    uint32_t argi = 0;
+    int n;
+
+    out[0] = '\0';
+    while (*fmt != '\0' && pos + 1U < outsz) {
+        size_t sl = 0;
+        uint32_t arg;
+        char conv;
+
+        if (*fmt != '%') {
+            out[pos++] = *fmt++;
+            continue;
+        }
+        if (fmt[1] == '%') {
+            out[pos++] = '%';
+            fmt += 2;
+            continue;
+        }
+
+        /* 收集标志、宽度和精度，丢弃长度修饰符(参数均为32位) */
+        spec[sl++] = *fmt++;
+        while (*fmt != '\0' && strchr("-+ #0123456789.", *fmt) != NULL && sl < sizeof(spec) - 3U) {
+            spec[sl++] = *fmt++;
+        }
+        while (*fmt != '\0' && strchr("hlLqjzt", *fmt) != NULL) {
+            fmt++;
+        }
+        conv = *fmt;
+        if (conv == '\0' || argi >= nargs) {
+            return -1;
+        }
+        fmt++;
+        arg = args[argi++];
+
+        switch (conv) {
+        case 'd':
+        case 'i':
+            spec[sl++] = 'd';
+            spec[sl] = '\0';
+            n = snprintf(out + pos, outsz - pos, spec, (int)(int32_t)arg);
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        case 'c':
+            spec[sl++] = conv;
+            spec[sl] = '\0';
+            n = snprintf(out + pos, outsz - pos, spec, (unsigned)arg);
+            break;
+        case 'p':
+            n = snprintf(out + pos, outsz - pos, "0x%08x", (unsigned)arg);
+            break;
+        case 's': {
+            const char* s = lookup(t, arg);
+            spec[sl++] = 's';
+            spec[sl] = '\0';
+            n = snprintf(out + pos, outsz - pos, spec, (s != NULL) ? s : "<bad string id>");
+            break;
+        }
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A': {
+            union { float f; uint32_t u; } v;
+            v.u = arg;
+            spec[sl++] = conv;
+            spec[sl] = '\0';
+            n = snprintf(out + pos, outsz - pos, spec, (double)v.f);
+            break;
+        }
+        default:
+            return -1;
+        }
+        if (n > 0) {
+            pos += ((size_t)n < outsz - pos) ? (size_t)n : outsz - pos - 1U;
+        }
+    }
+    out[pos] = '\0';
+    return (argi == nargs) ? 0 : -1;
+}
+
+static int load_stream(const char* path, uint8_t** data, size_t* size)
+{
+    FILE* f = (strcmp(path, "-") == 0) ? stdin : fopen(path, "rb");
+    size_t cap = 4096;
+    size_t len = 0;
+    size_t n;
+
+    if (f == NULL) {
+        perror(path);
+        return -1;
+    }
+    *data = (uint8_t*)malloc(cap);
+    while (*data != NULL && (n = fread(*data + len, 1, cap - len, f)) > 0) {
+        len += n;
+        if (len == cap) {
+            cap *= 2;
+            *data = (uint8_t*)realloc(*data, cap);
+        }
+    }
+    if (f != stdin) {
+        fclose(f);
+    }
+    if (*data == NULL) {
+        fprintf(stderr, "out of memory\n");
+        return -1;
+    }
+    *size = len;
+    return 0;
+}
+
+/* 解码整个数据流，返回成功还原的记录数 */
+static uint32_t decode_stream(const fmt_table_t* t, const uint8_t* p, size_t size,
+                              int show_ts, double timer_hz)
+{
+    char line[LINE_MAX_LEN];
+    uint32_t args[TLOG_MAX_ARGS];
+    uint32_t records = 0;
+    uint32_t skipped = 0;
+    uint64_t ts_ext = 0;
+    uint32_t ts_last = 0;
+    size_t off = 0;
+
+    while (off < size) {
+        uint8_t hdr = p[off];
+        uint32_t nargs = hdr & TLOG_NARGS_MASK;
+        size_t cur = off + 1U;
+        uint32_t id = 0, ts = 0, used, i;
+        const char* fmt;
+        size_t len;
+
+        /* 同步位错误、编号或参数不完整/不符时丢弃1字节重新同步 */
+        if ((hdr & TLOG_SYNC_MASK) != TLOG_SYNC || nargs > TLOG_MAX_ARGS ||
+            (used = get_varint(p + cur, size - cur, &id)) == 0U) {
+            goto resync;
+        }
+        cur += used;
+        if ((hdr & TLOG_FLAG_TIMESTAMP) != 0U) {
+            if (size - cur < 4U) {
+                goto resync;
+            }
+            ts = (uint32_t)p[cur] | ((uint32_t)p[cur + 1] << 8) |
+                 ((uint32_t)p[cur + 2] << 16) | ((uint32_t)p[cur + 3] << 24);
+            cur += 4U;
+        }
+        for (i = 0; i < nargs; i++) {
+            used = get_varint(p + cur, size - cur, &args[i]);
+            if (used == 0U) {
+                break;
+            }
+            cur += used;
+        }
+        fmt = lookup(t, id);
+        if (i < nargs || fmt == NULL || format_record(t, fmt, args, nargs, line, sizeof(line)) != 0) {
+            goto resync;
+        }
+
+        if (skipped > 0U) {
+            fprintf(stderr, "tlog: skipped %u bytes\n", (unsigned)skipped);
+            skipped = 0;
+        }
+        len = strlen(line);
+        while (len > 0U && (line[len - 1U] == '\n' || line[len - 1U] == '\r')) {
+            line[--len] = '\0';
+        }
+        if (show_ts && (hdr & TLOG_FLAG_TIMESTAMP) != 0U) {
+            /* 32位计数器回绕后扩展为64位 */
+            if (records > 0U && ts < ts_last) {
+                ts_ext += 1ULL << 32;
+            }
+            ts_last = ts;
+            printf("[%12.6f] ", (double)(ts_ext + ts) / timer_hz);
+        }
+        printf("%s\n", line);
+        records++;
+        off = cur;
+        continue;
+
+resync:
+        skipped++;
+        off++;
+    }
+    if (skipped > 0U) {
+        fprintf(stderr, "tlog: skipped %u bytes\n", (unsigned)skipped);
+    }
+    return records;
+}
+
+static void list_formats(const fmt_table_t* t)
+{
+    uint32_t off = 0;
+
+    while (off < t->size) {
+        size_t len = strlen(t->data + off);
+        if (len > 0U) {
+            printf("%6u  \"", (unsigned)off);
+            for (size_t i = 0; i < len; i++) {
+                char c = t->data[off + i];
+                if (c == '\n') {
+                    printf("\\n");
+                } else if (c == '\r') {
+                    printf("\\r");
+                } else {
+                    putchar(c);
+                }
+            }
+            printf("\"\n");
+        }
+        off += (uint32_t)len + 1U;
+    }
+}
+
+/**
+  * @brief  -s模式下的TLOG输出：与目标端tlog.c相同的帧格式，写入文件
+  */
+void TLOG_Write(uint32_t id, const uint32_t* args, uint32_t nargs)
+{
+    uint8_t frame[TLOG_FRAME_MAX];
+    uint32_t len = 0;
+    uint32_t i, v;
+
+    frame[len++] = (uint8_t)(TLOG_SYNC | TLOG_FLAG_TIMESTAMP | nargs);
+    for (v = id; v >= 0x80U; v >>= 7) {
+        frame[len++] = (uint8_t)(v | 0x80U);
+    }
+    frame[len++] = (uint8_t)v;
+    sim_timestamp += 84000U;            /* 每条间隔1ms */
+    for (i = 0; i < 4U; i++) {
+        frame[len++] = (uint8_t)(sim_timestamp >> (8U * i));
+    }
+    for (i = 0; i < nargs; i++) {
+        for (v = args[i]; v >= 0x80U; v >>= 7) {
+            frame[len++] = (uint8_t)(v | 0x80U);
+        }
+        frame[len++] = (uint8_t)v;
+    }
+    fwrite(frame, 1, len, sim_out);
+}
+
+static int make_simulated_stream(const char* path)
+{
+    uint32_t counter;
+
+    sim_out = fopen(path, "wb");
+    if (sim_out == NULL) {
+        perror(path);
+        return -1;
+    }
+    TLOG("tlog simulated stream\r\n");
+    for (counter = 0; counter < 3U; counter++) {
+        TLOG("Hellow rtos! Counter: %lu\r\n", counter);
+    }
+    TLOG("task %s prio=%d stack=%u/%u\r\n", TLOG_STR("serial"), 3, 212U, 1024U);
+    TLOG("temp=%.2f C err=%d flags=0x%08x\r\n", TLOG_FLOAT(36.6f), -5, 0xDEADBEEFU);
+    fputc(0x55, sim_out);               /* 一个损坏字节，验证重新同步 */
+    TLOG("%5u|%-5d|%c\r\n", 42U, 7, 'x');
+    fclose(sim_out);
+    printf("wrote %s, decode with: tlog_decode -e <this tool> %s\n", path, path);
+    return 0;
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+            "usage: tlog_decode -e fw.elf [-t] [-f hz] [stream.bin | -]\n"
+            "       tlog_decode -e fw.elf -l\n"
+            "       tlog_decode -s stream.bin\n");
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(int argc, char** argv)
+{
+    const char* elf_path = NULL;
+    const char* in_path = "-";
+    double timer_hz = DEFAULT_TIMER_HZ;
+    int show_ts = 0, list = 0;
+    elf_file_t elf;
+    elf_section_t sec;
+    fmt_table_t table;
+    uint8_t* stream;
+    size_t size;
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            return make_simulated_stream(argv[i + 1]) == 0 ? 0 : 1;
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            elf_path = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0) {
+            show_ts = 1;
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            timer_hz = strtod(argv[++i], NULL);
+        } else if (strcmp(argv[i], "-l") == 0) {
+            list = 1;
+        } else if (argv[i][0] != '-' || strcmp(argv[i], "-") == 0) {
+            in_path = argv[i];
+        } else {
+            usage();
+            return 1;
+        }
+    }
+    if (elf_path == NULL || timer_hz <= 0.0) {
+        usage();
+        return 1;
+    }
+
+    if (elf_open(elf_path, &elf) != 0) {
+        return 1;
+    }
+    if (elf_find_section(&elf, TLOG_SECTION_NAME, &sec) != 0 ||
+        elf_section_data(&elf, &sec) == NULL) {
+        fprintf(stderr, "%s: no %s section\n", elf_path, TLOG_SECTION_NAME);
+        elf_close(&elf);
+        return 1;
+    }
+    table.data = (const char*)elf_section_data(&elf, &sec);
+    table.size = (uint32_t)sec.size;
+
+    if (list) {
+        list_formats(&table);
+    } else {
+        if (load_stream(in_path, &stream, &size) != 0) {
+            elf_close(&elf);
+            return 1;
+        }
+        decode_stream(&table, stream, size, show_ts, timer_hz);
+        free(stream);
+    }
+    elf_close(&elf);
+    return 0;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,377 @@
+/**
+  ******************************************************************************
+  * @file    bench_kernel.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   内核主机端吞吐量基准测试
+  *          在POSIX移植层上运行未经修改的内核源码，测量调度相关开销
+  ******************************************************************************
+  * @attention
+  *
+  * 测试项目：
+  * 1. critical   临界区进入/退出(最外层和嵌套)
+  * 2. switch     等待队列乒乓：高优先级任务等待，低优先级任务唤醒，每轮两次切换
+  * 3. irq_wake   模拟中断(SIGUSR1)唤醒任务，从触发到任务恢复运行的延迟
+  * 4. delay      Delay_us(100)的实际延时超出量
+  * 5. alloc      rtos_alloc/rtos_free成对调用(普通、DMA、FAST各一次)
+  * 6. pool       pool_alloc/pool_free成对调用，与glibc malloc/free对比
+  * 7. arena      控制周期：16次临时分配后整体复位，与rtos_alloc/rtos_free对比
+  *
+  * 主机上的数值包含信号屏蔽和setitimer的系统调用开销，只用于比较内核
+  * 改动前后的相对变化，不代表目标板性能。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "mem.h"
+#include "pool.h"
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Private define ------------------------------------------------------------*/
+#define CRITICAL_LOOPS          1000000U
+#define SWITCH_ROUNDS           200000U
+#define IRQ_SAMPLES             20000U
+#define DELAY_SAMPLES           200U
+#define DELAY_US                100U
+#define ALLOC_ROUNDS            200000U
+#define POOL_BLOCK_SIZE         64U
+#define POOL_BATCH              16U
+#define ARENA_CYCLES            100000U
+#define ARENA_ALLOCS            16U
+
+/* Private typedef -----------------------------------------------------------*/
+
+/* 延迟统计 */
+typedef struct {
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+    uint32_t count;
+} bench_stat_t;
+
+/* Private variables ---------------------------------------------------------*/
+static wait_queue_t bench_queue;
+static volatile uint32_t bench_count;
+static volatile uint64_t bench_stamp;
+static uint64_t bench_elapsed[2];
+static bench_stat_t bench_stat;
+POOL_DEFINE(bench_pool, POOL_BLOCK_SIZE, POOL_BATCH);
+ARENA_DEFINE(bench_arena, 8192);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  读取单调时钟
+  * @param  None
+  * @retval 纳秒
+  */
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+  * @brief  记录一个延迟样本
+  * @param  value: 样本值
+  * @retval None
+  */
+static void stat_add(uint64_t value)
+{
+    if (bench_stat.count == 0 || value < bench_stat.min) {
+        bench_stat.min = value;
+    }
+    if (value > bench_stat.max) {
+        bench_stat.max = value;
+    }
+    bench_stat.sum += value;
+    bench_stat.count++;
+}
+
+/**
+  * @brief  初始化内核、创建测试任务并运行到任务调用port_posix_stop
+  * @param  high: 优先级1的任务，可为NULL
+  * @param  low: 优先级2的任务
+  * @retval None
+  */
+static void bench_run(void (*high)(void*), void (*low)(void*))
+{
+    bench_queue.head = NULL;
+    bench_queue.tail = NULL;
+    bench_count = 0;
+    bench_stat.min = bench_stat.max = bench_stat.sum = 0;
+    bench_stat.count = 0;
+
+    rtos_init();
+    Time_Init();
+    if (high) {
+        task_create(high, NULL, 1);
+    }
+    task_create(low, NULL, 2);
+    rtos_start();
+    Time_DeInit();
+}
+
+/* 1. 临界区 -------------------------------------------------------------------*/
+
+static void critical_task(void* arg)
+{
+    uint32_t outer;
+    uint32_t primask;
+    uint64_t start;
+    uint32_t i;
+
+    (void)arg;
+    start = now_ns();
+    for (i = 0; i < CRITICAL_LOOPS; i++) {
+        primask = rtos_enter_critical();
+        rtos_exit_critical(primask);
+    }
+    bench_elapsed[0] = now_ns() - start;
+
+    outer = rtos_enter_critical();
+    start = now_ns();
+    for (i = 0; i < CRITICAL_LOOPS; i++) {
+        primask = rtos_enter_critical();
+        rtos_exit_critical(primask);
+    }
+    bench_elapsed[1] = now_ns() - start;
+    rtos_exit_critical(outer);
+
+    port_posix_stop();
+}
+
+/* 2. 任务切换 -----------------------------------------------------------------*/
+
+static void switch_waiter(void* arg)
+{
+    uint32_t primask;
+
+    (void)arg;
+    while (1) {
+        primask = rtos_enter_critical();
+        task_wait(&bench_queue);
+        rtos_exit_critical(primask);   /* 在此切换到唤醒者 */
+        bench_count++;
+    }
+}
+
+static void switch_waker(void* arg)
+{
+    uint64_t start;
+    uint32_t i;
+
+    (void)arg;
+    start = now_ns();
+    for (i = 0; i < SWITCH_ROUNDS; i++) {
+        task_wake_one(&bench_queue);   /* 等待者优先级更高，立即切换 */
+    }
+    bench_elapsed[0] = now_ns() - start;
+
+    port_posix_stop();
+}
+
+/* 3. 中断唤醒 -----------------------------------------------------------------*/
+
+static void irq_handler(void)
+{
+    task_wake_one(&bench_queue);
+}
+
+static void irq_waiter(void* arg)
+{
+    uint32_t primask;
+
+    (void)arg;
+    while (1) {
+        primask = rtos_enter_critical();
+        task_wait(&bench_queue);
+        rtos_exit_critical(primask);
+        stat_add(now_ns() - bench_stamp);
+    }
+}
+
+static void irq_trigger(void* arg)
+{
+    uint32_t i;
+
+    (void)arg;
+    for (i = 0; i < IRQ_SAMPLES; i++) {
+        bench_stamp = now_ns();
+        port_posix_trigger_irq();      /* 处理函数返回前切换到等待者 */
+    }
+
+    port_posix_stop();
+}
+
+/* 4. 延时精度 -----------------------------------------------------------------*/
+
+static void delay_task(void* arg)
+{
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t i;
+
+    (void)arg;
+    for (i = 0; i < DELAY_SAMPLES; i++) {
+        start = port_timer_now();
+        Delay_us(DELAY_US);
+        elapsed = port_timer_now() - start;
+        stat_add(TICKS_TO_NS((uint64_t)(elapsed - US_TO_TICKS(DELAY_US))));
+    }
+
+    port_posix_stop();
+}
+
+/* 5. 动态内存 -----------------------------------------------------------------*/
+
+static void alloc_task(void* arg)
+{
+    void* a;
+    void* b;
+    void* c;
+    uint64_t start;
+    uint32_t i;
+
+    (void)arg;
+    start = now_ns();
+    for (i = 0; i < ALLOC_ROUNDS; i++) {
+        a = rtos_alloc(64U + (i & 0xFFU), RTOS_MEM_ANY);
+        b = rtos_alloc(256U, RTOS_MEM_DMA);
+        c = rtos_alloc(128U + (i & 0x7FU), RTOS_MEM_FAST);
+        rtos_free(b);
+        rtos_free(a);
+        rtos_free(c);
+    }
+    bench_elapsed[0] = now_ns() - start;
+
+    port_posix_stop();
+}
+
+/* 6. 内存块池 -----------------------------------------------------------------*/
+
+static void pool_task(void* arg)
+{
+    void* blocks[POOL_BATCH];
+    uint64_t start;
+    uint32_t i;
+    uint32_t k;
+
+    (void)arg;
+    start = now_ns();
+    for (i = 0; i < ALLOC_ROUNDS / POOL_BATCH; i++) {
+        for (k = 0; k < POOL_BATCH; k++) {
+            blocks[k] = pool_alloc(&bench_pool);
+        }
+        for (k = 0; k < POOL_BATCH; k++) {
+            pool_free(&bench_pool, blocks[k]);
+        }
+    }
+    bench_elapsed[0] = now_ns() - start;
+
+    start = now_ns();
+    for (i = 0; i < ALLOC_ROUNDS / POOL_BATCH; i++) {
+        for (k = 0; k < POOL_BATCH; k++) {
+            blocks[k] = malloc(POOL_BLOCK_SIZE);
+        }
+        for (k = 0; k < POOL_BATCH; k++) {
+            free(blocks[k]);
+        }
+    }
+    bench_elapsed[1] = now_ns() - start;
+
+    port_posix_stop();
+}
+
+/* 7. 临时内存区 ---------------------------------------------------------------*/
+
+static void arena_task(void* arg)
+{
+    void* blocks[ARENA_ALLOCS];
+    uint64_t start;
+    uint32_t i;
+    uint32_t k;
+
+    (void)arg;
+    arena_attach(NULL, &bench_arena);
+    start = now_ns();
+    for (i = 0; i < ARENA_CYCLES; i++) {
+        for (k = 0; k < ARENA_ALLOCS; k++) {
+            blocks[k] = arena_scratch(16U + 24U * k);
+        }
+        arena_reset(&bench_arena);
+    }
+    bench_elapsed[0] = now_ns() - start;
+
+    start = now_ns();
+    for (i = 0; i < ARENA_CYCLES; i++) {
+        for (k = 0; k < ARENA_ALLOCS; k++) {
+            blocks[k] = rtos_alloc(16U + 24U * k, RTOS_MEM_FAST);
+        }
+        for (k = 0; k < ARENA_ALLOCS; k++) {
+            rtos_free(blocks[k]);
+        }
+    }
+    bench_elapsed[1] = now_ns() - start;
+
+    port_posix_stop();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    printf("%-10s %12s %12s %12s\n", "bench", "min(ns)", "avg(ns)", "max(ns)");
+
+    bench_run(NULL, critical_task);
+    printf("%-10s %12s %12.1f %12s  (outermost)\n", "critical", "-",
+           (double)bench_elapsed[0] / CRITICAL_LOOPS, "-");
+    printf("%-10s %12s %12.1f %12s  (nested)\n", "critical", "-",
+           (double)bench_elapsed[1] / CRITICAL_LOOPS, "-");
+
+    bench_run(switch_waiter, switch_waker);
+    printf("%-10s %12s %12.1f %12s  (per switch, %u rounds, %u woken)\n", "switch", "-",
+           (double)bench_elapsed[0] / (2.0 * SWITCH_ROUNDS), "-",
+           SWITCH_ROUNDS, (unsigned)bench_count);
+
+    port_posix_set_irq_handler(irq_handler);
+    bench_run(irq_waiter, irq_trigger);
+    port_posix_set_irq_handler(NULL);
+    printf("%-10s %12llu %12.1f %12llu  (%u samples)\n", "irq_wake",
+           (unsigned long long)bench_stat.min, (double)bench_stat.sum / bench_stat.count,
+           (unsigned long long)bench_stat.max, (unsigned)bench_stat.count);
+
+    bench_run(NULL, delay_task);
+    printf("%-10s %12llu %12.1f %12llu  (overshoot of Delay_us(%u))\n", "delay",
+           (unsigned long long)bench_stat.min, (double)bench_stat.sum / bench_stat.count,
+           (unsigned long long)bench_stat.max, DELAY_US);
+
+    bench_run(NULL, alloc_task);
+    printf("%-10s %12s %12.1f %12s  (per alloc+free pair)\n", "alloc", "-",
+           (double)bench_elapsed[0] / (3.0 * ALLOC_ROUNDS), "-");
+
+    bench_run(NULL, pool_task);
+    printf("%-10s %12s %12.1f %12s  (per alloc+free pair, %u used at peak, LIFO masks signals)\n", "pool", "-",
+           (double)bench_elapsed[0] / ALLOC_ROUNDS, "-", (unsigned)bench_pool.peak);
+    printf("%-10s %12s %12.1f %12s  (glibc malloc+free pair, same pattern)\n", "malloc", "-",
+           (double)bench_elapsed[1] / ALLOC_ROUNDS, "-");
+
+    bench_run(NULL, arena_task);
+    printf("%-10s %12s %12.1f %12s  (per control cycle of %u allocs + reset, peak %u bytes)\n", "arena", "-",
+           (double)bench_elapsed[0] / ARENA_CYCLES, "-", ARENA_ALLOCS, (unsigned)bench_arena.peak);
+    printf("%-10s %12s %12.1f %12s  (same cycle with rtos_alloc/rtos_free)\n", "arena/heap", "-",
+           (double)bench_elapsed[1] / ARENA_CYCLES, "-");
+
+    return 0;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,139 @@
+/**
+  ******************************************************************************
+  * @file    ftrace_host.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   函数跟踪主机示例
+  *          在POSIX移植层上跟踪内核和两个工作任务，输出供ftrace_report分析
+  ******************************************************************************
+  * @attention
+  *
+  * 本文件和02_rtos/core.c、time.c以-finstrument-functions编译(见Makefile的
+  * ftrace目标)。两个工作任务各自执行固定次数的计算和延时，读出任务
+  * 每毫秒调用一次ftrace_read把数据块写入文件，工作任务结束后停止调度器。
+  *
+  * 主机上port_cycles为纳秒，调用树中的耗时包含钩子本身和系统调用的开销，
+  * 只用于检查调用关系和相对大小。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "ftrace.h"
+#include <stdio.h>
+
+/* Private define ------------------------------------------------------------*/
+#define DEMO_ITERATIONS         200U
+#define DEMO_WORKERS            2U
+
+/* Private variables ---------------------------------------------------------*/
+static volatile uint32_t demo_sink;
+static volatile uint32_t demo_done;
+static FILE* demo_out;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  叶子函数 - 固定次数的计算
+  * @param  n: 循环次数
+  * @retval None
+  */
+static void __attribute__((noinline)) demo_leaf(uint32_t n)
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++) {
+        demo_sink += i * 2654435761U;
+    }
+}
+
+/**
+  * @brief  一次工作：两次叶子调用，第二次是第一次的一半
+  * @param  n: 第一次的循环次数
+  * @retval None
+  */
+static void __attribute__((noinline)) demo_work(uint32_t n)
+{
+    demo_leaf(n);
+    demo_leaf(n / 2U);
+}
+
+/**
+  * @brief  工作任务
+  * @param  arg: 叶子函数循环次数
+  * @retval None
+  */
+static void demo_worker(void* arg)
+{
+    uint32_t i;
+
+    for (i = 0; i < DEMO_ITERATIONS; i++) {
+        demo_work((uint32_t)(uintptr_t)arg);
+        Delay_us(200);
+    }
+    demo_done++;
+}
+
+/**
+  * @brief  读出全部数据块写入文件
+  * @param  None
+  * @retval None
+  */
+static void FTRACE_NO_INSTRUMENT demo_drain(void)
+{
+    static uint8_t buf[16384];
+    uint32_t len;
+
+    while ((len = ftrace_read(buf, sizeof(buf))) > 0U) {
+        fwrite(buf, 1, len, demo_out);
+    }
+}
+
+/**
+  * @brief  读出任务 - 优先级低于工作任务，工作任务结束后停止调度器
+  * @param  arg: 未使用
+  * @retval None
+  */
+static void FTRACE_NO_INSTRUMENT demo_reader(void* arg)
+{
+    (void)arg;
+    while (demo_done < DEMO_WORKERS) {
+        demo_drain();
+        Delay_ms(1);
+    }
+    demo_drain();
+    port_posix_stop();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int FTRACE_NO_INSTRUMENT main(int argc, char** argv)
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: ftrace_demo trace.bin\n");
+        return 1;
+    }
+    demo_out = fopen(argv[1], "wb");
+    if (demo_out == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    ftrace_init();
+    rtos_init();
+    Time_Init();
+    task_create(demo_worker, (void*)(uintptr_t)20000U, 2);
+    task_create(demo_worker, (void*)(uintptr_t)5000U, 3);
+    task_create(demo_reader, NULL, 10);
+    rtos_start();
+    Time_DeInit();
+
+    fclose(demo_out);
+    printf("wrote %s, %u calls skipped in interrupt context\n", argv[1], (unsigned)ftrace_skipped());
+    return 0;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
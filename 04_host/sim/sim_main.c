@@ -0,0 +1,525 @@
+/**
+  ******************************************************************************
+  * @file    sim_main.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   虚拟时间仿真场景运行器
+  *          读取场景脚本，在port/sim上运行未经修改的内核，输出跟踪和延迟统计
+  ******************************************************************************
+  * @attention
+  *
+  * 用法：rtos_sim [-q] scenario.sim
+  *   -q  不输出逐事件跟踪，只输出统计
+  *
+  * 脚本格式(每行一条，#后为注释，时间单位为微秒，周期按168MHz)：
+  *   limit <us>                           仿真时长上限，省略时运行到全部任务阻塞
+  *   task <name> <prio> [repeat <n>]      开始一个任务块，repeat 0表示无限循环
+  *     run <cycles>                       执行指定周期数，可被中断和抢占
+  *     delay <us>                         Delay_us
+  *     wait <queue> [<timeout_us>]        取走一次通知，没有时阻塞等待
+  *     wake <queue> | wakeall <queue>     通知一次并唤醒队首任务 | 通知全部等待者
+  *     stop                               结束仿真
+  *   end
+  *   irq <name> <prio> at <us> [every <us>] [count <n>] [cost <cycles>]
+  *       [wake <queue> | wakeall <queue>] 脚本中断，处理函数执行cost周期后唤醒
+  *
+  * 统计(单位均为周期)：
+  * - wake   从通知到阻塞的等待任务恢复运行(未阻塞的wait不计入)
+  * - delay  Delay_us实际返回时刻超出请求值的部分
+  * - irq    从计划触发时刻到处理函数开始执行
+  * - perf   每个任务(含idle)的运行周期、异常进出开销、睡眠周期和切入次数，
+  *          来自内核的task_get_perf(以RTOS_PERF_ENABLE=1编译时输出)
+  * p50/p99由02_rtos/hist的对数线性直方图给出，是所在桶的上界(误差不超过6.25%)。
+  * 输出只依赖脚本，可与保存的结果直接diff。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "hist.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define SCRIPT_MAX_TASKS        16
+#define SCRIPT_MAX_OPS          32
+#define SCRIPT_MAX_IRQS         (SIM_MAX_IRQS - SIM_IRQ_USER)
+#define SCRIPT_MAX_QUEUES       8
+#define SCRIPT_NAME_LEN         16
+#define CYCLES_PER_US           (SIM_CPU_HZ / 1000000UL)
+
+/* Private typedef -----------------------------------------------------------*/
+
+typedef enum {
+    OP_RUN = 0,
+    OP_DELAY,
+    OP_WAIT,
+    OP_WAKE,
+    OP_WAKEALL,
+    OP_STOP
+} script_op_kind_t;
+
+typedef struct {
+    uint64_t min;
+    uint64_t max;
+    uint64_t sum;
+    uint32_t count;
+    hist_t hist;                                /* 分位数 */
+} script_stat_t;
+
+typedef struct {
+    char name[SCRIPT_NAME_LEN];
+    wait_queue_t queue;
+    uint32_t count;                             /* 未被取走的通知次数 */
+    uint64_t stamp;                             /* 最近一次通知的时刻 */
+} script_queue_t;
+
+typedef struct {
+    script_op_kind_t kind;
+    script_queue_t* queue;
+    uint32_t value;
+    uint32_t timeout_us;                        /* 0表示无限等待 */
+} script_op_t;
+
+typedef struct {
+    char name[SCRIPT_NAME_LEN];
+    uint32_t priority;
+    uint32_t repeat;
+    script_op_t ops[SCRIPT_MAX_OPS];
+    uint32_t op_count;
+    script_stat_t wake;
+    script_stat_t delay;
+    task_t* tcb;
+} script_task_t;
+
+typedef struct {
+    char name[SCRIPT_NAME_LEN];
+    uint32_t priority;
+    uint64_t due;                               /* 下一次计划触发时刻 */
+    uint64_t every;
+    uint32_t count;
+    uint32_t fired;
+    uint32_t cost;
+    script_op_kind_t wake_kind;
+    script_queue_t* queue;
+    int irq;
+    script_stat_t latency;
+} script_irq_t;
+
+/* Private variables ---------------------------------------------------------*/
+static script_task_t tasks[SCRIPT_MAX_TASKS];
+static script_irq_t irqs[SCRIPT_MAX_IRQS];
+static script_queue_t queues[SCRIPT_MAX_QUEUES];
+static uint32_t task_count;
+static uint32_t irq_count;
+static uint32_t queue_count;
+static uint64_t limit_cycles = SIM_NEVER;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void stat_add(script_stat_t* s, uint64_t value)
+{
+    if (s->count == 0 || value < s->min) {
+        s->min = value;
+    }
+    if (value > s->max) {
+        s->max = value;
+    }
+    s->sum += value;
+    s->count++;
+    hist_record(&s->hist, (value > 0xFFFFFFFFULL) ? 0xFFFFFFFFUL : (uint32_t)value);
+}
+
+static void stat_print(const char* label, const script_stat_t* s)
+{
+    if (s->count == 0) {
+        printf("  %-6s %8s\n", label, "-");
+        return;
+    }
+    printf("  %-6s %8u %10llu %10llu %10u %10u %10llu\n", label, (unsigned)s->count,
+           (unsigned long long)s->min, (unsigned long long)(s->sum / s->count),
+           (unsigned)hist_percentile(&s->hist, 500000), (unsigned)hist_percentile(&s->hist, 990000),
+           (unsigned long long)s->max);
+}
+
+#if RTOS_PERF_ENABLE
+static void perf_print(const char* name, task_t* task)
+{
+    task_perf_t perf;
+
+    task_get_perf(task, &perf);
+    printf("  %-8s %12llu %10llu %12llu %8u\n", name, (unsigned long long)perf.cycles,
+           (unsigned long long)perf.exc, (unsigned long long)perf.sleep, (unsigned)perf.switches);
+}
+#endif
+
+static void trace_line(const char* line)
+{
+    puts(line);
+}
+
+static void die(uint32_t line, const char* msg)
+{
+    fprintf(stderr, "line %u: %s\n", (unsigned)line, msg);
+    exit(1);
+}
+
+/**
+  * @brief  按名称查找或创建等待队列
+  * @param  name: 队列名
+  * @param  line: 脚本行号，用于报错
+  * @retval 队列
+  */
+static script_queue_t* queue_get(const char* name, uint32_t line)
+{
+    uint32_t i;
+
+    for (i = 0; i < queue_count; i++) {
+        if (strcmp(queues[i].name, name) == 0) {
+            return &queues[i];
+        }
+    }
+    if (queue_count >= SCRIPT_MAX_QUEUES) {
+        die(line, "too many queues");
+    }
+    snprintf(queues[queue_count].name, SCRIPT_NAME_LEN, "%s", name);
+    return &queues[queue_count++];
+}
+
+/* 脚本任务 ------------------------------------------------------------------*/
+
+/**
+  * @brief  通知队列 - 先记录通知次数再唤醒，等待者尚未阻塞时通知不会丢失
+  * @param  q: 队列
+  * @param  all: 非0时通知当前全部等待者
+  * @retval None
+  */
+static void script_post(script_queue_t* q, int all)
+{
+    uint32_t primask = rtos_enter_critical();
+    task_t* t;
+
+    q->stamp = sim_now();
+    if (all) {
+        for (t = q->queue.head; t; t = t->wait_next) {
+            q->count++;
+        }
+        task_wake_all(&q->queue);
+    } else {
+        q->count++;
+        task_wake_one(&q->queue);
+    }
+    rtos_exit_critical(primask);
+}
+
+static void script_wait(script_task_t* t, const script_op_t* op)
+{
+    script_queue_t* q = op->queue;
+    uint32_t ticks = op->timeout_us ? (uint32_t)US_TO_TICKS(op->timeout_us) : RTOS_WAIT_FOREVER;
+    uint32_t primask;
+    int blocked = 0;
+
+    sim_trace(t->name, "wait %s", q->name);
+    primask = rtos_enter_critical();
+    if (q->count == 0) {
+        task_wait_timeout(&q->queue, ticks);
+        rtos_exit_critical(primask);    /* 在此切换，被唤醒或超时后返回 */
+        primask = rtos_enter_critical();
+        blocked = 1;
+    }
+    if (q->count > 0) {
+        q->count--;
+        rtos_exit_critical(primask);
+        if (blocked) {
+            stat_add(&t->wake, sim_now() - q->stamp);
+            sim_trace(t->name, "resume %s lat=%llu", q->name,
+                      (unsigned long long)(sim_now() - q->stamp));
+        }
+    } else {
+        rtos_exit_critical(primask);
+        sim_trace(t->name, "timeout %s", q->name);
+    }
+}
+
+static void script_task(void* arg)
+{
+    script_task_t* t = (script_task_t*)arg;
+    const script_op_t* op;
+    uint64_t start;
+    uint32_t iter;
+    uint32_t i;
+
+    for (iter = 0; t->repeat == 0 || iter < t->repeat; iter++) {
+        for (i = 0; i < t->op_count; i++) {
+            op = &t->ops[i];
+            switch (op->kind) {
+            case OP_RUN:
+                sim_run(op->value);
+                break;
+            case OP_DELAY:
+                sim_trace(t->name, "delay %uus", (unsigned)op->value);
+                start = sim_now();
+                Delay_us(op->value);
+                stat_add(&t->delay, sim_now() - start - (uint64_t)op->value * CYCLES_PER_US);
+                break;
+            case OP_WAIT:
+                script_wait(t, op);
+                break;
+            case OP_WAKE:
+            case OP_WAKEALL:
+                sim_trace(t->name, "%s %s", op->kind == OP_WAKE ? "wake" : "wakeall", op->queue->name);
+                script_post(op->queue, op->kind == OP_WAKEALL);
+                break;
+            case OP_STOP:
+                sim_stop();
+                break;
+            }
+        }
+    }
+    sim_trace(t->name, "exit");
+}
+
+/* 脚本中断 ------------------------------------------------------------------*/
+
+static void script_isr(void* arg)
+{
+    script_irq_t* d = (script_irq_t*)arg;
+
+    stat_add(&d->latency, sim_now() - d->due);
+    sim_trace("irq", "%s lat=%llu", d->name, (unsigned long long)(sim_now() - d->due));
+
+    if (d->cost) {
+        sim_run(d->cost);
+    }
+    if (d->queue) {
+        script_post(d->queue, d->wake_kind == OP_WAKEALL);
+    }
+
+    d->fired++;
+    if (d->fired < d->count) {
+        d->due += d->every;
+        sim_irq_schedule(d->irq, d->due);
+    }
+}
+
+/* 脚本解析 ------------------------------------------------------------------*/
+
+static uint32_t parse_u32(const char* s, uint32_t line)
+{
+    char* end;
+    unsigned long v;
+
+    if (s == NULL) {
+        die(line, "missing number");
+    }
+    v = strtoul(s, &end, 0);
+    if (*end != '\0') {
+        die(line, "bad number");
+    }
+    return (uint32_t)v;
+}
+
+static void parse_irq(char** tok, uint32_t n, uint32_t line)
+{
+    script_irq_t* d;
+    uint32_t i;
+
+    if (irq_count >= SCRIPT_MAX_IRQS || n < 5) {
+        die(line, "bad irq");
+    }
+    d = &irqs[irq_count++];
+    snprintf(d->name, SCRIPT_NAME_LEN, "%s", tok[1]);
+    d->priority = parse_u32(tok[2], line);
+    d->count = 1;
+    for (i = 3; i + 1 < n; i += 2) {
+        if (strcmp(tok[i], "at") == 0) {
+            d->due = (uint64_t)parse_u32(tok[i + 1], line) * CYCLES_PER_US;
+        } else if (strcmp(tok[i], "every") == 0) {
+            d->every = (uint64_t)parse_u32(tok[i + 1], line) * CYCLES_PER_US;
+        } else if (strcmp(tok[i], "count") == 0) {
+            d->count = parse_u32(tok[i + 1], line);
+        } else if (strcmp(tok[i], "cost") == 0) {
+            d->cost = parse_u32(tok[i + 1], line);
+        } else if (strcmp(tok[i], "wake") == 0 || strcmp(tok[i], "wakeall") == 0) {
+            d->wake_kind = (tok[i][4] == '\0') ? OP_WAKE : OP_WAKEALL;
+            d->queue = queue_get(tok[i + 1], line);
+        } else {
+            die(line, "unknown irq option");
+        }
+    }
+    if (i != n || d->priority > 15 || (d->count > 1 && d->every == 0)) {
+        die(line, "bad irq");
+    }
+}
+
+static void parse_op(script_task_t* t, char** tok, uint32_t n, uint32_t line)
+{
+    script_op_t* op;
+
+    if (t->op_count >= SCRIPT_MAX_OPS) {
+        die(line, "too many ops");
+    }
+    op = &t->ops[t->op_count++];
+    if (strcmp(tok[0], "run") == 0 && n == 2) {
+        op->kind = OP_RUN;
+        op->value = parse_u32(tok[1], line);
+    } else if (strcmp(tok[0], "delay") == 0 && n == 2) {
+        op->kind = OP_DELAY;
+        op->value = parse_u32(tok[1], line);
+    } else if (strcmp(tok[0], "wait") == 0 && (n == 2 || n == 3)) {
+        op->kind = OP_WAIT;
+        op->queue = queue_get(tok[1], line);
+        op->timeout_us = (n == 3) ? parse_u32(tok[2], line) : 0;
+    } else if (strcmp(tok[0], "wake") == 0 && n == 2) {
+        op->kind = OP_WAKE;
+        op->queue = queue_get(tok[1], line);
+    } else if (strcmp(tok[0], "wakeall") == 0 && n == 2) {
+        op->kind = OP_WAKEALL;
+        op->queue = queue_get(tok[1], line);
+    } else if (strcmp(tok[0], "stop") == 0 && n == 1) {
+        op->kind = OP_STOP;
+    } else {
+        die(line, "unknown op");
+    }
+}
+
+static void parse_script(FILE* f)
+{
+    char buf[256];
+    char* tok[16];
+    char* p;
+    uint32_t n;
+    uint32_t line = 0;
+    script_task_t* cur = NULL;
+
+    while (fgets(buf, sizeof(buf), f)) {
+        line++;
+        if ((p = strchr(buf, '#')) != NULL) {
+            *p = '\0';
+        }
+        n = 0;
+        for (p = strtok(buf, " \t\r\n"); p && n < 16; p = strtok(NULL, " \t\r\n")) {
+            tok[n++] = p;
+        }
+        if (n == 0) {
+            continue;
+        }
+
+        if (cur) {
+            if (strcmp(tok[0], "end") == 0) {
+                cur = NULL;
+            } else {
+                parse_op(cur, tok, n, line);
+            }
+        } else if (strcmp(tok[0], "task") == 0 && (n == 3 || n == 5)) {
+            if (task_count >= SCRIPT_MAX_TASKS) {
+                die(line, "too many tasks");
+            }
+            cur = &tasks[task_count++];
+            snprintf(cur->name, SCRIPT_NAME_LEN, "%s", tok[1]);
+            cur->priority = parse_u32(tok[2], line);
+            cur->repeat = 1;
+            if (n == 5) {
+                if (strcmp(tok[3], "repeat") != 0) {
+                    die(line, "expected repeat");
+                }
+                cur->repeat = parse_u32(tok[4], line);
+            }
+            if (cur->priority >= MAX_PRIORITY) {
+                die(line, "priority must be below the idle task");
+            }
+        } else if (strcmp(tok[0], "irq") == 0) {
+            parse_irq(tok, n, line);
+        } else if (strcmp(tok[0], "limit") == 0 && n == 2) {
+            limit_cycles = (uint64_t)parse_u32(tok[1], line) * CYCLES_PER_US;
+        } else {
+            die(line, "unknown statement");
+        }
+    }
+    if (cur) {
+        die(line, "missing end");
+    }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(int argc, char** argv)
+{
+    FILE* f;
+    task_t* task;
+    uint32_t i;
+    int trace = 1;
+    int arg = 1;
+
+    if (arg < argc && strcmp(argv[arg], "-q") == 0) {
+        trace = 0;
+        arg++;
+    }
+    if (arg + 1 != argc) {
+        fprintf(stderr, "usage: %s [-q] scenario.sim\n", argv[0]);
+        return 2;
+    }
+    f = fopen(argv[arg], "r");
+    if (f == NULL) {
+        perror(argv[arg]);
+        return 1;
+    }
+    parse_script(f);
+    fclose(f);
+
+    sim_reset();
+    sim_set_trace(trace ? trace_line : NULL);
+    rtos_init();
+    Time_Init();
+
+    for (i = 0; i < task_count; i++) {
+        hist_init(&tasks[i].wake.hist);
+        hist_init(&tasks[i].delay.hist);
+        task = task_create(script_task, &tasks[i], tasks[i].priority);
+        if (task == NULL) {
+            fprintf(stderr, "task_create failed for %s\n", tasks[i].name);
+            return 1;
+        }
+        sim_set_task_name(task, tasks[i].name);
+        tasks[i].tcb = task;
+    }
+    for (i = 0; i < irq_count; i++) {
+        hist_init(&irqs[i].latency.hist);
+        irqs[i].irq = sim_irq_register(irqs[i].name, irqs[i].priority, script_isr, &irqs[i]);
+        sim_irq_schedule(irqs[i].irq, irqs[i].due);
+    }
+    sim_set_end(limit_cycles);
+
+    rtos_start();
+    Time_DeInit();
+
+    printf("\nend at %llu cycles\n", (unsigned long long)sim_now());
+    printf("  %-6s %8s %10s %10s %10s %10s %10s\n", "", "n", "min", "avg", "p50", "p99", "max");
+    for (i = 0; i < task_count; i++) {
+        printf("task %s (prio %u)\n", tasks[i].name, (unsigned)tasks[i].priority);
+        stat_print("wake", &tasks[i].wake);
+        stat_print("delay", &tasks[i].delay);
+    }
+    for (i = 0; i < irq_count; i++) {
+        printf("irq %s (prio %u)\n", irqs[i].name, (unsigned)irqs[i].priority);
+        stat_print("lat", &irqs[i].latency);
+    }
+#if RTOS_PERF_ENABLE
+    printf("perf\n  %-8s %12s %10s %12s %8s\n", "", "cycles", "exc", "sleep", "switches");
+    for (i = 0; i < task_count; i++) {
+        perf_print(tasks[i].name, tasks[i].tcb);
+    }
+    for (i = 0; i < scheduler.task_count; i++) {
+        if (scheduler.tasks[i]->priority == MAX_PRIORITY) {
+            perf_print("idle", scheduler.tasks[i]);
+        }
+    }
+#endif
+    return 0;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,139 @@
+/**
+  ******************************************************************************
+  * @file    stm32f4xx.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   主机测试用的STM32F4标准外设库替身
+  *          只声明00_project/User/drv/drv_uart.c和02_rtos/rtt.c用到的类型、常量和函数
+  ******************************************************************************
+  * @attention
+  *
+  * 以-I加入测试的包含路径，drv_uart.h中的#include "stm32f4xx.h"找到本文件
+  * 而不是固件库。外设寄存器不存在，函数由测试程序实现，在port/sim上按
+  * 虚拟时间模拟USART1和DMA2的行为(见test_uart_rx.c)。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __STM32F4xx_H
+#define __STM32F4xx_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported types ------------------------------------------------------------*/
+
+typedef enum { RESET = 0, SET = !RESET } FlagStatus, ITStatus;
+typedef enum { DISABLE = 0, ENABLE = !DISABLE } FunctionalState;
+
+typedef enum {
+    USART1_IRQn = 37,
+    DMA2_Stream2_IRQn = 58,
+    DMA2_Stream7_IRQn = 70
+} IRQn_Type;
+
+/* 外设只以地址区分，寄存器由模型保存 */
+typedef struct {
+    volatile uint32_t DR;
+} USART_TypeDef;
+
+typedef struct {
+    uint32_t id;
+} DMA_Stream_TypeDef;
+
+typedef struct {
+    uint32_t DMA_Channel;
+    uint32_t DMA_PeripheralBaseAddr;
+    uint32_t DMA_Memory0BaseAddr;
+    uint32_t DMA_DIR;
+    uint32_t DMA_BufferSize;
+    uint32_t DMA_PeripheralInc;
+    uint32_t DMA_MemoryInc;
+    uint32_t DMA_PeripheralDataSize;
+    uint32_t DMA_MemoryDataSize;
+    uint32_t DMA_Mode;
+    uint32_t DMA_Priority;
+    uint32_t DMA_FIFOMode;
+    uint32_t DMA_FIFOThreshold;
+    uint32_t DMA_MemoryBurst;
+    uint32_t DMA_PeripheralBurst;
+} DMA_InitTypeDef;
+
+/* Exported constants --------------------------------------------------------*/
+
+extern USART_TypeDef stub_usart1;
+extern DMA_Stream_TypeDef stub_dma2_stream2;
+extern DMA_Stream_TypeDef stub_dma2_stream7;
+
+#define USART1                      (&stub_usart1)
+#define DMA2_Stream2                (&stub_dma2_stream2)
+#define DMA2_Stream7                (&stub_dma2_stream7)
+
+#define RCC_AHB1Periph_DMA2         0x00400000U
+
+#define DMA_Channel_4               0x08000000U
+#define DMA_DIR_PeripheralToMemory  0x00000000U
+#define DMA_DIR_MemoryToPeripheral  0x00000040U
+#define DMA_PeripheralInc_Disable   0x00000000U
+#define DMA_MemoryInc_Enable        0x00000400U
+#define DMA_PeripheralDataSize_Byte 0x00000000U
+#define DMA_MemoryDataSize_Byte     0x00000000U
+#define DMA_Mode_Normal             0x00000000U
+#define DMA_Mode_Circular           0x00000100U
+#define DMA_Priority_Medium         0x00010000U
+#define DMA_Priority_High           0x00020000U
+#define DMA_FIFOMode_Disable        0x00000000U
+#define DMA_FIFOThreshold_Full      0x00000003U
+#define DMA_MemoryBurst_Single      0x00000000U
+#define DMA_PeripheralBurst_Single  0x00000000U
+#define DMA_Memory_0                0x00000000U
+
+#define DMA_IT_TC                   0x00000010U
+#define DMA_IT_HT                   0x00000008U
+#define DMA_IT_HTIF2                0x10100000U
+#define DMA_IT_TCIF2                0x10200000U
+#define DMA_IT_TCIF7                0x28000000U
+#define DMA_FLAG_TCIF7              0x28000000U
+#define DMA_FLAG_HTIF7              0x24000000U
+#define DMA_FLAG_TEIF7              0x22000000U
+#define DMA_FLAG_DMEIF7             0x21000000U
+#define DMA_FLAG_FEIF7              0x20400000U
+
+#define USART_IT_IDLE               0x0424U
+#define USART_FLAG_RXNE             0x0020U
+#define USART_FLAG_TC               0x0040U
+#define USART_DMAReq_Tx             0x0080U
+#define USART_DMAReq_Rx             0x0040U
+
+/* Exported macro ------------------------------------------------------------*/
+#define assert_param(expr)          ((void)(expr))
+#define __DMB()                     __sync_synchronize()
+
+/* Exported functions ------------------------------------------------------- */
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void RCC_AHB1PeriphClockCmd(uint32_t RCC_AHB1Periph, FunctionalState NewState);
+
+void DMA_DeInit(DMA_Stream_TypeDef* DMAy_Streamx);
+void DMA_Init(DMA_Stream_TypeDef* DMAy_Streamx, DMA_InitTypeDef* DMA_InitStruct);
+void DMA_Cmd(DMA_Stream_TypeDef* DMAy_Streamx, FunctionalState NewState);
+FunctionalState DMA_GetCmdStatus(DMA_Stream_TypeDef* DMAy_Streamx);
+void DMA_ITConfig(DMA_Stream_TypeDef* DMAy_Streamx, uint32_t DMA_IT, FunctionalState NewState);
+void DMA_ClearFlag(DMA_Stream_TypeDef* DMAy_Streamx, uint32_t DMA_FLAG);
+void DMA_MemoryTargetConfig(DMA_Stream_TypeDef* DMAy_Streamx, uint32_t MemoryBaseAddr, uint32_t DMA_MemoryTarget);
+void DMA_SetCurrDataCounter(DMA_Stream_TypeDef* DMAy_Streamx, uint16_t Counter);
+uint16_t DMA_GetCurrDataCounter(DMA_Stream_TypeDef* DMAy_Streamx);
+ITStatus DMA_GetITStatus(DMA_Stream_TypeDef* DMAy_Streamx, uint32_t DMA_IT);
+void DMA_ClearITPendingBit(DMA_Stream_TypeDef* DMAy_Streamx, uint32_t DMA_IT);
+
+void USART_ITConfig(USART_TypeDef* USARTx, uint16_t USART_IT, FunctionalState NewState);
+void USART_DMACmd(USART_TypeDef* USARTx, uint16_t USART_DMAReq, FunctionalState NewState);
+ITStatus USART_GetITStatus(USART_TypeDef* USARTx, uint16_t USART_IT);
+FlagStatus USART_GetFlagStatus(USART_TypeDef* USARTx, uint16_t USART_FLAG);
+uint16_t USART_ReceiveData(USART_TypeDef* USARTx);
+
+#endif /* __STM32F4xx_H */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    test.h
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   主机端测试的检查宏
+  ******************************************************************************
+  * @attention
+  *
+  * 每个测试是一个独立程序，由make test逐个运行。TEST_CHECK失败时输出位置
+  * 和说明并计数，不中止程序；main以test_result()的返回值退出，非0即失败。
+  * 只在测试程序中包含，一个程序只包含一次。
+  *
+  ******************************************************************************
+  */
+
+#ifndef __TEST_H__
+#define __TEST_H__
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+
+/* Private variables ---------------------------------------------------------*/
+static unsigned test_checks;
+static unsigned test_failures;
+
+/* Exported macro ------------------------------------------------------------*/
+
+/* 检查条件，失败时输出文件、行号和printf格式的说明 */
+#define TEST_CHECK(cond, ...)                                                   \
+    do {                                                                        \
+        test_checks++;                                                          \
+        if (!(cond)) {                                                          \
+            test_failures++;                                                    \
+            printf("%s:%d: FAIL: ", __FILE__, __LINE__);                        \
+            printf(__VA_ARGS__);                                                \
+            printf("\n");                                                       \
+        }                                                                       \
+    } while (0)
+
+/* Exported functions ------------------------------------------------------- */
+
+/**
+  * @brief  输出测试结论
+  * @param  name: 测试名称
+  * @retval 全部通过返回0，否则返回1
+  */
+static inline int test_result(const char* name)
+{
+    printf("%-12s %s (%u checks, %u failed)\n", name,
+           (test_failures == 0U) ? "ok" : "FAIL", test_checks, test_failures);
+    return (test_failures == 0U) ? 0 : 1;
+}
+
+#endif /* __TEST_H__ */
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,138 @@
+/**
+  ******************************************************************************
+  * @file    test_delay.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   延时链表测试 - 分段延时和TIM2计数器回绕
+  ******************************************************************************
+  * @attention
+  *
+  * 在port/sim上以虚拟时间检查：
+  * - 超过DELAY_MAX_CHUNK_TICKS的Delay_ms/Delay_us/Delay_ticks分段完成，
+  *   总时长不短于请求，超出量只有中断和切换的开销
+  * - Delay_ms超过DELAY_MAX_MS时截断
+  * - 在32位计数器回绕前登记、回绕后到期的多个延时按到期先后唤醒，
+  *   各自的唤醒时刻正确
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "test.h"
+#include <stdint.h>
+
+/* Private define ------------------------------------------------------------*/
+#define CYCLES_PER_TIM2_TICK    ((uint64_t)SIM_CYCLES_PER_TICK)
+#define MAX_OVERSHOOT_CYCLES    400U        /* 每段延时的中断进出和切换开销上限 */
+#define WRAP_LEAD_TICKS         1000U       /* 回绕测试在回绕前多少个计数开始 */
+#define WRAP_SLEEPERS           4
+
+/* Private variables ---------------------------------------------------------*/
+static const uint32_t wrap_delays[WRAP_SLEEPERS] = { 3000U, 500U, 1500U, 1001U };
+
+static uint64_t wrap_slept[WRAP_SLEEPERS];
+static uint64_t wrap_woke[WRAP_SLEEPERS];
+static int wrap_order[WRAP_SLEEPERS];
+static int wrap_count;
+static int done;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* 检查一次延时的实际时长，chunks为分段数 */
+static void check_elapsed(const char* what, uint64_t start, uint64_t want_ticks, uint32_t chunks)
+{
+    uint64_t elapsed = sim_now() - start;
+    uint64_t want = want_ticks * CYCLES_PER_TIM2_TICK;
+
+    TEST_CHECK(elapsed >= want && elapsed - want <= (uint64_t)MAX_OVERSHOOT_CYCLES * chunks,
+               "%s: %llu cycles, want %llu (+%u)", what, (unsigned long long)elapsed,
+               (unsigned long long)want, MAX_OVERSHOOT_CYCLES * chunks);
+}
+
+static void wrap_sleeper(void* arg)
+{
+    int i = (int)(intptr_t)arg;
+
+    wrap_slept[i] = sim_now();
+    Delay_ticks(wrap_delays[i]);
+    wrap_woke[i] = sim_now();
+    wrap_order[wrap_count++] = i;
+}
+
+static void driver(void* arg)
+{
+    uint64_t start;
+    uint32_t now;
+    task_t* task;
+    int i;
+
+    (void)arg;
+
+    /* 60s = 5.04e9个计数：三段，跨过一次32位回绕 */
+    start = sim_now();
+    Delay_ms(60000U);
+    check_elapsed("Delay_ms(60000)", start, 60000ULL * TIM2_TICKS_PER_MS, 3U);
+
+    start = sim_now();
+    Delay_us(4000000000U);
+    check_elapsed("Delay_us(4e9)", start, 4000000000ULL * TIM2_TICKS_PER_US, 157U);
+
+    start = sim_now();
+    Delay_ticks(0xFFFFFFFFU);
+    check_elapsed("Delay_ticks(2^32-1)", start, 0xFFFFFFFFULL, 3U);
+
+    start = sim_now();
+    Delay_ticks(DELAY_MAX_CHUNK_TICKS);
+    check_elapsed("Delay_ticks(max chunk)", start, DELAY_MAX_CHUNK_TICKS, 1U);
+
+    start = sim_now();
+    Delay_ms(0xFFFFFFFFU);
+    check_elapsed("Delay_ms clamp", start, (uint64_t)DELAY_MAX_MS * TIM2_TICKS_PER_MS, 169U);
+
+    /* 睡到回绕前WRAP_LEAD_TICKS，再让几个任务登记跨越回绕的延时 */
+    now = port_timer_now();
+    Delay_ticks(0U - WRAP_LEAD_TICKS - now);
+    now = port_timer_now();
+    TEST_CHECK((uint32_t)(0U - now) <= WRAP_LEAD_TICKS && (uint32_t)(0U - now) > WRAP_LEAD_TICKS / 2U,
+               "counter %lu before the wrap test", (unsigned long)now);
+
+    for (i = 0; i < WRAP_SLEEPERS; i++) {
+        task = task_create(wrap_sleeper, (void*)(intptr_t)i, 1);
+        TEST_CHECK(task != NULL, "task_create %d", i);
+    }
+    Delay_ticks(5000U);
+    TEST_CHECK(port_timer_now() < 5000U, "counter %lu after the wrap", (unsigned long)port_timer_now());
+
+    TEST_CHECK(wrap_count == WRAP_SLEEPERS, "%d of %d sleepers woke", wrap_count, WRAP_SLEEPERS);
+    TEST_CHECK(wrap_order[0] == 1 && wrap_order[1] == 3 && wrap_order[2] == 2 && wrap_order[3] == 0,
+               "wake order %d %d %d %d", wrap_order[0], wrap_order[1], wrap_order[2], wrap_order[3]);
+    for (i = 0; i < WRAP_SLEEPERS; i++) {
+        uint64_t want = wrap_slept[i] + wrap_delays[i] * CYCLES_PER_TIM2_TICK;
+
+        TEST_CHECK(wrap_woke[i] >= want && wrap_woke[i] - want <= MAX_OVERSHOOT_CYCLES,
+                   "sleeper %d woke at %llu, want %llu", i,
+                   (unsigned long long)wrap_woke[i], (unsigned long long)want);
+    }
+
+    done = 1;
+    sim_stop();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    sim_reset();
+    rtos_init();
+    Time_Init();
+    sim_set_task_name(task_create(driver, NULL, 2), "driver");
+    rtos_start();
+
+    TEST_CHECK(done, "driver did not finish, stopped at %llu cycles", (unsigned long long)sim_now());
+    return test_result("delay");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
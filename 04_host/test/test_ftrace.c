@@ -0,0 +1,203 @@
+/**
+  ******************************************************************************
+  * @file    test_ftrace.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   函数跟踪测试 - 每任务环形缓冲区和切出时间的扣除
+  ******************************************************************************
+  * @attention
+  *
+  * 内核以FTRACE_ENABLE=1在port/sim上编译，只有本文件中的outer/inner/
+  * other_work/isr_work以-finstrument-functions跟踪，其余函数标记
+  * FTRACE_NO_INSTRUMENT。以虚拟周期检查：
+  * - 每个任务的记录写入各自的缓冲区，进入和返回成对、顺序正确
+  * - 函数内延时期间被切出的时间不计入，期间其他任务的执行记在其他任务名下
+  * - 任务执行期间发生的中断计入任务时间，中断中调用的被跟踪函数不记录、
+  *   只计数
+  *
+  * 记录中的地址为32位，程序以-no-pie链接。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "ftrace.h"
+#include "test.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define SLACK_CYCLES            200U        /* 切换路径中仍计入任务的部分 */
+#define OUTER_HEAD              1000U
+#define OUTER_TAIL              500U
+#define INNER_HEAD              2000U
+#define INNER_TAIL              300U
+#define INNER_SLEEP_TICKS       5000U
+#define OTHER_RUN               4000U
+#define ISR_RUN                 200U
+#define ISR_OVERHEAD            (SIM_IRQ_ENTRY_CYCLES + SIM_IRQ_EXIT_CYCLES)
+#define MAX_RECORDS             16
+
+/* Private types -------------------------------------------------------------*/
+
+/* 一个任务的记录，delta已还原为累计周期 */
+typedef struct {
+    uint32_t func;
+    uint32_t count;
+    uint32_t addr[MAX_RECORDS];
+    uint32_t exit[MAX_RECORDS];
+    uint64_t at[MAX_RECORDS];
+} task_records_t;
+
+/* Private variables ---------------------------------------------------------*/
+static int irq_traced;
+static int done;
+static uint8_t read_buf[4096];
+
+/* Private functions ---------------------------------------------------------*/
+
+static void __attribute__((noinline)) isr_work(void)
+{
+    sim_run(ISR_RUN);
+}
+
+static void __attribute__((noinline)) inner(void)
+{
+    sim_run(INNER_HEAD);
+    Delay_ticks(INNER_SLEEP_TICKS);
+    sim_run(INNER_TAIL);
+}
+
+static void __attribute__((noinline)) outer(void)
+{
+    sim_irq_schedule(irq_traced, sim_now() + OUTER_HEAD / 2U);
+    sim_run(OUTER_HEAD);
+    inner();
+    sim_run(OUTER_TAIL);
+}
+
+static void __attribute__((noinline)) other_work(void)
+{
+    sim_run(OTHER_RUN);
+}
+
+static void FTRACE_NO_INSTRUMENT traced_isr(void* arg)
+{
+    (void)arg;
+    isr_work();
+}
+
+static void FTRACE_NO_INSTRUMENT worker(void* arg)
+{
+    (void)arg;
+    outer();
+}
+
+static void FTRACE_NO_INSTRUMENT other(void* arg)
+{
+    (void)arg;
+    other_work();
+}
+
+/* 取出全部数据块，按任务入口函数分拣 */
+static void FTRACE_NO_INSTRUMENT collect(task_records_t* recs, int n)
+{
+    uint32_t len, pos, i;
+    ftrace_block_t hdr;
+    ftrace_record_t rec;
+    task_records_t* t;
+    int k;
+
+    while ((len = ftrace_read(read_buf, sizeof(read_buf))) > 0U) {
+        for (pos = 0; pos < len; ) {
+            memcpy(&hdr, &read_buf[pos], sizeof(hdr));
+            pos += (uint32_t)sizeof(hdr);
+            TEST_CHECK(hdr.magic == FTRACE_BLOCK_MAGIC && hdr.dropped == 0U, "bad block header");
+            t = NULL;
+            for (k = 0; k < n; k++) {
+                if (recs[k].func == hdr.func) {
+                    t = &recs[k];
+                }
+            }
+            for (i = 0; i < hdr.count; i++, pos += (uint32_t)sizeof(rec)) {
+                memcpy(&rec, &read_buf[pos], sizeof(rec));
+                if (t != NULL && t->count < MAX_RECORDS) {
+                    t->addr[t->count] = rec.addr;
+                    t->exit[t->count] = rec.delta_kind & FTRACE_EXIT;
+                    t->at[t->count] = ((t->count > 0U) ? t->at[t->count - 1U] : 0U) + (rec.delta_kind >> 1);
+                    t->count++;
+                }
+            }
+        }
+    }
+}
+
+static void FTRACE_NO_INSTRUMENT check_span(const char* what, uint64_t span, uint64_t want)
+{
+    TEST_CHECK(span >= want && span - want <= SLACK_CYCLES, "%s: %llu cycles, want %llu",
+               what, (unsigned long long)span, (unsigned long long)want);
+}
+
+static void FTRACE_NO_INSTRUMENT driver(void* arg)
+{
+    task_records_t recs[2];
+    const task_records_t* w = &recs[0];
+    const task_records_t* o = &recs[1];
+
+    (void)arg;
+    memset(recs, 0, sizeof(recs));
+    recs[0].func = (uint32_t)(uintptr_t)worker;
+    recs[1].func = (uint32_t)(uintptr_t)other;
+
+    (void)task_create(worker, NULL, 2);
+    (void)task_create(other, NULL, 3);
+    Delay_ticks(20000U);
+    collect(recs, 2);
+
+    /* worker: outer进入、inner进入、inner返回、outer返回 */
+    TEST_CHECK(w->count == 4U, "worker has %lu records", (unsigned long)w->count);
+    if (w->count == 4U) {
+        TEST_CHECK(w->addr[0] == (uint32_t)(uintptr_t)outer && !w->exit[0] &&
+                   w->addr[1] == (uint32_t)(uintptr_t)inner && !w->exit[1] &&
+                   w->addr[2] == (uint32_t)(uintptr_t)inner && w->exit[2] &&
+                   w->addr[3] == (uint32_t)(uintptr_t)outer && w->exit[3], "worker records out of order");
+        check_span("outer before inner (with the interrupt)", w->at[1] - w->at[0],
+                   OUTER_HEAD + ISR_RUN + ISR_OVERHEAD);
+        check_span("inner without the time switched out", w->at[2] - w->at[1], INNER_HEAD + INNER_TAIL);
+        check_span("outer after inner", w->at[3] - w->at[2], OUTER_TAIL);
+    }
+
+    /* other在worker延时期间运行，记录在自己的缓冲区 */
+    TEST_CHECK(o->count == 2U, "other has %lu records", (unsigned long)o->count);
+    if (o->count == 2U) {
+        TEST_CHECK(o->addr[0] == (uint32_t)(uintptr_t)other_work && o->exit[1], "other records");
+        check_span("other_work", o->at[1] - o->at[0], OTHER_RUN);
+    }
+
+    TEST_CHECK(ftrace_skipped() == 2U, "%lu calls skipped in interrupts, want 2",
+               (unsigned long)ftrace_skipped());
+
+    done = 1;
+    sim_stop();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int FTRACE_NO_INSTRUMENT main(void)
+{
+    sim_reset();
+    ftrace_init();
+    rtos_init();
+    Time_Init();
+    irq_traced = sim_irq_register("traced", 5, traced_isr, NULL);
+    sim_set_task_name(task_create(driver, NULL, 1), "driver");
+    rtos_start();
+
+    TEST_CHECK(done, "driver did not finish, stopped at %llu cycles", (unsigned long long)sim_now());
+    return test_result("ftrace");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
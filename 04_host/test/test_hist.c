@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file    test_hist.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   对数线性直方图精度测试
+  ******************************************************************************
+  * @attention
+  *
+  * 以几种已知分布的样本调用hist_record，与排序后的精确分位数比较。精确
+  * 分位数取第ceil(N*p)个样本(与hist_percentile的目标计数相同)，hist.h约定：
+  * - 结果不小于精确值，且不超过max
+  * - 小于2^(HIST_SUB_BITS+1)的值结果精确
+  * - 其余值的误差小于一个桶宽，即小于精确值的2^-HIST_SUB_BITS
+  * - 不小于2^HIST_MAX_BITS的值只保证不小于精确值
+  * 另检查hist_mean、hist_merge和序列化往返不改变结果。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "hist.h"
+#include "test.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define SAMPLES                 100000U
+#define SMALL_LIMIT             (1UL << (HIST_SUB_BITS + 1))
+#define OVERFLOW_LIMIT          (1UL << HIST_MAX_BITS)
+
+/* Private types -------------------------------------------------------------*/
+typedef uint32_t (*dist_fn)(void);
+
+/* Private variables ---------------------------------------------------------*/
+static uint64_t rng_state = 0x2545F4914F6CDD1DULL;
+static uint32_t samples[SAMPLES];
+static uint32_t sorted[SAMPLES];
+static hist_t h, half1, half2, merged, restored;
+static uint8_t serial[HIST_SERIAL_MAX];
+
+static const uint32_t ppms[] = { 0U, 1U, 10000U, 100000U, 250000U, 500000U, 750000U, 900000U,
+                                 990000U, 999000U, 999900U, 999990U, 1000000U };
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double rng_unit(void)
+{
+    return (double)(rng_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static uint32_t dist_uniform(void)      { return (uint32_t)(rng_next() % (1UL << 20)); }
+static uint32_t dist_small(void)        { return (uint32_t)(rng_next() % SMALL_LIMIT); }
+static uint32_t dist_constant(void)     { return 1234567U; }
+static uint32_t dist_exponential(void)  { return (uint32_t)(-5000.0 * log(1.0 - rng_unit())); }
+static uint32_t dist_log_uniform(void)  { return (uint32_t)exp2(rng_unit() * (HIST_MAX_BITS - 0.001)); }
+
+/* 90%在200附近，10%在50000附近：尾部分位数落在稀疏区 */
+static uint32_t dist_bimodal(void)
+{
+    return ((rng_next() % 10U) == 0U) ? 50000U + (uint32_t)(rng_next() % 5000U)
+                                      : 180U + (uint32_t)(rng_next() % 40U);
+}
+
+/* 1%超出可区分范围 */
+static uint32_t dist_overflow(void)
+{
+    return ((rng_next() % 100U) == 0U) ? OVERFLOW_LIMIT + (uint32_t)(rng_next() % 1000000U)
+                                       : (uint32_t)(rng_next() % 100000U);
+}
+
+static int cmp_u32(const void* a, const void* b)
+{
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+
+    return (x > y) - (x < y);
+}
+
+static void check_distribution(const char* name, dist_fn dist)
+{
+    uint64_t sum = 0, target;
+    uint32_t i, got, exact, len;
+
+    hist_init(&h);
+    hist_init(&half1);
+    hist_init(&half2);
+    for (i = 0; i < SAMPLES; i++) {
+        samples[i] = dist();
+        sum += samples[i];
+        hist_record(&h, samples[i]);
+        hist_record((i & 1U) ? &half1 : &half2, samples[i]);
+    }
+    memcpy(sorted, samples, sizeof(sorted));
+    qsort(sorted, SAMPLES, sizeof(sorted[0]), cmp_u32);
+
+    TEST_CHECK(h.count == SAMPLES && h.min == sorted[0] && h.max == sorted[SAMPLES - 1U],
+               "%s: count/min/max", name);
+    TEST_CHECK(hist_mean(&h) == (uint32_t)(sum / SAMPLES), "%s: mean %lu, want %lu", name,
+               (unsigned long)hist_mean(&h), (unsigned long)(sum / SAMPLES));
+
+    hist_init(&merged);
+    hist_merge(&merged, &half1);
+    hist_merge(&merged, &half2);
+    len = hist_serialize(&h, serial, sizeof(serial));
+    TEST_CHECK(len > 0U && hist_deserialize(&restored, serial, len) == 0, "%s: serialize", name);
+
+    for (i = 0; i < sizeof(ppms) / sizeof(ppms[0]); i++) {
+        target = ((uint64_t)SAMPLES * ppms[i] + 999999U) / 1000000U;
+        if (target == 0U) {
+            target = 1;
+        }
+        exact = sorted[target - 1U];
+        got = hist_percentile(&h, ppms[i]);
+
+        TEST_CHECK(got >= exact && got <= h.max, "%s p%lu: %lu below exact %lu", name,
+                   (unsigned long)ppms[i], (unsigned long)got, (unsigned long)exact);
+        if (exact < SMALL_LIMIT) {
+            TEST_CHECK(got == exact, "%s p%lu: %lu, exact %lu", name,
+                       (unsigned long)ppms[i], (unsigned long)got, (unsigned long)exact);
+        } else if (exact < OVERFLOW_LIMIT) {
+            TEST_CHECK(got - exact < (exact >> HIST_SUB_BITS), "%s p%lu: %lu, exact %lu (error %.2f%%)",
+                       name, (unsigned long)ppms[i], (unsigned long)got, (unsigned long)exact,
+                       100.0 * (got - exact) / exact);
+        }
+        TEST_CHECK(hist_percentile(&merged, ppms[i]) == got && hist_percentile(&restored, ppms[i]) == got,
+                   "%s p%lu: merged or deserialized histogram differs", name, (unsigned long)ppms[i]);
+    }
+    TEST_CHECK(hist_percentile(&h, 1000000U) == h.max, "%s: p100 is not max", name);
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    uint32_t v;
+
+    /* 桶边界：每个值落在自己桶的[low, high]内，相邻桶首尾相接 */
+    for (v = 0; v < OVERFLOW_LIMIT; v += 1U + (v >> 8)) {
+        uint32_t i = hist_bucket_index(v);
+
+        TEST_CHECK(hist_bucket_low(i) <= v && v <= hist_bucket_high(i), "value %lu outside bucket %lu",
+                   (unsigned long)v, (unsigned long)i);
+        if (i > 0U && hist_bucket_low(i) != hist_bucket_high(i - 1U) + 1U) {
+            TEST_CHECK(0, "gap before bucket %lu", (unsigned long)i);
+        }
+    }
+
+    check_distribution("uniform", dist_uniform);
+    check_distribution("small", dist_small);
+    check_distribution("constant", dist_constant);
+    check_distribution("exponential", dist_exponential);
+    check_distribution("log-uniform", dist_log_uniform);
+    check_distribution("bimodal", dist_bimodal);
+    check_distribution("overflow", dist_overflow);
+
+    return test_result("hist");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
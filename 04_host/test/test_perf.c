@@ -0,0 +1,141 @@
+/**
+  ******************************************************************************
+  * @file    test_perf.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   每任务性能计数测试
+  ******************************************************************************
+  * @attention
+  *
+  * 在port/sim上(RTOS_PERF_ENABLE=1)以已知的执行周期检查：
+  * - 每个任务的cycles等于其sim_run之和加上归入它的切换和异常开销
+  * - 全部任务的cycles之和等于经过的虚拟时间，没有遗漏和重复
+  * - 睡眠周期只归入空闲任务，switches为被切入的次数
+  * - rtos_perf_reset清零全部任务
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "test.h"
+#include <stdint.h>
+
+/* Private define ------------------------------------------------------------*/
+#define SLACK_CYCLES            400U        /* 切换和异常开销上限 */
+#define A_RUN1                  10000U
+#define A_RUN2                  3000U
+#define A_SLEEP_TICKS           5000U
+#define B_RUN                   7000U
+#define WINDOW_TICKS            30000U
+
+/* Private variables ---------------------------------------------------------*/
+static wait_queue_t parking;
+static int done;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void park(void)
+{
+    uint32_t primask = rtos_enter_critical();
+
+    (void)task_wait(&parking);
+    rtos_exit_critical(primask);
+}
+
+static void worker_a(void* arg)
+{
+    (void)arg;
+    sim_run(A_RUN1);
+    Delay_ticks(A_SLEEP_TICKS);
+    sim_run(A_RUN2);
+    park();
+}
+
+static void worker_b(void* arg)
+{
+    (void)arg;
+    sim_run(B_RUN);
+    park();
+}
+
+static void check_cycles(const char* who, const task_perf_t* perf, uint64_t want)
+{
+    TEST_CHECK(perf->cycles >= want && perf->cycles - want <= SLACK_CYCLES,
+               "%s: %llu cycles, want %llu", who, (unsigned long long)perf->cycles,
+               (unsigned long long)want);
+}
+
+static void driver(void* arg)
+{
+    task_t* a;
+    task_t* b;
+    task_t* idle = NULL;
+    task_perf_t pa, pb, pi, p;
+    uint64_t start;
+    uint64_t sum = 0;
+    uint8_t i;
+
+    (void)arg;
+
+    rtos_perf_reset();
+    start = sim_now();
+    a = task_create(worker_a, NULL, 2);
+    b = task_create(worker_b, NULL, 3);
+    Delay_ticks(WINDOW_TICKS);
+
+    for (i = 0; i < scheduler.task_count; i++) {
+        task_get_perf(scheduler.tasks[i], &p);
+        sum += p.cycles;
+        if (scheduler.tasks[i]->priority == MAX_PRIORITY) {
+            idle = scheduler.tasks[i];
+        }
+    }
+    TEST_CHECK(sum == sim_now() - start, "tasks account for %llu of %llu cycles",
+               (unsigned long long)sum, (unsigned long long)(sim_now() - start));
+
+    task_get_perf(a, &pa);
+    task_get_perf(b, &pb);
+    check_cycles("worker_a", &pa, A_RUN1 + A_RUN2);
+    check_cycles("worker_b", &pb, B_RUN);
+    TEST_CHECK(pa.switches == 2U && pb.switches == 1U, "switches a %lu b %lu",
+               (unsigned long)pa.switches, (unsigned long)pb.switches);
+    TEST_CHECK(pa.sleep == 0U && pb.sleep == 0U, "sleep charged to a worker");
+
+    TEST_CHECK(idle != NULL, "no idle task");
+    if (idle != NULL) {
+        task_get_perf(idle, &pi);
+        TEST_CHECK(pi.sleep > 0U && pi.sleep <= pi.cycles, "idle sleep %llu of %llu cycles",
+                   (unsigned long long)pi.sleep, (unsigned long long)pi.cycles);
+    }
+
+    rtos_perf_reset();
+    for (i = 0; i < scheduler.task_count; i++) {
+        if (scheduler.tasks[i] != scheduler.current_task) {
+            task_get_perf(scheduler.tasks[i], &p);
+            TEST_CHECK(p.cycles == 0U && p.sleep == 0U && p.switches == 0U,
+                       "task %u not cleared by rtos_perf_reset", i);
+        }
+    }
+
+    done = 1;
+    sim_stop();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    sim_reset();
+    rtos_init();
+    Time_Init();
+    sim_set_task_name(task_create(driver, NULL, 1), "driver");
+    rtos_start();
+
+    TEST_CHECK(done, "driver did not finish, stopped at %llu cycles", (unsigned long long)sim_now());
+    return test_result("perf");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,219 @@
+/**
+  ******************************************************************************
+  * @file    test_printf.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   rtos_snprintf与glibc snprintf逐字节对比
+  ******************************************************************************
+  * @attention
+  *
+  * 覆盖rtos_printf.h列出的全部转换：整数转换遍历标志、宽度、精度和长度
+  * 修饰的组合；%f除固定用例外，以随机二进制值和"十进制中点"值(如1.115、
+  * 2.675，其二进制值略大或略小于中点)在精度0~9下对比。每次对比同时检查
+  * 返回值和缓冲区不足时的截断结果。
+  *
+  * 不对比的部分：%p(glibc对NULL输出"(nil)")、精度大于9和|x| >= 2^64的%f
+  * (rtos_printf分别截到9位和输出"ovf")。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "rtos_printf.h"
+#include "test.h"
+#include <limits.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define OUT_SIZE        256
+#define TRUNC_SIZE      5           /* 截断检查用的缓冲区大小 */
+#define RANDOM_VALUES   200000U
+#define MAX_REPORTS     20U         /* 最多输出的差异条数 */
+
+/* Private variables ---------------------------------------------------------*/
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static unsigned compared;
+static unsigned reported;
+
+static const char* const flag_sets[] = { "", "-", "+", " ", "#", "0", "-+", "+0", " #", "#0", "-#0+ " };
+static const char* const widths[] = { "", "1", "6", "12" };
+static const char* const precs[] = { "", ".", ".0", ".1", ".5", ".12" };
+
+/* Private functions ---------------------------------------------------------*/
+
+static uint64_t rng_next(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+/* 以同一组参数调用两者，对比返回值、完整输出和截断输出 */
+static void compare(const char* fmt, ...)
+{
+    char want[OUT_SIZE];
+    char got[OUT_SIZE];
+    char want_trunc[TRUNC_SIZE];
+    char got_trunc[TRUNC_SIZE];
+    va_list ap, aq;
+    int want_len, got_len;
+
+    va_start(ap, fmt);
+    va_copy(aq, ap);
+    want_len = vsnprintf(want, sizeof(want), fmt, aq);
+    va_end(aq);
+    va_copy(aq, ap);
+    got_len = rtos_vsnprintf(got, sizeof(got), fmt, aq);
+    va_end(aq);
+    va_copy(aq, ap);
+    (void)vsnprintf(want_trunc, sizeof(want_trunc), fmt, aq);
+    va_end(aq);
+    va_copy(aq, ap);
+    (void)rtos_vsnprintf(got_trunc, sizeof(got_trunc), fmt, aq);
+    va_end(aq);
+    va_end(ap);
+
+    compared++;
+    if (want_len != got_len || strcmp(want, got) != 0 || strcmp(want_trunc, got_trunc) != 0) {
+        test_failures++;
+        if (reported++ < MAX_REPORTS) {
+            printf("FAIL: \"%s\": glibc \"%s\" (%d), rtos \"%s\" (%d)\n",
+                   fmt, want, want_len, got, got_len);
+        }
+    }
+}
+
+static void test_integers(void)
+{
+    static const char* const convs[] = { "d", "i", "u", "x", "X", "o" };
+    static const long long values[] = { 0, 1, -1, 7, -42, 255, 4096, 123456789,
+                                        INT_MAX, INT_MIN, LLONG_MAX, LLONG_MIN };
+    char fmt[32];
+    size_t f, w, p, c, v;
+
+    for (f = 0; f < sizeof(flag_sets) / sizeof(flag_sets[0]); f++) {
+        for (w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+            for (p = 0; p < sizeof(precs) / sizeof(precs[0]); p++) {
+                for (c = 0; c < sizeof(convs) / sizeof(convs[0]); c++) {
+                    for (v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+                        snprintf(fmt, sizeof(fmt), "[%%%s%s%s%s]", flag_sets[f], widths[w], precs[p], convs[c]);
+                        compare(fmt, (int)values[v]);
+                        snprintf(fmt, sizeof(fmt), "[%%%s%s%sll%s]", flag_sets[f], widths[w], precs[p], convs[c]);
+                        compare(fmt, values[v]);
+                        snprintf(fmt, sizeof(fmt), "[%%%s%s%shh%s]", flag_sets[f], widths[w], precs[p], convs[c]);
+                        compare(fmt, (int)values[v]);
+                        snprintf(fmt, sizeof(fmt), "[%%%s%s%sh%s]", flag_sets[f], widths[w], precs[p], convs[c]);
+                        compare(fmt, (int)values[v]);
+                    }
+                }
+            }
+        }
+    }
+
+    compare("%lu %ld %zu %zd %ju %jd %td", ULONG_MAX, LONG_MIN, (size_t)SIZE_MAX, (ssize_t)-5,
+            (uintmax_t)UINT64_MAX, (intmax_t)INT64_MIN, (ptrdiff_t)-3);
+    compare("%*d|%-*d|%.*d|%*.*x", 8, 42, 8, 42, 5, 42, -6, 3, 0xabU);
+    compare("%.*d", -1, 7);
+}
+
+static void test_strings(void)
+{
+    compare("%s|%10s|%-10s|%.3s|%10.2s|%-6.0s|", "hello", "hi", "hi", "hello", "hello", "x");
+    compare("%c%c|%3c|%-3c|", 'a', 'Z', 'q', 'r');
+    compare("100%% %s", "");
+    compare("plain text only");
+}
+
+static void test_float_fixed(void)
+{
+    static const double values[] = {
+        0.0, -0.0, 1.0, -1.0, 0.5, 1.5, 2.5, -2.5, 0.125, 0.375, 1.115, 2.675, 1.005,
+        0.045, 1.0005, 3.14159265358979, 9.5, 99.995, 0.9999999995, 9.9999999995,
+        1e-10, 5e-10, 123456789.123456789, 4503599627370495.5, 9007199254740993.0,
+        18446744073709549568.0, 1e15 + 0.3, 0.1, 0.2, 0.3, 0.7, 1.0 / 3.0, 2.0 / 3.0
+    };
+    char fmt[32];
+    size_t f, w, v;
+    int p;
+
+    for (f = 0; f < sizeof(flag_sets) / sizeof(flag_sets[0]); f++) {
+        for (w = 0; w < sizeof(widths) / sizeof(widths[0]); w++) {
+            for (v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+                snprintf(fmt, sizeof(fmt), "[%%%s%sf]", flag_sets[f], widths[w]);
+                compare(fmt, values[v]);
+                snprintf(fmt, sizeof(fmt), "[%%%s%sF]", flag_sets[f], widths[w]);
+                compare(fmt, -values[v]);
+                for (p = 0; p <= 9; p++) {
+                    snprintf(fmt, sizeof(fmt), "[%%%s%s.%df]", flag_sets[f], widths[w], p);
+                    compare(fmt, values[v]);
+                    compare(fmt, -values[v]);
+                }
+            }
+        }
+    }
+
+    compare("%f %F %5f %-6f| %+f", (double)NAN, (double)-NAN, (double)INFINITY, (double)-INFINITY, (double)INFINITY);
+    compare("%.*f", 2, 1.115);
+}
+
+/* 随机二进制值：53位尾数，指数使值落在[2^-40, 2^64) */
+static double random_binary(void)
+{
+    uint64_t mant = (rng_next() >> 11) | (1ULL << 52);
+    int exp = (int)(rng_next() % 104U) - 92;
+
+    return ldexp((double)mant, exp);
+}
+
+/* 十进制中点：n + k/10^digits，最后一位为5，按prec = digits - 1输出 */
+static double random_midpoint(int digits)
+{
+    static const double scale[] = { 1.0, 10.0, 100.0, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10 };
+    uint64_t whole = rng_next() % ((rng_next() & 1U) != 0U ? 100U : 10000000U);
+    uint64_t k = (rng_next() % (uint64_t)scale[digits - 1]) * 10U + 5U;
+
+    return (double)whole + (double)k / scale[digits];
+}
+
+static void test_float_random(void)
+{
+    char fmt[16];
+    uint32_t i;
+    int prec;
+    double v;
+
+    for (i = 0; i < RANDOM_VALUES; i++) {
+        prec = (int)(i % 10U);
+        snprintf(fmt, sizeof(fmt), "%%.%df", prec);
+        v = random_binary();
+        compare(fmt, ((i & 1U) != 0U) ? -v : v);
+        compare(fmt, random_midpoint(prec + 1));
+    }
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    char buf[16];
+
+    /* 1.115的二进制值为1.11499999999999999111821580299874...，应舍去 */
+    TEST_CHECK(rtos_snprintf(buf, sizeof(buf), "%.2f", 1.115) == 4 && strcmp(buf, "1.11") == 0,
+               "%%.2f of 1.115 gave \"%s\"", buf);
+
+    test_integers();
+    test_strings();
+    test_float_fixed();
+    test_float_random();
+
+    test_checks += compared;
+    return test_result("printf");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,386 @@
+/**
+  ******************************************************************************
+  * @file    test_rtt.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   RTT通道测试 - 主机端解析工具和阻塞模式的超时
+  ******************************************************************************
+  * @attention
+  *
+  * 02_rtos/rtt.c原样编译(外设库由test/stub替代)，在port/sim上检查：
+  * - 上行通道数据跨越缓冲区尾部回绕后，把控制块按目标端32位布局转储为
+  *   RAM镜像，03_tools/build/rtt_reader列出的wr/rd偏移和输出的待读数据
+  *   与通道一致；-d推进rd_off，-w向已回绕的下行通道写入的文本被截断到
+  *   可用空间，写回后RTT_Read逐字读出
+  * - 阻塞模式下调试器持续读取时大块数据全部按序写入，不丢弃
+  * - 调试器停止读取时写入在RTT_BLOCK_TIMEOUT_MS后返回并计入丢弃数，
+  *   等待期间低优先级任务照常运行；此后调试器仍未读取时立即丢弃，
+  *   恢复读取后重新等待
+  * - 中断中和调度器启动前的阻塞写入不等待，按截断处理
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "rtt.h"
+#include "test.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Private define ------------------------------------------------------------*/
+#ifndef RTT_READER
+#define RTT_READER              "../03_tools/build/rtt_reader"
+#endif
+
+/* 转储镜像的目标端布局 */
+#define IMG_BASE                0x20000000UL
+#define IMG_SIZE                0x1000U
+#define IMG_CB                  0x100U      /* 控制块 */
+#define IMG_DESC                24U         /* 目标端rtt_buffer_t的大小 */
+#define IMG_NAMES               0x400U      /* 通道名称，每个16字节 */
+#define IMG_BUFFERS             0x800U      /* 缓冲区，每个256字节 */
+#define IMG_SLOT                256U
+
+#define LOG_CH                  1U
+#define LOG_SIZE                32U
+#define CMD_SIZE                16U
+#define CMD_START               10U         /* 下行通道已读写到的位置 */
+
+#define BLOCK_CH                2U
+#define BLOCK_SIZE              64U
+#define BIG_LEN                 1000U
+#define HOST_CHUNK              16U         /* 调试器每次读取的字节数 */
+#define CYCLES_PER_MS           ((uint64_t)TIM2_TICKS_PER_MS * SIM_CYCLES_PER_TICK)
+
+/* Private variables ---------------------------------------------------------*/
+static char log_buf[LOG_SIZE];
+static char cmd_buf[CMD_SIZE];
+static char block_buf[BLOCK_SIZE];
+
+static uint8_t image[IMG_SIZE];
+static char output[1024];
+
+static uint8_t pattern[BIG_LEN];
+static uint8_t received[BIG_LEN];
+static uint32_t received_len;
+static volatile int host_reading;
+static uint32_t low_runs;
+
+static uint32_t isr_written;
+static int done;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void wr32(uint32_t off, uint32_t v)
+{
+    image[off] = (uint8_t)v;
+    image[off + 1U] = (uint8_t)(v >> 8);
+    image[off + 2U] = (uint8_t)(v >> 16);
+    image[off + 3U] = (uint8_t)(v >> 24);
+}
+
+static uint32_t rd32(const uint8_t* p, uint32_t off)
+{
+    return (uint32_t)p[off] | ((uint32_t)p[off + 1U] << 8) | ((uint32_t)p[off + 2U] << 16) |
+           ((uint32_t)p[off + 3U] << 24);
+}
+
+/* 把一个通道描述符和它的缓冲区按目标端布局写入镜像 */
+static void dump_channel(uint32_t index, const rtt_buffer_t* ring)
+{
+    uint32_t desc = IMG_CB + RTT_CB_ID_SIZE + 8U + index * IMG_DESC;
+    uint32_t name = IMG_NAMES + index * 16U;
+    uint32_t buf = IMG_BUFFERS + index * IMG_SLOT;
+
+    if (ring->buffer == NULL) {
+        return;
+    }
+    strncpy((char*)&image[name], ring->name, 15);
+    memcpy(&image[buf], ring->buffer, ring->size);
+    wr32(desc + 0U, IMG_BASE + name);
+    wr32(desc + 4U, IMG_BASE + buf);
+    wr32(desc + 8U, ring->size);
+    wr32(desc + 12U, ring->wr_off);
+    wr32(desc + 16U, ring->rd_off);
+    wr32(desc + 20U, ring->flags);
+}
+
+/* 相当于调试器的savebin：控制块和全部通道转储为RAM镜像 */
+static void dump_image(const char* path)
+{
+    uint32_t i;
+    FILE* f;
+
+    memset(image, 0, sizeof(image));
+    memcpy(&image[IMG_CB], _SEGGER_RTT.id, RTT_CB_ID_SIZE);
+    wr32(IMG_CB + RTT_CB_ID_SIZE, RTT_MAX_UP_BUFFERS);
+    wr32(IMG_CB + RTT_CB_ID_SIZE + 4U, RTT_MAX_DOWN_BUFFERS);
+    for (i = 0; i < RTT_MAX_UP_BUFFERS; i++) {
+        dump_channel(i, &_SEGGER_RTT.up[i]);
+    }
+    for (i = 0; i < RTT_MAX_DOWN_BUFFERS; i++) {
+        dump_channel(RTT_MAX_UP_BUFFERS + i, &_SEGGER_RTT.down[i]);
+    }
+
+    f = fopen(path, "wb");
+    TEST_CHECK(f != NULL && fwrite(image, 1, sizeof(image), f) == sizeof(image), "write %s", path);
+    if (f != NULL) {
+        fclose(f);
+    }
+}
+
+static int load_image(const char* path)
+{
+    FILE* f = fopen(path, "rb");
+    size_t n = 0;
+
+    if (f != NULL) {
+        n = fread(image, 1, sizeof(image), f);
+        fclose(f);
+    }
+    return (n == sizeof(image)) ? 0 : -1;
+}
+
+/* 运行rtt_reader，标准输出读入output，返回输出的字节数，失败返回-1 */
+static int run_reader(const char* args, const char* path)
+{
+    char cmd[512];
+    FILE* p;
+    size_t n;
+
+    snprintf(cmd, sizeof(cmd), "%s %s %s 2>/dev/null", RTT_READER, args, path);
+    p = popen(cmd, "r");
+    if (p == NULL) {
+        return -1;
+    }
+    n = fread(output, 1, sizeof(output) - 1U, p);
+    output[n] = '\0';
+    return (pclose(p) == 0) ? (int)n : -1;
+}
+
+/* 代替调试器取出上行通道中最多max字节 */
+static uint32_t drain(uint32_t ch, uint8_t* out, uint32_t max)
+{
+    rtt_buffer_t* ring = &_SEGGER_RTT.up[ch];
+    uint32_t n = 0;
+
+    while (ring->rd_off != ring->wr_off && n < max) {
+        out[n++] = (uint8_t)ring->buffer[ring->rd_off];
+        ring->rd_off = (ring->rd_off + 1U == ring->size) ? 0U : ring->rd_off + 1U;
+    }
+    return n;
+}
+
+/* 转储镜像，检查rtt_reader对回绕通道的解析，再把-w写入的命令写回 */
+static void test_reader(void)
+{
+    static const char first[] = "0123456789abcdefghij";
+    static const char second[] = "wrapped-past-the-end-0123";
+    char in_path[] = "/tmp/test_rtt_in_XXXXXX";
+    char out_path[] = "/tmp/test_rtt_out_XXXXXX";
+    rtt_buffer_t* log = &_SEGGER_RTT.up[LOG_CH];
+    rtt_buffer_t* cmd = &_SEGGER_RTT.down[LOG_CH];
+    uint8_t scratch[LOG_SIZE];
+    char want[256];
+    char got[CMD_SIZE + 1U];
+    uint32_t desc, off, n;
+    int fd_in = mkstemp(in_path);
+    int fd_out = mkstemp(out_path);
+
+    TEST_CHECK(fd_in >= 0 && fd_out >= 0, "mkstemp");
+    RTT_ConfigUpBuffer(LOG_CH, "Log", log_buf, LOG_SIZE, RTT_MODE_NO_BLOCK_TRIM);
+    RTT_ConfigDownBuffer(LOG_CH, "Cmd", cmd_buf, CMD_SIZE, 0);
+
+    /* 写入20字节并被读走，再写25字节：跨越尾部回绕到偏移13 */
+    RTT_WriteString(LOG_CH, first);
+    TEST_CHECK(drain(LOG_CH, scratch, sizeof(scratch)) == sizeof(first) - 1U, "drain first");
+    TEST_CHECK(RTT_WriteString(LOG_CH, second) == sizeof(second) - 1U, "write wrapped");
+    TEST_CHECK(log->rd_off == 20U && log->wr_off == 13U, "offsets wr=%lu rd=%lu",
+               (unsigned long)log->wr_off, (unsigned long)log->rd_off);
+
+    /* 下行通道：目标端已读到CMD_START，调试器的写入将跨越尾部回绕 */
+    cmd->wr_off = CMD_START;
+    cmd->rd_off = CMD_START;
+
+    dump_image(in_path);
+
+    /* -l：通道列表中的地址和偏移 */
+    TEST_CHECK(run_reader("-l", in_path) > 0, "%s -l failed", RTT_READER);
+    snprintf(want, sizeof(want), "%-4s %2d  %-16s buf=0x%08x size=%-6u wr=%-6u rd=%-6u mode=%u\n",
+             "up", (int)LOG_CH, "Log", (unsigned)(IMG_BASE + IMG_BUFFERS + LOG_CH * IMG_SLOT),
+             (unsigned)LOG_SIZE, 13U, 20U, (unsigned)RTT_MODE_NO_BLOCK_TRIM);
+    TEST_CHECK(strstr(output, want) != NULL, "listing:\n%s\nwant:\n%s", output, want);
+    off = RTT_MAX_UP_BUFFERS + LOG_CH;
+    snprintf(want, sizeof(want), "%-4s %2d  %-16s buf=0x%08x size=%-6u wr=%-6u rd=%-6u mode=0\n",
+             "down", (int)LOG_CH, "Cmd", (unsigned)(IMG_BASE + IMG_BUFFERS + off * IMG_SLOT),
+             (unsigned)CMD_SIZE, CMD_START, CMD_START);
+    TEST_CHECK(strstr(output, want) != NULL, "listing:\n%s\nwant:\n%s", output, want);
+
+    /* -c：回绕的待读数据按序输出 */
+    TEST_CHECK(run_reader("-c 1", in_path) == (int)sizeof(second) - 1 && strcmp(output, second) == 0,
+               "pending data \"%s\"", output);
+
+    /* -d -w：消费上行数据，向下行通道写入17字节，只有15字节的空间 */
+    snprintf(want, sizeof(want), "-c 1 -d -w 1:hello-rtt-command -o %s", out_path);
+    TEST_CHECK(run_reader(want, in_path) >= 0 && strcmp(output, second) == 0, "%s", want);
+    TEST_CHECK(load_image(out_path) == 0, "load %s", out_path);
+
+    desc = IMG_CB + RTT_CB_ID_SIZE + 8U + LOG_CH * IMG_DESC;
+    TEST_CHECK(rd32(image, desc + 16U) == 13U, "up rd_off %lu after -d", (unsigned long)rd32(image, desc + 16U));
+
+    /* 把调试器写入的下行数据写回目标，RTT_Read读出截断后的文本 */
+    desc = IMG_CB + RTT_CB_ID_SIZE + 8U + off * IMG_DESC;
+    n = rd32(image, desc + 12U);
+    TEST_CHECK(n == (CMD_START + CMD_SIZE - 1U) % CMD_SIZE, "down wr_off %lu", (unsigned long)n);
+    memcpy(cmd_buf, &image[IMG_BUFFERS + off * IMG_SLOT], CMD_SIZE);
+    cmd->wr_off = n;
+    TEST_CHECK(RTT_HasData(LOG_CH) == CMD_SIZE - 1U, "down pending %lu", (unsigned long)RTT_HasData(LOG_CH));
+    n = RTT_Read(LOG_CH, got, sizeof(got) - 1U);
+    got[n] = '\0';
+    TEST_CHECK(strcmp(got, "hello-rtt-comma") == 0, "read back \"%s\"", got);
+    TEST_CHECK(RTT_HasData(LOG_CH) == 0U && cmd->rd_off == cmd->wr_off, "down channel not empty");
+
+    if (fd_in >= 0) { close(fd_in); unlink(in_path); }
+    if (fd_out >= 0) { close(fd_out); unlink(out_path); }
+}
+
+/* 优先级低于写入任务的调试器：读取时每毫秒取一次，停止时占用处理器 */
+static void host(void* arg)
+{
+    uint32_t n;
+
+    (void)arg;
+    for (;;) {
+        if (host_reading) {
+            n = BIG_LEN - received_len;
+            received_len += drain(BLOCK_CH, &received[received_len], (n < HOST_CHUNK) ? n : HOST_CHUNK);
+            Delay_ms(1U);
+        } else {
+            sim_run(1000U);
+            low_runs++;
+        }
+    }
+}
+
+static void block_isr(void* arg)
+{
+    (void)arg;
+    isr_written = RTT_Write(BLOCK_CH, pattern, 100U);
+}
+
+/* 等到调试器把通道读空 */
+static void wait_drained(void)
+{
+    while (RTT_GetFreeSpace(BLOCK_CH) != BLOCK_SIZE - 1U) {
+        Delay_ms(1U);
+    }
+}
+
+static void writer(void* arg)
+{
+    int irq = (int)(intptr_t)arg;
+    uint64_t start, elapsed;
+    uint32_t n, drops;
+
+    /* 调试器持续读取：1000字节经64字节的通道全部写入 */
+    host_reading = 1;
+    received_len = 0;
+    n = RTT_Write(BLOCK_CH, pattern, BIG_LEN);
+    wait_drained();
+    TEST_CHECK(n == BIG_LEN && RTT_GetDropCount(BLOCK_CH) == 0U, "wrote %lu, dropped %lu",
+               (unsigned long)n, (unsigned long)RTT_GetDropCount(BLOCK_CH));
+    TEST_CHECK(received_len == BIG_LEN && memcmp(received, pattern, BIG_LEN) == 0,
+               "host received %lu bytes", (unsigned long)received_len);
+
+    /* 调试器停止读取：写满后等待超时，剩余数据丢弃，低优先级任务照常运行 */
+    host_reading = 0;
+    low_runs = 0;
+    start = sim_now();
+    n = RTT_Write(BLOCK_CH, pattern, 200U);
+    elapsed = sim_now() - start;
+    TEST_CHECK(n == BLOCK_SIZE - 1U && RTT_GetDropCount(BLOCK_CH) == 200U - n,
+               "wrote %lu, dropped %lu", (unsigned long)n, (unsigned long)RTT_GetDropCount(BLOCK_CH));
+    TEST_CHECK(elapsed >= RTT_BLOCK_TIMEOUT_MS * CYCLES_PER_MS &&
+               elapsed <= (RTT_BLOCK_TIMEOUT_MS + 2U) * CYCLES_PER_MS,
+               "timed out after %llu cycles", (unsigned long long)elapsed);
+    TEST_CHECK(low_runs >= RTT_BLOCK_TIMEOUT_MS * CYCLES_PER_MS / 1000U / 2U,
+               "low priority task ran %lu times while the writer waited", (unsigned long)low_runs);
+
+    /* 超时后调试器仍未读取：不再等待 */
+    drops = RTT_GetDropCount(BLOCK_CH);
+    start = sim_now();
+    n = RTT_Write(BLOCK_CH, pattern, 10U);
+    TEST_CHECK(n == 0U && sim_now() == start && RTT_GetDropCount(BLOCK_CH) == drops + 10U,
+               "stalled write: %lu bytes after %llu cycles", (unsigned long)n,
+               (unsigned long long)(sim_now() - start));
+
+    /* 调试器恢复读取后：重新等待，数据全部写入 */
+    host_reading = 1;
+    received_len = 0;
+    Delay_ms(2U);
+    n = RTT_Write(BLOCK_CH, pattern, 300U);
+    wait_drained();
+    TEST_CHECK(n == 300U && RTT_GetDropCount(BLOCK_CH) == drops + 10U, "resumed write %lu bytes",
+               (unsigned long)n);
+    TEST_CHECK(received_len == BLOCK_SIZE - 1U + 300U &&
+               memcmp(received, pattern, BLOCK_SIZE - 1U) == 0 &&
+               memcmp(&received[BLOCK_SIZE - 1U], pattern, 300U) == 0,
+               "host received %lu bytes after resuming", (unsigned long)received_len);
+
+    /* 中断中：不等待，截断写入 */
+    host_reading = 0;
+    drops = RTT_GetDropCount(BLOCK_CH);
+    start = sim_now();
+    sim_irq_pend(irq);
+    sim_run(100U);
+    TEST_CHECK(isr_written == BLOCK_SIZE - 1U && RTT_GetDropCount(BLOCK_CH) == drops + 100U - isr_written,
+               "isr wrote %lu", (unsigned long)isr_written);
+    TEST_CHECK(sim_now() - start <= 100U + SIM_IRQ_ENTRY_CYCLES + SIM_IRQ_EXIT_CYCLES, "isr write took %llu cycles",
+               (unsigned long long)(sim_now() - start));
+
+    done = 1;
+    sim_stop();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    uint32_t i, n;
+    int irq;
+
+    for (i = 0; i < BIG_LEN; i++) {
+        pattern[i] = (uint8_t)(i * 7U + i / 251U);
+    }
+
+    sim_reset();
+    rtos_init();
+    Time_Init();
+    RTT_Init();
+
+    test_reader();
+
+    /* 调度器启动前：不等待，截断写入 */
+    RTT_ConfigUpBuffer(BLOCK_CH, "Block", block_buf, BLOCK_SIZE, RTT_MODE_BLOCK_IF_FULL);
+    n = RTT_Write(BLOCK_CH, pattern, 100U);
+    TEST_CHECK(n == BLOCK_SIZE - 1U && RTT_GetDropCount(BLOCK_CH) == 100U - n,
+               "before start: wrote %lu, dropped %lu", (unsigned long)n,
+               (unsigned long)RTT_GetDropCount(BLOCK_CH));
+    RTT_ConfigUpBuffer(BLOCK_CH, "Block", block_buf, BLOCK_SIZE, RTT_MODE_BLOCK_IF_FULL);
+
+    irq = sim_irq_register("rtt", 5, block_isr, NULL);
+    sim_set_task_name(task_create(writer, (void*)(intptr_t)irq, 1), "writer");
+    sim_set_task_name(task_create(host, NULL, 2), "host");
+    rtos_start();
+
+    TEST_CHECK(done, "writer did not finish, stopped at %llu cycles", (unsigned long long)sim_now());
+    return test_result("rtt");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
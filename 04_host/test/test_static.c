@@ -0,0 +1,97 @@
+/**
+  ******************************************************************************
+  * @file    test_static.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   静态任务测试 - RTOS_TASK_DEFINE的启动和任务数上限
+  ******************************************************************************
+  * @attention
+  *
+  * 在port/sim上检查：
+  * - 静态任务与已创建的任务合计超过MAX_TASKS时，rtos_start以合计任务数
+  *   调用rtos_task_limit_exceeded(本程序重新实现为记录后返回)，不启动
+  *   任何静态任务，调度器不运行
+  * - 未超过时rtos_start启动全部静态任务，按优先级运行，与task_create
+  *   创建的任务一起调度
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "test.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define STATIC_TASKS            2U
+
+/* Private variables ---------------------------------------------------------*/
+static char order[8];
+static int order_len;
+static uint32_t limit_count;
+static int limit_calls;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void record(void* arg)
+{
+    order[order_len++] = (char)(intptr_t)arg;
+}
+
+static void last(void* arg)
+{
+    record(arg);
+    sim_stop();
+}
+
+static void filler(void* arg)
+{
+    (void)arg;
+}
+
+RTOS_TASK_DEFINE(static_high, record, (void*)'A', 1, RTOS_TASK_MIN_STACK + 64U);
+RTOS_TASK_DEFINE(static_low, record, (void*)'C', 3, RTOS_TASK_MIN_STACK + 64U);
+
+/* Public functions ----------------------------------------------------------*/
+
+/* 替代默认的停机实现：记录后返回，rtos_start随即返回 */
+void rtos_task_limit_exceeded(uint32_t count)
+{
+    limit_count = count;
+    limit_calls++;
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    /* 空闲任务 + 30个已创建的任务 + 2个静态任务 = 33 */
+    sim_reset();
+    rtos_init();
+    for (i = 0; i < MAX_TASKS - STATIC_TASKS; i++) {
+        TEST_CHECK(task_create(filler, NULL, 10) != NULL, "task_create %lu", (unsigned long)i);
+    }
+    rtos_start();
+    TEST_CHECK(limit_calls == 1 && limit_count == MAX_TASKS + 1U, "limit hook: %d calls, count %lu",
+               limit_calls, (unsigned long)limit_count);
+    TEST_CHECK(!scheduler.running && order_len == 0, "scheduler started with too many tasks");
+    TEST_CHECK(static_high.task_func == NULL && static_low.task_func == NULL,
+               "static tasks were set up");
+
+    /* 未超过上限：静态任务和已创建的任务按优先级运行 */
+    sim_reset();
+    rtos_init();
+    TEST_CHECK(task_create(record, (void*)'B', 2) != NULL, "task_create B");
+    TEST_CHECK(task_create(last, (void*)'D', 4) != NULL, "task_create D");
+    rtos_start();
+    order[order_len] = '\0';
+    TEST_CHECK(limit_calls == 1, "limit hook called for %lu tasks", (unsigned long)limit_count);
+    TEST_CHECK(strcmp(order, "ABCD") == 0, "run order \"%s\"", order);
+
+    return test_result("static");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
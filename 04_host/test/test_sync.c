@@ -0,0 +1,277 @@
+/**
+  ******************************************************************************
+  * @file    test_sync.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   等待队列、互斥锁和一次性初始化测试
+  ******************************************************************************
+  * @attention
+  *
+  * 在port/sim上以虚拟时间检查：
+  * - task_wait_timeout：无人唤醒时按时超时；提前唤醒时取消超时，之后不会
+  *   被过期的延时再次唤醒；task_wake_one/task_wake_all按入队顺序唤醒
+  * - rtos_mutex_lock/unlock：同一任务重复加锁；被占用时ticks为0立即失败，
+  *   有限等待按时失败，无限等待在解锁时得到锁；中断中的解锁不释放任务持有的锁
+  * - rtos_once：同时到达的多个任务中func只执行一次，其余任务在func完成后
+  *   才返回；func执行期间中断中调用返回-1，完成后返回0
+  *
+  * driver任务优先级最高，按阶段创建被测任务并以延时推进虚拟时间。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "test.h"
+#include <stdint.h>
+
+/* Private define ------------------------------------------------------------*/
+#define TICK_CYCLES             ((uint64_t)SIM_CYCLES_PER_TICK)
+#define SLACK_CYCLES            400U        /* 中断进出和切换开销上限 */
+#define WAITERS                 3
+#define ONCE_TASKS              3
+#define ONCE_FUNC_TICKS         2000U
+
+/* Private variables ---------------------------------------------------------*/
+static wait_queue_t queue;
+static wait_queue_t parking;                /* 只进不出，检测过期延时的误唤醒 */
+static rtos_mutex_t mutex;
+static rtos_once_t once;
+
+static uint64_t wait_start;
+static uint64_t wait_end;
+static int wait_returns;
+
+static int fifo_order[WAITERS];
+static int fifo_count;
+
+static int mutex_ret[2];
+static uint64_t mutex_at[2];
+
+static int once_calls;
+static volatile int once_done;
+static int once_ret[ONCE_TASKS];
+static int once_saw_done[ONCE_TASKS];
+static int once_irq_ret[2];
+static int once_irq_count;
+static int irq_once;
+static int irq_unlock;
+
+static int done;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void check_near(const char* what, uint64_t at, uint64_t want)
+{
+    TEST_CHECK(at >= want && at - want <= SLACK_CYCLES, "%s at %llu, want %llu",
+               what, (unsigned long long)at, (unsigned long long)want);
+}
+
+/* 在queue上等待ticks，返回后停在parking上 */
+static void timed_waiter(void* arg)
+{
+    uint32_t ticks = (uint32_t)(uintptr_t)arg;
+    uint32_t primask = rtos_enter_critical();
+
+    wait_start = sim_now();
+    (void)task_wait_timeout(&queue, ticks);
+    rtos_exit_critical(primask);
+    wait_end = sim_now();
+    wait_returns++;
+
+    primask = rtos_enter_critical();
+    (void)task_wait(&parking);
+    rtos_exit_critical(primask);
+    wait_returns++;                         /* 不应到达 */
+}
+
+static void fifo_waiter(void* arg)
+{
+    uint32_t primask = rtos_enter_critical();
+
+    (void)task_wait(&queue);
+    rtos_exit_critical(primask);
+    fifo_order[fifo_count++] = (int)(intptr_t)arg;
+}
+
+static void mutex_holder(void* arg)
+{
+    (void)arg;
+    TEST_CHECK(rtos_mutex_lock(&mutex, RTOS_WAIT_FOREVER) == 0, "holder lock");
+    Delay_ticks(5000U);
+    rtos_mutex_unlock(&mutex);
+}
+
+static void mutex_contender(void* arg)
+{
+    int i = (int)(intptr_t)arg;
+
+    mutex_ret[i] = rtos_mutex_lock(&mutex, (i == 0) ? 1000U : RTOS_WAIT_FOREVER);
+    mutex_at[i] = sim_now();
+    if (mutex_ret[i] == 0) {
+        TEST_CHECK(mutex.owner == scheduler.current_task && mutex.count == 1U, "contender owns the mutex");
+        rtos_mutex_unlock(&mutex);
+    }
+}
+
+static void once_func(void)
+{
+    once_calls++;
+    Delay_ticks(ONCE_FUNC_TICKS);
+    once_done = 1;
+}
+
+static void once_task(void* arg)
+{
+    int i = (int)(intptr_t)arg;
+
+    once_ret[i] = rtos_once(&once, once_func);
+    once_saw_done[i] = once_done;
+}
+
+static void once_isr(void* arg)
+{
+    (void)arg;
+    once_irq_ret[once_irq_count++] = rtos_once(&once, once_func);
+}
+
+static void unlock_isr(void* arg)
+{
+    (void)arg;
+    rtos_mutex_unlock(&mutex);
+}
+
+static void test_wait_timeout(void)
+{
+    uint64_t t;
+    int i;
+
+    /* 无人唤醒：按时超时 */
+    (void)task_create(timed_waiter, (void*)(uintptr_t)1000U, 2);
+    Delay_ticks(3000U);
+    TEST_CHECK(wait_returns == 1, "timed waiter returned %d times", wait_returns);
+    check_near("timeout", wait_end, wait_start + 1000U * TICK_CYCLES);
+    TEST_CHECK(queue.head == NULL && queue.tail == NULL, "queue not empty after timeout");
+
+    /* 删除停在parking上的任务 */
+    task_delete(parking.head);
+    parking.head = parking.tail = NULL;
+    wait_returns = 0;
+
+    /* 提前唤醒：超时被取消，20000个周期后不会再被过期的延时唤醒 */
+    (void)task_create(timed_waiter, (void*)(uintptr_t)10000U, 2);
+    Delay_ticks(500U);
+    t = sim_now();
+    TEST_CHECK(task_wake_one(&queue) != NULL, "no task to wake");
+    Delay_ticks(100U);
+    TEST_CHECK(wait_returns == 1, "woken waiter returned %d times", wait_returns);
+    check_near("early wake", wait_end, t);
+    Delay_ticks(20000U);
+    TEST_CHECK(wait_returns == 1, "stale timeout woke the waiter again");
+    task_delete(parking.head);
+    parking.head = parking.tail = NULL;
+
+    /* 按入队顺序唤醒 */
+    for (i = 0; i < WAITERS; i++) {
+        (void)task_create(fifo_waiter, (void*)(intptr_t)i, 2);
+    }
+    Delay_ticks(100U);
+    (void)task_wake_one(&queue);
+    Delay_ticks(100U);
+    TEST_CHECK(fifo_count == 1 && fifo_order[0] == 0, "wake_one woke %d first", fifo_order[0]);
+    task_wake_all(&queue);
+    Delay_ticks(100U);
+    TEST_CHECK(fifo_count == WAITERS && fifo_order[1] == 1 && fifo_order[2] == 2,
+               "wake order %d %d %d", fifo_order[0], fifo_order[1], fifo_order[2]);
+}
+
+static void test_mutex(void)
+{
+    uint64_t t;
+
+    /* 同一任务重复加锁 */
+    TEST_CHECK(rtos_mutex_lock(&mutex, 0) == 0 && rtos_mutex_lock(&mutex, 0) == 0, "recursive lock");
+    TEST_CHECK(mutex.count == 2U, "count %lu after two locks", (unsigned long)mutex.count);
+    rtos_mutex_unlock(&mutex);
+    TEST_CHECK(mutex.owner == scheduler.current_task, "released after one of two unlocks");
+    rtos_mutex_unlock(&mutex);
+    TEST_CHECK(mutex.owner == NULL && mutex.count == 0U, "still held after two unlocks");
+
+    /* 中断中的解锁没有对应的加锁，不改变任务持有的锁 */
+    TEST_CHECK(rtos_mutex_lock(&mutex, 0) == 0, "lock before interrupt");
+    sim_irq_pend(irq_unlock);
+    sim_run(100U);
+    TEST_CHECK(mutex.owner == scheduler.current_task && mutex.count == 1U,
+               "unlock in an interrupt released the task's mutex");
+    rtos_mutex_unlock(&mutex);
+
+    /* 其他任务持有5000个计数 */
+    (void)task_create(mutex_holder, NULL, 3);
+    Delay_ticks(100U);
+    t = sim_now();
+    TEST_CHECK(rtos_mutex_lock(&mutex, 0) == -1 && sim_now() == t, "trylock of a held mutex");
+
+    (void)task_create(mutex_contender, (void*)(intptr_t)0, 2);
+    (void)task_create(mutex_contender, (void*)(intptr_t)1, 2);
+    Delay_ticks(8000U);
+    TEST_CHECK(mutex_ret[0] == -1, "timed lock returned %d", mutex_ret[0]);
+    check_near("timed lock failure", mutex_at[0], t + 1000U * TICK_CYCLES);
+    TEST_CHECK(mutex_ret[1] == 0, "blocking lock returned %d", mutex_ret[1]);
+    TEST_CHECK(mutex_at[1] > t + 4900U * TICK_CYCLES, "blocking lock got the mutex before unlock");
+    TEST_CHECK(mutex.owner == NULL && mutex.waiters.head == NULL, "mutex not free at the end");
+}
+
+static void test_once(void)
+{
+    int i;
+
+    for (i = 0; i < ONCE_TASKS; i++) {
+        (void)task_create(once_task, (void*)(intptr_t)i, 2);
+    }
+    sim_irq_schedule(irq_once, sim_now() + ONCE_FUNC_TICKS * TICK_CYCLES / 2U);
+    Delay_ticks(ONCE_FUNC_TICKS * 2U);
+    sim_irq_pend(irq_once);
+    Delay_ticks(10U);
+
+    TEST_CHECK(once_calls == 1, "func ran %d times", once_calls);
+    TEST_CHECK(once.state == RTOS_ONCE_DONE && once.waiters.head == NULL, "once not done");
+    for (i = 0; i < ONCE_TASKS; i++) {
+        TEST_CHECK(once_ret[i] == 0 && once_saw_done[i], "task %d: ret %d before func finished",
+                   i, once_ret[i]);
+    }
+    TEST_CHECK(once_irq_count == 2 && once_irq_ret[0] == -1 && once_irq_ret[1] == 0,
+               "irq calls: %d, ret %d %d", once_irq_count, once_irq_ret[0], once_irq_ret[1]);
+    TEST_CHECK(rtos_once(&once, once_func) == 0 && once_calls == 1, "second round ran func");
+}
+
+static void driver(void* arg)
+{
+    (void)arg;
+
+    test_wait_timeout();
+    test_mutex();
+    test_once();
+
+    done = 1;
+    sim_stop();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    sim_reset();
+    rtos_init();
+    Time_Init();
+    irq_once = sim_irq_register("once", 5, once_isr, NULL);
+    irq_unlock = sim_irq_register("unlock", 5, unlock_isr, NULL);
+    sim_set_task_name(task_create(driver, NULL, 1), "driver");
+    rtos_start();
+
+    TEST_CHECK(done, "driver did not finish, stopped at %llu cycles", (unsigned long long)sim_now());
+    return test_result("sync");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
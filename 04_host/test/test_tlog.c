@@ -0,0 +1,182 @@
+/**
+  ******************************************************************************
+  * @file    test_tlog.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   令牌化日志编码和主机端解码的往返测试
+  ******************************************************************************
+  * @attention
+  *
+  * 02_rtos/tlog.c和rtt.c原样编译(外设库由test/stub替代)，TLOG写入RTT
+  * 通道1，测试程序代替调试器从环形缓冲区取出数据流，再以本程序的ELF
+  * 运行03_tools/build/tlog_decode，逐字比较还原的文本：
+  * - LEB128各长度的边界值(1~5字节)，检查编码字节和还原的数值
+  * - 负数%d、TLOG_STR的%s(含宽度)、TLOG_FLOAT的%f/%g/%e、无参数、%c和%%
+  * - 数据流中插入一个损坏字节后重新同步，其后的帧照常还原
+  * - 末尾被截断的帧不输出，报告跳过的字节数
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "rtt.h"
+#include "tlog.h"
+#include "test.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Private define ------------------------------------------------------------*/
+#ifndef TLOG_DECODE
+#define TLOG_DECODE             "../03_tools/build/tlog_decode"
+#endif
+
+#define STREAM_MAX              1024U
+#define OUTPUT_MAX              2048U
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t stream[STREAM_MAX];
+static char output[OUTPUT_MAX];
+static char errors[OUTPUT_MAX];
+
+/* 损坏字节之前的帧还原后的文本 */
+static const char expected_head[] =
+    "leb 0 127 128 16383 16384\n"
+    "leb 2097151 2097152 268435455 268435456 4294967295\n"
+    "neg -1 -2147483648 -12345\n"
+    "str [serial] [idle    ] [  x]\n"
+    "float 36.60 -0.5 1.500000e-03\n"
+    "no args\n"
+    "hex 0xdeadbeef x %\n";
+
+static const char expected_tail[] = "after corrupt byte 7\n";
+
+/* LEB128边界值的编码 */
+static const uint8_t leb_small[] = { 0x00, 0x7F, 0x80, 0x01, 0xFF, 0x7F, 0x80, 0x80, 0x01 };
+static const uint8_t leb_large[] = { 0xFF, 0xFF, 0x7F, 0x80, 0x80, 0x80, 0x01, 0xFF, 0xFF, 0xFF,
+                                     0x7F, 0x80, 0x80, 0x80, 0x80, 0x01, 0xFF, 0xFF, 0xFF, 0xFF,
+                                     0x0F };
+
+/* Private functions ---------------------------------------------------------*/
+
+/* 代替调试器取出上行通道中的全部数据，更新读偏移 */
+static uint32_t drain(uint32_t ch, uint8_t* out, uint32_t max)
+{
+    rtt_buffer_t* ring = &_SEGGER_RTT.up[ch];
+    uint32_t n = 0;
+
+    while (ring->rd_off != ring->wr_off && n < max) {
+        out[n++] = (uint8_t)ring->buffer[ring->rd_off];
+        ring->rd_off = (ring->rd_off + 1U == ring->size) ? 0U : ring->rd_off + 1U;
+    }
+    return n;
+}
+
+/* 从pos处的帧头跳过编号，返回参数的起始位置 */
+static uint32_t skip_header(const uint8_t* p, uint32_t pos)
+{
+    pos++;
+    while (p[pos] & 0x80U) {
+        pos++;
+    }
+    return pos + 1U;
+}
+
+static void read_file(const char* path, char* buf, size_t max)
+{
+    FILE* f = fopen(path, "r");
+    size_t n = 0;
+
+    if (f != NULL) {
+        n = fread(buf, 1, max - 1U, f);
+        fclose(f);
+    }
+    buf[n] = '\0';
+}
+
+/* 以本程序的ELF解码数据流，标准输出和标准错误分别读入output和errors */
+static int run_decoder(const uint8_t* data, uint32_t len)
+{
+    char in_path[] = "/tmp/test_tlog_in_XXXXXX";
+    char out_path[] = "/tmp/test_tlog_out_XXXXXX";
+    char err_path[] = "/tmp/test_tlog_err_XXXXXX";
+    char cmd[512];
+    int fd_in = mkstemp(in_path);
+    int fd_out = mkstemp(out_path);
+    int fd_err = mkstemp(err_path);
+    int ret = -1;
+
+    if (fd_in >= 0 && fd_out >= 0 && fd_err >= 0 && write(fd_in, data, len) == (ssize_t)len) {
+        snprintf(cmd, sizeof(cmd), "%s -e /proc/%d/exe %s >%s 2>%s", TLOG_DECODE, (int)getpid(),
+                 in_path, out_path, err_path);
+        ret = system(cmd);
+        read_file(out_path, output, sizeof(output));
+        read_file(err_path, errors, sizeof(errors));
+    }
+    if (fd_in >= 0) { close(fd_in); unlink(in_path); }
+    if (fd_out >= 0) { close(fd_out); unlink(out_path); }
+    if (fd_err >= 0) { close(fd_err); unlink(err_path); }
+    return ret;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    uint32_t len, pos, head_len, tail_start, tail_len, trunc_start;
+    char want[OUTPUT_MAX];
+    char msg[64];
+
+    RTT_Init();
+    TLOG_Init();
+
+    TLOG("leb %u %u %u %u %u\r\n", 0U, 127U, 128U, 16383U, 16384U);
+    TLOG("leb %u %u %u %u %u\r\n", 0x1FFFFFU, 0x200000U, 0xFFFFFFFU, 0x10000000U, 0xFFFFFFFFU);
+    TLOG("neg %d %d %i\r\n", -1, INT32_MIN, -12345);
+    TLOG("str [%s] [%-8s] [%3s]\r\n", TLOG_STR("serial"), TLOG_STR("idle"), TLOG_STR("x"));
+    TLOG("float %.2f %g %e\r\n", TLOG_FLOAT(36.6f), TLOG_FLOAT(-0.5f), TLOG_FLOAT(1.5e-3f));
+    TLOG("no args\r\n");
+    TLOG("hex 0x%08lx %c %%\r\n", 0xDEADBEEFUL, 'x');
+    head_len = drain(TLOG_RTT_CHANNEL, stream, STREAM_MAX);
+
+    /* 编码：头字节的参数个数和各边界值的字节 */
+    TEST_CHECK(stream[0] == (TLOG_SYNC | 5U), "header 0x%02x", stream[0]);
+    pos = skip_header(stream, 0);
+    TEST_CHECK(memcmp(&stream[pos], leb_small, sizeof(leb_small)) == 0, "LEB128 of 0..16384");
+    pos += (uint32_t)sizeof(leb_small);
+    TEST_CHECK(stream[pos] == (TLOG_SYNC | 5U), "second header 0x%02x", stream[pos]);
+    pos = skip_header(stream, pos);
+    TEST_CHECK(memcmp(&stream[pos], leb_large, sizeof(leb_large)) == 0, "LEB128 of 2^21-1..2^32-1");
+
+    /* 一个损坏字节，随后一个完整的帧和一个缺少最后一个字节的帧 */
+    stream[head_len] = 0x55U;
+    tail_start = head_len + 1U;
+    TLOG("after corrupt byte %d\r\n", 7);
+    tail_len = drain(TLOG_RTT_CHANNEL, &stream[tail_start], STREAM_MAX - tail_start);
+    trunc_start = tail_start + tail_len;
+    TLOG("truncated %u %u\r\n", 1000000U, 2000000U);
+    len = trunc_start + drain(TLOG_RTT_CHANNEL, &stream[trunc_start], STREAM_MAX - trunc_start) - 1U;
+    TEST_CHECK(RTT_GetDropCount(TLOG_RTT_CHANNEL) == 0U, "frames dropped by the channel");
+
+    TEST_CHECK(run_decoder(stream, len) == 0, "%s failed", TLOG_DECODE);
+    snprintf(want, sizeof(want), "%s%s", expected_head, expected_tail);
+    TEST_CHECK(strcmp(output, want) == 0, "decoded text:\n%s", output);
+
+    /* 损坏字节和截断的帧各报告一次 */
+    snprintf(want, sizeof(want), "tlog: skipped 1 bytes\ntlog: skipped %u bytes\n",
+             (unsigned)(len - trunc_start));
+    TEST_CHECK(strcmp(errors, want) == 0, "decoder reported:\n%s", errors);
+
+    /* 只有截断的帧：不输出任何文本 */
+    TEST_CHECK(run_decoder(&stream[trunc_start], len - trunc_start) == 0 && output[0] == '\0',
+               "truncated frame decoded as \"%s\"", output);
+    snprintf(msg, sizeof(msg), "tlog: skipped %u bytes\n", (unsigned)(len - trunc_start));
+    TEST_CHECK(strcmp(errors, msg) == 0, "decoder reported: %s", errors);
+
+    return test_result("tlog");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
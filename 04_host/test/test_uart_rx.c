@@ -0,0 +1,440 @@
+/**
+  ******************************************************************************
+  * @file    test_uart_rx.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   UART1循环DMA接收测试 - 2Mbaud下不丢字节
+  *          在port/sim上运行未经修改的drv_uart.c，USART1和DMA2 Stream2由本文件按
+  *          虚拟时间模拟
+  ******************************************************************************
+  * @attention
+  *
+  * 模型：
+  * - 线路：2Mbaud、8N1，每字节840周期(168MHz)。按长度不同的帧发送，帧间
+  *   空闲1~3个字节时间；最后一个停止位之后空闲满一个字节时间置IDLE
+  * - USART：收到字节置RXNE，DMA_LATENCY周期后DMA读DR；RXNE未清又收到字节
+  *   为溢出(ORE)。IDLE以读SR后读DR清除，只有CPU读DR才算(保守假设DMA读DR
+  *   不清除IDLE)；CPU在RXNE置位时读DR会把字节从DMA手中拿走
+  * - DMA：循环模式，NDTR到一半和到0时置HTIF/TCIF
+  * - 中断：USART1和DMA2 Stream2为电平触发，优先级UART_RX_IRQ_PRIORITY；每帧
+  *   结束时一个更高优先级的中断占用约一个字节时间(长度逐帧变化)，使空闲线
+  *   中断的执行时刻扫过下一帧首字节等待DMA的窗口
+  *
+  * 读取任务以uart_read分块读取并逐字节核对，然后检查无数据时的超时，最后
+ * 在线路停止后直接推进DMA：uart_rx_peek取得的一段数据释放之前被DMA覆盖，
+ * 覆盖发生在两次发布之间，bytes_lost仍须如实计数。
+  * 外设地址经32位整数传递(DMA_InitTypeDef)，程序以-no-pie链接使其不截断。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "drv_uart.h"
+#include "test.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define LINE_BAUD               2000000UL
+#define CYCLES_PER_BYTE         (SIM_CPU_HZ / (LINE_BAUD / 10UL))   /* 840 */
+#define DMA_LATENCY             8U          /* RXNE到DMA读DR的周期数 */
+#define TEST_BYTES              200000U
+#define MAX_FRAME               1500U       /* 超过半个接收缓冲区，帧内也有HT/TC */
+#define NOISE_PRIORITY          2           /* 高于TIM2(3)和UART接收中断(4) */
+#define READ_CHUNK              300U
+#define READ_TIMEOUT_MS         20U
+#define READ_COST_PER_BYTE      30U         /* 读取任务处理每字节的周期数 */
+#define HW_PRIORITY             0           /* 外设模型事件，先于一切中断 */
+#define HOLD_BYTES              100U        /* 覆盖检查中读取者持有未释放的字节数 */
+#define OVERWRITTEN             10U         /* 其中被DMA覆盖的字节数 */
+
+/* Private variables ---------------------------------------------------------*/
+USART_TypeDef stub_usart1;
+DMA_Stream_TypeDef stub_dma2_stream2;
+DMA_Stream_TypeDef stub_dma2_stream7;
+
+/* USART1接收部分 */
+static struct {
+    uint8_t dr;
+    uint8_t rxne;
+    uint8_t idle;
+    uint8_t idle_armed;                     /* 收到字节后，下一次空闲时置IDLE */
+    uint8_t sr_read;                        /* 已读SR，等待读DR完成清除序列 */
+    uint8_t idleie;
+    uint8_t dmar;
+    uint32_t overruns;                      /* ORE：RXNE未清除时又收到字节 */
+    uint32_t stolen;                        /* CPU在RXNE置位时读DR取走的字节 */
+} usart;
+
+/* DMA2 Stream2 */
+static struct {
+    uint8_t* mem;
+    uint32_t size;
+    uint32_t ndtr;
+    uint8_t en;
+    uint8_t htie;
+    uint8_t tcie;
+    uint8_t htif;
+    uint8_t tcif;
+} rx_dma;
+
+/* 发送端 */
+static struct {
+    uint32_t sent;
+    uint32_t frame_no;
+    uint32_t frame_left;                    /* 本帧剩余字节，0表示处于帧间空闲 */
+} line;
+
+static int irq_line;
+static int irq_dmareq;
+static int irq_usart;
+static int irq_dma;
+static int irq_noise;
+static uint32_t noise_cost;
+
+static uint32_t received;
+static uint32_t mismatches;
+
+/* Private functions ---------------------------------------------------------*/
+
+/* 第i个字节的值 */
+static uint8_t pattern(uint32_t i)
+{
+    return (uint8_t)(i * 131U + (i >> 9));
+}
+
+static uint32_t frame_length(uint32_t n)
+{
+    return 1U + (n * 397U) % MAX_FRAME;
+}
+
+static void line_isr(void* arg)
+{
+    (void)arg;
+
+    if (line.frame_left == 0U) {
+        /* 空闲满一个字节时间 */
+        if (usart.idle_armed) {
+            usart.idle_armed = 0;
+            usart.idle = 1;
+            if (usart.idleie) {
+                sim_irq_pend(irq_usart);
+            }
+            /* 更高优先级的中断推迟空闲线中断，长度逐帧变化 */
+            noise_cost = CYCLES_PER_BYTE - 16U + (line.frame_no % 48U);
+            sim_irq_schedule(irq_noise, sim_now());
+        }
+        if (line.sent < TEST_BYTES) {
+            line.frame_left = frame_length(line.frame_no++);
+            if (line.frame_left > TEST_BYTES - line.sent) {
+                line.frame_left = TEST_BYTES - line.sent;
+            }
+            /* 首字节在1~3个字节时间后收完 */
+            sim_irq_schedule(irq_line, sim_now() + CYCLES_PER_BYTE * (1U + line.frame_no % 3U));
+        }
+        return;
+    }
+
+    /* 一个字节收完 */
+    if (usart.rxne) {
+        usart.overruns++;
+    } else {
+        usart.dr = pattern(line.sent);
+        usart.rxne = 1;
+        usart.idle_armed = 1;
+        if (usart.dmar) {
+            sim_irq_schedule(irq_dmareq, sim_now() + DMA_LATENCY);
+        }
+    }
+    line.sent++;
+    line.frame_left--;
+    sim_irq_schedule(irq_line, sim_now() + CYCLES_PER_BYTE);
+}
+
+static void dmareq_isr(void* arg)
+{
+    (void)arg;
+
+    if (!rx_dma.en || !usart.rxne) {
+        return;                             /* 请求已被CPU读DR撤销 */
+    }
+    usart.rxne = 0;
+    usart.sr_read = 0;
+    rx_dma.mem[rx_dma.size - rx_dma.ndtr] = usart.dr;
+    if (--rx_dma.ndtr == rx_dma.size / 2U) {
+        rx_dma.htif = 1;
+    } else if (rx_dma.ndtr == 0U) {
+        rx_dma.tcif = 1;
+        rx_dma.ndtr = rx_dma.size;
+    }
+    if ((rx_dma.htif && rx_dma.htie) || (rx_dma.tcif && rx_dma.tcie)) {
+        sim_irq_pend(irq_dma);
+    }
+}
+
+static void usart_isr(void* arg)
+{
+    (void)arg;
+    uart_rx_idle_irq_handler();
+    if (usart.idle && usart.idleie) {
+        sim_irq_pend(irq_usart);            /* 电平触发 */
+    }
+}
+
+static void dma_isr(void* arg)
+{
+    (void)arg;
+    uart_rx_dma_irq_handler();
+    if ((rx_dma.htif && rx_dma.htie) || (rx_dma.tcif && rx_dma.tcie)) {
+        sim_irq_pend(irq_dma);
+    }
+}
+
+static void noise_isr(void* arg)
+{
+    (void)arg;
+    sim_run(noise_cost);
+}
+
+/* DMA不经线路模型直接写入n个字节，期间不处理HT/TC中断 */
+static void dma_write(uint32_t n)
+{
+    while (n-- > 0U) {
+        rx_dma.mem[rx_dma.size - rx_dma.ndtr] = 0;
+        if (--rx_dma.ndtr == 0U) {
+            rx_dma.ndtr = rx_dma.size;
+        }
+    }
+}
+
+/* 置IDLE并运行空闲线中断，发布DMA已写入的字节 */
+static void idle_publish(void)
+{
+    usart.idle = 1;
+    sim_irq_pend(irq_usart);
+    sim_run(CYCLES_PER_BYTE);
+}
+
+static void reader(void* arg)
+{
+    uint8_t buf[READ_CHUNK];
+    const uint8_t* data;
+    uart_rx_stats_t stats;
+    uint64_t start;
+    uint64_t elapsed;
+    uint32_t n;
+    uint32_t i;
+
+    (void)arg;
+    for (;;) {
+        n = uart_read(buf, sizeof(buf), READ_TIMEOUT_MS);
+        for (i = 0; i < n; i++) {
+            if (buf[i] != pattern(received + i) && mismatches++ < 5U) {
+                printf("byte %u: got %u, want %u\n", (unsigned)(received + i),
+                       buf[i], pattern(received + i));
+            }
+        }
+        received += n;
+        sim_run(n * READ_COST_PER_BYTE);
+        if (n == 0U && line.sent >= TEST_BYTES) {
+            break;
+        }
+    }
+
+    uart_rx_get_stats(&stats);
+    TEST_CHECK(received == TEST_BYTES, "received %u of %u bytes", (unsigned)received, TEST_BYTES);
+    TEST_CHECK(mismatches == 0U, "%u bytes differ", (unsigned)mismatches);
+    TEST_CHECK(usart.overruns == 0U, "%u overruns", (unsigned)usart.overruns);
+    TEST_CHECK(usart.stolen == 0U, "%u bytes taken from DMA by the IDLE handler", (unsigned)usart.stolen);
+    TEST_CHECK(stats.bytes_received == TEST_BYTES, "bytes_received %u", (unsigned)stats.bytes_received);
+    TEST_CHECK(stats.bytes_lost == 0U, "bytes_lost %u", (unsigned)stats.bytes_lost);
+    TEST_CHECK(stats.idle_events >= line.frame_no, "idle_events %u < %u frames",
+               (unsigned)stats.idle_events, (unsigned)line.frame_no);
+    TEST_CHECK(stats.dma_events > 0U, "no DMA half/full events");
+    printf("%u bytes in %u frames, %u idle / %u dma events, max used %u\n",
+           (unsigned)received, (unsigned)line.frame_no, (unsigned)stats.idle_events,
+           (unsigned)stats.dma_events, (unsigned)stats.max_used);
+
+    /* 没有数据时按超时返回，超时由port_timer_now计量 */
+    start = sim_now();
+    n = uart_read(buf, 1, 5);
+    elapsed = sim_now() - start;
+    TEST_CHECK(n == 0U, "read %u bytes from an idle line", (unsigned)n);
+    TEST_CHECK(elapsed >= 5U * (SIM_CPU_HZ / 1000U) && elapsed < 6U * (SIM_CPU_HZ / 1000U),
+               "5 ms timeout took %llu cycles", (unsigned long long)elapsed);
+
+    /* 读取者持有一段数据未释放时DMA又写满一圈：释放时已被覆盖的字节
+     * 计入bytes_lost，即使这段覆盖在下一次发布之前就已发生 */
+    dma_write(HOLD_BYTES);
+    idle_publish();
+    n = uart_rx_peek(&data);
+    TEST_CHECK(n == HOLD_BYTES, "peek returned %u bytes", (unsigned)n);
+    dma_write(UART_RX_BUFFER_SIZE - HOLD_BYTES + OVERWRITTEN);
+    uart_rx_consume(n);
+    idle_publish();
+    uart_rx_get_stats(&stats);
+    TEST_CHECK(stats.bytes_lost == OVERWRITTEN, "bytes_lost %u after overwriting %u held bytes",
+               (unsigned)stats.bytes_lost, OVERWRITTEN);
+    TEST_CHECK(uart_rx_available() == UART_RX_BUFFER_SIZE - HOLD_BYTES + OVERWRITTEN,
+               "%u bytes unread", (unsigned)uart_rx_available());
+
+    sim_stop();
+}
+
+/* Public functions - 外设库替身 ---------------------------------------------*/
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority) { (void)IRQn; (void)priority; }
+void NVIC_EnableIRQ(IRQn_Type IRQn) { (void)IRQn; }
+void RCC_AHB1PeriphClockCmd(uint32_t periph, FunctionalState state) { (void)periph; (void)state; }
+
+void DMA_DeInit(DMA_Stream_TypeDef* s)
+{
+    if (s == DMA2_Stream2) {
+        memset(&rx_dma, 0, sizeof(rx_dma));
+    }
+}
+
+void DMA_Init(DMA_Stream_TypeDef* s, DMA_InitTypeDef* init)
+{
+    if (s == DMA2_Stream2) {
+        rx_dma.mem = (uint8_t*)(uintptr_t)init->DMA_Memory0BaseAddr;
+        rx_dma.size = init->DMA_BufferSize;
+        rx_dma.ndtr = init->DMA_BufferSize;
+    }
+}
+
+void DMA_Cmd(DMA_Stream_TypeDef* s, FunctionalState state)
+{
+    if (s == DMA2_Stream2) {
+        rx_dma.en = (state == ENABLE);
+    }
+}
+
+FunctionalState DMA_GetCmdStatus(DMA_Stream_TypeDef* s)
+{
+    return (s == DMA2_Stream2 && rx_dma.en) ? ENABLE : DISABLE;
+}
+
+void DMA_ITConfig(DMA_Stream_TypeDef* s, uint32_t it, FunctionalState state)
+{
+    if (s == DMA2_Stream2) {
+        if ((it & DMA_IT_HT) != 0U) {
+            rx_dma.htie = (state == ENABLE);
+        }
+        if ((it & DMA_IT_TC) != 0U) {
+            rx_dma.tcie = (state == ENABLE);
+        }
+    }
+}
+
+void DMA_ClearFlag(DMA_Stream_TypeDef* s, uint32_t flag) { (void)s; (void)flag; }
+void DMA_MemoryTargetConfig(DMA_Stream_TypeDef* s, uint32_t addr, uint32_t target) { (void)s; (void)addr; (void)target; }
+void DMA_SetCurrDataCounter(DMA_Stream_TypeDef* s, uint16_t n) { (void)s; (void)n; }
+
+uint16_t DMA_GetCurrDataCounter(DMA_Stream_TypeDef* s)
+{
+    return (s == DMA2_Stream2) ? (uint16_t)rx_dma.ndtr : 0U;
+}
+
+ITStatus DMA_GetITStatus(DMA_Stream_TypeDef* s, uint32_t it)
+{
+    if (s != DMA2_Stream2) {
+        return RESET;
+    }
+    if (it == DMA_IT_HTIF2) {
+        return rx_dma.htif ? SET : RESET;
+    }
+    return (it == DMA_IT_TCIF2 && rx_dma.tcif) ? SET : RESET;
+}
+
+void DMA_ClearITPendingBit(DMA_Stream_TypeDef* s, uint32_t it)
+{
+    if (s == DMA2_Stream2) {
+        if (it == DMA_IT_HTIF2) {
+            rx_dma.htif = 0;
+        } else if (it == DMA_IT_TCIF2) {
+            rx_dma.tcif = 0;
+        }
+    }
+}
+
+void USART_ITConfig(USART_TypeDef* u, uint16_t it, FunctionalState state)
+{
+    (void)u;
+    if (it == USART_IT_IDLE) {
+        usart.idleie = (state == ENABLE);
+    }
+}
+
+void USART_DMACmd(USART_TypeDef* u, uint16_t req, FunctionalState state)
+{
+    (void)u;
+    if ((req & USART_DMAReq_Rx) != 0U) {
+        usart.dmar = (state == ENABLE);
+    }
+}
+
+ITStatus USART_GetITStatus(USART_TypeDef* u, uint16_t it)
+{
+    (void)u;
+    usart.sr_read = 1;
+    return (it == USART_IT_IDLE && usart.idle && usart.idleie) ? SET : RESET;
+}
+
+FlagStatus USART_GetFlagStatus(USART_TypeDef* u, uint16_t flag)
+{
+    (void)u;
+    usart.sr_read = 1;
+    if (flag == USART_FLAG_RXNE) {
+        return usart.rxne ? SET : RESET;
+    }
+    return SET;                             /* TC：发送部分不模拟 */
+}
+
+uint16_t USART_ReceiveData(USART_TypeDef* u)
+{
+    (void)u;
+    if (usart.rxne) {
+        usart.rxne = 0;
+        usart.stolen++;
+    }
+    if (usart.sr_read) {
+        usart.idle = 0;
+        usart.sr_read = 0;
+    }
+    return usart.dr;
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    task_t* task;
+
+    sim_reset();
+    rtos_init();
+    Time_Init();
+
+    irq_line = sim_irq_register("line", HW_PRIORITY, line_isr, NULL);
+    irq_dmareq = sim_irq_register("dmareq", HW_PRIORITY, dmareq_isr, NULL);
+    irq_noise = sim_irq_register("noise", NOISE_PRIORITY, noise_isr, NULL);
+    irq_usart = sim_irq_register("USART1", UART_RX_IRQ_PRIORITY, usart_isr, NULL);
+    irq_dma = sim_irq_register("DMA2_S2", UART_RX_IRQ_PRIORITY, dma_isr, NULL);
+
+    uart_rx_init();
+    task = task_create(reader, NULL, 2);
+    sim_set_task_name(task, "reader");
+
+    sim_irq_schedule(irq_line, CYCLES_PER_BYTE);
+    sim_set_end((uint64_t)SIM_CPU_HZ * 5U);
+    rtos_start();
+
+    TEST_CHECK(received == TEST_BYTES, "simulation ended early at %llu cycles",
+               (unsigned long long)sim_now());
+    return test_result("uart_rx");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
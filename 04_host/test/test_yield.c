@@ -0,0 +1,127 @@
+/**
+  ******************************************************************************
+  * @file    test_yield.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   task_yield轮转顺序测试
+  ******************************************************************************
+  * @attention
+  *
+  * 在port/sim上检查：
+  * - 同优先级的三个就绪任务每次task_yield后按A、B、C轮转，顺序不随轮次变化
+  * - 轮转期间低优先级任务不运行
+  * - 没有同优先级就绪任务时task_yield经一次切换路径后继续运行当前任务
+  * - 中断中调用task_yield不做任何事
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "test.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Private define ------------------------------------------------------------*/
+#define PEERS                   3
+#define ROUNDS                  20
+#define RUN_CYCLES              100U
+#define LONE_YIELD_CYCLES       100U        /* PendSV进出和切换路径 */
+
+/* Private variables ---------------------------------------------------------*/
+static char order[PEERS * ROUNDS + 1];
+static int order_len;
+static int low_ran_during_peers;
+static int peers_left;
+static int irq_yield;
+static task_t* irq_saw_task;
+static int done;
+
+/* Private functions ---------------------------------------------------------*/
+
+static void peer(void* arg)
+{
+    int i;
+
+    for (i = 0; i < ROUNDS; i++) {
+        order[order_len++] = (char)('A' + (int)(intptr_t)arg);
+        sim_run(RUN_CYCLES);
+        task_yield();
+    }
+    peers_left--;
+}
+
+static void low(void* arg)
+{
+    (void)arg;
+    if (peers_left > 0) {
+        low_ran_during_peers = 1;
+    }
+}
+
+static void yield_isr(void* arg)
+{
+    (void)arg;
+    task_yield();
+    irq_saw_task = scheduler.current_task;
+}
+
+static void driver(void* arg)
+{
+    char want[PEERS * ROUNDS + 1];
+    task_t* self = scheduler.current_task;
+    uint64_t start;
+    int i;
+
+    (void)arg;
+
+    /* 驱动任务是唯一的最高优先级任务：经过一次切换路径后回到自身 */
+    start = sim_now();
+    task_yield();
+    TEST_CHECK(scheduler.current_task == self && sim_now() - start <= LONE_YIELD_CYCLES,
+               "lone yield took %llu cycles", (unsigned long long)(sim_now() - start));
+
+    /* 中断中调用不切换 */
+    sim_irq_pend(irq_yield);
+    sim_run(100U);
+    TEST_CHECK(irq_saw_task == self, "yield in an interrupt changed the current task");
+
+    /* 三个同优先级任务轮转，低优先级任务在它们结束后才运行 */
+    peers_left = PEERS;
+    (void)task_create(low, NULL, 4);
+    for (i = 0; i < PEERS; i++) {
+        (void)task_create(peer, (void*)(intptr_t)i, 3);
+    }
+    Delay_ticks(PEERS * ROUNDS * RUN_CYCLES);
+
+    for (i = 0; i < PEERS * ROUNDS; i++) {
+        want[i] = (char)('A' + i % PEERS);
+    }
+    want[PEERS * ROUNDS] = '\0';
+    TEST_CHECK(order_len == PEERS * ROUNDS, "%d of %d slices ran", order_len, PEERS * ROUNDS);
+    TEST_CHECK(strcmp(order, want) == 0, "order %s", order);
+    TEST_CHECK(peers_left == 0, "%d peers still running", peers_left);
+    TEST_CHECK(!low_ran_during_peers, "lower priority task ran between yields");
+
+    done = 1;
+    sim_stop();
+}
+
+/* Public functions ----------------------------------------------------------*/
+
+int main(void)
+{
+    sim_reset();
+    rtos_init();
+    Time_Init();
+    irq_yield = sim_irq_register("yield", 5, yield_isr, NULL);
+    sim_set_task_name(task_create(driver, NULL, 1), "driver");
+    rtos_start();
+
+    TEST_CHECK(done, "driver did not finish, stopped at %llu cycles", (unsigned long long)sim_now());
+    return test_result("yield");
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/
@@ -0,0 +1,67 @@
+/**
+  ******************************************************************************
+  * @file    tm_host.c
+  * @author  RTOS Team
+  * @version V1.0.0
+  * @date    2025-01-14
+  * @brief   Thread-Metric主机平台接口和入口
+  *          在POSIX移植层上运行00_project/User/tm中的测试，SIGUSR1作为软件中断
+  ******************************************************************************
+  * @attention
+  *
+  * 每项测试的时间窗口由编译时的TM_TEST_DURATION决定，见Makefile的TM_DURATION。
+  * 主机上的计数包含信号和系统调用开销，只用于比较内核改动前后的相对变化。
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "core.h"
+#include "time.h"
+#include "../../00_project/User/tm/tm_api.h"
+#include <stddef.h>
+
+/* Public functions ----------------------------------------------------------*/
+
+/**
+  * @brief  登记软件中断处理函数
+  * @param  handler: 处理函数
+  * @retval None
+  */
+void tm_platform_interrupt_init(void (*handler)(void))
+{
+    port_posix_set_irq_handler(handler);
+}
+
+/**
+  * @brief  触发软件中断，信号处理函数返回后才返回
+  * @param  None
+  * @retval None
+  */
+void tm_cause_interrupt(void)
+{
+    port_posix_trigger_irq();
+}
+
+/**
+  * @brief  全部测试结束，rtos_start返回到main
+  * @param  None
+  * @retval None
+  */
+void tm_platform_done(void)
+{
+    port_posix_set_irq_handler(NULL);
+    port_posix_stop();
+}
+
+int main(void)
+{
+    rtos_init();
+    Time_Init();
+    tm_start();
+    rtos_start();
+    Time_DeInit();
+    return 0;
+}
+
+/************************ (C) COPYRIGHT RTOS Team *****END OF FILE****/